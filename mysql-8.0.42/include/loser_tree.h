@@ -0,0 +1,189 @@
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#ifndef LOSER_TREE_INCLUDED
+#define LOSER_TREE_INCLUDED
+
+/**
+  @file include/loser_tree.h
+*/
+
+#include <assert.h>
+#include <stddef.h>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+  Implements a tournament tree of losers, for merging a fixed number of
+  sorted sequences.
+
+  The tree has one leaf for each sequence, holding the current element of
+  that sequence. Each inner node holds the loser of the match between the
+  winners of its two subtrees, and the overall winner is kept on the side.
+  When the winner has been consumed, and replaced by the next element of its
+  sequence (see update_top()), or its sequence has run out (see pop()), only
+  the matches on the path from its leaf to the root are replayed. This takes
+  one comparison per level of the tree, whereas a binary heap (see
+  Priority_queue) needs two comparisons per level to sift the new element
+  down, so a loser tree is the better choice for k-way merges.
+
+  Like Priority_queue, top() is the greatest element according to Less.
+  Elements that are equal according to Less come out in the order of the
+  sequences they belong to, so a merge of stable sorted sequences is stable.
+
+  @tparam T         Type of the elements.
+  @tparam Less      A binary predicate that takes two elements (of type T)
+                    and returns a bool. The expression less(a,b) shall return
+                    true if a is considered to go before b in the strict weak
+                    ordering the function defines.
+  @tparam Allocator Allocator for the elements of the tree.
+ */
+template <typename T, typename Less = std::less<T>,
+          typename Allocator = std::allocator<T>>
+class Loser_tree {
+  using size_allocator_type =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<size_t>;
+  using bool_allocator_type =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<bool>;
+
+ public:
+  explicit Loser_tree(const Less &less = Less(),
+                      const Allocator &alloc = Allocator())
+      : m_less(less),
+        m_elements(alloc),
+        m_removed(bool_allocator_type(alloc)),
+        m_nodes(size_allocator_type(alloc)) {}
+
+  /**
+    Set up the tree with one leaf for each of the given elements, which are
+    the first elements of the sequences to merge. The sequences are numbered
+    from 0, in the order given.
+
+    @returns true if out of memory.
+   */
+  template <typename Input_iterator>
+  [[nodiscard]] bool init(Input_iterator first, Input_iterator beyond) {
+    std::vector<size_t> winners;
+    try {
+      m_elements.assign(first, beyond);
+      m_removed.assign(m_elements.size(), false);
+      m_nodes.assign(std::max<size_t>(m_elements.size(), 1), 0);
+      winners.resize(m_elements.size());
+    } catch (std::bad_alloc const &) {
+      return true;
+    }
+    m_size = m_elements.size();
+    if (m_size == 0) return false;
+
+    // Play the matches bottom-up. Leaf i is node number (num_leaves() + i),
+    // and the children of node n are 2n and 2n + 1, so every inner node
+    // (1 to num_leaves() - 1) has two children.
+    const size_t leaves = num_leaves();
+    const auto winner_of = [&winners, leaves](size_t node) {
+      return node >= leaves ? node - leaves : winners[node];
+    };
+    for (size_t node = leaves - 1; node > 0; --node) {
+      const size_t left = winner_of(2 * node);
+      const size_t right = winner_of(2 * node + 1);
+      const bool left_wins = beats(left, right);
+      winners[node] = left_wins ? left : right;
+      m_nodes[node] = left_wins ? right : left;
+    }
+    if (leaves > 1) m_nodes[0] = winners[1];
+    return false;
+  }
+
+  /// @returns the number of sequences that have not run out.
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  /// @returns the number of sequences the tree was set up with.
+  size_t num_leaves() const { return m_elements.size(); }
+
+  /// @returns true if sequence i has not run out.
+  bool contains(size_t i) const { return !m_removed[i]; }
+
+  /// @returns the greatest current element.
+  T &top() {
+    assert(!empty());
+    return m_elements[m_nodes[0]];
+  }
+
+  /// @returns the number of the sequence that top() belongs to.
+  size_t top_index() const {
+    assert(!empty());
+    return m_nodes[0];
+  }
+
+  /**
+    Replay the matches of the top element, after it has been replaced (through
+    the reference returned by top()) by the next element of its sequence.
+   */
+  void update_top() {
+    assert(!empty());
+    replay();
+  }
+
+  /// Take out the sequence of the top element, which has run out.
+  void pop() {
+    assert(!empty());
+    m_removed[m_nodes[0]] = true;
+    --m_size;
+    replay();
+  }
+
+ private:
+  /// Replay the matches on the path from the leaf of the winner to the root.
+  void replay() {
+    size_t winner = m_nodes[0];
+    for (size_t node = (num_leaves() + winner) / 2; node > 0; node /= 2) {
+      if (beats(m_nodes[node], winner)) std::swap(m_nodes[node], winner);
+    }
+    m_nodes[0] = winner;
+  }
+
+  /// @returns true if the current element of sequence a goes out before the
+  /// one of sequence b. Sequences that have run out lose every match, and
+  /// ties go to the sequence with the lowest number.
+  bool beats(size_t a, size_t b) const {
+    if (m_removed[a] || m_removed[b]) return m_removed[b] && !m_removed[a];
+    return a < b ? !m_less(m_elements[a], m_elements[b])
+                 : m_less(m_elements[b], m_elements[a]);
+  }
+
+  Less m_less;
+  std::vector<T, Allocator> m_elements;
+  std::vector<bool, bool_allocator_type> m_removed;
+
+  /// m_nodes[0] is the number of the sequence holding the overall winner,
+  /// and m_nodes[n], for n > 0, the loser of the match at inner node n.
+  std::vector<size_t, size_allocator_type> m_nodes;
+
+  size_t m_size{0};
+};
+
+#endif  // LOSER_TREE_INCLUDED
@@ -0,0 +1,397 @@
+-- Copyright (c) 2025, Oracle and/or its affiliates.
+--
+-- This program is free software; you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation; version 2 of the License.
+--
+-- This program is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+-- GNU General Public License for more details.
+--
+-- You should have received a copy of the GNU General Public License
+-- along with this program; if not, write to the Free Software
+-- Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+DROP PROCEDURE IF EXISTS optimizer_cost_calibrate;
+
+DELIMITER $$
+
+CREATE DEFINER='mysql.sys'@'localhost' PROCEDURE optimizer_cost_calibrate (
+        IN in_rows INT UNSIGNED,
+        IN in_apply BOOLEAN
+    )
+    COMMENT '
+Description
+-----------
+
+Runs a set of micro-benchmarks on the running server, and fits the cost
+constants of the optimizer (see mysql.server_cost and mysql.engine_cost)
+to the time the operations they stand for take on this machine.
+
+The benchmarks work on temporary InnoDB tables that are created, and
+dropped again, by the procedure:
+
+   * row_evaluate_cost and memory_block_read_cost are fitted to full scans
+     of a table with narrow rows and a table with wide rows. The number of
+     pages read from the buffer pool is taken from the
+     Innodb_buffer_pool_read_requests status variable.
+   * key_compare_cost is fitted to a sort of the narrow table, assuming
+     N * log2(N) key comparisons for N rows.
+   * memory_temptable_create_cost, memory_temptable_row_cost,
+     disk_temptable_create_cost and disk_temptable_row_cost are fitted to
+     materialized derived tables, with big_tables set to OFF and ON.
+   * io_block_read_cost is the average time it has taken to read a page
+     from the InnoDB data files since the server started, as recorded by
+     the wait/io/file/innodb/innodb_data_file instrument of Performance
+     Schema. The benchmarks do not cause such reads themselves; if too
+     few pages have been read, the cost is not calibrated.
+
+Each benchmark is run three times, and the fastest run is used. The time
+is converted to cost units by keeping row_evaluate_cost at its default
+value, so that the calibrated constants can be compared with the defaults.
+
+Constants that cannot be measured (because the measurement came out as
+zero or less, which happens on a busy server) are left as they are. The
+results are most reliable on an otherwise idle server.
+
+The procedure changes the big_tables, sort_buffer_size,
+cte_max_recursion_depth and sql_log_bin session variables while it runs.
+They are restored when it returns, also if it fails.
+
+Requires the SUPER privilege for "SET sql_log_bin = 0;", and the UPDATE
+privilege on mysql.server_cost and mysql.engine_cost to apply the result.
+
+Parameters
+-----------
+
+in_rows (INT UNSIGNED):
+  The number of rows in the narrow table. The wide table gets a tenth of
+  that. NULL means 100000. The smallest allowed value is 1000.
+in_apply (BOOLEAN):
+  Whether to write the calibrated constants to mysql.server_cost and
+  mysql.engine_cost (the row for the default storage engine and device
+  type), and make the server use them with FLUSH OPTIMIZER_COSTS.
+  If FALSE, the constants are only returned.
+
+Configuration Options
+----------------------
+
+sys.debug
+  Whether to provide debugging output.
+  Default is ''OFF''. Set to ''ON'' to include.
+
+Example
+--------
+
+mysql> CALL sys.optimizer_cost_calibrate(NULL, FALSE);
++------------------------------+---------------+---------------+-------------+------------------+
+| cost_name                    | default_value | current_value | measured_ns | calibrated_value |
++------------------------------+---------------+---------------+-------------+------------------+
+| disk_temptable_create_cost   |            20 |          NULL |   27634.000 |         5.351485 |
+| disk_temptable_row_cost      |           0.5 |          NULL |    1046.470 |         0.202654 |
+| io_block_read_cost           |             1 |          NULL |   71210.335 |        13.790103 |
+| key_compare_cost             |          0.05 |          NULL |      31.027 |         0.006009 |
+| memory_block_read_cost       |          0.25 |          NULL |     226.122 |         0.043789 |
+| memory_temptable_create_cost |             1 |          NULL |    5893.000 |         1.141216 |
+| memory_temptable_row_cost    |           0.1 |          NULL |      97.410 |         0.018864 |
+| row_evaluate_cost            |           0.1 |          NULL |     516.386 |         0.100000 |
++------------------------------+---------------+---------------+-------------+------------------+
+8 rows in set (4.28 sec)
+
+Query OK, 0 rows affected (4.28 sec)
+'
+    SQL SECURITY INVOKER
+    NOT DETERMINISTIC
+    MODIFIES SQL DATA
+BEGIN
+    DECLARE v_done BOOLEAN DEFAULT FALSE;
+    DECLARE v_rows, v_wide_rows INT UNSIGNED;
+    DECLARE v_name VARCHAR(64);
+    DECLARE v_query TEXT;
+    DECLARE v_loops, v_loop, v_run INT UNSIGNED;
+    DECLARE v_use_disk BOOLEAN;
+    DECLARE v_start DATETIME(6);
+    DECLARE v_usec, v_best_usec, v_pages_start, v_pages, v_best_pages BIGINT;
+    DECLARE v_narrow_usec, v_narrow_pages, v_wide_usec, v_wide_pages DOUBLE;
+    DECLARE v_sort_usec, v_memory_rows_usec, v_disk_rows_usec DOUBLE;
+    DECLARE v_create_base_usec, v_create_memory_usec, v_create_disk_usec DOUBLE;
+    DECLARE v_det, v_row_ns, v_block_ns, v_unit_ns DOUBLE;
+    DECLARE v_row_cost FLOAT;
+    DECLARE v_big_tables, v_sort_buffer_size, v_cte_max_recursion_depth BIGINT;
+    DECLARE v_sql_log_bin BOOLEAN;
+
+    DECLARE c_measurements CURSOR FOR
+        SELECT name, query, loops, use_disk
+          FROM tmp_calibration_measurements
+         ORDER BY name;
+
+    DECLARE CONTINUE HANDLER FOR NOT FOUND SET v_done = TRUE;
+
+    -- Clean up, and leave the session as it was, before passing the error on
+    DECLARE EXIT HANDLER FOR SQLEXCEPTION
+    BEGIN
+        DROP TEMPORARY TABLE IF EXISTS tmp_calibration_narrow;
+        DROP TEMPORARY TABLE IF EXISTS tmp_calibration_wide;
+        DROP TEMPORARY TABLE IF EXISTS tmp_calibration_measurements;
+        DROP TEMPORARY TABLE IF EXISTS tmp_calibration_results;
+        SET @sys.optimizer_cost_calibrate.sql = NULL;
+
+        SET SESSION big_tables = v_big_tables,
+            SESSION sort_buffer_size = v_sort_buffer_size,
+            SESSION cte_max_recursion_depth = v_cte_max_recursion_depth;
+        IF (v_sql_log_bin AND NOT @@sql_log_bin) THEN
+            SET sql_log_bin = 1;
+        END IF;
+
+        RESIGNAL;
+    END;
+
+    SET v_big_tables = @@session.big_tables,
+        v_sort_buffer_size = @@session.sort_buffer_size,
+        v_cte_max_recursion_depth = @@session.cte_max_recursion_depth,
+        v_sql_log_bin = @@session.sql_log_bin;
+
+    -- Set configuration options
+    IF (@sys.debug IS NULL) THEN
+        SET @sys.debug = sys.sys_get_config('debug', 'OFF');
+    END IF;
+
+    SET v_rows = IFNULL(in_rows, 100000);
+    IF (v_rows < 1000) THEN
+        SIGNAL SQLSTATE '45000'
+           SET MESSAGE_TEXT = 'in_rows must be at least 1000';
+    END IF;
+    SET v_wide_rows = v_rows DIV 10;
+
+    -- Temporary table are used - disable sql_log_bin if necessary to prevent them replicating
+    IF (v_sql_log_bin) THEN
+        SET sql_log_bin = 0;
+    END IF;
+
+    -- The sort of the narrow table must not need merge passes
+    SET SESSION sort_buffer_size = GREATEST(v_sort_buffer_size, v_rows * 64),
+        SESSION cte_max_recursion_depth = GREATEST(v_cte_max_recursion_depth, v_rows);
+
+    DROP TEMPORARY TABLE IF EXISTS tmp_calibration_narrow;
+    DROP TEMPORARY TABLE IF EXISTS tmp_calibration_wide;
+    DROP TEMPORARY TABLE IF EXISTS tmp_calibration_measurements;
+    DROP TEMPORARY TABLE IF EXISTS tmp_calibration_results;
+
+    CREATE TEMPORARY TABLE tmp_calibration_narrow (
+        id INT UNSIGNED NOT NULL PRIMARY KEY,
+        a INT UNSIGNED NOT NULL,
+        b INT UNSIGNED NOT NULL
+    ) ENGINE = InnoDB;
+
+    CREATE TEMPORARY TABLE tmp_calibration_wide (
+        id INT UNSIGNED NOT NULL PRIMARY KEY,
+        a INT UNSIGNED NOT NULL,
+        b INT UNSIGNED NOT NULL,
+        pad VARCHAR(1024) CHARACTER SET latin1 NOT NULL
+    ) ENGINE = InnoDB;
+
+    -- b is in pseudo-random order, so that sorting on it takes real work
+    INSERT INTO tmp_calibration_narrow (id, a, b)
+    WITH RECURSIVE seq (n) AS (
+        SELECT 1
+         UNION ALL
+        SELECT n + 1 FROM seq WHERE n < v_rows
+    )
+    SELECT n, n, CRC32(n) FROM seq;
+
+    INSERT INTO tmp_calibration_wide (id, a, b, pad)
+    SELECT id, a, b, REPEAT('x', 1000)
+      FROM tmp_calibration_narrow
+     WHERE id <= v_wide_rows;
+
+    CREATE TEMPORARY TABLE tmp_calibration_measurements (
+        name VARCHAR(64) NOT NULL PRIMARY KEY,
+        query TEXT NOT NULL,
+        loops INT UNSIGNED NOT NULL,
+        use_disk BOOLEAN NOT NULL,
+        usec DOUBLE,
+        pages DOUBLE
+    ) ENGINE = InnoDB;
+
+    -- The create_* statements are short, so they are run many times, and
+    -- compared with the same statement without a temporary table
+    INSERT INTO tmp_calibration_measurements (name, query, loops, use_disk) VALUES
+        ('scan_narrow', 'DO (SELECT SUM(a) FROM tmp_calibration_narrow)', 1, FALSE),
+        ('scan_wide', 'DO (SELECT SUM(a) FROM tmp_calibration_wide)', 1, FALSE),
+        ('sort', CONCAT('DO (SELECT a FROM tmp_calibration_narrow ORDER BY b, a LIMIT ', v_rows - 1, ', 1)'), 1, FALSE),
+        ('temptable_memory_rows', 'DO (SELECT /*+ NO_MERGE(d) */ SUM(d.a) FROM (SELECT a FROM tmp_calibration_narrow) AS d)', 1, FALSE),
+        ('temptable_disk_rows', 'DO (SELECT /*+ NO_MERGE(d) */ SUM(d.a) FROM (SELECT a FROM tmp_calibration_narrow) AS d)', 1, TRUE),
+        ('create_base', 'DO (SELECT SUM(d.x) FROM (SELECT 1 AS x) AS d)', 100, FALSE),
+        ('create_temptable_memory', 'DO (SELECT /*+ NO_MERGE(d) */ SUM(d.x) FROM (SELECT 1 AS x) AS d)', 100, FALSE),
+        ('create_temptable_disk', 'DO (SELECT /*+ NO_MERGE(d) */ SUM(d.x) FROM (SELECT 1 AS x) AS d)', 100, TRUE);
+
+    OPEN c_measurements;
+    c_measurements_loop: LOOP
+        FETCH c_measurements INTO v_name, v_query, v_loops, v_use_disk;
+        IF v_done THEN
+            LEAVE c_measurements_loop;
+        END IF;
+
+        IF (@sys.debug = 'ON') THEN
+            SELECT v_name AS 'Debug', v_query AS 'Query', v_loops AS 'Loops', v_use_disk AS 'big_tables';
+        END IF;
+
+        SET @sys.optimizer_cost_calibrate.sql = v_query;
+        PREPARE stmt_calibrate FROM @sys.optimizer_cost_calibrate.sql;
+        SET SESSION big_tables = v_use_disk;
+
+        SET v_best_usec = NULL,
+            v_run = 0;
+        WHILE (v_run < 3) DO
+            SELECT VARIABLE_VALUE INTO v_pages_start
+              FROM performance_schema.global_status
+             WHERE VARIABLE_NAME = 'Innodb_buffer_pool_read_requests';
+
+            -- NOW() would return the time the CALL started
+            SET v_start = SYSDATE(6),
+                v_loop = 0;
+            WHILE (v_loop < v_loops) DO
+                EXECUTE stmt_calibrate;
+                SET v_loop = v_loop + 1;
+            END WHILE;
+            SET v_usec = TIMESTAMPDIFF(MICROSECOND, v_start, SYSDATE(6));
+
+            SELECT VARIABLE_VALUE - v_pages_start INTO v_pages
+              FROM performance_schema.global_status
+             WHERE VARIABLE_NAME = 'Innodb_buffer_pool_read_requests';
+
+            IF (v_best_usec IS NULL OR v_usec < v_best_usec) THEN
+                SET v_best_usec = v_usec,
+                    v_best_pages = v_pages;
+            END IF;
+            SET v_run = v_run + 1;
+        END WHILE;
+
+        SET SESSION big_tables = v_big_tables;
+        DEALLOCATE PREPARE stmt_calibrate;
+
+        UPDATE tmp_calibration_measurements
+           SET usec = v_best_usec / v_loops,
+               pages = v_best_pages / v_loops
+         WHERE name = v_name;
+    END LOOP;
+    CLOSE c_measurements;
+
+    SET @sys.optimizer_cost_calibrate.sql = NULL;
+
+    IF (@sys.debug = 'ON') THEN
+        SELECT * FROM tmp_calibration_measurements ORDER BY name;
+    END IF;
+
+    -- A temporary table can only be referred to once in a statement
+    SELECT MAX(IF(name = 'scan_narrow', usec, NULL)),
+           MAX(IF(name = 'scan_narrow', pages, NULL)),
+           MAX(IF(name = 'scan_wide', usec, NULL)),
+           MAX(IF(name = 'scan_wide', pages, NULL)),
+           MAX(IF(name = 'sort', usec, NULL)),
+           MAX(IF(name = 'temptable_memory_rows', usec, NULL)),
+           MAX(IF(name = 'temptable_disk_rows', usec, NULL)),
+           MAX(IF(name = 'create_base', usec, NULL)),
+           MAX(IF(name = 'create_temptable_memory', usec, NULL)),
+           MAX(IF(name = 'create_temptable_disk', usec, NULL))
+      INTO v_narrow_usec, v_narrow_pages, v_wide_usec, v_wide_pages,
+           v_sort_usec, v_memory_rows_usec, v_disk_rows_usec,
+           v_create_base_usec, v_create_memory_usec, v_create_disk_usec
+      FROM tmp_calibration_measurements;
+
+    -- A full scan takes pages * memory_block_read + rows * row_evaluate;
+    -- solve that for the two tables
+    SET v_det = v_narrow_pages * v_wide_rows - v_wide_pages * v_rows;
+    IF (v_det <> 0) THEN
+        SET v_block_ns = (v_narrow_usec * v_wide_rows - v_wide_usec * v_rows) / v_det * 1000,
+            v_row_ns = (v_narrow_pages * v_wide_usec - v_wide_pages * v_narrow_usec) / v_det * 1000;
+    END IF;
+    IF (v_row_ns IS NULL OR v_row_ns <= 0) THEN
+        SET v_row_ns = v_narrow_usec * 1000 / v_rows,
+            v_block_ns = NULL;
+    END IF;
+
+    CREATE TEMPORARY TABLE tmp_calibration_results (
+        cost_name VARCHAR(64) NOT NULL PRIMARY KEY,
+        is_engine_cost BOOLEAN NOT NULL,
+        measured_ns DOUBLE
+    ) ENGINE = InnoDB;
+
+    INSERT INTO tmp_calibration_results VALUES
+        ('row_evaluate_cost', FALSE, v_row_ns),
+        ('memory_block_read_cost', TRUE, v_block_ns),
+        ('key_compare_cost', FALSE,
+         (v_sort_usec - v_narrow_usec) * 1000 / (v_rows * LOG2(v_rows))),
+        ('memory_temptable_row_cost', FALSE,
+         (v_memory_rows_usec - v_narrow_usec) * 1000 / v_rows),
+        ('disk_temptable_row_cost', FALSE,
+         (v_disk_rows_usec - v_narrow_usec) * 1000 / v_rows),
+        ('memory_temptable_create_cost', FALSE,
+         (v_create_memory_usec - v_create_base_usec) * 1000),
+        ('disk_temptable_create_cost', FALSE,
+         (v_create_disk_usec - v_create_base_usec) * 1000),
+        ('io_block_read_cost', TRUE,
+         (SELECT SUM_TIMER_READ / 1000 / (SUM_NUMBER_OF_BYTES_READ / @@global.innodb_page_size)
+            FROM performance_schema.file_summary_by_event_name
+           WHERE EVENT_NAME = 'wait/io/file/innodb/innodb_data_file'
+             AND SUM_NUMBER_OF_BYTES_READ >= 1000 * @@global.innodb_page_size
+             AND SUM_TIMER_READ > 0));
+
+    UPDATE tmp_calibration_results
+       SET measured_ns = NULL
+     WHERE measured_ns <= 0;
+
+    -- Express the times in cost units, with row_evaluate_cost as the anchor
+    SELECT default_value INTO v_row_cost
+      FROM mysql.server_cost
+     WHERE cost_name = 'row_evaluate_cost';
+    SET v_unit_ns = v_row_ns / v_row_cost;
+
+    SELECT r.cost_name,
+           c.default_value,
+           c.cost_value AS current_value,
+           ROUND(r.measured_ns, 3) AS measured_ns,
+           ROUND(r.measured_ns / v_unit_ns, 6) AS calibrated_value
+      FROM tmp_calibration_results AS r
+      LEFT JOIN (
+                 SELECT cost_name, default_value, cost_value
+                   FROM mysql.server_cost
+                  UNION ALL
+                 SELECT cost_name, default_value, cost_value
+                   FROM mysql.engine_cost
+                  WHERE engine_name = 'default' AND device_type = 0
+                ) AS c USING (cost_name)
+     ORDER BY r.cost_name;
+
+    IF (in_apply) THEN
+        UPDATE mysql.server_cost AS c
+          JOIN tmp_calibration_results AS r USING (cost_name)
+           SET c.cost_value = r.measured_ns / v_unit_ns,
+               c.comment = CONCAT('Calibrated by sys.optimizer_cost_calibrate() on ', @@hostname)
+         WHERE NOT r.is_engine_cost AND r.measured_ns IS NOT NULL;
+
+        UPDATE mysql.engine_cost AS c
+          JOIN tmp_calibration_results AS r USING (cost_name)
+           SET c.cost_value = r.measured_ns / v_unit_ns,
+               c.comment = CONCAT('Calibrated by sys.optimizer_cost_calibrate() on ', @@hostname)
+         WHERE c.engine_name = 'default' AND c.device_type = 0
+           AND r.is_engine_cost AND r.measured_ns IS NOT NULL;
+
+        FLUSH OPTIMIZER_COSTS;
+    END IF;
+
+    DROP TEMPORARY TABLE tmp_calibration_narrow;
+    DROP TEMPORARY TABLE tmp_calibration_wide;
+    DROP TEMPORARY TABLE tmp_calibration_measurements;
+    DROP TEMPORARY TABLE tmp_calibration_results;
+
+    SET SESSION sort_buffer_size = v_sort_buffer_size,
+        SESSION cte_max_recursion_depth = v_cte_max_recursion_depth;
+
+    IF (v_sql_log_bin) THEN
+        SET sql_log_bin = 1;
+    END IF;
+END$$
+
+DELIMITER ;
@@ -53,6 +53,7 @@
 #include "add_with_saturate.h"
 #include "decimal.h"
 #include "field_types.h"  // enum_field_types
+#include "loser_tree.h"
 #include "m_ctype.h"
 #include "map_helpers.h"
 #include "my_basename.h"
@@ -71,7 +72,7 @@
 #include "mysql/udf_registration_types.h"
 #include "mysql_com.h"
 #include "mysqld_error.h"
-#include "priority_queue.h"
+#include "prealloced_array.h"
 #include "sql-common/json_dom.h"  // Json_wrapper
 #include "sql/auth/sql_security_ctx.h"
 #include "sql/bounded_queue.h"
@@ -85,6 +86,7 @@
 #include "sql/item.h"
 #include "sql/item_subselect.h"
 #include "sql/iterators/row_iterator.h"
+#include "sql/iterators/runtime_filter.h"
 #include "sql/iterators/sorting_iterator.h"
 #include "sql/key_spec.h"
 #include "sql/malloc_allocator.h"
@@ -145,8 +147,8 @@ static ha_rows read_all_rows(
     table_map tables_to_get_rowid_for, Filesort_info *fs_info,
     IO_CACHE *chunk_file, IO_CACHE *tempfile,
     Bounded_queue<uchar *, uchar *, Sort_param, Mem_compare_queue_key> *pq,
-    RowIterator *source_iterator, ha_rows *found_rows, size_t *longest_key,
-    size_t *longest_addon);
+    TopNFilter *top_n_filter, RowIterator *source_iterator,
+    ha_rows *found_rows, size_t *longest_key, size_t *longest_addon);
 static int write_keys(Sort_param *param, Filesort_info *fs_info, uint count,
                       IO_CACHE *buffer_file, IO_CACHE *tempfile);
 static int merge_index(THD *thd, Sort_param *param, Sort_buffer sort_buffer,
@@ -351,6 +353,10 @@ static void trace_filesort_information(Opt_trace_context *trace,
                              to use the priority queue optimization or not;
                              if we estimate fewer rows than we can fit into
                              RAM, we never use the priority queue.
+  @param      top_n_filter   If not nullptr, is shown every row before it is
+                             added to the sort, so that it can filter out
+                             rows that cannot make it past the LIMIT while
+                             source_iterator is still reading.
   @param      fs_info        Owns the buffers for sort_result.
   @param      sort_result    Where to store the sort result.
   @param[out] found_rows     Store the number of found rows here.
@@ -366,8 +372,8 @@ static void trace_filesort_information(Opt_trace_context *trace,
 
 bool filesort(THD *thd, Filesort *filesort, RowIterator *source_iterator,
               table_map tables_to_get_rowid_for, ha_rows num_rows_estimate,
-              Filesort_info *fs_info, Sort_result *sort_result,
-              ha_rows *found_rows) {
+              TopNFilter *top_n_filter, Filesort_info *fs_info,
+              Sort_result *sort_result, ha_rows *found_rows) {
   int error;
   ulong memory_available = thd->variables.sortbuff_size;
   ha_rows num_rows_found = HA_POS_ERROR;
@@ -426,6 +432,7 @@ bool filesort(THD *thd, Filesort *filesort, RowIterator *source_iterator,
                            sortlength(thd, filesort->sortorder, s_length),
                            filesort->tables, max_rows,
                            filesort->m_remove_duplicates);
+  param->m_max_sort_threads = thd->variables.sort_threads;
 
   fs_info->addon_fields = param->addon_fields;
 
@@ -505,7 +512,8 @@ bool filesort(THD *thd, Filesort *filesort, RowIterator *source_iterator,
     num_rows_found = read_all_rows(
         thd, param, filesort->tables, tables_to_get_rowid_for, fs_info,
         &chunk_file, &tempfile, param->using_pq ? &pq : nullptr,
-        source_iterator, found_rows, &longest_key, &longest_addons);
+        top_n_filter, source_iterator, found_rows, &longest_key,
+        &longest_addons);
     if (num_rows_found == HA_POS_ERROR) goto err;
   }
 
@@ -587,7 +595,8 @@ bool filesort(THD *thd, Filesort *filesort, RowIterator *source_iterator,
                                                    : "rowid");
     sort_mode.append(">");
 
-    const char *algo_text[] = {"none", "std::sort", "std::stable_sort"};
+    const char *algo_text[] = {"none", "std::sort", "std::stable_sort",
+                               "radix sort"};
 
     Opt_trace_object filesort_summary(trace, "filesort_summary");
     filesort_summary.add("memory_available", memory_available)
@@ -872,6 +881,7 @@ static bool alloc_and_make_sortkey(Sort_param *param, Filesort_info *fs_info,
                            in tempfile.
   @param tempfile          File to write sorted sequences of sortkeys to.
   @param pq                If !NULL, use it for keeping top N elements
+  @param top_n_filter      If !NULL, shown every row that is read.
   @param source_iterator   Where to read the rows to be sorted from.
   @param [out] found_rows  The number of FOUND_ROWS().
                            For a query with LIMIT, this value will typically
@@ -925,8 +935,8 @@ static ha_rows read_all_rows(
     table_map tables_to_get_rowid_for, Filesort_info *fs_info,
     IO_CACHE *chunk_file, IO_CACHE *tempfile,
     Bounded_queue<uchar *, uchar *, Sort_param, Mem_compare_queue_key> *pq,
-    RowIterator *source_iterator, ha_rows *found_rows, size_t *longest_key,
-    size_t *longest_addons) {
+    TopNFilter *top_n_filter, RowIterator *source_iterator,
+    ha_rows *found_rows, size_t *longest_key, size_t *longest_addons) {
   /*
     Set up an error handler for filesort. It is automatically pushed
     onto the internal error handler stack upon creation, and will be
@@ -1000,6 +1010,7 @@ static ha_rows read_all_rows(
 
     ++(*found_rows);
     num_total_records++;
+    if (top_n_filter != nullptr) top_n_filter->AddRow();
     if (pq != nullptr) {
       if (pq->push(tables)) return HA_POS_ERROR;
     } else {
@@ -1937,13 +1948,16 @@ static int merge_buffers(THD *thd, Sort_param *param, IO_CACHE *from_file,
   Merge_chunk_greater mcl = param->using_varlen_keys()
                                 ? Merge_chunk_greater(param)
                                 : Merge_chunk_greater(key_len);
-  Priority_queue<Merge_chunk *,
-                 std::vector<Merge_chunk *, Malloc_allocator<Merge_chunk *>>,
-                 Merge_chunk_greater>
+  // Each chunk is a sequence of the loser tree, so the chunk at the top is
+  // the one with the smallest key (like with a Priority_queue ordered by
+  // Merge_chunk_greater), and the number of the chunk in chunk_array is
+  // the number of its sequence.
+  Loser_tree<Merge_chunk *, Merge_chunk_greater,
+             Malloc_allocator<Merge_chunk *>>
       queue(mcl,
             Malloc_allocator<Merge_chunk *>(key_memory_Filesort_info_merge));
-
-  if (queue.reserve(chunk_array.size())) return 1;
+  Prealloced_array<Merge_chunk *, MERGEBUFF2> chunk_pointers(
+      key_memory_Filesort_info_merge);
 
   for (merge_chunk = chunk_array.begin(); merge_chunk != chunk_array.end();
        merge_chunk++) {
@@ -1957,8 +1971,9 @@ static int merge_buffers(THD *thd, Sort_param *param, IO_CACHE *from_file,
     if (error == -1) return error; /* purecov: inspected */
     // If less data in buffers than expected
     merge_chunk->set_max_keys(merge_chunk->mem_count());
-    (void)queue.push(merge_chunk);
+    if (chunk_pointers.push_back(merge_chunk)) return 1;
   }
+  if (queue.init(chunk_pointers.begin(), chunk_pointers.end())) return 1;
 
   bool seen_any_records = false;  // Used for deduplication only.
   while (queue.size() > 1) {
@@ -2006,14 +2021,19 @@ static int merge_buffers(THD *thd, Sort_param *param, IO_CACHE *from_file,
         // none, take it out of the queue.
         if (!(error = (int)read_to_buffer(from_file, merge_chunk, param))) {
           queue.pop();
-          reuse_freed_buff(merge_chunk, &queue);
+          // Give the buffer to a chunk that is still being merged.
+          for (size_t i = 0; i < chunk_array.size(); ++i) {
+            if (queue.contains(i) &&
+                merge_chunk->merge_freed_buff(&chunk_array[i]))
+              break;
+          }
           break; /* One buffer have been removed */
         } else if (error == -1)
           return error; /* purecov: inspected */
       }
       /*
-        The Merge_chunk at the queue's top had one of its keys consumed, thus
-        it may now rank differently in the comparison order of the queue, so:
+        The Merge_chunk at the tree's top had one of its keys consumed, thus
+        it may now rank differently in the comparison order of the tree, so:
       */
       queue.update_top();
     }
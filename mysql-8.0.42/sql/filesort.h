@@ -40,6 +40,7 @@ class JOIN;
 class RowIterator;
 class Sort_result;
 class THD;
+class TopNFilter;
 struct ORDER;
 struct TABLE;
 struct st_sort_field;
@@ -103,8 +104,8 @@ class Filesort {
 
 bool filesort(THD *thd, Filesort *filesort, RowIterator *source_iterator,
               table_map tables_to_get_rowid_for, ha_rows num_rows_estimate,
-              Filesort_info *fs_info, Sort_result *sort_result,
-              ha_rows *found_rows);
+              TopNFilter *top_n_filter, Filesort_info *fs_info,
+              Sort_result *sort_result, ha_rows *found_rows);
 void filesort_free_buffers(TABLE *table, bool full);
 void change_double_for_sort(double nr, uchar *to);
 
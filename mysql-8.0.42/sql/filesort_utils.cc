@@ -25,19 +25,31 @@
 
 #include <string.h>
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <memory>
 
 #include "add_with_saturate.h"
+#include "loser_tree.h"
 #include "my_dbug.h"
 #include "my_io.h"
 #include "my_pointer_arithmetic.h"
+#include "my_thread.h"
+#include "mysql/components/services/bits/psi_bits.h"
+#include "mysql/psi/mysql_thread.h"
+#include "prealloced_array.h"
+#include "scope_guard.h"
+#include "template_utils.h"
 #include "sql/cmp_varlen_keys.h"
+#include "sql/malloc_allocator.h"
 #include "sql/opt_costmodel.h"
 #include "sql/sort_param.h"
 #include "sql/sql_sort.h"
 #include "sql/thr_malloc.h"
 
 PSI_memory_key key_memory_Filesort_buffer_sort_keys;
+PSI_thread_key key_thread_sort_worker;
+ulong max_sort_threads;
 
 using std::max;
 using std::min;
@@ -126,8 +138,266 @@ class Equality_from_less {
   const Comp &m_comp;
 };
 
+/**
+  Sorting fewer keys than this on a thread of its own does not make up for
+  the cost of starting the thread and merging the result.
+*/
+constexpr size_t kMinKeysPerSortThread = 16384;
+
+/// The most partitions that sort_in_parallel() keeps without allocating.
+constexpr size_t kMaxSortPartitions = 64;
+
+/// A partition of the keys to sort, and the function to sort it with.
+template <class Sort_func>
+struct Sort_partition {
+  const Sort_func *sort_func;
+  uchar **first;
+  uchar **last;
+};
+
+template <class Sort_func>
+void *sort_partition_thread(void *arg) {
+  // The thread only moves pointers around, and allocates with MYF(0), so it
+  // needs no mysys thread state.
+  const auto *partition = static_cast<Sort_partition<Sort_func> *>(arg);
+  (*partition->sort_func)(partition->first, partition->last);
+  return nullptr;
+}
+
+/// The number of threads, over all sessions, that sort partitions right now.
+std::atomic<ulong> num_sort_threads_running{0};
+
+/**
+  Reserve up to "wanted" threads for sorting partitions, without going over
+  max_sort_threads for the server as a whole.
+
+  @returns the number of threads reserved, which may be zero. They are
+           given back with release_sort_threads().
+*/
+size_t reserve_sort_threads(size_t wanted) {
+  const ulong limit = max_sort_threads;
+  ulong running = num_sort_threads_running.load();
+  ulong reserved;
+  do {
+    if (running >= limit) return 0;
+    reserved = min<ulong>(wanted, limit - running);
+  } while (!num_sort_threads_running.compare_exchange_weak(
+      running, running + reserved));
+  return reserved;
+}
+
+void release_sort_threads(size_t reserved) {
+  num_sort_threads_running.fetch_sub(reserved);
+}
+
+/**
+  Sort keys on up to "max_threads" threads. The keys are split into equally
+  large partitions of at least kMinKeysPerSortThread keys, each partition is
+  sorted with "sort_func" on a thread of its own (the calling thread takes
+  the first one), and the sorted partitions are merged with a loser tree.
+  If "sort_func" is stable, so is the result.
+
+  The threads besides the calling thread count against max_sort_threads,
+  so the sort gets fewer partitions if other sorts are running. If a thread
+  cannot be started, its partition is sorted by the calling thread. If
+  there is not enough memory for the merge, all the keys are sorted by the
+  calling thread instead.
+
+  @param first pointer to the first key to sort
+  @param last pointer past the last key to sort
+  @param max_threads the maximum number of threads to sort on
+  @param sort_func sorts the keys in [first, last) given as arguments
+  @param less compares two keys
+*/
+template <class Sort_func, class Less>
+void sort_in_parallel(uchar **first, uchar **last, size_t max_threads,
+                      const Sort_func &sort_func, const Less &less) {
+  const size_t num_keys = last - first;
+  size_t num_partitions = min(max_threads, num_keys / kMinKeysPerSortThread);
+  if (num_partitions <= 1) {
+    sort_func(first, last);
+    return;
+  }
+  const size_t num_reserved = reserve_sort_threads(num_partitions - 1);
+  auto release_guard = create_scope_guard(
+      [num_reserved] { release_sort_threads(num_reserved); });
+  num_partitions = num_reserved + 1;
+
+  unique_ptr_my_free<uchar *> merged;
+  Prealloced_array<Sort_partition<Sort_func>, kMaxSortPartitions> partitions(
+      key_memory_Filesort_buffer_sort_keys);
+  Prealloced_array<my_thread_handle, kMaxSortPartitions> threads(
+      key_memory_Filesort_buffer_sort_keys);
+  Prealloced_array<uchar **, kMaxSortPartitions> firsts(
+      key_memory_Filesort_buffer_sort_keys);
+  if (num_partitions > 1) {
+    merged.reset(static_cast<uchar **>(
+        my_malloc(key_memory_Filesort_buffer_sort_keys,
+                  num_keys * sizeof(uchar *), MYF(0))));
+  }
+  if (merged == nullptr || partitions.reserve(num_partitions) ||
+      threads.reserve(num_partitions) || firsts.reserve(num_partitions)) {
+    sort_func(first, last);
+    return;
+  }
+
+  for (size_t i = 0; i < num_partitions; ++i) {
+    partitions.push_back({&sort_func, first + num_keys * i / num_partitions,
+                          first + num_keys * (i + 1) / num_partitions});
+  }
+  size_t num_started = 1;
+  for (; num_started < num_partitions; ++num_started) {
+    my_thread_handle thread;
+    if (mysql_thread_create(key_thread_sort_worker, &thread, nullptr,
+                            sort_partition_thread<Sort_func>,
+                            &partitions[num_started]) != 0) {
+      break;
+    }
+    threads.push_back(thread);
+  }
+  sort_func(partitions[0].first, partitions[0].last);
+  for (size_t i = num_started; i < num_partitions; ++i) {
+    sort_func(partitions[i].first, partitions[i].last);
+  }
+  for (my_thread_handle &thread : threads) {
+    my_thread_join(&thread, nullptr);
+  }
+
+  // The tree holds the position of the next key of each partition, and
+  // yields the smallest key first.
+  const auto greater = [&less](uchar **key1, uchar **key2) {
+    return less(*key2, *key1);
+  };
+  Loser_tree<uchar **, decltype(greater), Malloc_allocator<uchar **>> tree(
+      greater,
+      Malloc_allocator<uchar **>(key_memory_Filesort_buffer_sort_keys));
+  for (const Sort_partition<Sort_func> &partition : partitions) {
+    firsts.push_back(partition.first);
+  }
+  if (tree.init(firsts.begin(), firsts.end())) {
+    // The partitions are sorted, so this keeps the sort stable.
+    sort_func(first, last);
+    return;
+  }
+  uchar **to = merged.get();
+  while (!tree.empty()) {
+    uchar **&key = tree.top();
+    *to++ = *key;
+    if (++key == partitions[tree.top_index()].last) {
+      tree.pop();
+    } else {
+      tree.update_top();
+    }
+  }
+  std::copy(merged.get(), merged.get() + num_keys, first);
+}
+
 }  // namespace
 
+void radix_sort_keys(uchar **first, uchar **last, size_t key_len) {
+  /*
+    Buckets with fewer keys than this are sorted with std::stable_sort;
+    distributing them takes two passes over the keys, and clearing and
+    summing 256 counters, which does not pay off for a handful of keys.
+  */
+  constexpr size_t kMinKeysForRadixSort = 64;
+
+  struct Bucket {
+    uchar **first;
+    uchar **last;
+    size_t depth;  ///< The byte to distribute the keys on.
+  };
+
+  const size_t num_keys = last - first;
+  if (num_keys <= 1 || key_len == 0) return;
+
+  const auto comparison_sort = [key_len](const Bucket &bucket) {
+    const size_t depth = bucket.depth;
+    const Mem_compare compare(key_len - depth);
+    stable_sort(bucket.first, bucket.last,
+                [depth, &compare](const uchar *s1, const uchar *s2) {
+                  return compare(s1 + depth, s2 + depth);
+                });
+  };
+
+  // The keys are scattered into this buffer, and then copied back. The
+  // digits are cached after the pointers, so that each key is only read once
+  // per pass. Without memory for them, the keys are sorted by comparison.
+  unique_ptr_my_free<uchar *> buffer(static_cast<uchar **>(
+      my_malloc(key_memory_Filesort_buffer_sort_keys,
+                num_keys * (sizeof(uchar *) + 1), MYF(0))));
+  if (buffer == nullptr) {
+    comparison_sort({first, last, 0});
+    return;
+  }
+  uchar *digits = pointer_cast<uchar *>(buffer.get() + num_keys);
+
+  // Buckets that are left to sort. Sorting them one at a time, instead of
+  // recursing, keeps the stack depth bounded for long keys.
+  Prealloced_array<Bucket, 256> buckets(key_memory_Filesort_buffer_sort_keys);
+  buckets.push_back({first, last, 0});
+  while (!buckets.empty()) {
+    const Bucket bucket = buckets.back();
+    buckets.pop_back();
+    const size_t count = bucket.last - bucket.first;
+
+    if (count < kMinKeysForRadixSort) {
+      comparison_sort(bucket);
+      continue;
+    }
+
+    size_t sizes[256];
+    size_t depth = bucket.depth;
+    for (;;) {
+      std::fill(std::begin(sizes), std::end(sizes), 0);
+      for (size_t i = 0; i < count; ++i) {
+        const uchar digit = bucket.first[i][depth];
+        digits[i] = digit;
+        ++sizes[digit];
+      }
+      // If all keys have the same digit, there is nothing to move.
+      if (sizes[digits[0]] != count) break;
+      if (++depth == key_len) break;
+    }
+    if (depth == key_len) continue;  // All keys are equal.
+
+    size_t offsets[256];
+    size_t offset = 0;
+    for (size_t digit = 0; digit < 256; ++digit) {
+      offsets[digit] = offset;
+      offset += sizes[digit];
+    }
+    // Scattering in input order keeps the sort stable.
+    for (size_t i = 0; i < count; ++i) {
+      buffer.get()[offsets[digits[i]]++] = bucket.first[i];
+    }
+    std::copy(buffer.get(), buffer.get() + count, bucket.first);
+
+    if (depth + 1 == key_len) continue;
+    uchar **bucket_first = bucket.first;
+    for (size_t digit = 0; digit < 256; ++digit) {
+      if (sizes[digit] > 1) {
+        const Bucket next = {bucket_first, bucket_first + sizes[digit],
+                             depth + 1};
+        if (buckets.push_back(next)) comparison_sort(next);
+      }
+      bucket_first += sizes[digit];
+    }
+  }
+}
+
+void radix_sort_keys_in_parallel(uchar **first, uchar **last, size_t key_len,
+                                 size_t max_threads) {
+  sort_in_parallel(
+      first, last, max_threads,
+      [key_len](uchar **partition_first, uchar **partition_last) {
+        radix_sort_keys(partition_first, partition_last, key_len);
+      },
+      [key_len](const uchar *s1, const uchar *s2) {
+        return memcmp(s1, s2, key_len) < 0;
+      });
+}
+
 size_t Filesort_buffer::sort_buffer(Sort_param *param, size_t num_input_rows,
                                     size_t max_output_rows) {
   param->m_sort_algorithm = Sort_param::FILESORT_ALG_NONE;
@@ -156,7 +426,11 @@ size_t Filesort_buffer::sort_buffer(Sort_param *param, size_t num_input_rows,
     // TODO: Make more elaborate heuristics than just always picking
     // std::sort.
     param->m_sort_algorithm = Sort_param::FILESORT_ALG_STD_SORT;
-    sort(it_begin, it_end, comp);
+    uchar **keys = m_record_pointers.data();
+    sort_in_parallel(
+        keys, keys + (it_end - it_begin), param->m_max_sort_threads,
+        [&comp](uchar **first, uchar **last) { sort(first, last, comp); },
+        comp);
     if (param->m_remove_duplicates) {
       num_input_rows =
           unique(it_begin, it_end,
@@ -214,29 +488,33 @@ size_t Filesort_buffer::sort_buffer(Sort_param *param, size_t num_input_rows,
     return std::min(num_input_rows, max_output_rows);
   }
 
-  param->m_sort_algorithm = Sort_param::FILESORT_ALG_STD_STABLE;
-  // Heuristics here: avoid function overhead call for short keys.
-  if (key_len < 10) {
-    if (prefilter_nth_element) {
+  /*
+    The keys are memcmp-comparable, so sort them byte by byte instead of
+    comparing them with each other. This also saves the temp buffer of
+    std::stable_sort. Heuristics here: avoid function overhead call for short
+    keys in nth_element() and unique().
+  */
+  param->m_sort_algorithm = Sort_param::FILESORT_ALG_RADIX;
+  if (prefilter_nth_element) {
+    if (key_len < 10) {
       nth_element(it_begin, it_begin + max_output_rows - 1, it_end,
                   Mem_compare(key_len));
-      it_end = it_begin + max_output_rows;
+    } else {
+      nth_element(it_begin, it_begin + max_output_rows - 1, it_end,
+                  Mem_compare_longkey(key_len));
     }
-    stable_sort(it_begin, it_end, Mem_compare(key_len));
-    if (param->m_remove_duplicates) {
+    it_end = it_begin + max_output_rows;
+  }
+  uchar **keys = m_record_pointers.data();
+  radix_sort_keys_in_parallel(keys, keys + (it_end - it_begin), key_len,
+                              param->m_max_sort_threads);
+  if (param->m_remove_duplicates) {
+    if (key_len < 10) {
       num_input_rows =
           unique(it_begin, it_end,
                  Equality_from_less<Mem_compare>(Mem_compare(key_len))) -
           it_begin;
-    }
-  } else {
-    if (prefilter_nth_element) {
-      nth_element(it_begin, it_begin + max_output_rows - 1, it_end,
-                  Mem_compare_longkey(key_len));
-      it_end = it_begin + max_output_rows;
-    }
-    stable_sort(it_begin, it_end, Mem_compare_longkey(key_len));
-    if (param->m_remove_duplicates) {
+    } else {
       num_input_rows = unique(it_begin, it_end,
                               Equality_from_less<Mem_compare_longkey>(
                                   Mem_compare_longkey(key_len))) -
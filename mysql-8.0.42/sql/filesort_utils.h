@@ -35,12 +35,48 @@
 #include "my_base.h"  // ha_rows
 
 #include "my_inttypes.h"
+#include "mysql/components/services/bits/psi_thread_bits.h"
 #include "mysql/service_mysql_alloc.h"  // my_free
 #include "sql/sql_array.h"              // Bounds_checked_array
 
 class Cost_model_table;
 class Sort_param;
 
+/// Performance schema key of the threads that sort partitions of filesorts.
+extern PSI_thread_key key_thread_sort_worker;
+
+/**
+  The largest number of threads that may sort partitions of filesorts at the
+  same time, over all sessions and not counting the session threads
+  (the max_sort_threads system variable).
+*/
+extern ulong max_sort_threads;
+
+/**
+  Sort fixed-length, memcmp-comparable keys with a most-significant-digit
+  radix sort. The sort is stable: keys that compare equal keep their order.
+
+  The keys are distributed into 256 buckets on their first byte, and each
+  bucket is then sorted on the next byte, and so on, until a bucket holds
+  so few keys that a comparison sort is cheaper. Bytes that are the same
+  for all keys in a bucket (like the null indicator of a column without
+  NULLs, or the high bytes of small integers) are skipped over without
+  moving any keys.
+
+  @param first pointer to the first key to sort
+  @param last pointer past the last key to sort
+  @param key_len the number of bytes to compare in each key
+*/
+void radix_sort_keys(uchar **first, uchar **last, size_t key_len);
+
+/**
+  Like radix_sort_keys(), but splits large sorts into partitions that are
+  sorted on up to "max_threads" threads, and then merged. The threads besides
+  the calling one are limited by max_sort_threads.
+*/
+void radix_sort_keys_in_parallel(uchar **first, uchar **last, size_t key_len,
+                                 size_t max_threads);
+
 /**
   Buffer used for storing records to be sorted. The records are stored in
   a series of buffers that are allocated incrementally, growing 50% each
@@ -7995,6 +7995,8 @@ int handler::ha_reset() {
   cancel_pushed_idx_cond();
   // Forget the record buffer.
   m_record_buffer = nullptr;
+  // Forget the runtime filter.
+  ha_set_runtime_filter(nullptr);
   m_unique = nullptr;
 
   const int retval = reset();
@@ -82,6 +82,7 @@ class Partition_handler;
 class Plugin_table;
 class Plugin_tablespace;
 class Record_buffer;
+class RuntimeFilter;
 class SE_cost_constants;  // see opt_costconstants.h
 class String;
 class THD;
@@ -3912,6 +3913,15 @@ class ha_statistics {
   */
   double table_in_mem_estimate;
 
+  /**
+    Number of rows inserted, updated or deleted since the storage engine
+    started tracking the table. The counter only grows while the table
+    stays cached in the engine, so callers should compare it against a
+    value they read earlier rather than interpret it on its own. Engines
+    that do not track modifications leave it at 0.
+  */
+  ulonglong rows_modified;
+
   ha_statistics()
       : data_file_length(0),
         max_data_file_length(0),
@@ -3925,7 +3935,8 @@ class ha_statistics {
         check_time(0),
         update_time(0),
         block_size(0),
-        table_in_mem_estimate(IN_MEMORY_ESTIMATE_UNKNOWN) {}
+        table_in_mem_estimate(IN_MEMORY_ESTIMATE_UNKNOWN),
+        rows_modified(0) {}
 };
 
 /**
@@ -4453,6 +4464,10 @@ class handler {
 
  private:
   Record_buffer *m_record_buffer = nullptr;  ///< Buffer for multi-row reads.
+  /// Filter for the rows read by scans. See ha_set_runtime_filter().
+  RuntimeFilter *m_runtime_filter = nullptr;
+  /// Whether the storage engine checks m_runtime_filter itself.
+  bool m_runtime_filter_checked_by_engine = false;
   /*
     Storage space for the end range value. Should only be accessed using
     the end_range pointer. The content is invalid when end_range is NULL.
@@ -4725,6 +4740,41 @@ class handler {
     return is_record_buffer_wanted(max_rows);
   }
 
+  /**
+    Set a filter that rows read by table scans and index scans can be checked
+    against, so that rows that are known to be uninteresting are thrown away
+    as early as possible. The filter is only a hint; it is fine to return rows
+    that do not pass it. The filter is checked by the storage engine if it
+    supports it, and otherwise by the iterators doing the scans (see
+    ha_get_runtime_filter_to_check()). The filter is removed by
+    ha_set_runtime_filter(nullptr) and by ha_reset(). Use RuntimeFilter::Push()
+    and RuntimeFilter::Remove() to add and remove one of several filters.
+
+    @param filter the filter to use, or nullptr to remove the current filter
+  */
+  void ha_set_runtime_filter(RuntimeFilter *filter) {
+    m_runtime_filter = filter;
+    m_runtime_filter_checked_by_engine = runtime_filter_push(filter);
+  }
+
+  /**
+    Get the filter set with ha_set_runtime_filter().
+
+    @return the filter, or nullptr if there is none
+  */
+  RuntimeFilter *ha_get_runtime_filter() const { return m_runtime_filter; }
+
+  /**
+    Get the filter that the caller must check the rows returned from scans
+    against, since the storage engine does not.
+
+    @return the filter, or nullptr if there is none (or the storage engine
+            checks it)
+  */
+  RuntimeFilter *ha_get_runtime_filter_to_check() const {
+    return m_runtime_filter_checked_by_engine ? nullptr : m_runtime_filter;
+  }
+
   int ha_open(TABLE *table, const char *name, int mode, int test_if_locked,
               const dd::Table *table_def);
   int ha_close(void);
@@ -4895,6 +4945,15 @@ class handler {
   */
   virtual void parallel_scan_end(void *scan_ctx [[maybe_unused]]) { return; }
 
+  /**
+    Get the number of threads a parallel scan of this table would ask for,
+    without reserving any of them. The optimizer uses this to cost plans that
+    scan the table in parallel; parallel_scan_init() may still get fewer
+    threads, or none at all.
+    @return the number of threads, or 0 if parallel scans are not supported.
+  */
+  virtual size_t max_parallel_scan_threads() const { return 0; }
+
   /**
     Submit a dd::Table object representing a core DD table having
     hardcoded data to be filled in by the DDSE. This function can be
@@ -6583,6 +6642,24 @@ class handler {
     return false;
   }
 
+  /**
+    Notify the storage engine that a runtime filter has been set or removed
+    with ha_set_runtime_filter(). The filter can be fetched with
+    ha_get_runtime_filter().
+
+    Storage engines that can check the filter for the rows they read, before
+    they are returned from rnd_next() and the index scan functions, should
+    override this function.
+
+    @param filter the new filter, or nullptr if the filter was removed
+
+    @retval true   if the storage engine will check the filter
+    @retval false  if the caller has to check the filter
+  */
+  virtual bool runtime_filter_push(RuntimeFilter *filter [[maybe_unused]]) {
+    return false;
+  }
+
   // Set se_private_id and se_private_data during upgrade
   virtual bool upgrade_table(THD *thd [[maybe_unused]],
                              const char *dbname [[maybe_unused]],
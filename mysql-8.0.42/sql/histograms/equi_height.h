@@ -211,7 +211,7 @@ class Equi_height : public Histogram {
   bool histogram_to_json(Json_object *json_object) const override;
 
   /**
-    Get the buckets of the histogram. Exposed for unit testing.
+    Get the buckets of the histogram.
 
     @return A const reference to the collection of buckets.
   */
@@ -1239,11 +1239,16 @@ bool update_histogram(THD *thd, Table_ref *table, const columns_set &columns,
                       int num_buckets, LEX_STRING data, results_map &results) {
   dd::cache::Dictionary_client::Auto_releaser auto_releaser(thd->dd_client());
 
-  // Read only should have been stopped at an earlier stage.
-  assert(!check_readonly(thd, false));
   assert(!thd->tx_read_only);
-
   assert(results.empty());
+
+  // Read only is normally stopped at an earlier stage, but the server may
+  // have been made read only since then.
+  if (check_readonly(thd, false)) {
+    results.emplace("", Message::SERVER_READ_ONLY);
+    return true;
+  }
+
   assert(!columns.empty());
 
   // Only one table should be specified in ANALYZE TABLE .. UPDATE HISTOGRAM
@@ -2044,6 +2049,187 @@ bool Histogram::get_selectivity(Item **items, size_t item_count,
   return false;
 }
 
+/**
+  A bucket of an equi-height histogram, or a value of a singleton histogram,
+  as merged by get_equi_join_selectivity().
+*/
+template <class T>
+struct Join_bucket {
+  const T *lower_inclusive;
+  const T *upper_inclusive;
+
+  /// The fraction of the rows that have a value in the bucket.
+  double frequency;
+
+  double num_distinct;
+
+  /// The equi-height bucket, or nullptr for a singleton value.
+  const equi_height::Bucket<T> *bucket;
+};
+
+template <class T>
+static std::vector<Join_bucket<T>> get_join_buckets(
+    const Histogram &histogram) {
+  std::vector<Join_bucket<T>> join_buckets;
+  double previous_cumulative_frequency = 0.0;
+  switch (histogram.get_histogram_type()) {
+    case Histogram::enum_histogram_type::SINGLETON: {
+      const auto &buckets =
+          down_cast<const Singleton<T> &>(histogram).get_buckets();
+      join_buckets.reserve(buckets.size());
+      for (const SingletonBucket<T> &bucket : buckets) {
+        join_buckets.push_back(
+            {&bucket.value, &bucket.value,
+             bucket.cumulative_frequency - previous_cumulative_frequency, 1.0,
+             nullptr});
+        previous_cumulative_frequency = bucket.cumulative_frequency;
+      }
+      break;
+    }
+    case Histogram::enum_histogram_type::EQUI_HEIGHT: {
+      const auto &buckets =
+          down_cast<const Equi_height<T> &>(histogram).get_buckets();
+      join_buckets.reserve(buckets.size());
+      for (const equi_height::Bucket<T> &bucket : buckets) {
+        join_buckets.push_back(
+            {&bucket.get_lower_inclusive(), &bucket.get_upper_inclusive(),
+             bucket.get_cumulative_frequency() - previous_cumulative_frequency,
+             std::max<double>(1.0, bucket.get_num_distinct()), &bucket});
+        previous_cumulative_frequency = bucket.get_cumulative_frequency();
+      }
+      break;
+    }
+  }
+  return join_buckets;
+}
+
+/**
+  Find the fraction of the values of a bucket that lie in the interval
+  [lower, upper], which must be inside the bucket.
+*/
+template <class T>
+static double get_fraction_in_interval(const Join_bucket<T> &join_bucket,
+                                       const T &lower, const T &upper) {
+  if (join_bucket.bucket == nullptr) return 1.0;
+
+  const Histogram_comparator less;
+  if (!less(lower, upper)) {
+    // A single value, see Equi_height<T>::get_equal_to_selectivity().
+    return 1.0 / join_bucket.num_distinct;
+  }
+
+  double fraction = 1.0;
+  if (less(*join_bucket.lower_inclusive, lower)) {
+    fraction -= join_bucket.bucket->get_distance_from_lower(lower);
+  }
+  if (less(upper, *join_bucket.upper_inclusive)) {
+    fraction -= join_bucket.bucket->get_distance_from_upper(upper);
+  }
+  return std::clamp(fraction, 0.0, 1.0);
+}
+
+template <class T>
+static double get_equi_join_selectivity(const Histogram &left,
+                                        const Histogram &right) {
+  const std::vector<Join_bucket<T>> left_buckets = get_join_buckets<T>(left);
+  const std::vector<Join_bucket<T>> right_buckets =
+      get_join_buckets<T>(right);
+  const Histogram_comparator less;
+
+  double selectivity = 0.0;
+  auto l = left_buckets.begin();
+  auto r = right_buckets.begin();
+  while (l != left_buckets.end() && r != right_buckets.end()) {
+    if (less(*l->upper_inclusive, *r->lower_inclusive)) {
+      ++l;
+      continue;
+    }
+    if (less(*r->upper_inclusive, *l->lower_inclusive)) {
+      ++r;
+      continue;
+    }
+
+    // The interval where the two buckets overlap.
+    const T &lower = less(*l->lower_inclusive, *r->lower_inclusive)
+                         ? *r->lower_inclusive
+                         : *l->lower_inclusive;
+    const T &upper = less(*l->upper_inclusive, *r->upper_inclusive)
+                         ? *l->upper_inclusive
+                         : *r->upper_inclusive;
+    const double left_fraction = get_fraction_in_interval(*l, lower, upper);
+    const double right_fraction = get_fraction_in_interval(*r, lower, upper);
+    selectivity +=
+        l->frequency * left_fraction * r->frequency * right_fraction /
+        std::max({l->num_distinct * left_fraction,
+                  r->num_distinct * right_fraction, 1.0});
+
+    // Move on from the bucket that ends first, or from both.
+    const bool left_ends_first =
+        !less(*r->upper_inclusive, *l->upper_inclusive);
+    const bool right_ends_first =
+        !less(*l->upper_inclusive, *r->upper_inclusive);
+    if (left_ends_first) ++l;
+    if (right_ends_first) ++r;
+  }
+  return selectivity;
+}
+
+bool Histogram::get_equi_join_selectivity(const Histogram &other,
+                                          double *selectivity) const {
+  if (get_data_type() != other.get_data_type()) return true;
+
+  switch (get_data_type()) {
+    case Value_map_type::INVALID:
+    case Value_map_type::ENUM:
+    case Value_map_type::SET:
+      // ENUM and SET values are stored as indexes into the list of elements
+      // of the column, which need not be the same for two columns.
+      return true;
+    case Value_map_type::STRING:
+      if (get_character_set()->number != other.get_character_set()->number)
+        return true;
+      *selectivity =
+          histograms::get_equi_join_selectivity<String>(*this, other);
+      break;
+    case Value_map_type::INT:
+      *selectivity =
+          histograms::get_equi_join_selectivity<longlong>(*this, other);
+      break;
+    case Value_map_type::UINT:
+      *selectivity =
+          histograms::get_equi_join_selectivity<ulonglong>(*this, other);
+      break;
+    case Value_map_type::DOUBLE:
+      *selectivity =
+          histograms::get_equi_join_selectivity<double>(*this, other);
+      break;
+    case Value_map_type::DECIMAL:
+      *selectivity =
+          histograms::get_equi_join_selectivity<my_decimal>(*this, other);
+      break;
+    case Value_map_type::DATE:
+    case Value_map_type::TIME:
+    case Value_map_type::DATETIME:
+      *selectivity =
+          histograms::get_equi_join_selectivity<MYSQL_TIME>(*this, other);
+      break;
+  }
+
+  /*
+    For the same reasons as in get_selectivity(), values or ranges of values
+    that were missed by the sampling must not make the estimate drop to zero.
+    Do not go below a hundredth of the estimate we would get if all the values
+    of the column with the fewer distinct values were found in the other
+    column, evenly spread.
+  */
+  const double uniform_selectivity =
+      get_non_null_values_fraction() * other.get_non_null_values_fraction() /
+      std::max<double>({1.0, static_cast<double>(get_num_distinct_values()),
+                        static_cast<double>(other.get_num_distinct_values())});
+  *selectivity = std::clamp(*selectivity, uniform_selectivity / 100.0, 1.0);
+  return false;
+}
+
 bool Histogram::get_raw_selectivity(Item **items, size_t item_count,
                                     enum_operator op,
                                     double *selectivity) const {
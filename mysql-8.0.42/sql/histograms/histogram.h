@@ -660,6 +660,30 @@ class Histogram {
   bool get_selectivity(Item **items, size_t item_count, enum_operator op,
                        double *selectivity) const;
 
+  /**
+    Get the selectivity of an equijoin between the column of this histogram
+    and the column of another histogram, i.e. the fraction of the rows in the
+    cross product of the two tables that satisfies "column = other column".
+
+    Unlike an estimate based on the number of distinct values alone, this
+    takes into account how the values of the two columns overlap, and how
+    frequent each value is on both sides. The buckets of the two histograms
+    are merged, and within each overlapping piece of two buckets, the values
+    are assumed to be spread evenly, and each value on the side with the fewer
+    distinct values is assumed to be found on the other side.
+
+    @param other            the histogram of the column on the other side
+    @param[out] selectivity the estimated selectivity, between 0.0 and 1.0
+                            inclusive
+
+    @retval true if the histograms cannot be combined (they hold different
+    types of data, ENUM or SET values, or strings in different character
+    sets)
+    @return false if success
+  */
+  bool get_equi_join_selectivity(const Histogram &other,
+                                 double *selectivity) const;
+
   /**
     @return the fraction of non-null values in the histogram.
   */
@@ -0,0 +1,432 @@
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include "sql/histograms/histogram_maintenance.h"
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "my_dbug.h"
+#include "my_inttypes.h"
+#include "my_sys.h"
+#include "my_systime.h"  // set_timespec_nsec
+#include "my_thread.h"
+#include "mysql/components/services/log_builtins.h"  // LogErr
+#include "mysql/psi/mysql_cond.h"
+#include "mysql/psi/mysql_mutex.h"
+#include "mysql/psi/mysql_thread.h"
+#include "mysqld_error.h"
+#include "sql/auth/auth_common.h"  // check_readonly
+#include "sql/current_thd.h"
+#include "sql/handler.h"
+#include "sql/histograms/histogram.h"
+#include "sql/mysqld.h"  // read_only, super_read_only
+#include "sql/mysqld_thd_manager.h"  // Global_THD_manager
+#include "sql/replication.h"  // THD_ENTER_COND
+#include "sql/sql_backup_lock.h"
+#include "sql/sql_base.h"  // open_and_lock_tables, tdc_remove_table
+#include "sql/sql_class.h"
+#include "sql/sql_lex.h"
+#include "sql/sql_parse.h"  // mysql_reset_thd_for_next_command
+#include "sql/sql_planner.h"  // Join_order_cache
+#include "sql/table.h"
+#include "sql/transaction.h"  // trans_rollback_stmt
+
+ulong histogram_auto_update_threshold = 0;
+ulong histogram_auto_update_interval = 60;
+
+namespace histograms {
+
+namespace {
+
+/// Baseline of a table whose modification counter has not been read yet.
+constexpr ulonglong BASELINE_UNKNOWN = std::numeric_limits<ulonglong>::max();
+
+using Table_key = std::pair<std::string, std::string>;
+
+/**
+  Registered tables, mapped to the value of their modification counter when
+  the histograms were last refreshed (or when the table was first checked).
+  Protected by LOCK_auto_update.
+*/
+std::map<Table_key, ulonglong> registry;
+
+mysql_mutex_t LOCK_auto_update;
+mysql_cond_t COND_auto_update;
+
+/// Set once LOCK_auto_update and COND_auto_update have been initialized.
+std::atomic<bool> registry_initialized{false};
+
+/// Protected by LOCK_auto_update.
+bool terminate_thread = false;
+
+my_thread_handle auto_update_thread_id;
+
+/**
+  Sleep for the given duration, or until the thread is asked to stop or is
+  killed.
+
+  @param thd      background thread handle
+  @param duration how long to sleep
+
+  @retval true  the thread should stop
+  @retval false the full duration has passed
+*/
+bool wait_or_terminate(THD *thd, std::chrono::nanoseconds duration) {
+  struct timespec abstime;
+  set_timespec_nsec(&abstime, duration.count());
+
+  mysql_mutex_lock(&LOCK_auto_update);
+  THD_ENTER_COND(thd, &COND_auto_update, &LOCK_auto_update, &stage_suspending,
+                 nullptr);
+  while (!terminate_thread && !thd->killed) {
+    if (is_timeout(mysql_cond_timedwait(&COND_auto_update, &LOCK_auto_update,
+                                        &abstime)))
+      break;
+  }
+  const bool stop = terminate_thread || thd->killed;
+  mysql_mutex_unlock(&LOCK_auto_update);
+  THD_EXIT_COND(thd, nullptr);
+  return stop;
+}
+
+/**
+  Start a new "statement" in the background thread.
+
+  @param thd background thread handle
+*/
+void reset_statement(THD *thd) {
+  lex_start(thd);
+  mysql_reset_thd_for_next_command(thd);
+}
+
+/**
+  End the current "statement" in the background thread, releasing any open
+  tables and metadata locks.
+
+  @param thd background thread handle
+*/
+void end_statement(THD *thd) {
+  trans_rollback_stmt(thd);
+  trans_rollback(thd);
+  close_thread_tables(thd);
+  thd->mdl_context.release_transactional_locks();
+  thd->clear_error();
+  lex_end(thd->lex);
+}
+
+/**
+  Take the global intention exclusive lock until the end of the statement,
+  as statements that write do. Making the server read only takes the global
+  read lock, so it waits until the lock is released.
+
+  @param thd background thread handle
+
+  @retval true  the lock could not be taken
+  @retval false otherwise
+*/
+bool acquire_global_intention_exclusive_lock(THD *thd) {
+  MDL_request mdl_request;
+  MDL_REQUEST_INIT(&mdl_request, MDL_key::GLOBAL, "", "",
+                   MDL_INTENTION_EXCLUSIVE, MDL_TRANSACTION);
+  return thd->mdl_context.acquire_lock(&mdl_request,
+                                       thd->variables.lock_wait_timeout);
+}
+
+/**
+  Check one registered table, and rebuild its histograms if enough rows have
+  been modified since the baseline was taken.
+
+  @param thd           background thread handle
+  @param key           schema and table name
+  @param[in,out] baseline modification counter at the previous refresh;
+                       updated when the table was refreshed or when the
+                       counter was found to have been reset
+
+  @retval true  the table no longer exists and should be unregistered
+  @retval false otherwise
+*/
+bool check_table(THD *thd, const Table_key &key, ulonglong *baseline) {
+  const char *db = key.first.c_str();
+  const char *name = key.second.c_str();
+
+  reset_statement(thd);
+  Table_ref table_ref(db, key.first.length(), name, key.second.length(), name,
+                      TL_READ);
+  if (open_and_lock_tables(thd, &table_ref, 0)) {
+    const uint error = thd->get_stmt_da()->mysql_errno();
+    end_statement(thd);
+    return error == ER_NO_SUCH_TABLE || error == ER_BAD_DB_ERROR;
+  }
+
+  if (table_ref.is_view() || table_ref.table == nullptr) {
+    end_statement(thd);
+    return true;
+  }
+
+  TABLE *table = table_ref.table;
+  if (table->file->info(HA_STATUS_VARIABLE | HA_STATUS_NO_LOCK) != 0) {
+    end_statement(thd);
+    return false;
+  }
+  const ulonglong modified = table->file->stats.rows_modified;
+  const ha_rows records = table->file->stats.records;
+
+  // Columns with histograms, grouped by the bucket count they were built with.
+  std::map<size_t, std::vector<std::string>> columns_by_buckets;
+  for (uint i = 0; i < table->s->fields; ++i) {
+    const Histogram *histogram = table->s->find_histogram(i);
+    if (histogram == nullptr) continue;
+    columns_by_buckets[histogram->get_num_buckets_specified()].emplace_back(
+        table->field[i]->field_name);
+  }
+  end_statement(thd);
+
+  if (columns_by_buckets.empty()) return true;
+
+  // The counter starts over when InnoDB evicts and reloads the table.
+  if (*baseline == BASELINE_UNKNOWN || modified < *baseline) {
+    *baseline = modified;
+    return false;
+  }
+
+  const double limit = static_cast<double>(records) *
+                       histogram_auto_update_threshold / 100.0;
+  if (static_cast<double>(modified - *baseline) <= limit) return false;
+
+  DBUG_PRINT("histogram", ("refreshing histograms of %s.%s", db, name));
+  bool refreshed = false;
+  for (const auto &[num_buckets, column_names] : columns_by_buckets) {
+    columns_set columns;
+    for (const std::string &column : column_names) columns.emplace(column);
+
+    reset_statement(thd);
+    Table_ref update_ref(db, key.first.length(), name, key.second.length(),
+                         name, TL_READ);
+    results_map results;
+    if (acquire_shared_backup_lock(thd, thd->variables.lock_wait_timeout) ||
+        acquire_global_intention_exclusive_lock(thd)) {
+      DBUG_PRINT("histogram", ("failed to refresh histograms of %s.%s", db,
+                               name));
+    } else if (read_only || super_read_only || check_readonly(thd, false) ||
+               DBUG_EVALUATE_IF("histogram_auto_update_read_only", true,
+                                false)) {
+      /*
+        The server was made read only after check_registered_tables()
+        looked, so skip the table until the next check. Otherwise, the
+        global lock keeps the server writable until update_histogram() is
+        done.
+      */
+      DBUG_PRINT("histogram", ("read only, not refreshing %s.%s", db, name));
+      end_statement(thd);
+      break;
+    } else if (update_histogram(thd, &update_ref, columns,
+                                static_cast<int>(num_buckets), {nullptr, 0},
+                                results)) {
+      DBUG_PRINT("histogram", ("failed to refresh histograms of %s.%s", db,
+                               name));
+    } else {
+      refreshed = true;
+    }
+    end_statement(thd);
+  }
+
+  /*
+    Keep the baseline if nothing was rebuilt (e.g. a metadata lock timed
+    out), so that the table is tried again at the next check.
+  */
+  if (!refreshed) return false;
+
+  /*
+    The histograms are cached in the TABLE_SHARE, so request the old share to
+    go away, and let cached join orders be searched for again, like
+    ANALYZE TABLE ... UPDATE HISTOGRAM does.
+  */
+  tdc_remove_table(thd, TDC_RT_REMOVE_UNUSED, db, name, false);
+  Join_order_cache::invalidate_all();
+  *baseline = modified;
+  return false;
+}
+
+/**
+  Check every registered table once.
+
+  @param thd background thread handle
+
+  @retval true  the thread should stop
+  @retval false otherwise
+*/
+bool check_registered_tables(THD *thd) {
+  std::vector<Table_key> tables;
+  mysql_mutex_lock(&LOCK_auto_update);
+  tables.reserve(registry.size());
+  for (const auto &entry : registry) tables.push_back(entry.first);
+  mysql_mutex_unlock(&LOCK_auto_update);
+
+  for (const Table_key &key : tables) {
+    if (histogram_auto_update_threshold == 0 || read_only || super_read_only)
+      return false;
+
+    mysql_mutex_lock(&LOCK_auto_update);
+    const bool stop = terminate_thread;
+    auto it = registry.find(key);
+    ulonglong baseline = it == registry.end() ? BASELINE_UNKNOWN : it->second;
+    mysql_mutex_unlock(&LOCK_auto_update);
+    if (stop) return true;
+
+    const auto start = std::chrono::steady_clock::now();
+    const bool forget = check_table(thd, key, &baseline);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    mysql_mutex_lock(&LOCK_auto_update);
+    if (forget)
+      registry.erase(key);
+    else
+      registry[key] = baseline;
+    mysql_mutex_unlock(&LOCK_auto_update);
+
+    /*
+      Throttle: after a table has been checked, stay idle for as long as the
+      check took, so that the thread uses at most half of one CPU and of the
+      I/O it needs for sampling.
+    */
+    if (wait_or_terminate(thd, elapsed)) return true;
+  }
+  return false;
+}
+
+extern "C" {
+static void *auto_update_thread(void *p_thd) {
+  THD *thd = static_cast<THD *>(p_thd);
+  mysql_thread_set_psi_id(thd->thread_id());
+  my_thread_init();
+  {
+    DBUG_TRACE;
+    thd->thread_stack = reinterpret_cast<char *>(&thd);
+    thd->set_command(COM_DAEMON);
+    thd->security_context()->skip_grants();
+    thd->system_thread = SYSTEM_THREAD_BACKGROUND;
+    thd->store_globals();
+    thd->set_time();
+    // Show the thread in the process list, and let shutdown kill it.
+    Global_THD_manager::get_instance()->add_thd(thd);
+
+    // Refreshed statistics are local to this server, like ANALYZE TABLE.
+    thd->variables.option_bits &= ~OPTION_BIN_LOG;
+    // Never keep user DDL waiting behind a background refresh for long.
+    thd->variables.lock_wait_timeout = 1;
+
+    for (;;) {
+      const std::chrono::seconds interval{histogram_auto_update_interval};
+      if (wait_or_terminate(thd, interval)) break;
+      if (histogram_auto_update_threshold == 0 || read_only ||
+          super_read_only)
+        continue;
+      if (check_registered_tables(thd)) break;
+    }
+
+    thd->release_resources();
+    Global_THD_manager::get_instance()->remove_thd(thd);
+    thd->restore_globals();
+    delete thd;
+    current_thd = nullptr;
+  }
+  my_thread_end();
+  my_thread_exit(nullptr);
+  return nullptr;
+}
+}  // extern "C"
+
+}  // namespace
+
+void register_table_for_auto_update(const char *db_name,
+                                    const char *table_name) {
+  if (!registry_initialized.load(std::memory_order_acquire)) return;
+
+  mysql_mutex_lock(&LOCK_auto_update);
+  registry.emplace(Table_key(db_name, table_name), BASELINE_UNKNOWN);
+  mysql_mutex_unlock(&LOCK_auto_update);
+}
+
+void create_auto_update_thread() {
+  mysql_mutex_init(key_LOCK_histogram_auto_update, &LOCK_auto_update,
+                   MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_COND_histogram_auto_update, &COND_auto_update);
+  terminate_thread = false;
+  registry_initialized.store(true, std::memory_order_release);
+
+  THD *thd = new THD;
+  thd->set_new_thread_id();
+  THD_CHECK_SENTRY(thd);
+
+  my_thread_attr_t attr;
+  if (my_thread_attr_init(&attr)) {
+    delete thd;
+    return;
+  }
+
+  int error = 0;
+#ifndef _WIN32
+  error = pthread_attr_setscope(&attr, PTHREAD_SCOPE_SYSTEM);
+#endif
+  if (error == 0)
+    error = mysql_thread_create(key_thread_histogram_auto_update,
+                                &auto_update_thread_id, &attr,
+                                auto_update_thread, thd);
+  if (error != 0) {
+    LogErr(WARNING_LEVEL, ER_LOG_PRINTF_MSG,
+           "Could not create the histogram auto update thread");
+    delete thd;
+  }
+
+  (void)my_thread_attr_destroy(&attr);
+}
+
+void terminate_auto_update_thread() {
+  DBUG_TRACE;
+  if (!registry_initialized.load(std::memory_order_acquire)) return;
+
+  mysql_mutex_lock(&LOCK_auto_update);
+  terminate_thread = true;
+  mysql_cond_signal(&COND_auto_update);
+  mysql_mutex_unlock(&LOCK_auto_update);
+
+  if (auto_update_thread_id.thread != 0) {
+    my_thread_join(&auto_update_thread_id, nullptr);
+    auto_update_thread_id.thread = 0;
+  }
+}
+
+void auto_update_cleanup() {
+  if (!registry_initialized.exchange(false)) return;
+  registry.clear();
+  mysql_cond_destroy(&COND_auto_update);
+  mysql_mutex_destroy(&LOCK_auto_update);
+}
+
+}  // namespace histograms
@@ -0,0 +1,72 @@
+#ifndef HISTOGRAMS_HISTOGRAM_MAINTENANCE_INCLUDED
+#define HISTOGRAMS_HISTOGRAM_MAINTENANCE_INCLUDED
+
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/**
+  @file sql/histograms/histogram_maintenance.h
+  Background refresh of histogram statistics.
+
+  Tables that have histograms are registered when their TABLE_SHARE is
+  loaded. A background thread periodically asks the storage engine how many
+  rows have been modified in each registered table (ha_statistics::
+  rows_modified), and rebuilds the histograms of a table once the number of
+  modifications since the previous refresh exceeds
+  histogram_auto_update_threshold percent of the table's rows. The rebuild
+  uses the same sampling code path as ANALYZE TABLE ... UPDATE HISTOGRAM.
+*/
+
+/**
+  Percentage of a table's rows that must have been modified before its
+  histograms are rebuilt in the background. 0 disables the refresh.
+*/
+extern unsigned long histogram_auto_update_threshold;
+
+/** Number of seconds between two checks of the registered tables. */
+extern unsigned long histogram_auto_update_interval;
+
+namespace histograms {
+
+/**
+  Make a table a candidate for background histogram refresh. Registering a
+  table that is already known has no effect.
+
+  @param db_name    schema name
+  @param table_name table name
+*/
+void register_table_for_auto_update(const char *db_name,
+                                    const char *table_name);
+
+/** Start the background histogram refresh thread. */
+void create_auto_update_thread();
+
+/** Stop the background histogram refresh thread and wait for it to exit. */
+void terminate_auto_update_thread();
+
+/** Release the resources used by the table registry. */
+void auto_update_cleanup();
+
+}  // namespace histograms
+
+#endif
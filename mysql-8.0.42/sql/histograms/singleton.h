@@ -186,6 +186,15 @@ class Singleton : public Histogram {
   */
   size_t get_num_distinct_values() const override { return get_num_buckets(); }
 
+  /**
+    Get the buckets of the histogram.
+
+    @return A const reference to the collection of buckets.
+  */
+  const Mem_root_array<SingletonBucket<T>> &get_buckets() const {
+    return m_buckets;
+  }
+
   /**
     Returns the histogram type as a readable string.
 
@@ -36,12 +36,15 @@
 #include <cstring>
 #include <initializer_list>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 #include "decimal.h"
 #include "lex_string.h"
 #include "m_ctype.h"
 #include "m_string.h"
+#include "map_helpers.h"
 #include "my_alloc.h"
 #include "my_base.h"
 #include "my_compiler.h"
@@ -69,12 +72,14 @@
 #include "sql/join_optimizer/cost_model.h"
 #include "sql/join_optimizer/join_optimizer.h"
 #include "sql/key.h"
+#include "sql/malloc_allocator.h"
 #include "sql/my_decimal.h"
 #include "sql/mysqld.h"  // in_left_expr_name
 #include "sql/opt_explain_format.h"
 #include "sql/opt_trace.h"  // OPT_TRACE_TRANSFORM
 #include "sql/opt_trace_context.h"
 #include "sql/parse_tree_nodes.h"  // PT_subquery
+#include "sql/psi_memory_key.h"
 #include "sql/query_options.h"
 #include "sql/query_result.h"
 #include "sql/sql_class.h"  // THD
@@ -339,9 +344,305 @@ void Item_subselect::cleanup() {
   in_cond_of_tab = NO_PLAN_IDX;
 }
 
+/**
+  The results of a correlated scalar subquery, keyed by the values of its
+  outer references.
+
+  A correlated subquery is run again for every row of the outer query, even
+  if its outer references have the same values as for an earlier row, as
+  they often do when the subquery looks up a row by a foreign key of the outer
+  table. If the result of the subquery depends on nothing but the values of
+  its outer references (see Item_singlerow_subselect::setup_result_cache()),
+  it is enough to run it once for each distinct combination of values, so
+  the result of each run is kept here, keyed by the values it was run for.
+
+  The values are serialized into the key as they are, so 'a' and 'A' are
+  different keys even where they compare equal. This costs a run of the
+  subquery now and then, but never gives a wrong result. When the results
+  would take up more than subquery_result_cache_size bytes, the cache is
+  emptied and filled up again. It is freed at the end of each execution of
+  the statement.
+*/
+class Subquery_result_cache {
+ public:
+  /// The kinds of Item_cache a result can be restored into.
+  enum class Value_type { INT, REAL, DECIMAL, STRING, TEMPORAL };
+
+  /// The result of one run of the subquery.
+  struct Result {
+    /// Whether the subquery returned a row. If not, the other members are
+    /// not used.
+    bool has_row{false};
+    bool null_value{true};
+    /// For INT and TEMPORAL (packed) values.
+    longlong int_value{0};
+    double real_value{0.0};
+    my_decimal decimal_value;
+    /// For STRING values. Allocated on the MEM_ROOT of the cache.
+    const char *str{""};
+    size_t length{0};
+    const CHARSET_INFO *charset{nullptr};
+  };
+
+  using Outer_refs = std::vector<Item *, Malloc_allocator<Item *>>;
+
+  Subquery_result_cache(Outer_refs outer_refs, Value_type value_type,
+                        ulonglong max_size)
+      : m_outer_refs(std::move(outer_refs)),
+        m_value_type(value_type),
+        m_max_size(max_size) {}
+
+  /// Returns nullptr, after reporting the error, if out of memory.
+  static void *operator new(size_t size) noexcept {
+    return my_malloc(key_memory_subquery_result_cache, size,
+                     MYF(MY_WME | ME_FATALERROR));
+  }
+  static void operator delete(void *ptr) { my_free(ptr); }
+
+  /**
+    Find out how the result held by an Item_cache can be saved and restored.
+
+    @returns false if results of this type cannot be cached
+  */
+  static bool get_value_type(const Item_cache *value, Value_type *type);
+
+  /// @returns true if the values of the expression can be part of the key.
+  static bool is_supported_key_part(const Item *item);
+
+  /**
+    Serialize the current values of the outer references into the key for
+    find() and insert().
+
+    @returns true on error
+  */
+  bool make_key(THD *thd);
+
+  /// @returns the result for the key made by make_key(), or nullptr.
+  const Result *find() const {
+    const auto it =
+        m_results.find(std::string_view(m_key.ptr(), m_key.length()));
+    return it == m_results.end() ? nullptr : &it->second;
+  }
+
+  /**
+    Save the result the subquery has just returned for the key made by
+    make_key().
+
+    @param has_row whether the subquery returned a row
+    @param value the Item_cache holding the row, if any
+
+    @returns true on error
+  */
+  bool insert(bool has_row, Item_cache *value);
+
+  /// Put a result that has a row back into the Item_cache it came from.
+  void restore(const Result &result, Item_cache *value) const;
+
+  ulonglong m_hits{0};
+  ulonglong m_misses{0};
+
+ private:
+  /// Add a value of a key part to m_key. NULL is a single byte.
+  void append_key_part(bool null_value, const void *data, size_t length) {
+    m_key.append(null_value ? '\1' : '\0');
+    if (!null_value) m_key.append(static_cast<const char *>(data), length);
+  }
+
+  /// @returns an estimate of the memory used by the cache, in bytes.
+  size_t used_size() const {
+    return m_mem_root.allocated_size() +
+           m_results.size() * kOverheadPerResult +
+           m_results.bucket_count() * sizeof(void *);
+  }
+
+  /// Hash table node, and the pointers to it.
+  static constexpr size_t kOverheadPerResult =
+      sizeof(std::pair<const std::string_view, Result>) + 2 * sizeof(void *);
+
+  const Outer_refs m_outer_refs;
+  const Value_type m_value_type;
+  const ulonglong m_max_size;
+
+  /// The keys, and the string values of the results.
+  MEM_ROOT m_mem_root{key_memory_subquery_result_cache, 4096};
+  malloc_unordered_map<std::string_view, Result> m_results{
+      key_memory_subquery_result_cache};
+
+  String m_key;
+  String m_buffer;
+};
+
+bool Subquery_result_cache::get_value_type(const Item_cache *value,
+                                           Value_type *type) {
+  // See Item_cache::get_cache().
+  switch (value->result_type()) {
+    case INT_RESULT:
+      *type = Value_type::INT;
+      return true;
+    case REAL_RESULT:
+      *type = Value_type::REAL;
+      return true;
+    case DECIMAL_RESULT:
+      *type = Value_type::DECIMAL;
+      return true;
+    case STRING_RESULT:
+      if (value->is_temporal()) {
+        *type = Value_type::TEMPORAL;
+        return true;
+      }
+      if (value->data_type() == MYSQL_TYPE_JSON) return false;
+      *type = Value_type::STRING;
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool Subquery_result_cache::is_supported_key_part(const Item *item) {
+  // Expressions with subqueries would be evaluated twice, once for the key
+  // and once by the subquery.
+  return item->result_type() != ROW_RESULT &&
+         item->data_type() != MYSQL_TYPE_JSON && !item->has_subquery() &&
+         !item->is_non_deterministic();
+}
+
+bool Subquery_result_cache::make_key(THD *thd) {
+  m_key.length(0);
+  for (Item *item : m_outer_refs) {
+    if (item->is_temporal()) {
+      const longlong packed = item->val_temporal_by_field_type();
+      append_key_part(item->null_value, &packed, sizeof(packed));
+      continue;
+    }
+    switch (item->result_type()) {
+      case INT_RESULT: {
+        const longlong val = item->val_int();
+        append_key_part(item->null_value, &val, sizeof(val));
+        break;
+      }
+      case REAL_RESULT: {
+        const double val = item->val_real();
+        append_key_part(item->null_value, &val, sizeof(val));
+        break;
+      }
+      default: {
+        // Decimals are keyed by their string form, which is exact.
+        const String *str = item->val_str(&m_buffer);
+        if (item->null_value || str == nullptr) {
+          append_key_part(/*null_value=*/true, nullptr, 0);
+          break;
+        }
+        // Prefix the length, so that two strings cannot run together.
+        const uint32 length = static_cast<uint32>(str->length());
+        append_key_part(/*null_value=*/false, &length, sizeof(length));
+        m_key.append(str->ptr(), length);
+        break;
+      }
+    }
+  }
+  return thd->is_error();
+}
+
+bool Subquery_result_cache::insert(bool has_row, Item_cache *value) {
+  Result result;
+  result.has_row = has_row;
+  if (has_row) {
+    switch (m_value_type) {
+      case Value_type::INT:
+        result.int_value = value->val_int();
+        break;
+      case Value_type::TEMPORAL:
+        result.int_value = value->val_temporal_by_field_type();
+        break;
+      case Value_type::REAL:
+        result.real_value = value->val_real();
+        break;
+      case Value_type::DECIMAL: {
+        const my_decimal *val = value->val_decimal(&result.decimal_value);
+        if (val != nullptr && val != &result.decimal_value)
+          result.decimal_value = *val;
+        break;
+      }
+      case Value_type::STRING: {
+        // Item_cache_str returns its own string and leaves the buffer alone.
+        const String *str = value->val_str(&m_buffer);
+        if (str != nullptr) {
+          result.str = str->ptr();
+          result.length = str->length();
+          result.charset = str->charset();
+        }
+        break;
+      }
+    }
+    result.null_value = value->null_value;
+  }
+
+  const size_t string_length =
+      m_value_type == Value_type::STRING && !result.null_value ? result.length
+                                                               : 0;
+  const size_t size = m_key.length() + string_length + kOverheadPerResult;
+  if (size > m_max_size) return false;
+  if (used_size() + size > m_max_size) {
+    m_results.clear();
+    m_mem_root.ClearForReuse();
+  }
+
+  const char *key =
+      static_cast<const char *>(memdup_root(&m_mem_root, m_key.ptr(),
+                                            m_key.length()));
+  if (key == nullptr) return true;
+  if (string_length > 0) {
+    result.str = static_cast<const char *>(
+        memdup_root(&m_mem_root, result.str, string_length));
+    if (result.str == nullptr) return true;
+  }
+  m_results.emplace(std::string_view(key, m_key.length()), result);
+  return false;
+}
+
+void Subquery_result_cache::restore(const Result &result,
+                                    Item_cache *value) const {
+  assert(result.has_row);
+  value->clear();
+  if (result.null_value) {
+    value->store_null();
+    return;
+  }
+
+  // The store_value() functions take the NULL-ness from their first argument.
+  value->null_value = false;
+  switch (m_value_type) {
+    case Value_type::INT:
+      down_cast<Item_cache_int *>(value)->store_value(value, result.int_value);
+      break;
+    case Value_type::TEMPORAL:
+      down_cast<Item_cache_datetime *>(value)->store_value(value,
+                                                           result.int_value);
+      break;
+    case Value_type::REAL:
+      down_cast<Item_cache_real *>(value)->store_value(value,
+                                                       result.real_value);
+      break;
+    case Value_type::DECIMAL:
+      down_cast<Item_cache_decimal *>(value)->store_value(
+          value, const_cast<my_decimal *>(&result.decimal_value));
+      break;
+    case Value_type::STRING: {
+      String str(result.str, result.length, result.charset);
+      down_cast<Item_cache_str *>(value)->store_value(value, str);
+      break;
+    }
+  }
+}
+
+Item_singlerow_subselect::~Item_singlerow_subselect() { delete m_result_cache; }
+
 void Item_singlerow_subselect::cleanup() {
   DBUG_TRACE;
   Item_subselect::cleanup();
+  delete m_result_cache;
+  m_result_cache = nullptr;
+  m_result_cache_checked = false;
 }
 
 /**
@@ -1223,6 +1524,92 @@ void Item_singlerow_subselect::bring_value() {
     reset();
 }
 
+bool Item_singlerow_subselect::setup_result_cache(THD *thd) {
+  m_result_cache_checked = true;
+
+  // Only correlated subqueries are run more than once. Their results must
+  // not depend on anything but the outer references, and nothing may change
+  // the tables they read while the statement runs (such as stored functions
+  // or triggers).
+  if (thd->variables.subquery_result_cache_size == 0 ||
+      (unit->uncacheable & UNCACHEABLE_DEPENDENT) == 0 ||
+      (unit->uncacheable &
+       ~(UNCACHEABLE_DEPENDENT | UNCACHEABLE_UNITED)) != 0 ||
+      max_columns != 1 || is_maxmin() ||
+      thd->lex->sql_command != SQLCOM_SELECT ||
+      thd->lex->uses_stored_routines())
+    return false;
+
+  Subquery_result_cache::Value_type value_type;
+  if (!Subquery_result_cache::get_value_type(value, &value_type)) return false;
+
+  // Collect the outer references, including the ones from subqueries of the
+  // subquery. Aggregates that are evaluated in an outer query block depend on
+  // more than the current values of their arguments, and references to
+  // expressions that give a new value each time they are evaluated cannot be
+  // keyed on.
+  const int nest_level = unit->first_query_block()->nest_level;
+  Subquery_result_cache::Outer_refs outer_refs(
+      Malloc_allocator<Item *>{key_memory_subquery_result_cache});
+  const bool supported = !WalkQueryExpression(
+      unit, enum_walk::SUBQUERY_POSTFIX, [&outer_refs, nest_level](Item *item) {
+        if (item->is_non_deterministic()) return true;
+        if (item->type() == SUM_FUNC_ITEM) {
+          const Item_sum *sum = down_cast<Item_sum *>(item);
+          return sum->aggr_query_block != nullptr &&
+                 sum->aggr_query_block->nest_level < nest_level;
+        }
+        if (item->type() != FIELD_ITEM && item->type() != REF_ITEM)
+          return false;
+        const Item_ident *ident = down_cast<Item_ident *>(item);
+        if (ident->depended_from == nullptr ||
+            ident->depended_from->nest_level >= nest_level)
+          return false;
+        if (!Subquery_result_cache::is_supported_key_part(item)) return true;
+        outer_refs.push_back(item);
+        return false;
+      });
+  if (!supported || outer_refs.empty()) return false;
+
+  m_result_cache =
+      new Subquery_result_cache(std::move(outer_refs), value_type,
+                                thd->variables.subquery_result_cache_size);
+  return m_result_cache == nullptr;
+}
+
+bool Item_singlerow_subselect::exec(THD *thd) {
+  if (!m_result_cache_checked && setup_result_cache(thd)) return true;
+  if (m_result_cache == nullptr) return Item_subselect::exec(thd);
+
+  if (thd->is_error() || thd->killed) return true;
+  if (m_result_cache->make_key(thd)) return true;
+
+  const Subquery_result_cache::Result *result = m_result_cache->find();
+  if (result != nullptr) {
+    ++m_result_cache->m_hits;
+    if (result->has_row) {
+      m_result_cache->restore(*result, value);
+      assigned(true);
+    } else {
+      assigned(false);
+      reset();
+    }
+    return false;
+  }
+
+  ++m_result_cache->m_misses;
+  if (Item_subselect::exec(thd)) return true;
+  return m_result_cache->insert(assigned(), value);
+}
+
+ulonglong Item_singlerow_subselect::result_cache_hits() const {
+  return m_result_cache == nullptr ? 0 : m_result_cache->m_hits;
+}
+
+ulonglong Item_singlerow_subselect::result_cache_misses() const {
+  return m_result_cache == nullptr ? 0 : m_result_cache->m_misses;
+}
+
 double Item_singlerow_subselect::val_real() {
   assert(fixed == 1);
   if (!no_rows && !exec(current_thd) && !value->null_value) {
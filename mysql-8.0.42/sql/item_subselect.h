@@ -65,6 +65,7 @@ class Query_block;
 class Query_expression;
 class String;
 class SubqueryWithResult;
+class Subquery_result_cache;
 class THD;
 class Temp_table_param;
 class my_decimal;
@@ -284,10 +285,27 @@ class Item_singlerow_subselect : public Item_subselect {
   Item_singlerow_subselect(Query_block *query_block);
   Item_singlerow_subselect()
       : Item_subselect(), value(nullptr), row(nullptr), no_rows(false) {}
+  ~Item_singlerow_subselect() override;
 
   void cleanup() override;
   subs_type substype() const override { return SINGLEROW_SUBS; }
 
+  /**
+    Run the subquery, unless it is correlated and has already been run for
+    the current values of its outer references during this execution of the
+    statement, in which case its result is taken from the result cache (see
+    Subquery_result_cache).
+  */
+  bool exec(THD *thd) override;
+
+  /// @returns the number of times the result was taken from the result
+  /// cache, or 0 if the result cache is not used.
+  ulonglong result_cache_hits() const;
+
+  /// @returns the number of times the subquery was run and its result added
+  /// to the result cache, or 0 if the result cache is not used.
+  ulonglong result_cache_misses() const;
+
   void reset() override;
   bool select_transformer(THD *thd, Query_block *select) override;
   void store(uint i, Item *item);
@@ -365,6 +383,24 @@ class Item_singlerow_subselect : public Item_subselect {
   std::optional<ContainedSubquery> get_contained_subquery(
       const Query_block *outer_query_block) override;
   friend class Query_result_scalar_subquery;
+
+ private:
+  /**
+    Set up m_result_cache if the result of the subquery depends on nothing
+    but the values of its outer references, and the result cache is
+    enabled.
+
+    @returns true on error
+  */
+  bool setup_result_cache(THD *thd);
+
+  /// Results of earlier executions, or nullptr if they are not cached.
+  /// Freed by cleanup().
+  Subquery_result_cache *m_result_cache{nullptr};
+
+  /// Whether setup_result_cache() has been called for this execution of the
+  /// statement.
+  bool m_result_cache_checked{false};
 };
 
 /* used in static ALL/ANY optimization */
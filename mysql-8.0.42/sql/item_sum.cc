@@ -1966,6 +1966,18 @@ bool Item_sum_sum::add() {
   return false;
 }
 
+void Item_sum_sum::add_partial_sum(const my_decimal *partial_sum,
+                                   ulonglong num_values) {
+  assert(!m_is_window_function && hybrid_type == DECIMAL_RESULT);
+  if (num_values == 0) return;
+  my_decimal_add(E_DEC_FATAL_ERROR, dec_buffs + (curr_dec_buff ^ 1),
+                 partial_sum, dec_buffs + curr_dec_buff);
+  curr_dec_buff ^= 1;
+  null_value = false;
+  // Item_sum_avg divides by this.
+  m_count += num_values;
+}
+
 longlong Item_sum_sum::val_int() {
   assert(fixed == 1);
   if (m_window != nullptr) {
@@ -808,6 +808,7 @@ class Unique;
 
 class Aggregator_distinct : public Aggregator {
   friend class Item_sum_sum;
+  friend class Item_sum_count;
 
   /*
     flag to prevent consecutive runs of endup(). Normally in endup there are
@@ -1045,6 +1046,15 @@ class Item_sum_sum : public Item_sum_num {
   }
   void clear() override;
   bool add() override;
+  /**
+    Add the sum of rows that were aggregated elsewhere, as if add() had been
+    called for each of them. Used by ParallelAggregateIterator. Only for
+    DECIMAL_RESULT.
+
+    @param partial_sum the sum of the non-NULL values in the rows.
+    @param num_values the number of non-NULL values (needed by AVG).
+  */
+  void add_partial_sum(const my_decimal *partial_sum, ulonglong num_values);
   double val_real() override;
   longlong val_int() override;
   String *val_str(String *str) override;
@@ -1098,6 +1108,23 @@ class Item_sum_count : public Item_sum_int {
     return false;
   }
   void no_rows_in_result() override { count = 0; }
+  /**
+    Add rows that were counted elsewhere, as if add() had been called for
+    each of them. Used by ParallelAggregateIterator.
+  */
+  void add_partial_count(longlong count_arg) { count += count_arg; }
+  /**
+    Make the result of COUNT(DISTINCT) a number of distinct values that were
+    counted elsewhere, instead of the number of values given to the distinct
+    aggregator. Used by ParallelAggregateIterator.
+  */
+  void set_distinct_count(longlong count_arg) {
+    assert(aggr != nullptr &&
+           aggr->Aggrtype() == Aggregator::DISTINCT_AGGREGATOR);
+    count = count_arg;
+    // Keep endup() from counting the values in the aggregator instead.
+    down_cast<Aggregator_distinct *>(aggr)->endup_done = true;
+  }
   void make_const(longlong count_arg) {
     count = count_arg;
     Item_sum::make_const();
@@ -42,7 +42,9 @@
 #include "mysqld_error.h"
 #include "sql/debug_sync.h"
 #include "sql/handler.h"
+#include "sql/iterators/row_batch.h"
 #include "sql/iterators/row_iterator.h"
+#include "sql/iterators/runtime_filter.h"
 #include "sql/mem_root_array.h"
 #include "sql/sql_bitmap.h"
 #include "sql/sql_class.h"  // THD
@@ -99,34 +101,46 @@ bool IndexScanIterator<Reverse>::Init() {
 //! @cond
 template <>
 int IndexScanIterator<false>::Read() {  // Forward read.
-  int error;
-  if (m_first) {
-    error = table()->file->ha_index_first(m_record);
-    m_first = false;
-  } else {
-    error = table()->file->ha_index_next(m_record);
-  }
-  if (error) return HandleError(error);
-  if (m_examined_rows != nullptr) {
-    ++*m_examined_rows;
+  RuntimeFilter *runtime_filter =
+      table()->file->ha_get_runtime_filter_to_check();
+  for (;;) {
+    int error;
+    if (m_first) {
+      error = table()->file->ha_index_first(m_record);
+      m_first = false;
+    } else {
+      error = table()->file->ha_index_next(m_record);
+    }
+    if (error) return HandleError(error);
+    if (m_examined_rows != nullptr) {
+      ++*m_examined_rows;
+    }
+    if (runtime_filter == nullptr || runtime_filter->MayMatch(m_record)) {
+      return 0;
+    }
   }
-  return 0;
 }
 
 template <>
 int IndexScanIterator<true>::Read() {  // Backward read.
-  int error;
-  if (m_first) {
-    error = table()->file->ha_index_last(m_record);
-    m_first = false;
-  } else {
-    error = table()->file->ha_index_prev(m_record);
-  }
-  if (error) return HandleError(error);
-  if (m_examined_rows != nullptr) {
-    ++*m_examined_rows;
+  RuntimeFilter *runtime_filter =
+      table()->file->ha_get_runtime_filter_to_check();
+  for (;;) {
+    int error;
+    if (m_first) {
+      error = table()->file->ha_index_last(m_record);
+      m_first = false;
+    } else {
+      error = table()->file->ha_index_prev(m_record);
+    }
+    if (error) return HandleError(error);
+    if (m_examined_rows != nullptr) {
+      ++*m_examined_rows;
+    }
+    if (runtime_filter == nullptr || runtime_filter->MayMatch(m_record)) {
+      return 0;
+    }
   }
-  return 0;
 }
 //! @endcond
 
@@ -217,17 +231,21 @@ bool TableScanIterator::Init() {
 int TableScanIterator::Read() {
   int tmp;
   if (table()->is_union_or_table()) {
-    while ((tmp = table()->file->ha_rnd_next(m_record))) {
-      /*
-       ha_rnd_next can return RECORD_DELETED for MyISAM when one thread is
-       reading and another deleting without locks.
-       */
-      if (tmp == HA_ERR_RECORD_DELETED && !thd()->killed) continue;
-      return HandleError(tmp);
-    }
-    if (m_examined_rows != nullptr) {
-      ++*m_examined_rows;
-    }
+    RuntimeFilter *runtime_filter =
+        table()->file->ha_get_runtime_filter_to_check();
+    do {
+      while ((tmp = table()->file->ha_rnd_next(m_record))) {
+        /*
+         ha_rnd_next can return RECORD_DELETED for MyISAM when one thread is
+         reading and another deleting without locks.
+         */
+        if (tmp == HA_ERR_RECORD_DELETED && !thd()->killed) continue;
+        return HandleError(tmp);
+      }
+      if (m_examined_rows != nullptr) {
+        ++*m_examined_rows;
+      }
+    } while (runtime_filter != nullptr && !runtime_filter->MayMatch(m_record));
   } else {
     while (true) {
       if (m_remaining_dups == 0) {  // always initially
@@ -276,6 +294,30 @@ int TableScanIterator::Read() {
   return 0;
 }
 
+int TableScanIterator::ReadBatch(RowBatch *batch) {
+  if (!table()->is_union_or_table()) {
+    // INTERSECT and EXCEPT need the duplicate handling in Read().
+    return RowIterator::ReadBatch(batch);
+  }
+  RuntimeFilter *runtime_filter =
+      table()->file->ha_get_runtime_filter_to_check();
+  while (!batch->full()) {
+    const int tmp = table()->file->ha_rnd_next(m_record);
+    if (tmp != 0) {
+      if (tmp == HA_ERR_RECORD_DELETED && !thd()->killed) continue;
+      return HandleError(tmp);
+    }
+    if (m_examined_rows != nullptr) {
+      ++*m_examined_rows;
+    }
+    if (runtime_filter != nullptr && !runtime_filter->MayMatch(m_record)) {
+      continue;
+    }
+    batch->AppendFromTableBuffers();
+  }
+  return 0;
+}
+
 ZeroRowsIterator::ZeroRowsIterator(THD *thd,
                                    Mem_root_array<TABLE *> pruned_tables)
     : RowIterator(thd), m_pruned_tables(std::move(pruned_tables)) {}
@@ -73,6 +73,7 @@ class TableScanIterator final : public TableRowIterator {
 
   bool Init() override;
   int Read() override;
+  int ReadBatch(RowBatch *batch) override;
 
  private:
   uchar *const m_record;
@@ -0,0 +1,137 @@
+#ifndef SQL_ITERATORS_BLOOM_FILTER_H_
+#define SQL_ITERATORS_BLOOM_FILTER_H_
+
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/// @file
+///
+/// This file contains the BloomFilter class, a set of 64-bit hash values
+/// that can have false positives, but no false negatives.
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+
+#include "my_alloc.h"
+
+/**
+  A split block Bloom filter over 64-bit hash values.
+
+  The filter is an array of 256-bit blocks. The upper half of a hash value
+  selects a block, and the lower half sets (or tests) one bit in each of the
+  eight 32-bit words of the block. This way, an insertion or a lookup touches
+  a single cache line, at the price of a slightly higher false positive rate
+  than a classic Bloom filter of the same size. With kBitsPerKey bits per
+  key, the false positive rate is about 1%.
+
+  The hash values must be of good quality in all 64 bits (xxHash64 or
+  similar). The memory is allocated on a MEM_ROOT given by the user, and is
+  never freed by the filter itself.
+ */
+class BloomFilter {
+ public:
+  /// The number of bits to use per expected key.
+  static constexpr size_t kBitsPerKey = 10;
+
+  /**
+    Allocate an empty filter.
+
+    @param mem_root where to allocate the filter.
+    @param expected_num_keys the number of keys the filter is sized for. More
+      keys can be inserted, but the false positive rate goes up.
+    @param max_bytes the maximum size of the filter.
+
+    @retval true on out of memory. my_error() is not called.
+   */
+  bool Init(MEM_ROOT *mem_root, size_t expected_num_keys, size_t max_bytes) {
+    const size_t wanted_blocks =
+        std::max<size_t>(1, expected_num_keys * kBitsPerKey / kBitsPerBlock);
+    const size_t max_blocks = std::max<size_t>(1, max_bytes / sizeof(Block));
+    // Use a power of two number of blocks, so that selecting a block is a
+    // bitwise AND.
+    m_num_blocks = 1;
+    while (m_num_blocks < wanted_blocks && m_num_blocks * 2 <= max_blocks) {
+      m_num_blocks *= 2;
+    }
+    m_blocks = mem_root->ArrayAlloc<Block>(m_num_blocks);
+    if (m_blocks == nullptr) {
+      m_num_blocks = 0;
+      return true;
+    }
+    memset(static_cast<void *>(m_blocks), 0, m_num_blocks * sizeof(Block));
+    return false;
+  }
+
+  /// @returns true if Init() has been called successfully.
+  bool is_enabled() const { return m_blocks != nullptr; }
+
+  void Insert(uint64_t hash) {
+    assert(is_enabled());
+    Block &block = m_blocks[(hash >> 32) & (m_num_blocks - 1)];
+    const uint32_t key = static_cast<uint32_t>(hash);
+    for (size_t i = 0; i < kWordsPerBlock; ++i) {
+      block.words[i] |= BitInWord(key, i);
+    }
+  }
+
+  /// @returns false if the hash value was never inserted into the filter.
+  bool MayContain(uint64_t hash) const {
+    assert(is_enabled());
+    const Block &block = m_blocks[(hash >> 32) & (m_num_blocks - 1)];
+    const uint32_t key = static_cast<uint32_t>(hash);
+    for (size_t i = 0; i < kWordsPerBlock; ++i) {
+      if ((block.words[i] & BitInWord(key, i)) == 0) return false;
+    }
+    return true;
+  }
+
+  size_t size_in_bytes() const { return m_num_blocks * sizeof(Block); }
+
+ private:
+  static constexpr size_t kWordsPerBlock = 8;
+  static constexpr size_t kBitsPerBlock = kWordsPerBlock * 32;
+
+  struct Block {
+    uint32_t words[kWordsPerBlock];
+  };
+
+  /// @returns the bit to set in word number "word_idx" of a block: one of 32
+  /// bits, chosen by multiplying the key with an odd constant for the word
+  /// and using the upper five bits of the product.
+  static uint32_t BitInWord(uint32_t key, size_t word_idx) {
+    static constexpr uint32_t kSalts[kWordsPerBlock] = {
+        0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+        0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+    return uint32_t{1} << ((key * kSalts[word_idx]) >> 27);
+  }
+
+  Block *m_blocks{nullptr};
+
+  /// The number of blocks. Always a power of two if the filter is enabled.
+  size_t m_num_blocks{0};
+};
+
+#endif  // SQL_ITERATORS_BLOOM_FILTER_H_
@@ -47,6 +47,7 @@
 #include "sql/item_func.h"
 #include "sql/item_sum.h"
 #include "sql/iterators/basic_row_iterators.h"
+#include "sql/iterators/row_batch.h"
 #include "sql/iterators/timing_iterator.h"
 #include "sql/join_optimizer/access_path.h"
 #include "sql/join_optimizer/materialize_path_parameters.h"
@@ -99,6 +100,43 @@ int FilterIterator::Read() {
   }
 }
 
+int FilterIterator::ReadBatch(RowBatch *batch) {
+  // Subqueries and stored functions may look at (or depend on) more than the
+  // current row of our input, so evaluate them one row at a time, as usual.
+  if (m_condition->has_subquery() || m_condition->has_stored_program()) {
+    return RowIterator::ReadBatch(batch);
+  }
+
+  for (;;) {
+    const int err = m_source->ReadBatch(batch);
+    if (err == 1) return 1;
+
+    // Evaluate the condition for every row in the batch, and keep only the
+    // matching ones.
+    size_t num_matched = 0;
+    for (size_t i = 0; i < batch->size(); ++i) {
+      batch->LoadSelectedRow(i);
+      const bool matched = m_condition->val_int();
+
+      if (thd()->killed) {
+        thd()->send_kill_message();
+        return 1;
+      }
+
+      /* check for errors evaluating the condition */
+      if (thd()->is_error()) return 1;
+
+      if (matched) batch->MoveSelectedRow(i, num_matched++);
+    }
+    batch->ShrinkSelection(num_matched);
+
+    if (num_matched > 0 || err == -1) return err;
+
+    // No rows in this batch matched; try the next one.
+    batch->Clear();
+  }
+}
+
 bool LimitOffsetIterator::Init() {
   if (m_source->Init()) {
     return true;
@@ -205,10 +243,18 @@ bool AggregateIterator::Init() {
         m_tables, pointer_cast<const uchar *>(m_first_row_next_group.ptr()));
     m_first_row_next_group.length(0);
   }
+  // Similarly, if we stopped in the middle of a batch, the source left the
+  // last row of the batch in the table buffers.
+  if (m_batch.is_enabled()) {
+    m_batch.Clear();
+  }
 
   if (m_source->Init()) {
     return true;
   }
+  if (m_batch.Init(&m_tables, thd()->variables.iterator_batch_size)) {
+    return true;
+  }
 
   // If we have a HAVING after us, it needs to be evaluated within the context
   // of the slice we're in (unless we're in the hypergraph optimizer, which
@@ -241,7 +287,7 @@ int AggregateIterator::Read() {
     case READING_FIRST_ROW: {
       // Start the first group, if possible. (If we're not at the first row,
       // we already saw the first row in the new group at the previous Read().)
-      int err = m_source->Read();
+      int err = ReadSourceRow();
       if (err == -1) {
         m_seen_eof = true;
         m_state = DONE_OUTPUTTING_ROWS;
@@ -313,7 +359,7 @@ int AggregateIterator::Read() {
 
       // Keep reading rows as long as they are part of the existing group.
       for (;;) {
-        int err = m_source->Read();
+        int err = ReadSourceRow();
         if (err == 1) return 1;  // Error.
 
         if (err == -1) {
@@ -51,6 +51,7 @@
 #include "my_base.h"
 #include "my_inttypes.h"
 #include "my_table_map.h"
+#include "sql/iterators/row_batch.h"
 #include "sql/iterators/row_iterator.h"
 #include "sql/join_type.h"
 #include "sql/mem_root_array.h"
@@ -84,6 +85,7 @@ class FilterIterator final : public RowIterator {
   bool Init() override { return m_source->Init(); }
 
   int Read() override;
+  int ReadBatch(RowBatch *batch) override;
 
   void SetNullRowFlag(bool is_null_row) override {
     m_source->SetNullRowFlag(is_null_row);
@@ -232,6 +234,13 @@ class AggregateIterator final : public RowIterator {
     DONE_OUTPUTTING_ROWS
   } m_state;
 
+  /// Read the next row from the source iterator, through m_batch if batch
+  /// mode is enabled.
+  int ReadSourceRow() {
+    return m_batch.is_enabled() ? m_batch.ReadRow(m_source.get())
+                                : m_source->Read();
+  }
+
   unique_ptr_destroy_only<RowIterator> m_source;
 
   /**
@@ -281,6 +290,10 @@ class AggregateIterator final : public RowIterator {
    */
   pack_rows::TableCollection m_tables;
 
+  /// Used for reading the input in batches, if enabled by iterator_batch_size
+  /// (see RowIterator::ReadBatch()).
+  RowBatch m_batch;
+
   /// Packed version of the first row in the group we are currently processing.
   String m_first_row_this_group;
 
@@ -26,6 +26,7 @@
 #include <assert.h>
 #include <algorithm>
 #include <cstdint>
+#include <new>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -37,6 +38,7 @@
 #include "my_inttypes.h"
 #include "my_sys.h"
 #include "mysqld_error.h"
+#include "sql/iterators/hash_join_flat_map.h"
 #include "sql/item_cmpfunc.h"
 #include "sql/psi_memory_key.h"
 #include "sql/sql_class.h"
@@ -169,11 +171,12 @@ void LoadImmutableStringIntoTableBuffers(const TableCollection &tables,
 
 HashJoinRowBuffer::HashJoinRowBuffer(
     TableCollection tables, std::vector<HashJoinCondition> join_conditions,
-    size_t max_mem_available)
+    size_t max_mem_available, HashTableType table_type)
     : m_join_conditions(std::move(join_conditions)),
       m_tables(std::move(tables)),
       m_mem_root(key_memory_hash_join, 16384 /* 16 kB */),
       m_overflow_mem_root(key_memory_hash_join, 256),
+      m_table_type(table_type),
       m_hash_map(nullptr),
       m_max_mem_available(
           std::max<size_t>(max_mem_available, 16384 /* 16 kB */)) {
@@ -186,10 +189,11 @@ HashJoinRowBuffer::HashJoinRowBuffer(
 HashJoinRowBuffer::~HashJoinRowBuffer() = default;
 
 bool HashJoinRowBuffer::Init() {
-  if (m_hash_map != nullptr) {
+  if (Initialized()) {
     // Reset the unique_ptr, so that the hash map destructors are called before
     // clearing the MEM_ROOT.
     m_hash_map.reset(nullptr);
+    m_flat_hash_map.reset(nullptr);
     m_mem_root.Clear();
     // Limit is being applied only after the first row.
     m_mem_root.set_max_capacity(0);
@@ -203,10 +207,18 @@ bool HashJoinRowBuffer::Init() {
   // table.
   m_row_size_upper_bound = ComputeRowSizeUpperBound(m_tables);
 
-  m_hash_map.reset(new HashMap());
-  if (m_hash_map == nullptr) {
-    my_error(ER_OUTOFMEMORY, MYF(ME_FATALERROR), sizeof(*m_hash_map));
-    return true;
+  if (m_table_type == HashTableType::FLAT) {
+    m_flat_hash_map.reset(new (std::nothrow) FlatHashMap());
+    if (m_flat_hash_map == nullptr) {
+      my_error(ER_OUTOFMEMORY, MYF(ME_FATALERROR), sizeof(*m_flat_hash_map));
+      return true;
+    }
+  } else {
+    m_hash_map.reset(new HashMap());
+    if (m_hash_map == nullptr) {
+      my_error(ER_OUTOFMEMORY, MYF(ME_FATALERROR), sizeof(*m_hash_map));
+      return true;
+    }
   }
 
   m_last_row_stored = LinkedImmutableString{nullptr};
@@ -270,25 +282,38 @@ StoreRowResult HashJoinRowBuffer::StoreRow(THD *thd,
     // Keep bytes_to_commit == 0; the value is already committed.
   }
 
-  std::pair<HashMap::iterator, bool> key_it_and_inserted;
-  try {
-    key_it_and_inserted =
-        m_hash_map->emplace(key, LinkedImmutableString{nullptr});
-  } catch (const std::overflow_error &) {
-    // This can only happen if the hash function is extremely bad
-    // (should never happen in practice).
-    return StoreRowResult::FATAL_ERROR;
+  // The chain of rows for the key, and whether the key was inserted.
+  std::pair<LinkedImmutableString *, bool> value_and_inserted;
+  if (m_table_type == HashTableType::FLAT) {
+    value_and_inserted =
+        m_flat_hash_map->emplace(FlatHashMap::Hash(key.Decode()), key);
+    if (value_and_inserted.first == nullptr) {
+      return StoreRowResult::FATAL_ERROR;
+    }
+  } else {
+    try {
+      const auto it_and_inserted =
+          m_hash_map->emplace(key, LinkedImmutableString{nullptr});
+      value_and_inserted = {&it_and_inserted.first->second,
+                            it_and_inserted.second};
+    } catch (const std::overflow_error &) {
+      // This can only happen if the hash function is extremely bad
+      // (should never happen in practice).
+      return StoreRowResult::FATAL_ERROR;
+    }
   }
   LinkedImmutableString next_ptr{nullptr};
-  if (key_it_and_inserted.second) {
+  if (value_and_inserted.second) {
     // We inserted an element, so the hash table may have grown.
     // Update the capacity available for the MEM_ROOT; our total may
     // have gone slightly over already, and if so, we will signal
     // that and immediately start spilling to disk.
     const size_t bytes_used =
-        m_hash_map->bucket_count() * sizeof(HashMap::bucket_type) +
-        m_hash_map->values().capacity() *
-            sizeof(HashMap::value_container_type::value_type);
+        m_table_type == HashTableType::FLAT
+            ? m_flat_hash_map->bytes_used()
+            : m_hash_map->bucket_count() * sizeof(HashMap::bucket_type) +
+                  m_hash_map->values().capacity() *
+                      sizeof(HashMap::value_container_type::value_type);
     if (bytes_used >= m_max_mem_available) {
       // 0 means no limit, so set the minimum possible limit.
       m_mem_root.set_max_capacity(1);
@@ -306,11 +331,11 @@ StoreRowResult HashJoinRowBuffer::StoreRow(THD *thd,
     // We already have another element with the same key, so our insert
     // failed, Put the new value in the hash bucket, but keep track of
     // what the old one was; it will be our “next” pointer.
-    next_ptr = key_it_and_inserted.first->second;
+    next_ptr = *value_and_inserted.first;
   }
 
   // Save the contents of all columns marked for reading.
-  m_last_row_stored = key_it_and_inserted.first->second =
+  m_last_row_stored = *value_and_inserted.first =
       StoreLinkedImmutableStringFromTableBuffers(next_ptr, &full);
   if (m_last_row_stored == nullptr) {
     return StoreRowResult::FATAL_ERROR;
@@ -321,15 +346,44 @@ StoreRowResult HashJoinRowBuffer::StoreRow(THD *thd,
   }
 }
 
-size_t HashJoinRowBuffer::size() const { return m_hash_map->size(); }
+size_t HashJoinRowBuffer::size() const {
+  if (m_table_type == HashTableType::FLAT) return m_flat_hash_map->size();
+  return m_hash_map->size();
+}
 
 std::optional<LinkedImmutableString> HashJoinRowBuffer::find(Key key) const {
+  if (m_table_type == HashTableType::FLAT) {
+    const LinkedImmutableString row =
+        m_flat_hash_map->find(FlatHashMap::Hash(key), key);
+    if (row == nullptr) return {};
+    return row;
+  }
   const auto it = m_hash_map->find(key);
   if (it == m_hash_map->end()) return {};
   return it->second;
 }
 
+void HashJoinRowBuffer::find_batch(const Key *keys, size_t num_keys,
+                                   LinkedImmutableString *rows) {
+  if (m_table_type != HashTableType::FLAT) {
+    for (size_t i = 0; i < num_keys; ++i) {
+      rows[i] = find(keys[i]).value_or(LinkedImmutableString{nullptr});
+    }
+    return;
+  }
+
+  m_hashes.resize(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    m_hashes[i] = FlatHashMap::Hash(keys[i]);
+  }
+  m_flat_hash_map->FindBatch(m_hashes.data(), keys, num_keys, rows);
+}
+
 std::optional<LinkedImmutableString> HashJoinRowBuffer::first_row() const {
+  if (m_table_type == HashTableType::FLAT) {
+    if (m_flat_hash_map->empty()) return {};
+    return m_flat_hash_map->first_value();
+  }
   if (m_hash_map->empty()) return {};
   return m_hash_map->begin()->second;
 }
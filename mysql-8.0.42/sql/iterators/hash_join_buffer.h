@@ -116,13 +116,26 @@ void LoadImmutableStringIntoTableBuffers(
 
 enum class StoreRowResult { ROW_STORED, BUFFER_FULL, FATAL_ERROR };
 
+/// The kind of hash table HashJoinRowBuffer stores its rows in.
+enum class HashTableType {
+  /// A segmented map from ankerl::unordered_dense, where the buckets point
+  /// into a separate array of keys and values.
+  SEGMENTED,
+  /// A FlatHashMap, which keeps fingerprints and hash values inline in the
+  /// table, and supports prefetching batch lookups (see find_batch()).
+  FLAT
+};
+
+class FlatHashMap;
+
 class HashJoinRowBuffer {
  public:
   // Construct the buffer. Note that Init() must be called before the buffer can
   // be used.
   HashJoinRowBuffer(pack_rows::TableCollection tables,
                     std::vector<HashJoinCondition> join_conditions,
-                    size_t max_mem_available_bytes);
+                    size_t max_mem_available_bytes,
+                    HashTableType table_type = HashTableType::SEGMENTED);
 
   ~HashJoinRowBuffer();
 
@@ -152,6 +165,18 @@ class HashJoinRowBuffer {
 
   std::optional<LinkedImmutableString> find(Key key) const;
 
+  /// Look up many keys at a time. This is faster than calling find() for each
+  /// key if the hash table is much larger than the CPU caches, since the
+  /// memory accesses for upcoming keys are started early (if the hash table
+  /// type is FLAT; otherwise, it is the same as calling find() repeatedly).
+  ///
+  /// @param keys the keys to look up.
+  /// @param num_keys the number of keys.
+  /// @param[out] rows for each key, the first matching row, or nullptr if
+  ///   there is none.
+  void find_batch(const Key *keys, size_t num_keys,
+                  LinkedImmutableString *rows);
+
   std::optional<LinkedImmutableString> first_row() const;
 
   LinkedImmutableString LastRowStored() const {
@@ -159,7 +184,11 @@ class HashJoinRowBuffer {
     return m_last_row_stored;
   }
 
-  bool Initialized() const { return m_hash_map != nullptr; }
+  bool Initialized() const {
+    return m_hash_map != nullptr || m_flat_hash_map != nullptr;
+  }
+
+  HashTableType table_type() const { return m_table_type; }
 
   bool contains(const Key &key) const { return find(key).has_value(); }
 
@@ -185,8 +214,16 @@ class HashJoinRowBuffer {
   // disk.
   MEM_ROOT m_overflow_mem_root;
 
-  // The hash table where the rows are stored.
+  // The kind of hash table to store the rows in.
+  const HashTableType m_table_type;
+
+  // The hash table where the rows are stored. Only one of these is set,
+  // depending on m_table_type.
   std::unique_ptr<HashMap> m_hash_map;
+  std::unique_ptr<FlatHashMap> m_flat_hash_map;
+
+  // A buffer for the hash values in find_batch().
+  std::vector<uint64_t> m_hashes;
 
   // A buffer we can use when we are constructing a join key from a join
   // condition. In order to avoid reallocating memory, the buffer never shrinks.
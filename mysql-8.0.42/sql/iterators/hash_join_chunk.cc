@@ -43,7 +43,8 @@ HashJoinChunk::HashJoinChunk(HashJoinChunk &&other)
     : m_tables(std::move(other.m_tables)),
       m_num_rows(other.m_num_rows),
       m_file(other.m_file),
-      m_uses_match_flags(other.m_uses_match_flags) {
+      m_uses_match_flags(other.m_uses_match_flags),
+      m_stores_join_keys(other.m_stores_join_keys) {
   setup_io_cache(&m_file);
   // Reset the IO_CACHE structure so that the destructor doesn't close/clear the
   // file contents and it's buffers.
@@ -54,6 +55,7 @@ HashJoinChunk &HashJoinChunk::operator=(HashJoinChunk &&other) {
   m_tables = std::move(other.m_tables);
   m_num_rows = other.m_num_rows;
   m_uses_match_flags = other.m_uses_match_flags;
+  m_stores_join_keys = other.m_stores_join_keys;
 
   // Since the file we are replacing will become unreachable, free all resources
   // used by it.
@@ -69,19 +71,20 @@ HashJoinChunk &HashJoinChunk::operator=(HashJoinChunk &&other) {
 
 HashJoinChunk::~HashJoinChunk() { close_cached_file(&m_file); }
 
-bool HashJoinChunk::Init(const TableCollection &tables, bool uses_match_flags) {
+bool HashJoinChunk::Init(const TableCollection &tables, bool uses_match_flags,
+                         bool stores_join_keys) {
   m_tables = tables;
   m_file.file_key = key_file_hash_join;
   m_num_rows = 0;
   m_uses_match_flags = uses_match_flags;
+  m_stores_join_keys = stores_join_keys;
   close_cached_file(&m_file);
   return open_cached_file(&m_file, mysql_tmpdir, TEMP_PREFIX, DISK_BUFFER_SIZE,
                           MYF(MY_WME));
 }
 
 bool HashJoinChunk::Rewind() {
-  if (my_b_flush_io_cache(&m_file, /*need_append_buffer_lock=*/0) == -1 ||
-      reinit_io_cache(&m_file, READ_CACHE, 0, false, false)) {
+  if (RewindQuietly()) {
     my_error(ER_TEMP_FILE_WRITE_FAILURE, MYF(0));
     return true;
   }
@@ -89,7 +92,36 @@ bool HashJoinChunk::Rewind() {
   return false;
 }
 
+bool HashJoinChunk::RewindQuietly() {
+  return my_b_flush_io_cache(&m_file, /*need_append_buffer_lock=*/0) == -1 ||
+         reinit_io_cache(&m_file, READ_CACHE, 0, false, false);
+}
+
+// Write a length-prefixed string to the file.
+static bool WriteString(IO_CACHE *file, const String &str) {
+  const size_t length = str.length();
+  return my_b_write(file, pointer_cast<const uchar *>(&length),
+                    sizeof(length)) != 0 ||
+         my_b_write(file, pointer_cast<const uchar *>(str.ptr()), length) != 0;
+}
+
+// Read a string written by WriteString() from the file.
+static bool ReadString(IO_CACHE *file, String *str) {
+  size_t length;
+  if (my_b_read(file, pointer_cast<uchar *>(&length), sizeof(length)) != 0 ||
+      str->reserve(length)) {
+    return true;
+  }
+  str->length(length);
+  return my_b_read(file, pointer_cast<uchar *>(str->ptr()), length) != 0;
+}
+
 bool HashJoinChunk::WriteRowToChunk(String *buffer, bool matched) {
+  if (m_stores_join_keys && WriteString(&m_file, *buffer)) {
+    my_error(ER_TEMP_FILE_WRITE_FAILURE, MYF(0));
+    return true;
+  }
+
   if (StoreFromTableBuffers(m_tables, buffer)) {
     my_error(ER_OUTOFMEMORY, MYF(ME_FATALERROR),
              ComputeRowSizeUpperBound(m_tables));
@@ -123,6 +155,13 @@ bool HashJoinChunk::WriteRowToChunk(String *buffer, bool matched) {
 }
 
 bool HashJoinChunk::LoadRowFromChunk(String *buffer, bool *matched) {
+  // The join key is not needed when loading the row into the record buffers,
+  // so just skip it.
+  if (m_stores_join_keys && ReadString(&m_file, buffer)) {
+    my_error(ER_TEMP_FILE_WRITE_FAILURE, MYF(0));
+    return true;
+  }
+
   if (m_uses_match_flags) {
     if (my_b_read(&m_file, pointer_cast<uchar *>(matched), sizeof(*matched)) !=
         0) {
@@ -157,3 +196,18 @@ bool HashJoinChunk::LoadRowFromChunk(String *buffer, bool *matched) {
 
   return false;
 }
+
+bool HashJoinChunk::ReadRawRowFromChunk(String *join_key, String *row,
+                                        bool *matched) {
+  if (m_stores_join_keys && ReadString(&m_file, join_key)) {
+    return true;
+  }
+
+  if (m_uses_match_flags &&
+      my_b_read(&m_file, pointer_cast<uchar *>(matched), sizeof(*matched)) !=
+          0) {
+    return true;
+  }
+
+  return ReadString(&m_file, row);
+}
@@ -26,6 +26,7 @@
 
 #include "my_base.h"
 #include "my_sys.h"
+#include "sql/iterators/bloom_filter.h"
 #include "sql/pack_rows.h"
 
 class String;
@@ -82,9 +83,13 @@ class HashJoinChunk {
   ///   the chunk file is determined by each tables read set.
   /// @param uses_match_flags Whether each row should be prefixed with a match
   ///   flag, saying whether the row had a matching row.
+  /// @param stores_join_keys Whether the join key of each row should be stored
+  ///   in front of the row, so that the chunk can be joined without evaluating
+  ///   the join conditions (see ParallelChunkJoin).
   ///
   /// @returns true if the initialization failed.
-  bool Init(const pack_rows::TableCollection &tables, bool uses_match_flags);
+  bool Init(const pack_rows::TableCollection &tables, bool uses_match_flags,
+            bool stores_join_keys);
 
   /// @returns the number of rows in this HashJoinChunk
   ha_rows num_rows() const { return m_num_rows; }
@@ -99,6 +104,8 @@ class HashJoinChunk {
   ///
   /// @param buffer a buffer that is used when copying data from the tables to
   ///   the chunk file. Note that any existing data in "buffer" is overwritten.
+  ///   If the chunk stores join keys, "buffer" must hold the join key of the
+  ///   row when this function is called.
   /// @param matched whether this row has seen a matching row from the other
   ///   input. The flag is only written if 'm_uses_match_flags' is set, and if
   ///   the row comes from the probe input.
@@ -121,11 +128,29 @@ class HashJoinChunk {
   /// @retval true on error.
   bool LoadRowFromChunk(String *buffer, bool *matched);
 
+  /// Read a row from the HashJoinChunk without putting it in the record
+  /// buffers. Unlike the other functions in this class, this function (and
+  /// RewindQuietly()) does not call my_error() on failure, so that it can be
+  /// used from threads that do not have a THD.
+  ///
+  /// @param[out] join_key the join key of the row. Only set if the chunk
+  ///   stores join keys.
+  /// @param[out] row the row, as packed by StoreFromTableBuffers().
+  /// @param[out] matched the match flag of the row. Only set if
+  ///   'm_uses_match_flags' is set.
+  /// @retval true on error.
+  bool ReadRawRowFromChunk(String *join_key, String *row, bool *matched);
+
   /// Flush the file buffer, and prepare the file for reading.
   ///
   /// @retval true on error
   bool Rewind();
 
+  /// Same as Rewind(), but does not call my_error() on failure.
+  ///
+  /// @retval true on error
+  bool RewindQuietly();
+
  private:
   // A collection of which tables the chunk file holds data from. Used to
   // determine where to read data from, and where to put the data back.
@@ -139,6 +164,26 @@ class HashJoinChunk {
 
   // Whether every row is prefixed with a match flag.
   bool m_uses_match_flags{false};
+
+  // Whether every row is prefixed with its join key.
+  bool m_stores_join_keys{false};
+};
+
+// A pair of chunk files that hold the rows from the build and probe input
+// whose join keys hash to the same partition.
+struct ChunkPair {
+  HashJoinChunk probe_chunk;
+  HashJoinChunk build_chunk;
+
+  // The hashes of the join keys of all rows in build_chunk, used for dropping
+  // probe rows that cannot have a match instead of writing them to
+  // probe_chunk. Not enabled if there was not enough memory for it.
+  BloomFilter build_keys;
+
+  // How many times the rows in this chunk pair have been partitioned after
+  // the initial partitioning, because the build chunk was too large to fit in
+  // memory. The level decides the hash seed used for partitioning.
+  int repartitioning_level{0};
 };
 
 #endif  // SQL_ITERATORS_HASH_JOIN_CHUNK_H_
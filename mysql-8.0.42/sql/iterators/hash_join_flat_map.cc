@@ -0,0 +1,240 @@
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include "sql/iterators/hash_join_flat_map.h"
+
+#include <assert.h>
+#include <string.h>
+#include <new>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HAVE_FLAT_MAP_SSE2
+#endif
+
+#include <ankerl/unordered_dense.h>
+
+#include "my_sys.h"
+#include "mysql/service_mysql_alloc.h"
+#include "sql/join_optimizer/bit_utils.h"
+#include "sql/psi_memory_key.h"
+
+namespace hash_join_buffer {
+
+namespace {
+
+// The control byte of an empty slot. Full slots have a fingerprint between 0
+// and 127.
+constexpr int8_t kEmpty = -128;
+
+// Keys are looked up this many keys after their control bytes are prefetched,
+// and again this many keys after the matching slots are prefetched.
+constexpr size_t kPrefetchDistance = 8;
+
+inline int8_t Fingerprint(uint64_t hash) { return hash & 0x7f; }
+
+// Returns a bitmap with bit i set if control byte number i in the group
+// equals "value".
+inline uint32_t MatchControlBytes(const int8_t *group, int8_t value) {
+#ifdef HAVE_FLAT_MAP_SSE2
+  const __m128i control =
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+  return static_cast<uint32_t>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(value), control)));
+#else
+  uint32_t mask = 0;
+  for (size_t i = 0; i < FlatHashMap::kGroupSize; ++i) {
+    mask |= uint32_t{group[i] == value} << i;
+  }
+  return mask;
+#endif
+}
+
+inline void Prefetch(const void *addr [[maybe_unused]]) {
+#if defined(__GNUC__)
+  __builtin_prefetch(addr, 0, 3);
+#endif
+}
+
+}  // namespace
+
+FlatHashMap::~FlatHashMap() { my_free(m_slots); }
+
+uint64_t FlatHashMap::Hash(std::string_view key) {
+  return ankerl::unordered_dense::hash<std::string_view>()(key);
+}
+
+size_t FlatHashMap::bytes_used() const {
+  return m_num_groups * kGroupSize * (sizeof(Slot) + sizeof(*m_control));
+}
+
+LinkedImmutableString FlatHashMap::find(uint64_t hash,
+                                        std::string_view key) const {
+  if (m_num_groups == 0) return LinkedImmutableString{nullptr};
+
+  const int8_t fingerprint = Fingerprint(hash);
+  size_t group = FirstGroup(hash);
+  for (size_t step = 1;; ++step) {
+    const int8_t *control = m_control + group * kGroupSize;
+    for (size_t idx : BitsSetIn(MatchControlBytes(control, fingerprint))) {
+      const Slot &slot = m_slots[group * kGroupSize + idx];
+      if (slot.hash == hash && slot.key.Decode() == key) {
+        return slot.value;
+      }
+    }
+    // The key would have been inserted into the first empty slot on its probe
+    // sequence, and nothing is ever deleted; so if there is an empty slot in
+    // this group, the key is not in the table. The table is never full, so we
+    // will find an empty slot eventually.
+    if (MatchControlBytes(control, kEmpty) != 0) {
+      return LinkedImmutableString{nullptr};
+    }
+    group = (group + step) & (m_num_groups - 1);
+  }
+}
+
+void FlatHashMap::PrefetchGroup(uint64_t hash) const {
+  if (m_num_groups == 0) return;
+  Prefetch(m_control + FirstGroup(hash) * kGroupSize);
+}
+
+void FlatHashMap::FindBatch(const uint64_t *hashes,
+                            const std::string_view *keys, size_t num_keys,
+                            LinkedImmutableString *rows) const {
+  // A software pipeline with three stages, each kPrefetchDistance keys
+  // apart: prefetch the control bytes of the first group on the probe
+  // sequence, then prefetch the slots that have a matching fingerprint (the
+  // control bytes should be in the cache by now), and finally do the lookup.
+  for (size_t i = 0; i < num_keys + 2 * kPrefetchDistance; ++i) {
+    if (i < num_keys) {
+      PrefetchGroup(hashes[i]);
+    }
+    if (i >= kPrefetchDistance && i - kPrefetchDistance < num_keys &&
+        m_num_groups > 0) {
+      const uint64_t hash = hashes[i - kPrefetchDistance];
+      const size_t group = FirstGroup(hash);
+      for (size_t idx : BitsSetIn(MatchControlBytes(
+               m_control + group * kGroupSize, Fingerprint(hash)))) {
+        Prefetch(&m_slots[group * kGroupSize + idx]);
+      }
+    }
+    if (i >= 2 * kPrefetchDistance) {
+      const size_t key_idx = i - 2 * kPrefetchDistance;
+      rows[key_idx] = find(hashes[key_idx], keys[key_idx]);
+    }
+  }
+}
+
+std::pair<LinkedImmutableString *, bool> FlatHashMap::emplace(
+    uint64_t hash, ImmutableStringWithLength key) {
+  const std::string_view decoded_key = key.Decode();
+  const int8_t fingerprint = Fingerprint(hash);
+
+  // See if the key is in the table already.
+  if (m_num_groups > 0) {
+    size_t group = FirstGroup(hash);
+    for (size_t step = 1;; ++step) {
+      const int8_t *control = m_control + group * kGroupSize;
+      for (size_t idx : BitsSetIn(MatchControlBytes(control, fingerprint))) {
+        Slot &slot = m_slots[group * kGroupSize + idx];
+        if (slot.hash == hash && slot.key.Decode() == decoded_key) {
+          return {&slot.value, false};
+        }
+      }
+      if (MatchControlBytes(control, kEmpty) != 0) break;
+      group = (group + step) & (m_num_groups - 1);
+    }
+  }
+
+  if (m_growth_left == 0 && Grow()) {
+    return {nullptr, false};
+  }
+
+  // Insert into the first empty slot on the probe sequence.
+  size_t group = FirstGroup(hash);
+  for (size_t step = 1;; ++step) {
+    int8_t *control = m_control + group * kGroupSize;
+    const uint32_t empty_slots = MatchControlBytes(control, kEmpty);
+    if (empty_slots != 0) {
+      const size_t idx = FindLowestBitSet(empty_slots);
+      control[idx] = fingerprint;
+      Slot *slot = new (&m_slots[group * kGroupSize + idx])
+          Slot{hash, key, LinkedImmutableString{nullptr}};
+      ++m_size;
+      --m_growth_left;
+      return {&slot->value, true};
+    }
+    group = (group + step) & (m_num_groups - 1);
+  }
+}
+
+bool FlatHashMap::Grow() {
+  const size_t new_num_groups = m_num_groups == 0 ? 1 : m_num_groups * 2;
+  const size_t new_capacity = new_num_groups * kGroupSize;
+  void *memory =
+      my_malloc(key_memory_hash_join,
+                new_capacity * (sizeof(Slot) + sizeof(*m_control)), MYF(0));
+  if (memory == nullptr) return true;
+
+  Slot *old_slots = m_slots;
+  const int8_t *old_control = m_control;
+  const size_t old_capacity = m_num_groups * kGroupSize;
+
+  m_slots = static_cast<Slot *>(memory);
+  m_control = reinterpret_cast<int8_t *>(m_slots + new_capacity);
+  memset(m_control, kEmpty, new_capacity);
+  m_num_groups = new_num_groups;
+
+  // Move all the keys over to the new slots. There are no duplicates, and the
+  // hash values are stored, so there is no need to look at the keys.
+  for (size_t i = 0; i < old_capacity; ++i) {
+    if (old_control[i] == kEmpty) continue;
+    const Slot &old_slot = old_slots[i];
+    size_t group = FirstGroup(old_slot.hash);
+    for (size_t step = 1;; ++step) {
+      int8_t *control = m_control + group * kGroupSize;
+      const uint32_t empty_slots = MatchControlBytes(control, kEmpty);
+      if (empty_slots != 0) {
+        const size_t idx = FindLowestBitSet(empty_slots);
+        control[idx] = old_control[i];
+        new (&m_slots[group * kGroupSize + idx]) Slot(old_slot);
+        break;
+      }
+      group = (group + step) & (m_num_groups - 1);
+    }
+  }
+  my_free(old_slots);
+
+  // Keep the load factor at or below 7/8, so that probe sequences stay short.
+  m_growth_left = new_capacity - new_capacity / 8 - m_size;
+  return false;
+}
+
+LinkedImmutableString FlatHashMap::first_value() const {
+  for (size_t i = 0; i < m_num_groups * kGroupSize; ++i) {
+    if (m_control[i] != kEmpty) return m_slots[i].value;
+  }
+  return LinkedImmutableString{nullptr};
+}
+
+}  // namespace hash_join_buffer
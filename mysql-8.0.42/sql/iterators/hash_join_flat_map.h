@@ -0,0 +1,153 @@
+#ifndef SQL_ITERATORS_HASH_JOIN_FLAT_MAP_H_
+#define SQL_ITERATORS_HASH_JOIN_FLAT_MAP_H_
+
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/// @file
+///
+/// This file contains the FlatHashMap class, an alternative hash table for
+/// HashJoinRowBuffer.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+#include <utility>
+
+#include "sql/immutable_string.h"
+
+namespace hash_join_buffer {
+
+/**
+  A flat, open-addressing hash table from join keys to chains of rows, laid
+  out for few cache misses per lookup.
+
+  The table is an array of slots, divided into groups of kGroupSize slots.
+  In addition to the slots, there is one control byte per slot, which is
+  either kEmpty or the lowest seven bits of the key's hash value (the
+  fingerprint). A lookup computes the group to start in from the rest of the
+  hash value, and compares the fingerprint against all the control bytes of a
+  group at once (using SSE2 where available). Only slots with a matching
+  fingerprint are looked at, and each slot stores the complete hash value, so
+  the key itself (which lives on the MEM_ROOT of the HashJoinRowBuffer) is
+  only read when the hash values are equal. If a group has no empty slots and
+  no match, the search continues in the next group of a triangular probe
+  sequence.
+
+  Since a hash join never removes anything from its hash table, there are no
+  tombstones; the table is only ever inserted into, grown and cleared.
+
+  For probing many keys at a time, FindBatch() first prefetches the control
+  bytes and slots of upcoming keys, so that the cache misses of several
+  lookups overlap.
+ */
+class FlatHashMap {
+ public:
+  /// The number of slots whose control bytes are matched at a time.
+  static constexpr size_t kGroupSize = 16;
+
+  FlatHashMap() = default;
+  ~FlatHashMap();
+
+  FlatHashMap(const FlatHashMap &) = delete;
+  FlatHashMap &operator=(const FlatHashMap &) = delete;
+
+  /// @returns the hash value of the given key. All keys passed to this class
+  /// must be hashed with this function.
+  static uint64_t Hash(std::string_view key);
+
+  /**
+    Insert the given key, with an empty chain of rows, unless the key is
+    already in the table.
+
+    @param hash the hash value of the key, as returned by Hash().
+    @param key the key. Must outlive the table.
+
+    @returns a pointer to the chain of rows for the key (which stays valid
+      until the next insertion), and whether the key was inserted. The
+      pointer is nullptr if the table could not grow.
+   */
+  std::pair<LinkedImmutableString *, bool> emplace(
+      uint64_t hash, ImmutableStringWithLength key);
+
+  /// Look up the given key. @returns the chain of rows for the key, or nullptr
+  /// if the key is not in the table.
+  LinkedImmutableString find(uint64_t hash, std::string_view key) const;
+
+  /**
+    Look up many keys at a time, prefetching ahead.
+
+    @param hashes the hash values of the keys.
+    @param keys the keys to look up.
+    @param num_keys the number of keys.
+    @param[out] rows for each key, the chain of rows for the key, or nullptr if
+      the key is not in the table.
+   */
+  void FindBatch(const uint64_t *hashes, const std::string_view *keys,
+                 size_t num_keys, LinkedImmutableString *rows) const;
+
+  /// @returns the chain of rows of an arbitrary key, or nullptr if the table
+  /// is empty.
+  LinkedImmutableString first_value() const;
+
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  /// @returns the number of bytes allocated for the slots and control bytes.
+  size_t bytes_used() const;
+
+ private:
+  struct Slot {
+    uint64_t hash;
+    ImmutableStringWithLength key;
+    LinkedImmutableString value;
+  };
+
+  /// Make room for at least one more key. @retval true on out of memory.
+  bool Grow();
+
+  /// @returns the group where the probe sequence for the hash value starts.
+  size_t FirstGroup(uint64_t hash) const {
+    return (hash >> 7) & (m_num_groups - 1);
+  }
+
+  /// Prefetch the first group of the probe sequence for the hash value.
+  void PrefetchGroup(uint64_t hash) const;
+
+  /// The control bytes, kGroupSize for each group. Allocated together with
+  /// m_slots.
+  int8_t *m_control{nullptr};
+  Slot *m_slots{nullptr};
+
+  /// The number of groups. Always zero or a power of two.
+  size_t m_num_groups{0};
+
+  size_t m_size{0};
+
+  /// The number of keys that can be inserted before the table must grow.
+  size_t m_growth_left{0};
+};
+
+}  // namespace hash_join_buffer
+
+#endif  // SQL_ITERATORS_HASH_JOIN_FLAT_MAP_H_
@@ -40,6 +40,7 @@
 #include "my_sys.h"
 #include "mysql/components/services/bits/psi_bits.h"
 #include "mysqld_error.h"
+#include "sql/handler.h"
 #include "sql/item.h"
 #include "sql/item_cmpfunc.h"
 #include "sql/iterators/hash_join_buffer.h"
@@ -49,6 +50,7 @@
 #include "sql/sql_list.h"
 #include "sql/system_variables.h"
 #include "sql/table.h"
+#include "template_utils.h"
 
 using hash_join_buffer::LoadBufferRowIntoTableBuffers;
 using hash_join_buffer::LoadImmutableStringIntoTableBuffers;
@@ -80,13 +82,16 @@ HashJoinIterator::HashJoinIterator(
                            tables_to_get_rowid_for,
                            /*tables_to_store_contents_of_null_rows_for=*/0),
       m_tables_to_get_rowid_for(tables_to_get_rowid_for),
-      m_row_buffer(m_build_input_tables, join_conditions, max_memory_available),
+      m_row_buffer(m_build_input_tables, join_conditions, max_memory_available,
+                   static_cast<hash_join_buffer::HashTableType>(
+                       thd->variables.hash_join_table_type)),
       m_join_conditions(PSI_NOT_INSTRUMENTED, join_conditions.data(),
                         join_conditions.data() + join_conditions.size()),
       m_chunk_files_on_disk(thd->mem_root, kMaxChunks),
       m_estimated_build_rows(estimated_build_rows),
       m_probe_input_batch_mode(probe_input_batch_mode),
       m_allow_spill_to_disk(allow_spill_to_disk),
+      m_max_memory_available(max_memory_available),
       m_join_type(join_type) {
   assert(m_build_input != nullptr);
   assert(m_probe_input != nullptr);
@@ -105,6 +110,29 @@ HashJoinIterator::HashJoinIterator(
     m_extra_condition->update_used_tables();
     m_extra_condition->apply_is_true();
   }
+
+  // See if one of the join conditions can be used for filtering the probe
+  // table while it is scanned. Outer joins and antijoins must see all the
+  // probe rows, including the ones that do not match.
+  if ((m_join_type == JoinType::INNER || m_join_type == JoinType::SEMI) &&
+      probe_input_tables.size() == 1) {
+    for (const HashJoinCondition &condition : m_join_conditions) {
+      if (condition.null_equals_null()) continue;
+      const bool left_is_build = condition.left_uses_any_table(
+          m_build_input_tables.tables_bitmap());
+      Item *build_side = left_is_build ? condition.left_extractor()
+                                       : condition.right_extractor();
+      Item *probe_side = left_is_build ? condition.right_extractor()
+                                       : condition.left_extractor();
+      if (RuntimeFilter::IsSupportedCondition(probe_side, build_side,
+                                              probe_input_tables[0])) {
+        m_runtime_filter.emplace(
+            down_cast<Item_field *>(probe_side->real_item())->field,
+            build_side);
+        break;
+      }
+    }
+  }
 }
 
 bool HashJoinIterator::InitRowBuffer() {
@@ -134,17 +162,52 @@ static void MarkCopyBlobsIfTableContainsGeometry(
 bool HashJoinIterator::InitProbeIterator() {
   assert(m_state == State::READING_ROW_FROM_PROBE_ITERATOR);
 
+  PushRuntimeFilter();
   if (m_probe_input->Init()) {
     return true;
   }
 
+  // Batched lookups only pay off with a hash table that can prefetch.
+  const bool batch_probe_input =
+      m_row_buffer.table_type() == hash_join_buffer::HashTableType::FLAT &&
+      !m_join_conditions.empty();
+  if (m_probe_batch.Init(
+          &m_probe_input_tables,
+          batch_probe_input ? thd()->variables.iterator_batch_size : 0)) {
+    return true;
+  }
+  m_next_probe_row_in_batch = 0;
+  m_probe_batch_end_of_records = false;
+
   if (m_probe_input_batch_mode) {
     m_probe_input->StartPSIBatchMode();
   }
   return false;
 }
 
+void HashJoinIterator::PushRuntimeFilter() {
+  // If the hash table is refilled without spilling to disk, the probe input
+  // is read once for each refill, and only the last time around do we know
+  // all the values from the build input. If we spilled to disk, the build
+  // input was read to the end before we started reading the probe input.
+  if (!m_use_runtime_filter || m_runtime_filter_pushed ||
+      (m_build_iterator_has_more_rows && m_chunk_files_on_disk.empty())) {
+    return;
+  }
+  m_runtime_filter->Push();
+  m_runtime_filter_pushed = true;
+}
+
+void HashJoinIterator::RemoveRuntimeFilter() {
+  if (!m_runtime_filter_pushed) return;
+  m_runtime_filter->Remove();
+  m_runtime_filter_pushed = false;
+}
+
 bool HashJoinIterator::Init() {
+  // The runtime filter must not be used while it is being rebuilt.
+  RemoveRuntimeFilter();
+
   // If we are entirely in-memory and the JOIN we are part of hasn't been
   // asked to clear its hash tables since last time, we can reuse the table
   // without having to rebuild it. This is useful if we are on the right side
@@ -183,6 +246,10 @@ bool HashJoinIterator::Init() {
            thd()->killed);  // my_error should have been called.
     return true;
   }
+  if (m_build_batch.Init(&m_build_input_tables,
+                         thd()->variables.iterator_batch_size)) {
+    return true;
+  }
 
   // We always start out by doing everything in memory.
   m_hash_join_type = HashJoinType::IN_MEMORY;
@@ -221,8 +288,20 @@ bool HashJoinIterator::Init() {
   MarkCopyBlobsIfTableContainsGeometry(m_probe_input_tables);
   MarkCopyBlobsIfTableContainsGeometry(m_build_input_tables);
 
-  // Close any leftover files from previous iterations.
+  // Close any leftover files from previous iterations. Any worker threads from
+  // a previous iteration must be stopped first, as they may be reading from
+  // the files.
+  m_parallel_chunk_join.End();
+  m_join_chunks_in_parallel = false;
   m_chunk_files_on_disk.clear();
+  m_chunk_mem_root.ClearForReuse();
+
+  m_use_runtime_filter = m_runtime_filter.has_value() &&
+                         thd()->variables.hash_join_runtime_filters;
+  if (m_use_runtime_filter) {
+    m_runtime_filter->Reset(&m_chunk_mem_root, m_estimated_build_rows,
+                            MaxBloomFilterBytes());
+  }
 
   m_build_chunk_current_row = 0;
   m_probe_chunk_current_row = 0;
@@ -285,12 +364,18 @@ static bool ConstructJoinKey(
 // (record[0]) for each involved table. The row is put into one of the chunks in
 // the input vector "chunks"; which chunk to use is decided by the hash value of
 // the join attribute.
+//
+// The hash value of the join key of a build row is added to the Bloom filter
+// of the chunk pair. If "pruned" is not nullptr, a probe row is not written at
+// all if the Bloom filter says that the build chunk has no row with the same
+// join key; *pruned is set to true in that case.
 static bool WriteRowToChunk(
     THD *thd, Mem_root_array<ChunkPair> *chunks, bool write_to_build_chunk,
     const pack_rows::TableCollection &tables,
     const Prealloced_array<HashJoinCondition, 4> &join_conditions,
     const uint32 xxhash_seed, bool row_has_match,
-    bool store_row_with_null_in_join_key, String *join_key_and_row_buffer) {
+    bool store_row_with_null_in_join_key, String *join_key_and_row_buffer,
+    bool *pruned = nullptr) {
   assert(!thd->is_error());
   bool null_in_join_key = ConstructJoinKey(
       thd, join_conditions, tables.tables_bitmap(), join_key_and_row_buffer);
@@ -315,25 +400,37 @@ static bool WriteRowToChunk(
   const size_t chunk_index = join_key_hash & (chunks->size() - 1);
   ChunkPair &chunk_pair = (*chunks)[chunk_index];
   if (write_to_build_chunk) {
+    if (chunk_pair.build_keys.is_enabled()) {
+      chunk_pair.build_keys.Insert(join_key_hash);
+    }
     return chunk_pair.build_chunk.WriteRowToChunk(join_key_and_row_buffer,
                                                   row_has_match);
   } else {
+    if (pruned != nullptr && chunk_pair.build_keys.is_enabled() &&
+        !chunk_pair.build_keys.MayContain(join_key_hash)) {
+      *pruned = true;
+      return false;
+    }
     return chunk_pair.probe_chunk.WriteRowToChunk(join_key_and_row_buffer,
                                                   row_has_match);
   }
 }
 
 // Write all the remaining rows from the given iterator out to chunk files
-// on disk. If the function returns true, an unrecoverable error occurred
-// (IO error etc.).
+// on disk. If "batch" is not nullptr, the rows are read through it (including
+// any rows that are left in it). If "runtime_filter" is not nullptr, each row
+// is added to it. If the function returns true, an unrecoverable error
+// occurred (IO error etc.).
 static bool WriteRowsToChunks(
-    THD *thd, RowIterator *iterator, const pack_rows::TableCollection &tables,
+    THD *thd, RowIterator *iterator, RowBatch *batch,
+    const pack_rows::TableCollection &tables,
     const Prealloced_array<HashJoinCondition, 4> &join_conditions,
     const uint32 xxhash_seed, Mem_root_array<ChunkPair> *chunks,
     bool write_to_build_chunk, bool write_rows_with_null_in_join_key,
-    table_map tables_to_get_rowid_for, String *join_key_buffer) {
+    table_map tables_to_get_rowid_for, String *join_key_buffer,
+    RuntimeFilter *runtime_filter = nullptr) {
   for (;;) {  // Termination condition within loop.
-    int res = iterator->Read();
+    int res = batch != nullptr ? batch->ReadRow(iterator) : iterator->Read();
     if (res == 1) {
       assert(thd->is_error() ||
              thd->killed);  // my_error should have been called.
@@ -347,6 +444,9 @@ static bool WriteRowsToChunks(
     assert(res == 0);
 
     RequestRowId(tables.tables(), tables_to_get_rowid_for);
+    if (runtime_filter != nullptr) {
+      runtime_filter->AddBuildRow();
+    }
     if (WriteRowToChunk(thd, chunks, write_to_build_chunk, tables,
                         join_conditions, xxhash_seed, /*row_has_match=*/false,
                         write_rows_with_null_in_join_key, join_key_buffer)) {
@@ -367,12 +467,20 @@ static bool WriteRowsToChunks(
 // instead of having to re-read the probe input multiple times. We limit the
 // number of chunks per input, so we don't risk hitting the server's limit for
 // number of open files.
+//
+// Each chunk pair also gets a Bloom filter for the join keys of the build rows,
+// sized for the estimated number of rows per chunk, and allocated on
+// "bloom_filter_mem_root". The filters use at most "max_bloom_filter_bytes" in
+// total; if they cannot be allocated, the chunks just go without.
 static bool InitializeChunkFiles(size_t estimated_rows_produced_by_join,
                                  size_t rows_in_hash_table,
                                  size_t max_chunk_files,
                                  const pack_rows::TableCollection &probe_tables,
                                  const pack_rows::TableCollection &build_tables,
                                  bool include_match_flag_for_probe,
+                                 bool store_join_keys,
+                                 MEM_ROOT *bloom_filter_mem_root,
+                                 size_t max_bloom_filter_bytes,
                                  Mem_root_array<ChunkPair> *chunk_pairs) {
   constexpr double kReductionFactor = 0.9;
   const double reduced_rows_in_hash_table =
@@ -396,12 +504,17 @@ static bool InitializeChunkFiles(size_t estimated_rows_produced_by_join,
   assert(chunk_pairs != nullptr && chunk_pairs->empty());
   chunk_pairs->resize(num_chunks_pow_2);
   for (ChunkPair &chunk_pair : *chunk_pairs) {
-    if (chunk_pair.build_chunk.Init(build_tables, /*uses_match_flags=*/false) ||
-        chunk_pair.probe_chunk.Init(probe_tables,
-                                    include_match_flag_for_probe)) {
+    if (chunk_pair.build_chunk.Init(build_tables, /*uses_match_flags=*/false,
+                                    store_join_keys) ||
+        chunk_pair.probe_chunk.Init(probe_tables, include_match_flag_for_probe,
+                                    store_join_keys)) {
       my_error(ER_TEMP_FILE_WRITE_FAILURE, MYF(0));
       return true;
     }
+    // An out-of-memory error only means that the chunk gets no Bloom filter.
+    chunk_pair.build_keys.Init(bloom_filter_mem_root,
+                               remaining_rows / num_chunks_pow_2 + 1,
+                               max_bloom_filter_bytes / num_chunks_pow_2);
   }
 
   return false;
@@ -451,7 +564,7 @@ bool HashJoinIterator::BuildHashTable() {
 
   PFSBatchMode batch_mode(m_build_input.get());
   for (;;) {  // Termination condition within loop.
-    int res = m_build_input->Read();
+    int res = ReadRowFromBuildIterator();
     if (res == 1) {
       assert(thd()->is_error() ||
              thd()->killed);  // my_error should have been called.
@@ -479,6 +592,9 @@ bool HashJoinIterator::BuildHashTable() {
     }
     assert(res == 0);
     RequestRowId(m_build_input_tables.tables(), m_tables_to_get_rowid_for);
+    if (m_use_runtime_filter) {
+      m_runtime_filter->AddBuildRow();
+    }
 
     const hash_join_buffer::StoreRowResult store_row_result =
         m_row_buffer.StoreRow(thd(), reject_duplicate_keys);
@@ -505,10 +621,13 @@ bool HashJoinIterator::BuildHashTable() {
           return false;
         }
 
+        m_join_chunks_in_parallel = ShouldJoinChunksInParallel();
         if (InitializeChunkFiles(
                 m_estimated_build_rows, m_row_buffer.size(), kMaxChunks,
                 m_probe_input_tables, m_build_input_tables,
                 /*include_match_flag_for_probe=*/m_join_type == JoinType::OUTER,
+                /*store_join_keys=*/m_join_chunks_in_parallel,
+                &m_chunk_mem_root, MaxBloomFilterBytes(),
                 &m_chunk_files_on_disk)) {
           assert(thd()->is_error());  // my_error should have been called.
           return true;
@@ -526,13 +645,18 @@ bool HashJoinIterator::BuildHashTable() {
         //
         // We never write out rows with NULL in condition for the build/right
         // input, as these rows will never match in a join condition.
-        if (WriteRowsToChunks(thd(), m_build_input.get(), m_build_input_tables,
-                              m_join_conditions, kChunkPartitioningHashSeed,
+        if (WriteRowsToChunks(thd(), m_build_input.get(),
+                              m_build_batch.is_enabled() ? &m_build_batch
+                                                         : nullptr,
+                              m_build_input_tables, m_join_conditions,
+                              kChunkPartitioningHashSeed,
                               &m_chunk_files_on_disk,
                               true /* write_to_build_chunks */,
                               false /* write_rows_with_null_in_join_key */,
                               m_tables_to_get_rowid_for,
-                              &m_temporary_row_and_join_key_buffer)) {
+                              &m_temporary_row_and_join_key_buffer,
+                              m_use_runtime_filter ? &*m_runtime_filter
+                                                   : nullptr)) {
           assert(thd()->is_error() ||
                  thd()->killed);  // my_error should have been called.
           return true;
@@ -562,6 +686,125 @@ bool HashJoinIterator::BuildHashTable() {
   }
 }
 
+bool HashJoinIterator::RepartitionCurrentChunkPair(ha_rows rows_that_fit,
+                                                   bool *repartitioned) {
+  *repartitioned = false;
+  const int level = m_chunk_files_on_disk[m_current_chunk].repartitioning_level;
+  if (level >= kMaxRepartitioningLevel) {
+    return false;
+  }
+
+  // The chunk pairs after the current one are still open, and so will the new
+  // ones be. Respect the limit on the number of open chunk pairs; the current
+  // pair is closed before the new ones are needed.
+  const size_t open_chunk_pairs =
+      m_chunk_files_on_disk.size() - m_current_chunk - 1;
+  if (open_chunk_pairs + 2 > kMaxChunks) {
+    return false;
+  }
+  // InitializeChunkFiles() rounds up to a power of two, so round down here.
+  const size_t max_new_chunk_pairs =
+      my_round_up_to_next_power(kMaxChunks - open_chunk_pairs + 1) / 2;
+
+  HashJoinChunk &build_chunk =
+      m_chunk_files_on_disk[m_current_chunk].build_chunk;
+  HashJoinChunk &probe_chunk =
+      m_chunk_files_on_disk[m_current_chunk].probe_chunk;
+
+  // All the rows of the build chunk are partitioned anew, including the ones
+  // in the hash table. InitializeChunkFiles() sizes the new chunks from the
+  // number of rows that are still to be written and the number of rows that
+  // fit in the hash table, so pass "rows_that_fit" as the hash table's row
+  // count and add it to the estimate to make every build row count as
+  // remaining.
+  Mem_root_array<ChunkPair> new_chunk_pairs(&m_chunk_mem_root);
+  if (InitializeChunkFiles(
+          build_chunk.num_rows() + rows_that_fit, rows_that_fit,
+          max_new_chunk_pairs, m_probe_input_tables, m_build_input_tables,
+          /*include_match_flag_for_probe=*/m_join_type == JoinType::OUTER,
+          /*store_join_keys=*/false, &m_chunk_mem_root, MaxBloomFilterBytes(),
+          &new_chunk_pairs)) {
+    return true;
+  }
+  if (new_chunk_pairs.size() < 2) {
+    return false;
+  }
+
+  // Partition with a different hash seed than the one that put all of these
+  // rows into the same chunk pair.
+  const uint32 seed = kChunkPartitioningHashSeed + level + 1;
+
+  if (build_chunk.Rewind()) {
+    return true;
+  }
+  for (ha_rows i = 0; i < build_chunk.num_rows(); ++i) {
+    if (build_chunk.LoadRowFromChunk(&m_temporary_row_and_join_key_buffer,
+                                     /*matched=*/nullptr) ||
+        WriteRowToChunk(thd(), &new_chunk_pairs, /*write_to_build_chunk=*/true,
+                        m_build_input_tables, m_join_conditions, seed,
+                        /*row_has_match=*/false,
+                        /*store_row_with_null_in_join_key=*/false,
+                        &m_temporary_row_and_join_key_buffer)) {
+      assert(thd()->is_error());  // my_error should have been called.
+      return true;
+    }
+  }
+
+  if (probe_chunk.Rewind()) {
+    return true;
+  }
+  const bool store_row_with_null_in_join_key =
+      m_join_type == JoinType::OUTER || m_join_type == JoinType::ANTI;
+  for (ha_rows i = 0; i < probe_chunk.num_rows(); ++i) {
+    bool matched = false;
+    if (probe_chunk.LoadRowFromChunk(&m_temporary_row_and_join_key_buffer,
+                                     &matched)) {
+      assert(thd()->is_error());  // my_error should have been called.
+      return true;
+    }
+    // Rows that cannot match anything can be dropped, unless they are to be
+    // returned NULL-complemented (which we cannot do from here).
+    bool pruned = false;
+    const bool can_prune = m_join_type == JoinType::INNER ||
+                           m_join_type == JoinType::SEMI || matched;
+    if (WriteRowToChunk(thd(), &new_chunk_pairs,
+                        /*write_to_build_chunk=*/false, m_probe_input_tables,
+                        m_join_conditions, seed, matched,
+                        store_row_with_null_in_join_key,
+                        &m_temporary_row_and_join_key_buffer,
+                        can_prune ? &pruned : nullptr)) {
+      assert(thd()->is_error());  // my_error should have been called.
+      return true;
+    }
+  }
+
+  for (ChunkPair &chunk_pair : new_chunk_pairs) {
+    if (chunk_pair.build_chunk.Rewind()) {
+      return true;
+    }
+    // If all the rows ended up in the same chunk, they probably have the same
+    // join key, and partitioning them again would not help.
+    chunk_pair.repartitioning_level =
+        chunk_pair.build_chunk.num_rows() == build_chunk.num_rows()
+            ? kMaxRepartitioningLevel
+            : level + 1;
+  }
+
+  // Close the files of the current chunk pair, and add the new chunk pairs to
+  // the end of the list (which may move the current one).
+  build_chunk = HashJoinChunk();
+  probe_chunk = HashJoinChunk();
+  for (ChunkPair &chunk_pair : new_chunk_pairs) {
+    if (m_chunk_files_on_disk.push_back(std::move(chunk_pair))) {
+      my_error(ER_OUTOFMEMORY, MYF(ME_FATALERROR), sizeof(ChunkPair));
+      return true;
+    }
+  }
+  m_build_chunk_current_row = 0;
+  *repartitioned = true;
+  return false;
+}
+
 bool HashJoinIterator::ReadNextHashJoinChunk() {
   // See if we should proceed to the next pair of chunk files. In general,
   // it works like this; if we are at the end of the build chunk, move to the
@@ -582,6 +825,12 @@ bool HashJoinIterator::ReadNextHashJoinChunk() {
   }
 
   if (move_to_next_chunk) {
+    if (m_current_chunk != -1) {
+      // We are done with this chunk pair, so close (and delete) its files.
+      ChunkPair &done_chunk_pair = m_chunk_files_on_disk[m_current_chunk];
+      done_chunk_pair.build_chunk = HashJoinChunk();
+      done_chunk_pair.probe_chunk = HashJoinChunk();
+    }
     m_current_chunk++;
     m_build_chunk_current_row = 0;
 
@@ -603,6 +852,7 @@ bool HashJoinIterator::ReadNextHashJoinChunk() {
   HashJoinChunk &build_chunk =
       m_chunk_files_on_disk[m_current_chunk].build_chunk;
 
+  const bool first_load_of_chunk = m_build_chunk_current_row == 0;
   const bool reject_duplicate_keys = RejectDuplicateKeys();
   for (; m_build_chunk_current_row < build_chunk.num_rows();
        ++m_build_chunk_current_row) {
@@ -627,6 +877,23 @@ bool HashJoinIterator::ReadNextHashJoinChunk() {
       // Since the last row read was actually stored in the buffer, increment
       // the row counter manually before breaking out of the loop.
       ++m_build_chunk_current_row;
+
+      if (first_load_of_chunk &&
+          m_build_chunk_current_row < build_chunk.num_rows()) {
+        // The build chunk does not fit in memory. Rather than reading the
+        // probe chunk once for every hash table refill, try to split the
+        // chunk pair into smaller ones.
+        bool repartitioned;
+        if (RepartitionCurrentChunkPair(m_build_chunk_current_row,
+                                        &repartitioned)) {
+          return true;
+        }
+        if (repartitioned) {
+          // The current chunk pair is empty now, so go on to the next one.
+          m_state = State::LOADING_NEXT_CHUNK_PAIR;
+          return false;
+        }
+      }
       break;
     } else if (store_row_result ==
                hash_join_buffer::StoreRowResult::FATAL_ERROR) {
@@ -670,10 +937,73 @@ bool HashJoinIterator::ReadNextHashJoinChunk() {
   return false;
 }
 
+int HashJoinIterator::ReadRowFromProbeBatch() {
+  while (m_next_probe_row_in_batch == m_probe_batch.size()) {
+    // Restore the record buffers as the probe input left them, also at the
+    // end of records.
+    m_probe_batch.Clear();
+    m_next_probe_row_in_batch = 0;
+    if (m_probe_batch_end_of_records) {
+      return -1;
+    }
+
+    const int result = m_probe_input->ReadBatch(&m_probe_batch);
+    if (result == 1) {
+      return 1;
+    }
+    m_probe_batch_end_of_records = result == -1;
+
+    if (LookupProbeBatchInHashTable()) {
+      return 1;
+    }
+  }
+
+  m_probe_batch.LoadSelectedRow(m_next_probe_row_in_batch++);
+  return 0;
+}
+
+bool HashJoinIterator::LookupProbeBatchInHashTable() {
+  const size_t num_rows = m_probe_batch.size();
+  m_probe_batch_key_buffer.length(0);
+  m_probe_batch_key_ends.clear();
+  m_probe_batch_null_in_key.clear();
+  for (size_t i = 0; i < num_rows; ++i) {
+    m_probe_batch.LoadSelectedRow(i);
+    const bool null_in_join_key = ConstructJoinKey(
+        thd(), m_join_conditions, m_probe_input_tables.tables_bitmap(),
+        &m_temporary_row_and_join_key_buffer);
+    if (thd()->is_error()) {
+      return true;
+    }
+    if (m_probe_batch_key_buffer.append(m_temporary_row_and_join_key_buffer)) {
+      my_error(ER_OUTOFMEMORY, MYF(ME_FATALERROR),
+               m_temporary_row_and_join_key_buffer.length());
+      return true;
+    }
+    m_probe_batch_key_ends.push_back(m_probe_batch_key_buffer.length());
+    m_probe_batch_null_in_key.push_back(null_in_join_key);
+  }
+
+  // The key buffer does not move anymore, so now we can point into it.
+  m_probe_batch_keys.clear();
+  size_t key_start = 0;
+  for (size_t key_end : m_probe_batch_key_ends) {
+    m_probe_batch_keys.emplace_back(m_probe_batch_key_buffer.ptr() + key_start,
+                                    key_end - key_start);
+    key_start = key_end;
+  }
+
+  m_probe_batch_rows.assign(num_rows, LinkedImmutableString{nullptr});
+  m_row_buffer.find_batch(m_probe_batch_keys.data(), num_rows,
+                          m_probe_batch_rows.data());
+  return false;
+}
+
 bool HashJoinIterator::ReadRowFromProbeIterator() {
   assert(m_current_chunk == -1);
 
-  int result = m_probe_input->Read();
+  int result = m_probe_batch.is_enabled() ? ReadRowFromProbeBatch()
+                                          : m_probe_input->Read();
   if (result == 1) {
     assert(thd()->is_error() ||
            thd()->killed);  // my_error should have been called.
@@ -684,6 +1014,17 @@ bool HashJoinIterator::ReadRowFromProbeIterator() {
     RequestRowId(m_probe_input_tables.tables(), m_tables_to_get_rowid_for);
 
     // A row from the probe iterator is ready.
+    if (m_probe_batch.is_enabled()) {
+      // The row was looked up when the batch was read.
+      const size_t row_idx = m_next_probe_row_in_batch - 1;
+      if (m_probe_batch_null_in_key[row_idx]) {
+        SetStateForNullInProbeJoinKey();
+      } else {
+        m_current_row = m_probe_batch_rows[row_idx];
+        m_state = State::READING_FIRST_ROW_FROM_HASH_TABLE;
+      }
+      return false;
+    }
     LookupProbeRowInHashTable();
     if (thd()->is_error()) return true;
     return false;
@@ -691,6 +1032,7 @@ bool HashJoinIterator::ReadRowFromProbeIterator() {
 
   assert(result == -1);
   m_probe_input->EndPSIBatchModeIfStarted();
+  RemoveRuntimeFilter();
 
   // The probe iterator is out of rows. We may be in three different situations
   // here (ordered from most common to less common):
@@ -704,6 +1046,22 @@ bool HashJoinIterator::ReadRowFromProbeIterator() {
   //    re-populate the hash table with the remaining rows from the build input.
   if (m_allow_spill_to_disk) {
     m_hash_join_type = HashJoinType::SPILL_TO_DISK;
+    if (m_join_chunks_in_parallel && on_disk_hash_join()) {
+      // Let the worker threads join the chunk pairs. All the chunks are
+      // complete now; the workers rewind the probe chunks themselves.
+      for (ChunkPair &chunk_pair : m_chunk_files_on_disk) {
+        if (chunk_pair.build_chunk.Rewind()) {
+          return true;
+        }
+      }
+      if (m_parallel_chunk_join.Start(thd(), &m_chunk_files_on_disk,
+                                      thd()->variables.hash_join_threads,
+                                      m_max_memory_available)) {
+        return true;
+      }
+      m_state = State::READING_FROM_PARALLEL_CHUNK_JOIN;
+      return false;
+    }
     m_state = State::LOADING_NEXT_CHUNK_PAIR;
     return false;
   }
@@ -862,15 +1220,7 @@ void HashJoinIterator::LookupProbeRowInHashTable() {
       &m_temporary_row_and_join_key_buffer);
 
   if (null_in_join_key) {
-    if (m_join_type == JoinType::ANTI || m_join_type == JoinType::OUTER) {
-      // SQL NULL was found, and we will never find a matching row in the hash
-      // table. Let us indicate that, so that a null-complemented row is
-      // returned.
-      m_current_row = LinkedImmutableString{nullptr};
-      m_state = State::READING_FIRST_ROW_FROM_HASH_TABLE;
-    } else {
-      SetReadingProbeRowState();
-    }
+    SetStateForNullInProbeJoinKey();
     return;
   }
 
@@ -883,6 +1233,18 @@ void HashJoinIterator::LookupProbeRowInHashTable() {
   m_state = State::READING_FIRST_ROW_FROM_HASH_TABLE;
 }
 
+void HashJoinIterator::SetStateForNullInProbeJoinKey() {
+  if (m_join_type == JoinType::ANTI || m_join_type == JoinType::OUTER) {
+    // SQL NULL was found, and we will never find a matching row in the hash
+    // table. Let us indicate that, so that a null-complemented row is
+    // returned.
+    m_current_row = LinkedImmutableString{nullptr};
+    m_state = State::READING_FIRST_ROW_FROM_HASH_TABLE;
+  } else {
+    SetReadingProbeRowState();
+  }
+}
+
 int HashJoinIterator::ReadJoinedRow() {
   if (m_current_row == nullptr) {
     // Signal that we have reached the end of hash table entries. Let the caller
@@ -897,6 +1259,8 @@ int HashJoinIterator::ReadJoinedRow() {
 }
 
 bool HashJoinIterator::WriteProbeRowToDiskIfApplicable() {
+  m_probe_row_pruned = false;
+
   // If we are spilling to disk, we need to match the row against rows from
   // the build input that are written out to chunk files. So we need to write
   // the probe row to chunk files as well. Semijoin/antijoin has an exception to
@@ -920,12 +1284,16 @@ bool HashJoinIterator::WriteProbeRowToDiskIfApplicable() {
         // for left outer join and antijoin.
         const bool store_row_with_null_in_join_key =
             m_join_type == JoinType::OUTER || m_join_type == JoinType::ANTI;
+        // A probe row that cannot match any row in the build chunk is not
+        // written. If it needs to be NULL-complemented, that is done right
+        // away instead (see ReadNextJoinedRowFromHashTable()).
         if (WriteRowToChunk(thd(), &m_chunk_files_on_disk,
                             false /* write_to_build_chunk */,
                             m_probe_input_tables, m_join_conditions,
                             kChunkPartitioningHashSeed, found_match,
                             store_row_with_null_in_join_key,
-                            &m_temporary_row_and_join_key_buffer)) {
+                            &m_temporary_row_and_join_key_buffer,
+                            &m_probe_row_pruned)) {
           return true;
         }
       }
@@ -950,6 +1318,41 @@ bool HashJoinIterator::JoinedRowPassesExtraConditions() const {
   return true;
 }
 
+bool HashJoinIterator::ShouldJoinChunksInParallel() const {
+  // The worker threads match rows on the join key alone, so only inner joins
+  // with at least one join condition can be joined in parallel.
+  return m_join_type == JoinType::INNER && !m_join_conditions.empty() &&
+         thd()->variables.hash_join_threads > 1;
+}
+
+int HashJoinIterator::ReadJoinedRowFromParallelChunkJoin() {
+  for (;;) {
+    const String *build_row;
+    const String *probe_row;
+    const int res = m_parallel_chunk_join.Read(&build_row, &probe_row);
+    if (res != 0) {
+      return res;
+    }
+
+    hash_join_buffer::LoadBufferRowIntoTableBuffers(
+        m_build_input_tables, {build_row->ptr(), build_row->length()});
+    hash_join_buffer::LoadBufferRowIntoTableBuffers(
+        m_probe_input_tables, {probe_row->ptr(), probe_row->length()});
+
+    const bool passes_extra_conditions = JoinedRowPassesExtraConditions();
+    if (thd()->killed) {
+      thd()->send_kill_message();
+      return 1;
+    }
+    if (thd()->is_error()) {
+      return 1;
+    }
+    if (passes_extra_conditions) {
+      return 0;
+    }
+  }
+}
+
 int HashJoinIterator::ReadNextJoinedRowFromHashTable() {
   int res;
   bool passes_extra_conditions = false;
@@ -1005,8 +1408,13 @@ int HashJoinIterator::ReadNextJoinedRowFromHashTable() {
     // would have to read the build chunk in multiple smaller chunks while doing
     // a probe phase for each of these smaller chunks. To keep track of this,
     // each probe row is prefixed with a match flag in the chunk files.
+    //
+    // If the probe row was pruned by the Bloom filter of its chunk pair, we
+    // know that it cannot match any row on disk either, so we can treat it as
+    // in an in-memory hash join.
     bool return_null_complemented_row = false;
-    if ((on_disk_hash_join() && m_current_chunk == -1) ||
+    if ((on_disk_hash_join() && m_current_chunk == -1 &&
+         !m_probe_row_pruned) ||
         m_write_to_probe_row_saving) {
       return_null_complemented_row = false;
     } else if (m_join_type == JoinType::ANTI) {
@@ -1098,6 +1506,14 @@ int HashJoinIterator::Read() {
         assert(res == 1);
         return res;
       }
+      case State::READING_FROM_PARALLEL_CHUNK_JOIN: {
+        const int res = ReadJoinedRowFromParallelChunkJoin();
+        if (res == -1) {
+          m_parallel_chunk_join.End();
+          m_state = State::END_OF_ROWS;
+        }
+        return res;
+      }
       case State::END_OF_ROWS:
         return -1;
     }
@@ -1111,7 +1527,8 @@ int HashJoinIterator::Read() {
 bool HashJoinIterator::InitWritingToProbeRowSavingFile() {
   m_write_to_probe_row_saving = true;
   return m_probe_row_saving_write_file.Init(m_probe_input_tables,
-                                            m_join_type == JoinType::OUTER);
+                                            m_join_type == JoinType::OUTER,
+                                            /*stores_join_keys=*/false);
 }
 
 bool HashJoinIterator::InitReadingFromProbeRowSavingFile() {
@@ -26,6 +26,7 @@
 
 #include <stdio.h>
 #include <cstdint>
+#include <optional>
 #include <vector>
 
 #include "my_alloc.h"
@@ -36,9 +37,13 @@
 #include "sql/item_cmpfunc.h"
 #include "sql/iterators/hash_join_buffer.h"
 #include "sql/iterators/hash_join_chunk.h"
+#include "sql/iterators/hash_join_parallel.h"
+#include "sql/iterators/row_batch.h"
 #include "sql/iterators/row_iterator.h"
+#include "sql/iterators/runtime_filter.h"
 #include "sql/join_type.h"
 #include "sql/mem_root_array.h"
+#include "sql/psi_memory_key.h"
 #include "sql/pack_rows.h"
 #include "sql/table.h"
 #include "sql_string.h"
@@ -46,11 +51,6 @@
 class Item;
 class THD;
 
-struct ChunkPair {
-  HashJoinChunk probe_chunk;
-  HashJoinChunk build_chunk;
-};
-
 /// @file
 ///
 /// An iterator for joining two inputs by using hashing to match rows from
@@ -156,14 +156,34 @@ struct ChunkPair {
 /// spilling to disk, we lose any reasonable ordering properties.
 ///
 /// Note that we still might end up in a case where a single chunk file from
-/// disk won't fit into memory. This is resolved by reading as much as possible
-/// into the hash table, and then reading the entire probe chunk file for each
-/// time the hash table is reloaded. This might happen if we have a very skewed
-/// data set, for instance.
+/// disk won't fit into memory, typically because the row estimate was too low.
+/// If so, the chunk pair is repartitioned into new, smaller chunk pairs using a
+/// different hash seed, and the new chunk pairs are processed after the
+/// existing ones. A chunk pair is repartitioned at most
+/// "kMaxRepartitioningLevel" times. If repartitioning does not help (all rows
+/// have the same join key, for instance), or we cannot open more chunk files,
+/// we read as much as possible into the hash table, and then read the entire
+/// probe chunk file for each time the hash table is reloaded.
 ///
 /// When we start spilling to disk, we allocate a maximum of "kMaxChunks"
 /// chunk files on disk for each of the two inputs. The reason for having an
-/// upper limit is to avoid running out of file descriptors.
+/// upper limit is to avoid running out of file descriptors. Chunk files are
+/// closed as soon as we are done with them.
+///
+/// While writing rows to a build chunk file, we also insert the hash of their
+/// join key into a Bloom filter for the chunk pair. A probe row whose join key
+/// is not in the Bloom filter cannot have any matches, so it is not written to
+/// the probe chunk file; for semijoins and inner joins it is dropped, and for
+/// antijoins and outer joins it is returned (NULL-complemented) right away.
+///
+/// Inner joins and semijoins where the probe input is a single table, and one
+/// of the join conditions compares an integer column of that table to an
+/// integer expression over the build input, go one step further: while the
+/// build input is read, a RuntimeFilter collects the range and a Bloom filter
+/// of the build side values. Once the entire build input is read, the filter
+/// is pushed to the handler of the probe table, so that probe rows that cannot
+/// match are thrown away by the scan (or by the storage engine) before they
+/// ever reach the hash join.
 ///
 /// There is also a flag we can set to avoid hash join spilling to disk
 /// regardless of the input size. If the flag is set, the join algorithm works
@@ -319,6 +339,10 @@ class HashJoinIterator final : public RowIterator {
                    bool probe_input_batch_mode,
                    uint64_t *hash_table_generation);
 
+  // The probe table's handler must not keep a pointer to m_runtime_filter
+  // after we are gone.
+  ~HashJoinIterator() override { RemoveRuntimeFilter(); }
+
   bool Init() override;
 
   int Read() override;
@@ -331,6 +355,9 @@ class HashJoinIterator final : public RowIterator {
   void EndPSIBatchModeIfStarted() override {
     m_build_input->EndPSIBatchModeIfStarted();
     m_probe_input->EndPSIBatchModeIfStarted();
+    // We are done reading, so the probe table's scans must not be filtered
+    // any more.
+    RemoveRuntimeFilter();
   }
 
   void UnlockRow() override {
@@ -348,12 +375,39 @@ class HashJoinIterator final : public RowIterator {
   /// @retval true in case of error
   bool BuildHashTable();
 
+  /// Read the next row from the build input into the tables' record buffers,
+  /// through m_build_batch if batch mode is enabled for the build input.
+  ///
+  /// @returns the same as RowIterator::Read()
+  int ReadRowFromBuildIterator() {
+    return m_build_batch.is_enabled()
+               ? m_build_batch.ReadRow(m_build_input.get())
+               : m_build_input->Read();
+  }
+
   /// Read all rows from the next chunk file into the in-memory hash table.
   /// See the class comment for details.
   ///
   /// @retval true in case of error
   bool ReadNextHashJoinChunk();
 
+  /// Split the current chunk pair, whose build chunk does not fit in memory,
+  /// into several smaller chunk pairs, which are added to the end of
+  /// m_chunk_files_on_disk. The current chunk pair is left empty. Nothing is
+  /// done if the chunk pair has been split too many times already, or if it
+  /// would take too many open files.
+  ///
+  /// @param rows_that_fit how many rows from the build chunk fit in the hash
+  ///   table.
+  /// @param[out] repartitioned whether the chunk pair was split.
+  ///
+  /// @retval true in case of error
+  bool RepartitionCurrentChunkPair(ha_rows rows_that_fit, bool *repartitioned);
+
+  /// @returns the maximum amount of memory to use for the Bloom filters of a
+  /// set of chunk pairs.
+  size_t MaxBloomFilterBytes() const { return m_max_memory_available / 4; }
+
   /// Read a single row from the probe iterator input into the tables' record
   /// buffers. If we have started spilling to disk, the row is written out to a
   /// chunk file on disk as well.
@@ -367,6 +421,20 @@ class HashJoinIterator final : public RowIterator {
   /// @retval true in case of error
   bool ReadRowFromProbeIterator();
 
+  /// Read the next row from m_probe_batch into the probe tables' record
+  /// buffers, refilling the batch from the probe input (and looking up all of
+  /// its rows in the hash table) when it is exhausted.
+  ///
+  /// @returns the same as RowIterator::Read()
+  int ReadRowFromProbeBatch();
+
+  /// Compute the join keys of all the rows in m_probe_batch, and look them all
+  /// up in the hash table at once, so that the cache misses of the lookups
+  /// overlap.
+  ///
+  /// @retval true in case of error
+  bool LookupProbeBatchInHashTable();
+
   /// Read a single row from the current probe chunk file into the tables'
   /// record buffers. The end conditions are the same as for
   /// ReadRowFromProbeIterator().
@@ -391,6 +459,10 @@ class HashJoinIterator final : public RowIterator {
   // there are no more matching rows for the computed join key.
   void LookupProbeRowInHashTable();
 
+  /// Set the iterator state for a probe row that has SQL NULL in its join key,
+  /// and thus cannot match anything in the hash table.
+  void SetStateForNullInProbeJoinKey();
+
   /// Take the next matching row from the hash table, and put the row into the
   /// build tables' record buffers. The function expects that
   /// LookupProbeRowInHashTable() has been called up-front. The user must
@@ -422,6 +494,16 @@ class HashJoinIterator final : public RowIterator {
   /// @retval true if the last joined row passes all of the extra conditions.
   bool JoinedRowPassesExtraConditions() const;
 
+  /// @returns true if the chunk pairs should be joined by several threads
+  /// (using ParallelChunkJoin) if the hash join spills to disk.
+  bool ShouldJoinChunksInParallel() const;
+
+  /// Read the next joined row from m_parallel_chunk_join into the tables'
+  /// record buffers, skipping rows that do not pass the extra conditions.
+  ///
+  /// @returns the same as RowIterator::Read()
+  int ReadJoinedRowFromParallelChunkJoin();
+
   /// If true, reject duplicate keys in the hash table.
   ///
   /// Semijoins/antijoins are only interested in the first matching row from the
@@ -447,6 +529,14 @@ class HashJoinIterator final : public RowIterator {
   /// @retval true in case of error. my_error has been called.
   bool InitProbeIterator();
 
+  /// Push m_runtime_filter to the handler of the probe table, if it is in use
+  /// and contains the values from the entire build input.
+  void PushRuntimeFilter();
+
+  /// Remove m_runtime_filter from the handler of the probe table, if it was
+  /// pushed.
+  void RemoveRuntimeFilter();
+
   /// Mark that probe row saving is enabled, and prepare the probe row saving
   /// file for writing.
   /// @see m_write_to_probe_row_saving
@@ -493,6 +583,9 @@ class HashJoinIterator final : public RowIterator {
     READING_FIRST_ROW_FROM_HASH_TABLE,
     // We are reading the remaining rows returned from the hash table lookup.
     READING_FROM_HASH_TABLE,
+    // The chunk pairs are being joined by ParallelChunkJoin, and we are reading
+    // the joined rows it returns.
+    READING_FROM_PARALLEL_CHUNK_JOIN,
     // No more rows, both inputs are empty.
     END_OF_ROWS
   };
@@ -516,6 +609,32 @@ class HashJoinIterator final : public RowIterator {
   // compute the join key when needed.
   pack_rows::TableCollection m_probe_input_tables;
   pack_rows::TableCollection m_build_input_tables;
+
+  // Used for reading the build input in batches, if enabled by
+  // iterator_batch_size (see RowIterator::ReadBatch()).
+  RowBatch m_build_batch;
+
+  // Used for reading the probe input in batches, if enabled by
+  // iterator_batch_size and the hash table supports batched lookups. All the
+  // rows in the batch are looked up in the hash table as soon as the batch is
+  // read; the results are kept in m_probe_batch_rows.
+  RowBatch m_probe_batch;
+
+  // The next selected row in m_probe_batch to return.
+  size_t m_next_probe_row_in_batch{0};
+
+  // Whether the probe input has reported end of records.
+  bool m_probe_batch_end_of_records{false};
+
+  // The join keys of the rows in m_probe_batch, concatenated.
+  String m_probe_batch_key_buffer;
+
+  // For each selected row in m_probe_batch: the join key, whether it contains
+  // SQL NULL, and the first matching row in the hash table.
+  std::vector<size_t> m_probe_batch_key_ends;
+  std::vector<hash_join_buffer::Key> m_probe_batch_keys;
+  std::vector<bool> m_probe_batch_null_in_key;
+  std::vector<LinkedImmutableString> m_probe_batch_rows;
   const table_map m_tables_to_get_rowid_for;
 
   // An in-memory hash table that holds rows from the build input (directly from
@@ -530,6 +649,14 @@ class HashJoinIterator final : public RowIterator {
   // on-disk hash join.
   Mem_root_array<ChunkPair> m_chunk_files_on_disk;
 
+  // Holds the Bloom filters of the chunk pairs, and the temporary arrays used
+  // when repartitioning. Cleared together with m_chunk_files_on_disk.
+  MEM_ROOT m_chunk_mem_root{key_memory_hash_join, 16384};
+
+  // Whether the last probe row was not written to a chunk file, since the
+  // Bloom filter of the chunk pair said it could not have a match.
+  bool m_probe_row_pruned{false};
+
   // Which HashJoinChunk, if any, we are currently reading from, in both
   // LOADING_NEXT_CHUNK_PAIR and READING_ROW_FROM_PROBE_CHUNK_FILE.
   // It is incremented during the state LOADING_NEXT_CHUNK_PAIR.
@@ -560,6 +687,11 @@ class HashJoinIterator final : public RowIterator {
   // should be placed in.
   static constexpr size_t kMaxChunks = 128;
 
+  // How many times the rows of a chunk pair can be repartitioned, when the
+  // build chunk does not fit in memory. After that, we fall back to reading
+  // the probe chunk once for each hash table refill.
+  static constexpr int kMaxRepartitioningLevel = 3;
+
   // A buffer that is used during two phases:
   // 1) when constructing a join key from join conditions.
   // 2) when moving a row between tables' record buffers and the hash table.
@@ -584,6 +716,17 @@ class HashJoinIterator final : public RowIterator {
   // Whether we are allowed to spill to disk.
   bool m_allow_spill_to_disk{true};
 
+  // The amount of memory the hash table may use.
+  const size_t m_max_memory_available;
+
+  // Whether the chunk files (if any) store the join key of each row, so that
+  // the chunk pairs are joined by m_parallel_chunk_join instead of one at a
+  // time by this iterator. Decided when the hash join spills to disk.
+  bool m_join_chunks_in_parallel{false};
+
+  // Joins the chunk pairs concurrently, if m_join_chunks_in_parallel is set.
+  ParallelChunkJoin m_parallel_chunk_join;
+
   // Whether the build iterator has more rows. This is used to stop the hash
   // join iterator asking for more rows when we know for sure that the entire
   // build input is consumed. The variable is only used if m_allow_spill_to_disk
@@ -591,6 +734,16 @@ class HashJoinIterator final : public RowIterator {
   // the probe input is consumed.
   bool m_build_iterator_has_more_rows{true};
 
+  // A filter that is pushed to the probe table, if the join condition allows
+  // for it. See the class comment.
+  std::optional<RuntimeFilter> m_runtime_filter;
+
+  // Whether m_runtime_filter collects values in this execution of the join.
+  bool m_use_runtime_filter{false};
+
+  // Whether m_runtime_filter is pushed to the handler of the probe table.
+  bool m_runtime_filter_pushed{false};
+
   // What kind of join the iterator should execute.
   const JoinType m_join_type;
 
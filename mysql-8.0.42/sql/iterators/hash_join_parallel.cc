@@ -0,0 +1,336 @@
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include "sql/iterators/hash_join_parallel.h"
+
+#include <assert.h>
+#include <string.h>
+#include <algorithm>
+#include <new>
+#include <string_view>
+
+#include <ankerl/unordered_dense.h>
+
+#include "my_alloc.h"
+#include "my_inttypes.h"
+#include "mysql/components/services/bits/psi_bits.h"
+#include "mysql/psi/mysql_thread.h"
+#include "my_systime.h"
+#include "mysqld_error.h"
+#include "sql/mysqld.h"
+#include "sql/psi_memory_key.h"
+#include "sql/sql_base.h"
+#include "sql/sql_class.h"
+#include "sql/sql_const.h"
+#include "template_utils.h"
+
+namespace {
+
+// A row from the build chunk, as stored in a worker's hash table. All rows
+// with the same join key are linked together. The packed row follows
+// immediately after the struct.
+struct BuildRow {
+  BuildRow *next;
+  size_t length;
+
+  const uchar *data() const { return pointer_cast<const uchar *>(this + 1); }
+};
+
+using BuildRowMap = ankerl::unordered_dense::map<std::string_view, BuildRow *>;
+
+bool WriteBytes(IO_CACHE *file, const uchar *data, size_t length) {
+  return my_b_write(file, pointer_cast<const uchar *>(&length),
+                    sizeof(length)) != 0 ||
+         my_b_write(file, data, length) != 0;
+}
+
+bool ReadBytes(IO_CACHE *file, String *str) {
+  size_t length;
+  if (my_b_read(file, pointer_cast<uchar *>(&length), sizeof(length)) != 0 ||
+      str->reserve(length)) {
+    return true;
+  }
+  str->length(length);
+  return my_b_read(file, pointer_cast<uchar *>(str->ptr()), length) != 0;
+}
+
+// How long Read() waits for a chunk pair before checking whether the session
+// has been killed.
+constexpr ulonglong kKillCheckIntervalNs = 100 * 1000 * 1000;
+
+}  // namespace
+
+bool ParallelChunkJoin::Start(THD *thd, Mem_root_array<ChunkPair> *chunk_pairs,
+                              size_t max_threads,
+                              size_t max_memory_per_thread) {
+  assert(!is_started());
+  assert(max_threads > 0);
+
+  m_thd = thd;
+  m_chunk_pairs = chunk_pairs;
+  m_max_memory_per_thread = max_memory_per_thread;
+  m_next_chunk_to_join = 0;
+  m_abort = false;
+  m_error = WorkerError::NONE;
+  m_current_chunk = 0;
+  m_current_row = HA_POS_ERROR;
+
+  m_results.reset(new (std::nothrow) ChunkResult[chunk_pairs->size()]);
+  if (m_results == nullptr) {
+    my_error(ER_OUTOFMEMORY, MYF(0),
+             chunk_pairs->size() * sizeof(ChunkResult));
+    return true;
+  }
+
+  mysql_mutex_init(key_LOCK_hash_join_parallel, &m_mutex,
+                   MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_COND_hash_join_chunk_done, &m_chunk_done);
+
+  // There is no point in starting more threads than there are chunk pairs.
+  const size_t num_threads = std::min(max_threads, chunk_pairs->size());
+  int error = 0;
+  for (size_t i = 0; i < num_threads; ++i) {
+    my_thread_handle thread;
+    error = mysql_thread_create(key_thread_hash_join_worker, &thread, nullptr,
+                                WorkerMain, this);
+    if (error != 0) {
+      // Go on with the threads we managed to start, if any.
+      break;
+    }
+    m_threads.push_back(thread);
+  }
+
+  if (m_threads.empty()) {
+    mysql_cond_destroy(&m_chunk_done);
+    mysql_mutex_destroy(&m_mutex);
+    m_results.reset();
+    my_error(ER_CANT_CREATE_THREAD, MYF(0), error);
+    return true;
+  }
+  return false;
+}
+
+void ParallelChunkJoin::End() {
+  if (!is_started()) return;
+
+  m_abort = true;
+  for (my_thread_handle &thread : m_threads) {
+    my_thread_join(&thread, nullptr);
+  }
+  m_threads.clear();
+  mysql_cond_destroy(&m_chunk_done);
+  mysql_mutex_destroy(&m_mutex);
+
+  // Closes and deletes the result files.
+  m_results.reset();
+}
+
+int ParallelChunkJoin::Read(const String **build_row,
+                            const String **probe_row) {
+  assert(is_started());
+  while (m_current_chunk < m_chunk_pairs->size()) {
+    ChunkResult &result = m_results[m_current_chunk];
+    if (m_current_row == HA_POS_ERROR) {
+      // Wait for a worker to finish this chunk pair. The workers do not know
+      // about the session, so wake up now and then to see if it was killed.
+      mysql_mutex_lock(&m_mutex);
+      while (!result.done && m_error == WorkerError::NONE &&
+             !m_thd->killed) {
+        struct timespec abstime;
+        set_timespec_nsec(&abstime, kKillCheckIntervalNs);
+        mysql_cond_timedwait(&m_chunk_done, &m_mutex, &abstime);
+      }
+      const WorkerError error = m_error;
+      const bool done = result.done;
+      mysql_mutex_unlock(&m_mutex);
+
+      if (!done && error == WorkerError::NONE) {
+        // Killed. The caller calls End(), which stops the workers.
+        m_thd->send_kill_message();
+        return 1;
+      }
+
+      switch (error) {
+        case WorkerError::NONE:
+          break;
+        case WorkerError::OUT_OF_MEMORY:
+          my_error(ER_OUTOFMEMORY, MYF(ME_FATALERROR),
+                   m_max_memory_per_thread);
+          return 1;
+        case WorkerError::FILE_ERROR:
+          my_error(ER_TEMP_FILE_WRITE_FAILURE, MYF(0));
+          return 1;
+      }
+      m_current_row = 0;
+    }
+
+    if (m_current_row < result.num_rows) {
+      if (ReadBytes(&result.file, &m_build_row) ||
+          ReadBytes(&result.file, &m_probe_row)) {
+        my_error(ER_TEMP_FILE_WRITE_FAILURE, MYF(0));
+        return 1;
+      }
+      ++m_current_row;
+      *build_row = &m_build_row;
+      *probe_row = &m_probe_row;
+      return 0;
+    }
+
+    // Done with this chunk pair; release its disk space right away.
+    close_cached_file(&result.file);
+    ++m_current_chunk;
+    m_current_row = HA_POS_ERROR;
+  }
+  return -1;
+}
+
+void *ParallelChunkJoin::WorkerMain(void *arg) {
+  if (my_thread_init()) {
+    // Let the other workers (or, if there are none, the iterator's thread)
+    // know that this worker could not do its job.
+    ParallelChunkJoin *join = static_cast<ParallelChunkJoin *>(arg);
+    mysql_mutex_lock(&join->m_mutex);
+    if (join->m_error == WorkerError::NONE) {
+      join->m_error = WorkerError::OUT_OF_MEMORY;
+    }
+    join->m_abort = true;
+    mysql_cond_broadcast(&join->m_chunk_done);
+    mysql_mutex_unlock(&join->m_mutex);
+    return nullptr;
+  }
+  static_cast<ParallelChunkJoin *>(arg)->RunWorker();
+  my_thread_end();
+  return nullptr;
+}
+
+void ParallelChunkJoin::RunWorker() {
+  while (!m_abort) {
+    const size_t chunk_idx = m_next_chunk_to_join++;
+    if (chunk_idx >= m_chunk_pairs->size()) break;
+
+    const WorkerError error = JoinChunkPair(chunk_idx);
+
+    mysql_mutex_lock(&m_mutex);
+    if (error != WorkerError::NONE && m_error == WorkerError::NONE) {
+      m_error = error;
+      m_abort = true;
+    }
+    m_results[chunk_idx].done = true;
+    mysql_cond_broadcast(&m_chunk_done);
+    mysql_mutex_unlock(&m_mutex);
+  }
+}
+
+ParallelChunkJoin::WorkerError ParallelChunkJoin::JoinChunkPair(
+    size_t chunk_idx) {
+  ChunkPair &chunk_pair = (*m_chunk_pairs)[chunk_idx];
+  ChunkResult &result = m_results[chunk_idx];
+
+  result.file.file_key = key_file_hash_join;
+  if (open_cached_file(&result.file, mysql_tmpdir, TEMP_PREFIX,
+                       DISK_BUFFER_SIZE, MYF(0))) {
+    return WorkerError::FILE_ERROR;
+  }
+
+  HashJoinChunk &build_chunk = chunk_pair.build_chunk;
+  HashJoinChunk &probe_chunk = chunk_pair.probe_chunk;
+
+  MEM_ROOT mem_root(key_memory_hash_join, 16384);
+  BuildRowMap hash_map;
+  String join_key;
+  String row;
+
+  // Inner joins never output anything for an empty chunk, so only read the
+  // build chunk if there is something to probe it with.
+  ha_rows build_rows_read =
+      probe_chunk.num_rows() == 0 ? build_chunk.num_rows() : 0;
+  while (build_rows_read < build_chunk.num_rows()) {
+    if (m_abort) return WorkerError::NONE;
+
+    mem_root.ClearForReuse();
+    hash_map.clear();
+
+    // Load as many rows from the build chunk as we have memory for (but always
+    // at least one).
+    do {
+      if (build_chunk.ReadRawRowFromChunk(&join_key, &row,
+                                          /*matched=*/nullptr)) {
+        return WorkerError::FILE_ERROR;
+      }
+      ++build_rows_read;
+
+      char *key_data = mem_root.ArrayAlloc<char>(join_key.length());
+      void *row_data = mem_root.Alloc(sizeof(BuildRow) + row.length());
+      if (key_data == nullptr || row_data == nullptr) {
+        return WorkerError::OUT_OF_MEMORY;
+      }
+      memcpy(key_data, join_key.ptr(), join_key.length());
+      BuildRow *build_row = new (row_data) BuildRow{nullptr, row.length()};
+      memcpy(pointer_cast<uchar *>(build_row + 1), row.ptr(), row.length());
+
+      const auto [it, inserted] = hash_map.emplace(
+          std::string_view(key_data, join_key.length()), build_row);
+      if (!inserted) {
+        build_row->next = it->second;
+        it->second = build_row;
+      }
+    } while (build_rows_read < build_chunk.num_rows() &&
+             mem_root.allocated_size() +
+                     hash_map.values().capacity() *
+                         sizeof(BuildRowMap::value_type) <
+                 m_max_memory_per_thread);
+
+    // Probe the hash table with all the rows from the probe chunk.
+    if (probe_chunk.RewindQuietly()) {
+      return WorkerError::FILE_ERROR;
+    }
+    for (ha_rows i = 0; i < probe_chunk.num_rows(); ++i) {
+      if (m_abort) return WorkerError::NONE;
+
+      bool matched;
+      if (probe_chunk.ReadRawRowFromChunk(&join_key, &row, &matched)) {
+        return WorkerError::FILE_ERROR;
+      }
+      const auto it = hash_map.find(
+          std::string_view(join_key.ptr(), join_key.length()));
+      if (it == hash_map.end()) continue;
+
+      for (const BuildRow *build_row = it->second; build_row != nullptr;
+           build_row = build_row->next) {
+        if (WriteBytes(&result.file, build_row->data(), build_row->length) ||
+            WriteBytes(&result.file, pointer_cast<const uchar *>(row.ptr()),
+                       row.length())) {
+          return WorkerError::FILE_ERROR;
+        }
+        ++result.num_rows;
+      }
+    }
+  }
+
+  // Prepare the result for reading.
+  if (my_b_flush_io_cache(&result.file, /*need_append_buffer_lock=*/0) == -1 ||
+      reinit_io_cache(&result.file, READ_CACHE, 0, false, false)) {
+    return WorkerError::FILE_ERROR;
+  }
+  return WorkerError::NONE;
+}
@@ -0,0 +1,172 @@
+#ifndef SQL_ITERATORS_HASH_JOIN_PARALLEL_H_
+#define SQL_ITERATORS_HASH_JOIN_PARALLEL_H_
+
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/// @file
+///
+/// This file contains the ParallelChunkJoin class, which joins the chunk
+/// files of an on-disk hash join using several threads.
+
+#include <stddef.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "my_base.h"
+#include "my_sys.h"
+#include "my_thread.h"
+#include "mysql/psi/mysql_cond.h"
+#include "mysql/psi/mysql_mutex.h"
+#include "sql/iterators/hash_join_chunk.h"
+#include "sql/mem_root_array.h"
+#include "sql_string.h"
+
+class THD;
+
+/**
+  Joins the chunk pairs of an on-disk inner hash join concurrently.
+
+  When a hash join spills to disk, the remaining rows from both inputs are
+  partitioned into pairs of chunk files (see HashJoinIterator), and every pair
+  can be joined independently of the others. ParallelChunkJoin hands out the
+  chunk pairs to a bounded pool of worker threads. Each worker builds a private
+  hash table from the build chunk, probes it with the rows from the probe
+  chunk, and writes every matching pair of rows to a result file for that
+  chunk pair. The iterator's thread reads the result files back in chunk order
+  and loads the rows into the record buffers, where it evaluates any extra
+  conditions.
+
+  The workers never look at Items, THD or the record buffers; the chunk files
+  must be set up to store the join key of each row (which the iterator's thread
+  computed when writing the row), so that the workers can match the rows by
+  comparing the join keys byte by byte, just like HashJoinRowBuffer does. For
+  the same reason, only inner joins can be joined this way; semijoins,
+  antijoins and outer joins need to know about matches across all of the
+  probe phases, which depends on the extra conditions.
+
+  If a build chunk does not fit in the memory given to each worker, the worker
+  joins it in several rounds, reading the probe chunk once for each round.
+ */
+class ParallelChunkJoin {
+ public:
+  ParallelChunkJoin() = default;
+  ~ParallelChunkJoin() { End(); }
+
+  ParallelChunkJoin(const ParallelChunkJoin &) = delete;
+  ParallelChunkJoin &operator=(const ParallelChunkJoin &) = delete;
+
+  /**
+    Start joining the given chunk pairs.
+
+    @param thd the session that reads the joined rows. Read() stops waiting
+      for the worker threads if this session is killed.
+    @param chunk_pairs the chunk pairs to join. The build chunks must be
+      rewound, and no more rows may be written to any of the chunks. Must stay
+      alive until End() is called.
+    @param max_threads the maximum number of worker threads to start.
+    @param max_memory_per_thread the amount of memory each worker may use for
+      its hash table.
+
+    @retval true on error. my_error() is called.
+   */
+  bool Start(THD *thd, Mem_root_array<ChunkPair> *chunk_pairs,
+             size_t max_threads, size_t max_memory_per_thread);
+
+  /**
+    Read the next joined pair of rows. Waits for the worker threads if the
+    next chunk pair is not done yet.
+
+    @param[out] build_row the packed row from the build input.
+    @param[out] probe_row the packed row from the probe input.
+      Both strings are owned by this object, and stay valid until the next
+      call.
+
+    @returns the same as RowIterator::Read(). my_error() is called on error.
+   */
+  int Read(const String **build_row, const String **probe_row);
+
+  /// Stop all worker threads and wait for them to finish. It is always safe to
+  /// call this.
+  void End();
+
+  /// @returns true if the join is started and End() is not called yet.
+  bool is_started() const { return !m_threads.empty(); }
+
+ private:
+  /// Errors that can be reported from the worker threads.
+  enum class WorkerError { NONE, OUT_OF_MEMORY, FILE_ERROR };
+
+  /// The matching pairs of rows found by joining one chunk pair.
+  struct ChunkResult {
+    ~ChunkResult() { close_cached_file(&file); }
+
+    IO_CACHE file;
+    ha_rows num_rows{0};
+    bool done{false};
+  };
+
+  static void *WorkerMain(void *arg);
+
+  /// Join chunk pairs until there are no more chunk pairs or the join is
+  /// aborted.
+  void RunWorker();
+
+  /// Join a single chunk pair, writing the result to m_results[chunk_idx].
+  WorkerError JoinChunkPair(size_t chunk_idx);
+
+  THD *m_thd{nullptr};
+  Mem_root_array<ChunkPair> *m_chunk_pairs{nullptr};
+  std::unique_ptr<ChunkResult[]> m_results;
+  size_t m_max_memory_per_thread{0};
+
+  /// The next chunk pair to be picked up by a worker.
+  std::atomic<size_t> m_next_chunk_to_join{0};
+
+  /// Set when the join should stop, because of an error or End().
+  std::atomic<bool> m_abort{false};
+
+  std::vector<my_thread_handle> m_threads;
+
+  /// Protects m_error and ChunkResult::done.
+  mysql_mutex_t m_mutex;
+
+  /// Signalled whenever a chunk pair is done.
+  mysql_cond_t m_chunk_done;
+
+  /// The first error reported by a worker.
+  WorkerError m_error{WorkerError::NONE};
+
+  /// The chunk pair the iterator's thread is reading results from.
+  size_t m_current_chunk{0};
+
+  /// The number of rows read from the result of the current chunk pair, or
+  /// HA_POS_ERROR if we did not wait for the chunk pair to be done yet.
+  ha_rows m_current_row{HA_POS_ERROR};
+
+  String m_build_row;
+  String m_probe_row;
+};
+
+#endif  // SQL_ITERATORS_HASH_JOIN_PARALLEL_H_
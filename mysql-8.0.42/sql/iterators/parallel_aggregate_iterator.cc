@@ -0,0 +1,1225 @@
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include "sql/iterators/parallel_aggregate_iterator.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <utility>
+
+#include "my_bitmap.h"
+#include "my_byteorder.h"
+#include "my_io.h"
+#include "my_sys.h"
+#include "myisampack.h"
+#include "mysql/components/services/bits/psi_bits.h"
+#include "mysqld_error.h"
+#include "sql/field.h"
+#include "sql/field_common_properties.h"
+#include "sql/handler.h"
+#include "sql/item.h"
+#include "sql/item_cmpfunc.h"
+#include "sql/item_func.h"
+#include "sql/item_sum.h"
+#include "sql/join_optimizer/access_path.h"
+#include "sql/mysqld.h"
+#include "sql/sql_base.h"
+#include "sql/sql_class.h"
+#include "sql/sql_lex.h"
+#include "sql/sql_optimizer.h"
+#include "sql/table.h"
+#include "template_utils.h"
+
+namespace parallel_aggregate {
+
+bool IntegerColumn::IsSupported(const Field *field) {
+  switch (field->type()) {
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_LONGLONG:
+      // Value() reads the little-endian format used by all storage engines
+      // in practice.
+      return !field->is_virtual_gcol() && field->table->s->db_low_byte_first;
+    default:
+      return false;
+  }
+}
+
+IntegerColumn IntegerColumn::FromField(const Field *field) {
+  assert(IsSupported(field));
+  IntegerColumn column;
+  column.offset = field->offset(field->table->record[0]);
+  column.length = field->pack_length();
+  if (field->is_nullable()) {
+    column.null_offset = field->null_offset();
+    column.null_bit = field->null_bit;
+  }
+  column.is_unsigned = field->is_unsigned();
+  return column;
+}
+
+longlong IntegerColumn::Value(const uchar *row) const {
+  const uchar *ptr = row + offset;
+  switch (length) {
+    case 1:
+      return is_unsigned ? longlong{*ptr}
+                         : longlong{static_cast<signed char>(*ptr)};
+    case 2:
+      return is_unsigned ? longlong{uint2korr(ptr)} : longlong{sint2korr(ptr)};
+    case 3:
+      return is_unsigned ? longlong{uint3korr(ptr)} : longlong{sint3korr(ptr)};
+    case 4:
+      return is_unsigned ? longlong{uint4korr(ptr)} : longlong{sint4korr(ptr)};
+    default:
+      assert(length == 8);
+      return sint8korr(ptr);
+  }
+}
+
+void IntegerColumn::CopyValue(const uchar *from, uchar *to) const {
+  memcpy(to + offset, from + offset, length);
+  if (null_bit != 0) {
+    to[null_offset] =
+        (to[null_offset] & ~null_bit) | (from[null_offset] & null_bit);
+  }
+}
+
+void IntegerColumn::StoreValue(longlong value, uchar *row) const {
+  uchar *ptr = row + offset;
+  switch (length) {
+    case 1:
+      *ptr = static_cast<uchar>(value);
+      break;
+    case 2:
+      int2store(ptr, static_cast<uint16>(value));
+      break;
+    case 3:
+      int3store(ptr, static_cast<uint32>(value));
+      break;
+    case 4:
+      int4store(ptr, static_cast<uint32>(value));
+      break;
+    default:
+      assert(length == 8);
+      int8store(ptr, static_cast<ulonglong>(value));
+      break;
+  }
+  if (null_bit != 0) row[null_offset] &= ~null_bit;
+}
+
+int CompareIntegers(longlong a, bool a_unsigned, longlong b, bool b_unsigned) {
+  if (a_unsigned != b_unsigned) {
+    // The unsigned value is the larger one if it is above LLONG_MAX, or if the
+    // signed value is negative. Otherwise, both can be compared as signed.
+    const longlong unsigned_value = a_unsigned ? a : b;
+    const longlong signed_value = a_unsigned ? b : a;
+    if (unsigned_value < 0 || signed_value < 0) return a_unsigned ? 1 : -1;
+  } else if (a_unsigned) {
+    const ulonglong ua = static_cast<ulonglong>(a);
+    const ulonglong ub = static_cast<ulonglong>(b);
+    return ua < ub ? -1 : (ua > ub ? 1 : 0);
+  }
+  return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+bool ColumnPredicate::Evaluate(const uchar *row) const {
+  const bool is_null = column.IsNull(row);
+  switch (op) {
+    case Op::IS_NULL:
+      return is_null;
+    case Op::IS_NOT_NULL:
+      return !is_null;
+    default:
+      break;
+  }
+  if (is_null || value_is_null) return false;
+
+  const int cmp = CompareIntegers(column.Value(row), column.is_unsigned, value,
+                                  value_is_unsigned);
+  switch (op) {
+    case Op::EQ:
+      return cmp == 0;
+    case Op::NE:
+      return cmp != 0;
+    case Op::LT:
+      return cmp < 0;
+    case Op::LE:
+      return cmp <= 0;
+    case Op::GT:
+      return cmp > 0;
+    case Op::GE:
+      return cmp >= 0;
+    default:
+      assert(false);
+      return false;
+  }
+}
+
+void AggregateState::Add(const AggregateSpec &spec, const uchar *row) {
+  if (spec.kind == AggregateSpec::Kind::COUNT_ROWS) {
+    ++count;
+    return;
+  }
+  if (spec.column.IsNull(row)) return;
+
+  const longlong value = spec.column.Value(row);
+  const bool is_unsigned = spec.column.is_unsigned;
+  switch (spec.kind) {
+    case AggregateSpec::Kind::SUM:
+      AddToSum(value, is_unsigned);
+      break;
+    case AggregateSpec::Kind::MIN:
+      if (count == 0 ||
+          CompareIntegers(value, is_unsigned, extreme, is_unsigned) < 0) {
+        extreme = value;
+      }
+      break;
+    case AggregateSpec::Kind::MAX:
+      if (count == 0 ||
+          CompareIntegers(value, is_unsigned, extreme, is_unsigned) > 0) {
+        extreme = value;
+      }
+      break;
+    default:
+      break;
+  }
+  ++count;
+}
+
+void AggregateState::Merge(const AggregateSpec &spec,
+                           const AggregateState &other) {
+  if (other.count == 0) return;
+
+  const bool is_unsigned = spec.column.is_unsigned;
+  switch (spec.kind) {
+    case AggregateSpec::Kind::SUM: {
+      AddToSum(other.int_sum, /*is_unsigned=*/false);
+      my_decimal result;
+      my_decimal_add(E_DEC_OK, &result, &decimal_sum, &other.decimal_sum);
+      decimal_sum = result;
+      break;
+    }
+    case AggregateSpec::Kind::MIN:
+      if (count == 0 || CompareIntegers(other.extreme, is_unsigned, extreme,
+                                        is_unsigned) < 0) {
+        extreme = other.extreme;
+      }
+      break;
+    case AggregateSpec::Kind::MAX:
+      if (count == 0 || CompareIntegers(other.extreme, is_unsigned, extreme,
+                                        is_unsigned) > 0) {
+        extreme = other.extreme;
+      }
+      break;
+    default:
+      break;
+  }
+  count += other.count;
+}
+
+void AggregateState::GetSum(my_decimal *sum) const {
+  my_decimal int_part;
+  int2my_decimal(E_DEC_OK, int_sum, /*unsigned_flag=*/false, &int_part);
+  my_decimal_add(E_DEC_OK, sum, &decimal_sum, &int_part);
+}
+
+void AggregateState::AddToSum(longlong value, bool is_unsigned) {
+  const bool fits_in_int_sum =
+      (!is_unsigned || value >= 0) &&
+      !(value > 0 && int_sum > LLONG_MAX - value) &&
+      !(value < 0 && int_sum < LLONG_MIN - value);
+  if (fits_in_int_sum) {
+    int_sum += value;
+    return;
+  }
+  // The errors from decimal arithmetic are not reported (we may not be in the
+  // session thread); a DECIMAL sum of BIGINTs cannot overflow in practice.
+  my_decimal decimal_value;
+  my_decimal result;
+  int2my_decimal(E_DEC_OK, value, is_unsigned, &decimal_value);
+  my_decimal_add(E_DEC_OK, &result, &decimal_sum, &decimal_value);
+  decimal_sum = result;
+}
+
+size_t AggregateState::SerializedSize() {
+  return 3 * sizeof(longlong) + decimal_bin_size(DECIMAL_MAX_PRECISION, 0);
+}
+
+void AggregateState::Serialize(uchar *to) const {
+  int8store(to, count);
+  int8store(to + sizeof(longlong), static_cast<ulonglong>(extreme));
+  int8store(to + 2 * sizeof(longlong), static_cast<ulonglong>(int_sum));
+  // A sum of integers never has a fractional part.
+  my_decimal2binary(E_DEC_OK, &decimal_sum, to + 3 * sizeof(longlong),
+                    DECIMAL_MAX_PRECISION, 0);
+}
+
+void AggregateState::Deserialize(const uchar *from) {
+  count = uint8korr(from);
+  extreme = sint8korr(from + sizeof(longlong));
+  int_sum = sint8korr(from + 2 * sizeof(longlong));
+  binary2my_decimal(E_DEC_OK, from + 3 * sizeof(longlong), &decimal_sum,
+                    DECIMAL_MAX_PRECISION, 0);
+}
+
+/**
+  A sorted run of groups in a temporary file. All the groups have the same
+  size (see GroupTable::SerializedGroupSize()). The file is written by the
+  thread that owns the GroupTable, and read by the session thread.
+ */
+class GroupTable::SpilledRun {
+ public:
+  SpilledRun() = default;
+  SpilledRun(const SpilledRun &) = delete;
+  SpilledRun &operator=(const SpilledRun &) = delete;
+  ~SpilledRun() { close_cached_file(&m_file); }
+
+  bool Open() {
+    // Errors are not reported, since this may not be the session thread.
+    return open_cached_file(&m_file, mysql_tmpdir, TEMP_PREFIX,
+                            DISK_BUFFER_SIZE, MYF(0));
+  }
+
+  bool Write(const uchar *group, size_t length) {
+    if (my_b_write(&m_file, group, length) != 0) return true;
+    ++m_num_groups;
+    return false;
+  }
+
+  /// Write out any groups that are still buffered. @retval true on error.
+  bool Flush() {
+    return my_b_flush_io_cache(&m_file, /*need_append_buffer_lock=*/0) == -1;
+  }
+
+  /// Position the file at the start for reading. Flush() must have been
+  /// called. @retval true on error.
+  bool Rewind() {
+    m_groups_left = m_num_groups;
+    return reinit_io_cache(&m_file, READ_CACHE, 0, false, false);
+  }
+
+  /// Report a failure to read or rewind the run with my_error().
+  void ReportReadError() const {
+    char errbuf[MYSYS_STRERROR_SIZE];
+    my_error(ER_ERROR_ON_READ, MYF(0), my_filename(m_file.file), my_errno(),
+             my_strerror(errbuf, sizeof(errbuf), my_errno()));
+  }
+
+  /// Read the next group into "group". @retval true on error.
+  bool Read(uchar *group, size_t length) {
+    assert(m_groups_left > 0);
+    --m_groups_left;
+    return my_b_read(&m_file, group, length) != 0;
+  }
+
+  bool at_end() const { return m_groups_left == 0; }
+
+ private:
+  IO_CACHE m_file;
+  size_t m_num_groups{0};
+  size_t m_groups_left{0};
+};
+
+/// A sorted input to the merge in ReadGroup(): either a spilled run, or the
+/// groups that are still in memory.
+struct GroupTable::MergeSource {
+  /// nullptr for the groups in memory.
+  SpilledRun *run{nullptr};
+  size_t next_in_memory{0};
+  /// The current group of the source, as written by SerializeGroup().
+  std::vector<uchar> group;
+};
+
+DistinctValues::DistinctValues(const AggregationSpec *spec, size_t max_memory)
+    : m_key_length(spec->group_columns.size() * (1 + sizeof(longlong)) +
+                   sizeof(longlong)) {
+  const size_t num_distinct = std::count_if(
+      spec->aggregates.begin(), spec->aggregates.end(),
+      [](const AggregateSpec &aggregate) {
+        return aggregate.kind == AggregateSpec::Kind::COUNT_DISTINCT;
+      });
+  // Besides its key, a value takes up to 8/3 slots of 16 bytes in the index,
+  // which keeps a quarter of its slots free and has a power of two of them.
+  const size_t value_size = m_key_length + 48;
+  const size_t max_values =
+      std::max<size_t>(max_memory / std::max<size_t>(num_distinct, 1) /
+                           value_size,
+                       1);
+  for (const AggregateSpec &aggregate : spec->aggregates) {
+    if (aggregate.kind == AggregateSpec::Kind::COUNT_DISTINCT) {
+      m_indexes.push_back(std::make_unique<Index>(
+          max_values, Malloc_allocator<uchar>(PSI_NOT_INSTRUMENTED)));
+    } else {
+      m_indexes.push_back(nullptr);
+    }
+  }
+}
+
+temptable::Result DistinctValues::Add(size_t aggregate_idx,
+                                      std::string_view key,
+                                      MEM_ROOT *mem_root) {
+  assert(key.size() == m_key_length);
+  Index *index = m_indexes[aggregate_idx].get();
+  const uint64_t hash = ankerl::unordered_dense::hash<std::string_view>{}(key);
+
+  // Most values are seen many times, so look for the value first, and only
+  // copy the key if it is new.
+  const auto matches = [key](const uchar &value) {
+    return memcmp(&value, key.data(), key.size()) == 0;
+  };
+  if (index->lookup(hash, matches) != nullptr) {
+    return temptable::Result::FOUND_DUPP_KEY;
+  }
+  uchar *copy = mem_root->ArrayAlloc<uchar>(key.size());
+  if (copy == nullptr) return temptable::Result::OUT_OF_MEM;
+  memcpy(copy, key.data(), key.size());
+
+  const size_t key_length = m_key_length;
+  uchar *existing;
+  return index->insert(
+      hash, copy,
+      [key_length](const uchar &a, const uchar &b) {
+        return memcmp(&a, &b, key_length) == 0;
+      },
+      &existing);
+}
+
+GroupTable::GroupTable(const AggregationSpec *spec, size_t max_memory,
+                       DistinctValues *distinct_values)
+    : m_spec(spec),
+      m_max_memory(max_memory),
+      m_distinct_values(distinct_values),
+      m_mem_root(PSI_NOT_INSTRUMENTED, 16384),
+      m_distinct_mem_root(PSI_NOT_INSTRUMENTED, 16384) {
+  m_key.reserve(m_spec->group_columns.size() * (1 + sizeof(longlong)));
+}
+
+GroupTable::~GroupTable() = default;
+
+void GroupTable::MakeKey(const uchar *row) {
+  m_key.clear();
+  for (const GroupColumn &group_column : m_spec->group_columns) {
+    const IntegerColumn &column = group_column.column;
+    const bool is_null = column.IsNull(row);
+    // NULL sorts before all other values, like in filesort.
+    uchar value[1 + sizeof(longlong)];
+    value[0] = is_null ? 0 : 1;
+    ulonglong bits = is_null ? 0 : static_cast<ulonglong>(column.Value(row));
+    if (!column.is_unsigned) bits ^= 1ULL << 63;
+    mi_int8store(value + 1, bits);
+    if (group_column.descending) {
+      for (uchar &byte : value) byte = ~byte;
+    }
+    m_key.append(pointer_cast<const char *>(value), sizeof(value));
+  }
+}
+
+bool GroupTable::OutOfMemory() const {
+  // An estimate of the memory used by the hash map, which has a bucket and an
+  // entry per group.
+  const size_t map_bytes =
+      m_map.size() * (sizeof(*m_map.begin()) + 2 * sizeof(uint32_t));
+  return m_mem_root.allocated_size() + map_bytes +
+             m_groups.capacity() * sizeof(Group *) >
+         m_max_memory;
+}
+
+GroupTable::Group *GroupTable::FindOrInsertGroup(std::string_view key,
+                                                 const uchar *row) {
+  const auto it = m_map.find(key);
+  if (it != m_map.end()) return it->second;
+
+  // Always keep at least one group in memory, however little memory we have.
+  if (OutOfMemory() && !m_groups.empty() && SpillGroups()) return nullptr;
+
+  const size_t num_states = std::max<size_t>(m_spec->aggregates.size(), 1);
+  char *key_copy = m_mem_root.ArrayAlloc<char>(key.size());
+  uchar *row_copy = m_mem_root.ArrayAlloc<uchar>(m_spec->row_length);
+  AggregateState *states = m_mem_root.ArrayAlloc<AggregateState>(num_states);
+  Group *group =
+      new (&m_mem_root) Group{std::string_view(), row_copy, states};
+  if (key_copy == nullptr || row_copy == nullptr || states == nullptr ||
+      group == nullptr) {
+    m_failure = Failure::OUT_OF_MEMORY;
+    m_failed_allocation_size = key.size() + m_spec->row_length +
+                               num_states * sizeof(AggregateState) +
+                               sizeof(Group);
+    return nullptr;
+  }
+  if (!key.empty()) memcpy(key_copy, key.data(), key.size());
+  memcpy(row_copy, row, m_spec->row_length);
+  group->key = std::string_view(key_copy, key.size());
+
+  m_map.emplace(group->key, group);
+  m_groups.push_back(group);
+  return group;
+}
+
+size_t GroupTable::SerializedGroupSize() const {
+  return m_spec->group_columns.size() * (1 + sizeof(longlong)) +
+         m_spec->row_length +
+         m_spec->aggregates.size() * AggregateState::SerializedSize();
+}
+
+void GroupTable::SerializeGroup(const Group &group, uchar *to) const {
+  if (!group.key.empty()) memcpy(to, group.key.data(), group.key.size());
+  to += group.key.size();
+  memcpy(to, group.row, m_spec->row_length);
+  to += m_spec->row_length;
+  for (size_t i = 0; i < m_spec->aggregates.size(); ++i) {
+    group.states[i].Serialize(to);
+    to += AggregateState::SerializedSize();
+  }
+}
+
+bool GroupTable::SpillGroups() {
+  SortGroups();
+  auto run = std::make_unique<SpilledRun>();
+  if (run->Open() ||
+      DBUG_EVALUATE_IF("parallel_aggregate_spill_fails", true, false)) {
+    m_failure = Failure::SPILL_FAILED;
+    return true;
+  }
+  const size_t group_size = SerializedGroupSize();
+  m_spill_buffer.resize(group_size);
+  for (const Group *group : m_groups) {
+    SerializeGroup(*group, m_spill_buffer.data());
+    if (run->Write(m_spill_buffer.data(), group_size)) {
+      m_failure = Failure::SPILL_FAILED;
+      return true;
+    }
+  }
+  m_runs.push_back(std::move(run));
+
+  m_map.clear();
+  m_groups.clear();
+  m_mem_root.ClearForReuse();
+  return false;
+}
+
+bool GroupTable::AddRow(const uchar *row) {
+  ++m_rows_read;
+  for (const ColumnPredicate &predicate : m_spec->predicates) {
+    if (!predicate.Evaluate(row)) return false;
+  }
+
+  MakeKey(row);
+  Group *group = FindOrInsertGroup(m_key, row);
+  if (group == nullptr) return true;
+
+  for (size_t i = 0; i < m_spec->aggregates.size(); ++i) {
+    const AggregateSpec &aggregate = m_spec->aggregates[i];
+    if (aggregate.kind == AggregateSpec::Kind::COUNT_DISTINCT) {
+      if (AddDistinctValue(i, row, group)) return true;
+    } else {
+      group->states[i].Add(aggregate, row);
+    }
+  }
+  return false;
+}
+
+bool GroupTable::AddDistinctValue(size_t aggregate_idx, const uchar *row,
+                                  Group *group) {
+  assert(m_distinct_values != nullptr);
+  const IntegerColumn &column = m_spec->aggregates[aggregate_idx].column;
+  if (column.IsNull(row)) return false;
+
+  uchar value[sizeof(longlong)];
+  int8store(value, static_cast<ulonglong>(column.Value(row)));
+  m_distinct_key.assign(group->key);
+  m_distinct_key.append(pointer_cast<const char *>(value), sizeof(value));
+  switch (m_distinct_values->Add(aggregate_idx, m_distinct_key,
+                                 &m_distinct_mem_root)) {
+    case temptable::Result::OK:
+      ++group->states[aggregate_idx].count;
+      return false;
+    case temptable::Result::FOUND_DUPP_KEY:
+      // Counted by whoever added it first.
+      return false;
+    case temptable::Result::OUT_OF_MEM:
+      m_failure = Failure::OUT_OF_MEMORY;
+      m_failed_allocation_size = m_distinct_key.size();
+      return true;
+    default:
+      m_failure = Failure::NO_ROOM;
+      return true;
+  }
+}
+
+bool GroupTable::Merge(GroupTable *other) {
+  assert(m_spec == other->m_spec);
+  m_rows_read += other->m_rows_read;
+  for (const Group *other_group : other->m_groups) {
+    Group *group = FindOrInsertGroup(other_group->key, other_group->row);
+    if (group == nullptr) return true;
+    for (size_t i = 0; i < m_spec->aggregates.size(); ++i) {
+      group->states[i].Merge(m_spec->aggregates[i], other_group->states[i]);
+    }
+  }
+  for (std::unique_ptr<SpilledRun> &run : other->m_runs) {
+    m_runs.push_back(std::move(run));
+  }
+  other->m_runs.clear();
+  return false;
+}
+
+bool GroupTable::ReportFailure() const {
+  switch (m_failure) {
+    case Failure::OUT_OF_MEMORY:
+      my_error(ER_OUTOFMEMORY, MYF(ME_FATALERROR),
+               static_cast<int>(m_failed_allocation_size));
+      return true;
+    case Failure::SPILL_FAILED:
+      my_error(ER_TEMP_FILE_WRITE_FAILURE, MYF(0));
+      return true;
+    case Failure::NONE:
+    case Failure::NO_ROOM:
+      break;
+  }
+  return false;
+}
+
+void GroupTable::SortGroups() {
+  if (m_spec->group_columns.empty()) return;
+
+  // The keys are made so that memcmp() gives the right order; see MakeKey().
+  std::sort(m_groups.begin(), m_groups.end(),
+            [](const Group *a, const Group *b) {
+              return memcmp(a->key.data(), b->key.data(), a->key.size()) < 0;
+            });
+}
+
+// The merge heap is a min-heap on the key of the current group of each source.
+static bool GreaterKey(const std::vector<uchar> &a, const std::vector<uchar> &b,
+                       size_t key_length) {
+  return memcmp(a.data(), b.data(), key_length) > 0;
+}
+
+bool GroupTable::StartReading() {
+  SortGroups();
+  m_next_group = 0;
+  m_merge_sources.clear();
+  m_merge_heap.clear();
+  if (m_runs.empty()) return false;
+
+  const size_t group_size = SerializedGroupSize();
+  const size_t key_length =
+      m_spec->group_columns.size() * (1 + sizeof(longlong));
+  for (std::unique_ptr<SpilledRun> &run : m_runs) {
+    if (run->Flush()) {
+      my_error(ER_TEMP_FILE_WRITE_FAILURE, MYF(0));
+      return true;
+    }
+    if (run->Rewind()) {
+      run->ReportReadError();
+      return true;
+    }
+    m_merge_sources.push_back(std::make_unique<MergeSource>());
+    m_merge_sources.back()->run = run.get();
+  }
+  m_merge_sources.push_back(std::make_unique<MergeSource>());
+
+  for (std::unique_ptr<MergeSource> &source : m_merge_sources) {
+    source->group.resize(group_size);
+    if (SourceAtEnd(*source)) continue;
+    if (AdvanceSource(source.get())) {
+      // Only runs can fail to advance.
+      source->run->ReportReadError();
+      return true;
+    }
+    m_merge_heap.push_back(source.get());
+  }
+  std::make_heap(m_merge_heap.begin(), m_merge_heap.end(),
+                 [key_length](const MergeSource *a, const MergeSource *b) {
+                   return GreaterKey(a->group, b->group, key_length);
+                 });
+
+  m_merged_key.resize(key_length);
+  m_merged_row.resize(m_spec->row_length);
+  m_merged_states.resize(std::max<size_t>(m_spec->aggregates.size(), 1));
+  return false;
+}
+
+bool GroupTable::SourceAtEnd(const MergeSource &source) const {
+  return source.run == nullptr ? source.next_in_memory == m_groups.size()
+                               : source.run->at_end();
+}
+
+bool GroupTable::AdvanceSource(MergeSource *source) {
+  if (source->run != nullptr) {
+    return source->run->Read(source->group.data(), source->group.size());
+  }
+  SerializeGroup(*m_groups[source->next_in_memory++], source->group.data());
+  return false;
+}
+
+void GroupTable::MergeFromSource(const MergeSource &source) {
+  const uchar *states = source.group.data() + m_merged_key.size() +
+                        m_spec->row_length;
+  for (size_t i = 0; i < m_spec->aggregates.size(); ++i) {
+    AggregateState state;
+    state.Deserialize(states + i * AggregateState::SerializedSize());
+    m_merged_states[i].Merge(m_spec->aggregates[i], state);
+  }
+}
+
+int GroupTable::ReadGroup(const Group **group) {
+  if (m_runs.empty()) {
+    if (m_next_group == m_groups.size()) return -1;
+    *group = m_groups[m_next_group++];
+    return 0;
+  }
+
+  if (m_merge_heap.empty()) return -1;
+
+  const size_t key_length = m_merged_key.size();
+  const auto greater = [key_length](const MergeSource *a,
+                                    const MergeSource *b) {
+    return GreaterKey(a->group, b->group, key_length);
+  };
+
+  // Take the smallest group, and combine it with the same group from all the
+  // other sources. Each source holds a group at most once.
+  bool first = true;
+  while (!m_merge_heap.empty() &&
+         (first || memcmp(m_merge_heap.front()->group.data(),
+                          m_merged_key.data(), key_length) == 0)) {
+    std::pop_heap(m_merge_heap.begin(), m_merge_heap.end(), greater);
+    MergeSource *source = m_merge_heap.back();
+    if (first) {
+      // The first row seen in the group in any source is as good as any.
+      memcpy(m_merged_key.data(), source->group.data(), key_length);
+      memcpy(m_merged_row.data(), source->group.data() + key_length,
+             m_spec->row_length);
+      for (AggregateState &state : m_merged_states) state = AggregateState();
+      first = false;
+    }
+    MergeFromSource(*source);
+
+    if (SourceAtEnd(*source)) {
+      m_merge_heap.pop_back();
+    } else {
+      if (AdvanceSource(source)) {
+        source->run->ReportReadError();
+        return 1;
+      }
+      std::push_heap(m_merge_heap.begin(), m_merge_heap.end(), greater);
+    }
+  }
+
+  m_merged_group.key = std::string_view(m_merged_key);
+  m_merged_group.row = m_merged_row.data();
+  m_merged_group.states = m_merged_states.data();
+  *group = &m_merged_group;
+  return 0;
+}
+
+Field *GetIntegerColumn(Item *item, const TABLE *table) {
+  Item *real_item = item->real_item();
+  if (real_item->type() != Item::FIELD_ITEM) return nullptr;
+  Field *field = down_cast<Item_field *>(real_item)->field;
+  if (field->table != table || !IntegerColumn::IsSupported(field)) {
+    return nullptr;
+  }
+  return field;
+}
+
+/// @returns true if the item is an integer constant that can be evaluated
+/// once before the scan.
+static bool IsIntegerConstant(const Item *item) {
+  return item->const_item() && is_integer_type(item->data_type()) &&
+         !item->has_subquery() && !item->has_stored_program();
+}
+
+bool ConvertCondition(Item *condition, const TABLE *table,
+                      std::vector<ColumnPredicate> *predicates) {
+  if (condition->type() == Item::COND_ITEM) {
+    Item_cond *cond = down_cast<Item_cond *>(condition);
+    if (cond->functype() != Item_func::COND_AND_FUNC) return false;
+    for (Item &item : *cond->argument_list()) {
+      if (!ConvertCondition(&item, table, predicates)) return false;
+    }
+    return true;
+  }
+  if (condition->type() != Item::FUNC_ITEM) return false;
+
+  Item_func *func = down_cast<Item_func *>(condition);
+  ColumnPredicate predicate;
+  switch (func->functype()) {
+    case Item_func::ISNULL_FUNC:
+    case Item_func::ISNOTNULL_FUNC: {
+      const Field *field = GetIntegerColumn(func->arguments()[0], table);
+      if (field == nullptr) return false;
+      predicate.column = IntegerColumn::FromField(field);
+      predicate.op = func->functype() == Item_func::ISNULL_FUNC
+                         ? ColumnPredicate::Op::IS_NULL
+                         : ColumnPredicate::Op::IS_NOT_NULL;
+      predicates->push_back(predicate);
+      return true;
+    }
+    case Item_func::EQ_FUNC:
+      predicate.op = ColumnPredicate::Op::EQ;
+      break;
+    case Item_func::NE_FUNC:
+      predicate.op = ColumnPredicate::Op::NE;
+      break;
+    case Item_func::LT_FUNC:
+      predicate.op = ColumnPredicate::Op::LT;
+      break;
+    case Item_func::LE_FUNC:
+      predicate.op = ColumnPredicate::Op::LE;
+      break;
+    case Item_func::GT_FUNC:
+      predicate.op = ColumnPredicate::Op::GT;
+      break;
+    case Item_func::GE_FUNC:
+      predicate.op = ColumnPredicate::Op::GE;
+      break;
+    default:
+      return false;
+  }
+
+  Item **args = func->arguments();
+  const Field *field = GetIntegerColumn(args[0], table);
+  Item *constant = args[1];
+  if (field == nullptr) {
+    // "constant <op> column"; turn it around.
+    field = GetIntegerColumn(args[1], table);
+    constant = args[0];
+    switch (predicate.op) {
+      case ColumnPredicate::Op::LT:
+        predicate.op = ColumnPredicate::Op::GT;
+        break;
+      case ColumnPredicate::Op::LE:
+        predicate.op = ColumnPredicate::Op::GE;
+        break;
+      case ColumnPredicate::Op::GT:
+        predicate.op = ColumnPredicate::Op::LT;
+        break;
+      case ColumnPredicate::Op::GE:
+        predicate.op = ColumnPredicate::Op::LE;
+        break;
+      default:
+        break;
+    }
+  }
+  if (field == nullptr || !IsIntegerConstant(constant)) return false;
+
+  predicate.column = IntegerColumn::FromField(field);
+  predicate.constant = constant;
+  predicates->push_back(predicate);
+  return true;
+}
+
+bool ConvertAggregate(Item_sum *item, const TABLE *table,
+                      AggregateSpec *aggregate) {
+  if ((item->has_with_distinct() &&
+       item->sum_func() != Item_sum::COUNT_DISTINCT_FUNC) ||
+      item->m_is_window_function || item->argument_count() != 1) {
+    return false;
+  }
+  Item *arg = item->get_arg(0);
+  switch (item->sum_func()) {
+    case Item_sum::COUNT_FUNC:
+      if (arg->const_item() && !arg->is_nullable() && !arg->has_subquery() &&
+          !arg->has_stored_program()) {
+        aggregate->kind = AggregateSpec::Kind::COUNT_ROWS;
+        return true;
+      }
+      aggregate->kind = AggregateSpec::Kind::COUNT;
+      break;
+    case Item_sum::COUNT_DISTINCT_FUNC:
+      aggregate->kind = AggregateSpec::Kind::COUNT_DISTINCT;
+      break;
+    case Item_sum::SUM_FUNC:
+    case Item_sum::AVG_FUNC:
+      // Integers are summed as DECIMAL.
+      if (item->data_type() != MYSQL_TYPE_NEWDECIMAL) return false;
+      aggregate->kind = AggregateSpec::Kind::SUM;
+      break;
+    case Item_sum::MIN_FUNC:
+      aggregate->kind = AggregateSpec::Kind::MIN;
+      break;
+    case Item_sum::MAX_FUNC:
+      aggregate->kind = AggregateSpec::Kind::MAX;
+      break;
+    default:
+      return false;
+  }
+  const Field *field = GetIntegerColumn(arg, table);
+  if (field == nullptr) return false;
+  aggregate->column = IntegerColumn::FromField(field);
+  return true;
+}
+
+std::unique_ptr<AggregationSpec> MakeAggregationSpec(
+    THD *thd, const AccessPath *aggregate_path, const JOIN *join,
+    const AccessPath **table_scan_path) {
+  if (join == nullptr || join->sum_funcs == nullptr ||
+      aggregate_path->aggregate().rollup || join->group_optimized_away ||
+      join->tmp_table_param.precomputed_group_by) {
+    return nullptr;
+  }
+
+  const AccessPath *sort_path = nullptr;
+  const AccessPath *scan_path = aggregate_path->aggregate().child;
+  if (scan_path->type == AccessPath::SORT) {
+    sort_path = scan_path;
+    scan_path = sort_path->sort().child;
+  }
+  Item *condition = nullptr;
+  if (scan_path->type == AccessPath::FILTER) {
+    if (scan_path->filter().materialize_subqueries) return nullptr;
+    condition = scan_path->filter().condition;
+    scan_path = scan_path->filter().child;
+  }
+  if (scan_path->type != AccessPath::TABLE_SCAN) return nullptr;
+  *table_scan_path = scan_path;
+
+  // The parallel scan reads a consistent snapshot without locking, which is
+  // only what a plain SELECT would do.
+  const TABLE *table = scan_path->table_scan().table;
+  if (table->s->tmp_table != NO_TMP_TABLE ||
+      table->reginfo.lock_type != TL_READ ||
+      thd->tx_isolation == ISO_SERIALIZABLE) {
+    return nullptr;
+  }
+
+  auto spec = std::make_unique<AggregationSpec>();
+  spec->row_length = table->s->reclength;
+
+  if (join->grouped) {
+    // The sort must be on the grouping columns and nothing else; then the
+    // groups can be returned in the order the sort would have returned them.
+    if (sort_path == nullptr || sort_path->sort().order == nullptr ||
+        sort_path->sort().limit != HA_POS_ERROR ||
+        sort_path->sort().remove_duplicates) {
+      return nullptr;
+    }
+    std::vector<const Field *> sort_fields;
+    for (ORDER *order = sort_path->sort().order; order != nullptr;
+         order = order->next) {
+      const Field *field = GetIntegerColumn(*order->item, table);
+      if (field == nullptr) return nullptr;
+      spec->group_columns.push_back(
+          {IntegerColumn::FromField(field), order->direction == ORDER_DESC});
+      sort_fields.push_back(field);
+    }
+    size_t num_group_fields = 0;
+    for (ORDER *group = join->query_block->group_list.first; group != nullptr;
+         group = group->next, ++num_group_fields) {
+      const Field *field = GetIntegerColumn(*group->item, table);
+      if (field == nullptr || std::find(sort_fields.begin(), sort_fields.end(),
+                                        field) == sort_fields.end()) {
+        return nullptr;
+      }
+    }
+    if (num_group_fields != sort_fields.size()) return nullptr;
+  } else if (sort_path != nullptr || !join->implicit_grouping) {
+    return nullptr;
+  }
+
+  if (condition != nullptr &&
+      !ConvertCondition(condition, table, &spec->predicates)) {
+    return nullptr;
+  }
+  for (Item_sum **item = join->sum_funcs; *item != nullptr; ++item) {
+    AggregateSpec aggregate;
+    if (!ConvertAggregate(*item, table, &aggregate)) return nullptr;
+    spec->aggregates.push_back(aggregate);
+  }
+  // All the columns that are read must be integers, so that the first row in
+  // each group can be loaded back into the record buffer.
+  for (uint i = 0; i < table->s->fields; ++i) {
+    if (!bitmap_is_set(table->read_set, i)) continue;
+    const Field *field = table->field[i];
+    if (!IntegerColumn::IsSupported(field)) return nullptr;
+    spec->output_columns.push_back(IntegerColumn::FromField(field));
+  }
+  return spec;
+}
+
+}  // namespace parallel_aggregate
+
+using parallel_aggregate::AggregateSpec;
+using parallel_aggregate::AggregateState;
+using parallel_aggregate::ColumnPredicate;
+using parallel_aggregate::DistinctValues;
+using parallel_aggregate::GroupTable;
+using parallel_aggregate::IntegerColumn;
+
+ParallelAggregateIterator::ParallelAggregateIterator(
+    THD *thd, JOIN *join, TABLE *table,
+    std::unique_ptr<parallel_aggregate::AggregationSpec> spec,
+    unique_ptr_destroy_only<RowIterator> serial_iterator,
+    ha_rows *examined_rows)
+    : RowIterator(thd),
+      m_join(join),
+      m_table(table),
+      m_spec(std::move(spec)),
+      m_serial_iterator(std::move(serial_iterator)),
+      m_examined_rows(examined_rows) {}
+
+bool ParallelAggregateIterator::Init() {
+  m_groups.reset();
+  m_returned_empty_row = false;
+  m_save_nullinfo = 0;
+
+  // The scanning threads cannot evaluate Items, so the constants in the
+  // filter are evaluated up front. (They may be different for each execution,
+  // e.g. in prepared statements.)
+  for (ColumnPredicate &predicate : m_spec->predicates) {
+    if (predicate.constant == nullptr) continue;
+    predicate.value = predicate.constant->val_int();
+    predicate.value_is_null = predicate.constant->null_value;
+    predicate.value_is_unsigned = predicate.constant->unsigned_flag;
+    if (thd()->is_error()) return true;
+  }
+
+  switch (ScanInParallel()) {
+    case ScanResult::ERROR:
+      return true;
+    case ScanResult::FALL_BACK:
+      m_groups.reset();
+      m_use_serial_iterator = true;
+      return m_serial_iterator->Init();
+    case ScanResult::OK:
+      m_use_serial_iterator = false;
+      break;
+  }
+
+  // See AggregateIterator::Init().
+  m_output_slice = -1;
+  if (!(m_join->implicit_grouping || m_join->group_optimized_away) &&
+      !thd()->lex->using_hypergraph_optimizer()) {
+    m_output_slice = m_join->get_ref_item_slice();
+  }
+  return false;
+}
+
+ParallelAggregateIterator::ScanResult
+ParallelAggregateIterator::ScanInParallel() {
+  // The groups of all threads together must fit in tmp_table_size, just like
+  // a temporary table used for grouping; beyond that, they are spilled to
+  // disk. If there is a COUNT(DISTINCT), its values get half of the memory.
+  size_t max_memory = thd()->variables.tmp_table_size;
+  std::unique_ptr<DistinctValues> distinct_values;
+  if (std::any_of(m_spec->aggregates.begin(), m_spec->aggregates.end(),
+                  [](const AggregateSpec &aggregate) {
+                    return aggregate.kind ==
+                           AggregateSpec::Kind::COUNT_DISTINCT;
+                  })) {
+    max_memory /= 2;
+    try {
+      distinct_values =
+          std::make_unique<DistinctValues>(m_spec.get(), max_memory);
+    } catch (const std::bad_alloc &) {
+      return ScanResult::ERROR;
+    }
+  }
+
+  handler *const file = m_table->file;
+  void *scan_ctx = nullptr;
+  size_t num_threads = 0;
+  int error = file->parallel_scan_init(scan_ctx, &num_threads,
+                                       /*use_reserved_threads=*/false);
+  if (error != 0 || scan_ctx == nullptr || num_threads == 0) {
+    // Typically, all the parallel read threads are in use by other queries.
+    if (error == 0 && scan_ctx != nullptr) file->parallel_scan_end(scan_ctx);
+    return thd()->is_error() ? ScanResult::ERROR : ScanResult::FALL_BACK;
+  }
+
+  std::vector<std::unique_ptr<GroupTable>> thread_groups;
+  std::vector<void *> thread_ctxs;
+  for (size_t i = 0; i < num_threads; ++i) {
+    thread_groups.push_back(std::make_unique<GroupTable>(
+        m_spec.get(), max_memory / num_threads, distinct_values.get()));
+    thread_ctxs.push_back(thread_groups.back().get());
+  }
+
+  std::atomic<bool> fall_back{false};
+  THD *const session = thd();
+  const size_t row_length = m_spec->row_length;
+
+  error = file->parallel_scan(
+      scan_ctx, thread_ctxs.data(),
+      [&fall_back, row_length](void *, ulong, ulong row_len, const ulong *,
+                               const ulong *, const ulong *) {
+        if (row_len != row_length) {
+          fall_back = true;
+          return true;
+        }
+        return false;
+      },
+      [&fall_back, session, row_length](void *cookie, uint num_rows,
+                                        void *rowdata, uint64_t) {
+        if (session->killed || fall_back) return true;
+        GroupTable *groups = static_cast<GroupTable *>(cookie);
+        const uchar *row = static_cast<const uchar *>(rowdata);
+        for (uint i = 0; i < num_rows; ++i, row += row_length) {
+          if (groups->AddRow(row)) {
+            fall_back = true;
+            return true;
+          }
+        }
+        return false;
+      },
+      [](void *) {});
+  file->parallel_scan_end(scan_ctx);
+
+  if (error != 0) {
+    if (fall_back && !thd()->killed) {
+      // Errors in the scanning threads are reported here, in the session
+      // thread. Only a lack of room for distinct values, or rows that are not
+      // in the expected format, are left to the serial iterators.
+      for (const std::unique_ptr<GroupTable> &groups : thread_groups) {
+        if (groups->ReportFailure()) return ScanResult::ERROR;
+      }
+      return ScanResult::FALL_BACK;
+    }
+    if (!thd()->is_error()) file->print_error(error, MYF(0));
+    return ScanResult::ERROR;
+  }
+
+  m_groups = std::make_unique<GroupTable>(m_spec.get(), max_memory);
+  for (std::unique_ptr<GroupTable> &groups : thread_groups) {
+    if (m_groups->Merge(groups.get())) {
+      m_groups->ReportFailure();
+      return ScanResult::ERROR;
+    }
+    groups.reset();
+  }
+  if (m_groups->StartReading()) return ScanResult::ERROR;
+
+  if (m_examined_rows != nullptr) {
+    *m_examined_rows += m_groups->rows_read();
+  }
+  return ScanResult::OK;
+}
+
+bool ParallelAggregateIterator::LoadGroup(const GroupTable::Group &group) {
+  uchar *record = m_table->record[0];
+  for (const IntegerColumn &column : m_spec->output_columns) {
+    column.CopyValue(group.row, record);
+  }
+  m_table->set_found_row();
+
+  // Give the merged partial results to the aggregate functions, as if
+  // AggregateIterator had added all the rows of the group to them.
+  bool restore_row = false;
+  size_t idx = 0;
+  for (Item_sum **item = m_join->sum_funcs; *item != nullptr; ++item, ++idx) {
+    const AggregateSpec &aggregate = m_spec->aggregates[idx];
+    const AggregateState &state = group.states[idx];
+    (*item)->aggregator_clear();
+    switch (aggregate.kind) {
+      case AggregateSpec::Kind::COUNT_ROWS:
+      case AggregateSpec::Kind::COUNT:
+        down_cast<Item_sum_count *>(*item)->add_partial_count(state.count);
+        break;
+      case AggregateSpec::Kind::COUNT_DISTINCT:
+        down_cast<Item_sum_count *>(*item)->set_distinct_count(state.count);
+        break;
+      case AggregateSpec::Kind::SUM: {
+        my_decimal sum;
+        state.GetSum(&sum);
+        down_cast<Item_sum_sum *>(*item)->add_partial_sum(&sum, state.count);
+        break;
+      }
+      case AggregateSpec::Kind::MIN:
+      case AggregateSpec::Kind::MAX:
+        // Let MIN or MAX see a single row with the extreme value.
+        if (state.count > 0) {
+          aggregate.column.StoreValue(state.extreme, record);
+          restore_row = true;
+          if ((*item)->aggregator_add()) return true;
+        }
+        break;
+    }
+  }
+
+  if (restore_row) {
+    for (const IntegerColumn &column : m_spec->output_columns) {
+      column.CopyValue(group.row, record);
+    }
+  }
+  return thd()->is_error();
+}
+
+int ParallelAggregateIterator::Read() {
+  if (m_use_serial_iterator) {
+    return m_serial_iterator->Read();
+  }
+
+  const GroupTable::Group *group;
+  const int result = m_groups->ReadGroup(&group);
+  if (result == 1) return 1;
+  if (result == 0) {
+    if (LoadGroup(*group)) {
+      return 1;
+    }
+    if (m_output_slice != -1) {
+      m_join->set_ref_item_slice(m_output_slice);
+    }
+    return 0;
+  }
+
+  if (m_groups->empty() && !m_join->grouped &&
+      !m_returned_empty_row) {
+    // Without GROUP BY, we need to output a row even if there are no input
+    // rows. See AggregateIterator::Read().
+    m_returned_empty_row = true;
+    for (Item *item : *m_join->get_current_fields()) {
+      if (!item->hidden ||
+          (item->type() == Item::SUM_FUNC_ITEM &&
+           down_cast<Item_sum *>(item)->aggr_query_block ==
+               m_join->query_block)) {
+        item->no_rows_in_result();
+      }
+    }
+    if (m_join->clear_fields(&m_save_nullinfo)) {
+      return 1;
+    }
+    // This also empties the values of any COUNT(DISTINCT) from an earlier
+    // execution.
+    for (Item_sum **item = m_join->sum_funcs; *item != nullptr; ++item) {
+      (*item)->aggregator_clear();
+    }
+    if (m_output_slice != -1) {
+      m_join->set_ref_item_slice(m_output_slice);
+    }
+    return 0;
+  }
+
+  if (m_save_nullinfo != 0) {
+    m_join->restore_fields(m_save_nullinfo);
+    m_save_nullinfo = 0;
+  }
+  return -1;
+}
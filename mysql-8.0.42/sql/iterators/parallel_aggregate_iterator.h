@@ -0,0 +1,616 @@
+#ifndef SQL_ITERATORS_PARALLEL_AGGREGATE_ITERATOR_H_
+#define SQL_ITERATORS_PARALLEL_AGGREGATE_ITERATOR_H_
+
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/// @file
+///
+/// This file contains the ParallelAggregateIterator class, which computes
+/// an aggregation over a full table scan by scanning the table with several
+/// threads, and the classes it uses for aggregating rows in those threads.
+
+#include <stddef.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <ankerl/unordered_dense.h>
+
+#include "my_alloc.h"
+#include "my_base.h"
+#include "my_inttypes.h"
+#include "my_table_map.h"
+#include "sql/iterators/row_iterator.h"
+#include "sql/malloc_allocator.h"
+#include "sql/my_decimal.h"
+#include "storage/temptable/include/temptable/lock_free_hash_index.h"
+#include "storage/temptable/include/temptable/result.h"
+
+class Field;
+class Item;
+class Item_sum;
+class JOIN;
+class THD;
+struct AccessPath;
+struct TABLE;
+
+namespace parallel_aggregate {
+
+/**
+  An integer column, read directly from the bytes of a row in the format of
+  TABLE::record[0]. Unlike Field, this can be used by several threads at the
+  same time, and on rows that do not lie in the record buffers of the table.
+ */
+struct IntegerColumn {
+  /// @returns true if the column can be read with this class: a stored
+  /// TINYINT, SMALLINT, MEDIUMINT, INT or BIGINT column.
+  static bool IsSupported(const Field *field);
+
+  static IntegerColumn FromField(const Field *field);
+
+  bool IsNull(const uchar *row) const {
+    return null_bit != 0 && (row[null_offset] & null_bit) != 0;
+  }
+
+  /// @returns the value of the column. Unsigned BIGINT values are returned
+  /// as the bit pattern of the value, like Field::val_int() does.
+  longlong Value(const uchar *row) const;
+
+  /// Copy the value of the column, including the NULL flag, from one row to
+  /// another.
+  void CopyValue(const uchar *from, uchar *to) const;
+
+  /// Store a non-NULL value into the column of a row.
+  void StoreValue(longlong value, uchar *row) const;
+
+  size_t offset{0};
+  size_t length{0};
+  size_t null_offset{0};
+  /// Zero if the column is NOT NULL.
+  uchar null_bit{0};
+  bool is_unsigned{false};
+};
+
+/// Compare two integers that may or may not be unsigned, like
+/// Arg_comparator does. @returns -1, 0 or 1.
+int CompareIntegers(longlong a, bool a_unsigned, longlong b, bool b_unsigned);
+
+/// A condition on a single integer column, which can be evaluated without
+/// going through Item: "column <op> constant", "column IS NULL" or
+/// "column IS NOT NULL".
+struct ColumnPredicate {
+  enum class Op { EQ, NE, LT, LE, GT, GE, IS_NULL, IS_NOT_NULL };
+
+  /// @returns true if the row satisfies the condition. NULL compares as
+  /// false, like in a WHERE clause.
+  bool Evaluate(const uchar *row) const;
+
+  IntegerColumn column;
+  Op op{Op::EQ};
+
+  /// The constant to compare with. Its value is cached in "value" before the
+  /// scan starts (see ParallelAggregateIterator::Init()), so that the scanning
+  /// threads never look at the Item.
+  Item *constant{nullptr};
+  longlong value{0};
+  bool value_is_unsigned{false};
+  bool value_is_null{false};
+};
+
+/// An aggregate function that can be computed in pieces and merged.
+struct AggregateSpec {
+  enum class Kind {
+    /// COUNT(*), or COUNT over a constant that is never NULL.
+    COUNT_ROWS,
+    /// COUNT(column).
+    COUNT,
+    /// SUM(column) or AVG(column); an AVG is computed from the sum and the
+    /// count.
+    SUM,
+    MIN,
+    MAX,
+    /// COUNT(DISTINCT column). The distinct values are shared by all the
+    /// threads; see DistinctValues.
+    COUNT_DISTINCT
+  };
+
+  Kind kind{Kind::COUNT_ROWS};
+  /// Not used for COUNT_ROWS.
+  IntegerColumn column;
+};
+
+/// The partial result of an aggregate function over some of the rows in a
+/// group.
+struct AggregateState {
+  AggregateState() { my_decimal_set_zero(&decimal_sum); }
+
+  /// Add a row to the state.
+  void Add(const AggregateSpec &spec, const uchar *row);
+
+  /// Add all the rows in another state for the same aggregate function.
+  void Merge(const AggregateSpec &spec, const AggregateState &other);
+
+  /// Get the sum of the values added to the state (for SUM).
+  void GetSum(my_decimal *sum) const;
+
+  /// @returns the number of bytes Serialize() writes.
+  static size_t SerializedSize();
+
+  /// Write the state to a buffer of SerializedSize() bytes, so that it can be
+  /// stored in a temporary file. (The state cannot be copied byte by byte,
+  /// since my_decimal points into itself.)
+  void Serialize(uchar *to) const;
+
+  /// Read a state written by Serialize().
+  void Deserialize(const uchar *from);
+
+  /// The number of rows added, not counting rows where the column is NULL.
+  ulonglong count{0};
+
+  /// The smallest (for MIN) or largest (for MAX) value seen, if count > 0.
+  longlong extreme{0};
+
+ private:
+  void AddToSum(longlong value, bool is_unsigned);
+
+  /// The sum is accumulated in a 64-bit integer, and only moved over to
+  /// decimal_sum when the integer would overflow.
+  longlong int_sum{0};
+  my_decimal decimal_sum;
+};
+
+/// A column to group on, with the order the groups are to be returned in.
+struct GroupColumn {
+  IntegerColumn column;
+  bool descending{false};
+};
+
+/// A description of what to compute from the rows of the table. This is
+/// shared by all the threads, and must not change while they are scanning.
+struct AggregationSpec {
+  /// All of these must be true for a row to be aggregated.
+  std::vector<ColumnPredicate> predicates;
+
+  /// The columns to group on. Empty for implicit grouping.
+  std::vector<GroupColumn> group_columns;
+
+  std::vector<AggregateSpec> aggregates;
+
+  /// The columns that are loaded into the record buffer of the table for
+  /// every group. All of them must be read by the scan.
+  std::vector<IntegerColumn> output_columns;
+
+  /// The length of a row, as delivered by the scan.
+  size_t row_length{0};
+};
+
+/**
+  The values seen so far by the COUNT(DISTINCT) aggregates, in each group.
+  All the scanning threads add to the same values at the same time, through
+  lock-free hash indexes (see temptable::Lock_free_hash_index), one per
+  COUNT(DISTINCT) aggregate. A value is counted only by the thread that adds
+  it first, in the partial state of its group in that thread, so when the
+  partial states of all threads are merged, every distinct value in a group
+  has been counted exactly once.
+
+  The indexes do not grow. If one of them fills up, the scan is given up, and
+  the aggregation is done by the serial iterators instead.
+ */
+class DistinctValues {
+ public:
+  /**
+    @param spec what to compute. Must outlive this object.
+    @param max_memory the amount of memory the values may use.
+
+    @throws std::bad_alloc if the indexes could not be allocated. The error
+      has been reported.
+   */
+  DistinctValues(const AggregationSpec *spec, size_t max_memory);
+
+  DistinctValues(const DistinctValues &) = delete;
+  DistinctValues &operator=(const DistinctValues &) = delete;
+
+  /// The length of the key of a value: the key of its group, followed by the
+  /// value. See GroupTable::MakeKey().
+  size_t key_length() const { return m_key_length; }
+
+  /**
+    Add a value of a COUNT(DISTINCT) aggregate, unless it is already there.
+    May be called by several threads at the same time.
+
+    @param aggregate_idx which aggregate the value is for.
+    @param key the key of the value, of key_length() bytes.
+    @param mem_root where to keep a copy of the key. It must not be cleared
+      while this object is in use.
+
+    @retval temptable::Result::OK the value was added, and the caller is to
+      count it
+    @retval temptable::Result::FOUND_DUPP_KEY the value was already there
+    @retval temptable::Result::RECORD_FILE_FULL there is no room for the
+      value
+    @retval temptable::Result::OUT_OF_MEM the key could not be copied
+   */
+  temptable::Result Add(size_t aggregate_idx, std::string_view key,
+                        MEM_ROOT *mem_root);
+
+ private:
+  /// The keys are stored as arrays of key_length() bytes.
+  using Index =
+      temptable::Lock_free_hash_index<uchar, Malloc_allocator<uchar>>;
+
+  const size_t m_key_length;
+
+  /// An index for every aggregate; nullptr for those that are not
+  /// COUNT(DISTINCT).
+  std::vector<std::unique_ptr<Index>> m_indexes;
+};
+
+/**
+  The groups seen so far, with a partial aggregate state for every aggregate
+  function in each group, and the first row seen in each group. Each scanning
+  thread has its own GroupTable; when the scan is done, they are merged into
+  one.
+
+  If the groups do not fit in the memory given to the table, the table
+  spills: the groups are sorted, written to a temporary file as a sorted run,
+  and removed from memory, and the table starts over with no groups. A group
+  may then be spread over several runs, each holding a partial state for it.
+  When the groups are read (see StartReading()), the runs and the groups in
+  memory are merged, and the partial states of each group are combined. Since
+  the runs are sorted in the order the groups are to be returned in, this
+  needs only a single pass over each run.
+
+  Only ParallelAggregateIterator uses this table, so spilling only applies to
+  the GROUP BY queries it can handle (integer columns of a single table and
+  splittable aggregate functions). Other GROUP BY queries still aggregate
+  through a temporary table, or a sort, as before.
+ */
+class GroupTable {
+ public:
+  struct Group {
+    std::string_view key;
+    /// The first row seen in the group; it is loaded into the record buffer
+    /// of the table before the group is returned.
+    const uchar *row;
+    AggregateState *states;
+  };
+
+  /**
+    @param spec what to compute. Must outlive the table.
+    @param max_memory the amount of memory the table may use. If it needs
+      more, the groups are spilled to a temporary file.
+    @param distinct_values where the threads add the values of COUNT(DISTINCT)
+      aggregates. Only needed if rows are to be added with AddRow().
+   */
+  GroupTable(const AggregationSpec *spec, size_t max_memory,
+             DistinctValues *distinct_values = nullptr);
+  ~GroupTable();
+
+  GroupTable(const GroupTable &) = delete;
+  GroupTable &operator=(const GroupTable &) = delete;
+
+  /// Why AddRow() or Merge() failed.
+  enum class Failure {
+    NONE,
+    OUT_OF_MEMORY,
+    /// The groups could not be written to a temporary file.
+    SPILL_FAILED,
+    /// There was no room for a distinct value (see DistinctValues). This is
+    /// not an error; the aggregation can still be done serially.
+    NO_ROOM
+  };
+
+  /// Aggregate a row, if it satisfies the predicates.
+  /// @retval true on failure; see failure(). No error is reported, since
+  ///   this may be called from other threads than the session thread.
+  bool AddRow(const uchar *row);
+
+  /// Add all the groups and partial states in another table, and take over
+  /// the runs it has spilled.
+  /// @retval true on failure; see failure(). No error is reported.
+  bool Merge(GroupTable *other);
+
+  Failure failure() const { return m_failure; }
+
+  /// Report the failure of AddRow() or Merge() with my_error(), unless it is
+  /// Failure::NO_ROOM. Must be called by the session thread.
+  /// @returns true if an error was reported.
+  bool ReportFailure() const;
+
+  /// Sort the groups in memory in the order given by the group columns.
+  void SortGroups();
+
+  /// The number of groups in memory, that is, not counting the groups that
+  /// have been spilled to disk.
+  size_t num_groups() const { return m_groups.size(); }
+  const Group &group(size_t idx) const { return *m_groups[idx]; }
+
+  /// The number of sorted runs that have been spilled to disk.
+  size_t num_spilled_runs() const { return m_runs.size(); }
+
+  /// @returns true if no row has been aggregated into any group.
+  bool empty() const { return m_groups.empty() && m_runs.empty(); }
+
+  /**
+    Prepare for reading all the groups with ReadGroup(), in the order given by
+    the group columns. No more rows can be added after this.
+
+    @retval true on error, which has been reported.
+   */
+  bool StartReading();
+
+  /**
+    Read the next group. If groups have been spilled to disk, this combines
+    the partial states of the group from all the runs.
+
+    @param[out] group the group. It is valid until the next call.
+
+    @retval 0 OK
+    @retval -1 no more groups
+    @retval 1 error, which has been reported
+   */
+  int ReadGroup(const Group **group);
+
+  /// @returns the number of rows given to AddRow(), including the rows that
+  /// did not satisfy the predicates.
+  ha_rows rows_read() const { return m_rows_read; }
+
+ private:
+  class SpilledRun;
+  struct MergeSource;
+
+  /// Find the group with the given key, or create it with a copy of "row" if
+  /// it does not exist. If the table is full, the groups are spilled before
+  /// the new group is created. @returns nullptr on error.
+  Group *FindOrInsertGroup(std::string_view key, const uchar *row);
+
+  /**
+    Set m_key to the group key of a row. The key of each group column is a
+    byte that tells whether the value is NULL, followed by the value in
+    big-endian order with the sign bit flipped (for signed columns), all of it
+    inverted for descending columns. Comparing the keys with memcmp() thus
+    gives the order the groups are to be returned in.
+   */
+  void MakeKey(const uchar *row);
+
+  bool OutOfMemory() const;
+
+  /// Write the groups in memory to a new sorted run, and empty the table.
+  /// @retval true on error (not reported).
+  bool SpillGroups();
+
+  /// Size of a group when it is written to a run.
+  size_t SerializedGroupSize() const;
+  void SerializeGroup(const Group &group, uchar *to) const;
+
+  bool SourceAtEnd(const MergeSource &source) const;
+
+  /// Load the next group of a merge source into its buffer.
+  /// @retval true on error (not reported).
+  bool AdvanceSource(MergeSource *source);
+
+  /// Combine the partial states of the group in a merge source with the
+  /// group in m_merged_group.
+  void MergeFromSource(const MergeSource &source);
+
+  /// Add the value of a COUNT(DISTINCT) aggregate in a row to
+  /// m_distinct_values, and count it in the group if it was not there.
+  /// @retval true on error (not reported).
+  bool AddDistinctValue(size_t aggregate_idx, const uchar *row, Group *group);
+
+  const AggregationSpec *m_spec;
+  const size_t m_max_memory;
+  DistinctValues *const m_distinct_values;
+
+  MEM_ROOT m_mem_root;
+
+  /// The keys of the distinct values this table has added to
+  /// m_distinct_values. Unlike m_mem_root, this is not cleared when the
+  /// groups are spilled.
+  MEM_ROOT m_distinct_mem_root;
+
+  /// Maps from group keys to groups. The keys and groups live on m_mem_root.
+  ankerl::unordered_dense::map<std::string_view, Group *> m_map;
+
+  /// The groups, in the order they were seen (until SortGroups() is called).
+  std::vector<Group *> m_groups;
+
+  /// The key of the row that is currently being added.
+  std::string m_key;
+
+  /// The key of the distinct value that is currently being added.
+  std::string m_distinct_key;
+
+  ha_rows m_rows_read{0};
+
+  Failure m_failure{Failure::NONE};
+  /// For Failure::OUT_OF_MEMORY: the number of bytes that could not be
+  /// allocated.
+  size_t m_failed_allocation_size{0};
+
+  /// The runs spilled to disk, in the order they were written.
+  std::vector<std::unique_ptr<SpilledRun>> m_runs;
+
+  /// Buffer for a group that is written to a run.
+  std::vector<uchar> m_spill_buffer;
+
+  /// While reading: the index of the next group in m_groups to return, if
+  /// nothing has been spilled.
+  size_t m_next_group{0};
+
+  /// While reading spilled groups: the runs and the groups in memory, as a
+  /// min-heap on the key of the group each of them is positioned on.
+  std::vector<std::unique_ptr<MergeSource>> m_merge_sources;
+  std::vector<MergeSource *> m_merge_heap;
+
+  /// The group returned by the last call to ReadGroup() when merging.
+  std::string m_merged_key;
+  std::vector<uchar> m_merged_row;
+  std::vector<AggregateState> m_merged_states;
+  Group m_merged_group{};
+};
+
+/**
+  Check whether a filter over a table scan can be evaluated by the scanning
+  threads, and if so, convert it to a list of column predicates.
+
+  @param condition the filter condition; a conjunction of comparisons between
+    integer columns of "table" and integer constants, and IS [NOT] NULL
+    tests on integer columns of "table".
+  @param table the table that is scanned.
+  @param[out] predicates the converted predicates are added here.
+
+  @returns false if the condition cannot be converted.
+ */
+bool ConvertCondition(Item *condition, const TABLE *table,
+                      std::vector<ColumnPredicate> *predicates);
+
+/**
+  Check whether an aggregate function can be computed by the scanning threads,
+  and if so, describe it with an AggregateSpec: it must be COUNT, SUM, AVG,
+  MIN or MAX (without DISTINCT) of an integer column of "table", COUNT(*) or
+  COUNT(DISTINCT) of a single integer column of "table".
+ */
+bool ConvertAggregate(Item_sum *item, const TABLE *table,
+                      AggregateSpec *aggregate);
+
+/// Get the integer column of "table" that an expression refers to, or nullptr
+/// if the expression is anything else.
+Field *GetIntegerColumn(Item *item, const TABLE *table);
+
+/**
+  Check whether an aggregation can be computed by ParallelAggregateIterator.
+  It must be over a full scan of a single table, optionally through a filter
+  and (for GROUP BY) a sort on the grouping columns, and all the columns
+  involved must be integer columns.
+
+  @param thd the session.
+  @param aggregate_path the AGGREGATE access path to compute in parallel.
+  @param join the join the aggregation belongs to.
+  @param[out] table_scan_path the scan of the table that is to be scanned in
+    parallel.
+
+  @returns what the scanning threads are to compute, or nullptr if the
+    aggregation cannot be computed in parallel.
+ */
+std::unique_ptr<AggregationSpec> MakeAggregationSpec(
+    THD *thd, const AccessPath *aggregate_path, const JOIN *join,
+    const AccessPath **table_scan_path);
+
+}  // namespace parallel_aggregate
+
+/**
+  An iterator that computes an aggregation (GROUP BY or implicit grouping)
+  over a full scan of a table by scanning the table with several threads.
+
+  The aggregation would otherwise be done by an AggregateIterator reading
+  from a TableScanIterator, possibly through a FilterIterator and, for
+  GROUP BY, a SortingIterator. Instead, the table is scanned with
+  handler::parallel_scan() (which, for InnoDB, splits the clustered index into
+  ranges that are read by a pool of threads; see Parallel_reader). Each thread
+  evaluates the filter and aggregates the rows it reads into a hash table of
+  its own; this is possible because all columns involved must be integer
+  columns, which can be read without going through Field or Item (see
+  parallel_aggregate::IntegerColumn), and all the aggregate functions are
+  ones that can be split into partial results (COUNT, SUM, AVG, MIN and MAX),
+  or COUNT(DISTINCT), whose values are shared by all the threads (see
+  parallel_aggregate::DistinctValues).
+  When the scan is done, the session thread merges the partial results of
+  all threads, sorts the groups in the order the SortingIterator would have
+  returned them, and returns one row per group. For each group, the first row
+  seen in the group is loaded into the record buffer of the table, and the
+  aggregate functions are given the merged partial results, just like if
+  AggregateIterator had added all the rows in the group one by one.
+
+  The iterator keeps the serial iterator tree around. If the storage engine
+  cannot start a parallel scan (e.g. because all parallel read threads are
+  busy), or the distinct values of a COUNT(DISTINCT) do not fit in memory,
+  the query is executed by the serial iterators instead. If the groups do not
+  fit in tmp_table_size, they are spilled to disk as sorted runs (see
+  parallel_aggregate::GroupTable) and merged when they are returned. Errors
+  while spilling or merging, and running out of memory, are reported like in
+  any other iterator, and do not lead to the serial iterators.
+ */
+class ParallelAggregateIterator final : public RowIterator {
+ public:
+  /**
+    @param thd the session.
+    @param join the join the aggregation belongs to.
+    @param table the table to scan.
+    @param spec what to compute. The aggregates must be in the same order as
+      join->sum_funcs.
+    @param serial_iterator the iterator to use if a parallel scan is not
+      possible.
+    @param examined_rows if not nullptr, incremented by the number of rows
+      scanned.
+   */
+  ParallelAggregateIterator(
+      THD *thd, JOIN *join, TABLE *table,
+      std::unique_ptr<parallel_aggregate::AggregationSpec> spec,
+      unique_ptr_destroy_only<RowIterator> serial_iterator,
+      ha_rows *examined_rows);
+
+  bool Init() override;
+  int Read() override;
+
+  void SetNullRowFlag(bool is_null_row) override {
+    m_serial_iterator->SetNullRowFlag(is_null_row);
+  }
+  void UnlockRow() override {}
+
+ private:
+  enum class ScanResult { OK, FALL_BACK, ERROR };
+
+  /// Scan the table with handler::parallel_scan(), and merge the results of
+  /// all threads into m_groups.
+  ScanResult ScanInParallel();
+
+  /// Load the given group into the record buffer of the table and the
+  /// aggregate functions. @retval true on error.
+  bool LoadGroup(const parallel_aggregate::GroupTable::Group &group);
+
+  JOIN *const m_join;
+  TABLE *const m_table;
+  const std::unique_ptr<parallel_aggregate::AggregationSpec> m_spec;
+  unique_ptr_destroy_only<RowIterator> m_serial_iterator;
+  ha_rows *const m_examined_rows;
+
+  /// True if the current execution is done by m_serial_iterator.
+  bool m_use_serial_iterator{false};
+
+  /// The merged groups from all threads.
+  std::unique_ptr<parallel_aggregate::GroupTable> m_groups;
+
+  /// For implicit grouping: whether the row for an empty input is returned.
+  bool m_returned_empty_row{false};
+
+  /// See AggregateIterator::m_save_nullinfo.
+  table_map m_save_nullinfo{0};
+
+  /// See AggregateIterator::m_output_slice.
+  int m_output_slice{-1};
+};
+
+#endif  // SQL_ITERATORS_PARALLEL_AGGREGATE_ITERATOR_H_
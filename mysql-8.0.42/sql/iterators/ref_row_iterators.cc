@@ -28,8 +28,11 @@
 #include <iterator>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 
+#include <ankerl/unordered_dense.h>
+
 #include "ft_global.h"
 #include "mem_root_deque.h"
 #include "my_alloc.h"
@@ -37,6 +40,7 @@
 #include "my_dbug.h"
 #include "my_inttypes.h"
 #include "my_table_map.h"
+#include "mysqld_error.h"
 #include "sql/debug_sync.h"  // DEBUG_SYNC
 #include "sql/handler.h"
 #include "sql/item.h"
@@ -52,6 +56,7 @@
 #include "sql/mysqld.h"     // stage_executing
 #include "sql/opt_trace.h"  // Opt_trace_object
 #include "sql/opt_trace_context.h"
+#include "sql/pack_rows.h"
 #include "sql/psi_memory_key.h"
 #include "sql/range_optimizer/path_helpers.h"
 #include "sql/range_optimizer/range_optimizer.h"
@@ -473,6 +478,209 @@ template class RefIterator<true>;
 template class RefIterator<false>;
 //! @endcond
 
+/// A row in the hash table of AdaptiveRefIterator. The row itself (see
+/// StoreFromTableBuffers()) follows right after this struct.
+struct AdaptiveRefIterator::StoredRow {
+  /// The next row with the same key, if any.
+  const StoredRow *next;
+
+  const uchar *data() const { return pointer_cast<const uchar *>(this + 1); }
+};
+
+/// Maps the key image of each key in the table to the rows with that key.
+class AdaptiveRefIterator::HashTable
+    : public ankerl::unordered_dense::map<std::string_view,
+                                          const StoredRow *> {};
+
+AdaptiveRefIterator::AdaptiveRefIterator(THD *thd, TABLE *table,
+                                         Index_lookup *ref,
+                                         double expected_rows,
+                                         ha_rows hash_lookup_threshold,
+                                         ha_rows *examined_rows)
+    : TableRowIterator(thd, table),
+      m_index_iterator(thd, table, ref, /*use_order=*/false, expected_rows,
+                       examined_rows),
+      m_ref(ref),
+      m_hash_lookup_threshold(hash_lookup_threshold),
+      m_examined_rows(examined_rows),
+      m_mem_root(key_memory_hash_join, 16384) {
+  assert(hash_lookup_threshold > 0);
+}
+
+AdaptiveRefIterator::~AdaptiveRefIterator() = default;
+
+bool AdaptiveRefIterator::Init() {
+  if (m_hash_table == nullptr && !m_hash_table_failed &&
+      m_index_lookups >= m_hash_lookup_threshold) {
+    if (BuildHashTable()) return true;
+  }
+
+  if (m_hash_table != nullptr) {
+    m_first_record_since_init = true;
+    m_next_row = nullptr;
+    return false;
+  }
+
+  ++m_index_lookups;
+  return m_index_iterator.Init();
+}
+
+bool AdaptiveRefIterator::BuildHashTable() {
+  handler *const file = table()->file;
+
+  // Rows that are thrown away by the scan would be missing from the hash
+  // table. Runtime filters come and go, so try again at the next lookup.
+  if (file->pushed_idx_cond != nullptr || file->pushed_cond != nullptr) {
+    m_hash_table_failed = true;
+    return false;
+  }
+  if (file->ha_get_runtime_filter() != nullptr) {
+    return false;
+  }
+
+  if (file->inited == handler::INDEX) {
+    const int error = file->ha_index_end();
+    if (error != 0) {
+      PrintError(error);
+      return true;
+    }
+  }
+
+  // The key is built from the row, and the primary key is needed if anyone
+  // calls position() on the rows we return (see the checks in the optimizer).
+  table()->mark_columns_used_by_index_no_reset(m_ref->key, table()->read_set);
+  table()->prepare_for_position();
+  file->column_bitmaps_signal();
+
+  Prealloced_array<TABLE *, 4> tables{PSI_NOT_INSTRUMENTED};
+  tables.push_back(table());
+  m_tables = pack_rows::TableCollection(
+      tables, /*store_rowids=*/false, /*tables_to_get_rowid_for=*/0,
+      /*tables_to_store_contents_of_null_rows_for=*/0);
+
+  const KEY *key = &table()->key_info[m_ref->key];
+  uchar *key_buffer = m_mem_root.ArrayAlloc<uchar>(m_ref->key_length);
+  if (key_buffer == nullptr) {
+    my_error(ER_OUTOFMEMORY, MYF(ME_FATALERROR), m_ref->key_length);
+    return true;
+  }
+  auto hash_table = std::make_unique<HashTable>();
+  String row_buffer;
+  const size_t max_mem_available = thd()->variables.join_buff_size;
+  bool full = false;
+
+  int error = file->ha_rnd_init(/*scan=*/true);
+  if (error != 0) {
+    PrintError(error);
+    return true;
+  }
+  for (;;) {
+    error = file->ha_rnd_next(table()->record[0]);
+    if (error == HA_ERR_END_OF_FILE) {
+      break;
+    }
+    if (error != 0) {
+      if (error == HA_ERR_RECORD_DELETED && !thd()->killed) continue;
+      PrintError(error);
+      file->ha_rnd_end();
+      return true;
+    }
+
+    // A lookup never matches NULL (see Index_lookup::impossible_null_ref()).
+    bool has_null = false;
+    for (uint i = 0; i < m_ref->key_parts; ++i) {
+      has_null |= key->key_part[i].field->is_null();
+    }
+    if (has_null) continue;
+
+    if (StoreFromTableBuffers(m_tables, &row_buffer)) {
+      my_error(ER_OUTOFMEMORY, MYF(ME_FATALERROR), row_buffer.length());
+      file->ha_rnd_end();
+      return true;
+    }
+    StoredRow *row = static_cast<StoredRow *>(
+        m_mem_root.Alloc(sizeof(StoredRow) + row_buffer.length()));
+    if (row == nullptr) {
+      my_error(ER_OUTOFMEMORY, MYF(ME_FATALERROR),
+               sizeof(StoredRow) + row_buffer.length());
+      file->ha_rnd_end();
+      return true;
+    }
+    memcpy(row + 1, row_buffer.ptr(), row_buffer.length());
+
+    key_copy(key_buffer, table()->record[0], key, m_ref->key_length);
+    const std::string_view key_image(pointer_cast<const char *>(key_buffer),
+                                     m_ref->key_length);
+    const auto it = hash_table->find(key_image);
+    if (it != hash_table->end()) {
+      row->next = it->second;
+      it->second = row;
+    } else {
+      const char *stored_key = static_cast<const char *>(
+          memdup_root(&m_mem_root, key_buffer, m_ref->key_length));
+      if (stored_key == nullptr) {
+        my_error(ER_OUTOFMEMORY, MYF(ME_FATALERROR), m_ref->key_length);
+        file->ha_rnd_end();
+        return true;
+      }
+      row->next = nullptr;
+      hash_table->emplace(std::string_view(stored_key, m_ref->key_length),
+                          row);
+    }
+
+    if (m_mem_root.allocated_size() +
+            hash_table->size() *
+                (sizeof(HashTable::value_type) + sizeof(uint64_t)) >
+        max_mem_available) {
+      full = true;
+      break;
+    }
+  }
+  file->ha_rnd_end();
+
+  if (full) {
+    // Keep using the index; it will be initialized again by RefIterator.
+    m_mem_root.Clear();
+    m_hash_table_failed = true;
+    return false;
+  }
+  m_hash_table = std::move(hash_table);
+  return false;
+}
+
+int AdaptiveRefIterator::Read() {
+  if (m_hash_table == nullptr) {
+    return m_index_iterator.Read();
+  }
+
+  if (m_first_record_since_init) {
+    m_first_record_since_init = false;
+
+    // See RefIterator<false>::Read().
+    if (m_ref->impossible_null_ref() ||
+        construct_lookup(thd(), table(), m_ref)) {
+      table()->set_no_row();
+      return -1;
+    }
+    const auto it = m_hash_table->find(std::string_view(
+        pointer_cast<const char *>(m_ref->key_buff), m_ref->key_length));
+    m_next_row = it == m_hash_table->end() ? nullptr : it->second;
+  }
+
+  if (m_next_row == nullptr) {
+    table()->set_no_row();
+    return -1;
+  }
+  LoadIntoTableBuffers(m_tables, m_next_row->data());
+  table()->set_found_row();
+  m_next_row = m_next_row->next;
+
+  if (m_examined_rows != nullptr) {
+    ++*m_examined_rows;
+  }
+  return 0;
+}
+
 DynamicRangeIterator::DynamicRangeIterator(THD *thd, TABLE *table,
                                            QEP_TAB *qep_tab,
                                            ha_rows *examined_rows)
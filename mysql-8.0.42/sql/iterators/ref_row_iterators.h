@@ -32,6 +32,7 @@
 #include "my_inttypes.h"
 #include "sql/iterators/basic_row_iterators.h"
 #include "sql/iterators/row_iterator.h"
+#include "sql/pack_rows.h"
 #include "sql/sql_sort.h"
 
 class Item_func_match;
@@ -92,6 +93,75 @@ class RefOrNullIterator final : public TableRowIterator {
   bool m_is_mvi_unique_filter_enabled;
 };
 
+/**
+  Like RefIterator (reading forward), but protects nested loop joins against
+  row estimates that are far too low. The lookups are done in the index, like
+  RefIterator does, until there have been more of them than a threshold set
+  by the optimizer (see the adaptive_join_factor system variable). At that
+  point, the iterator reads the entire table once, into a hash table keyed on
+  the lookup key, and does the rest of the lookups in the hash table. This
+  turns the rest of the nested loop join into a hash join (with this table as
+  the build input), without changing anything for the iterators above, so it
+  works for all the join types nested loop joins support.
+
+  Rows are matched on the bytes of their key images, so the optimizer only
+  sets a threshold if those are equal exactly when the key values are (e.g.
+  for integer and temporal columns). If the table does not fit in
+  join_buffer_size, or if rows read by scans are being filtered (by index
+  condition pushdown or a runtime filter), the iterator keeps using the
+  index.
+ */
+class AdaptiveRefIterator final : public TableRowIterator {
+ public:
+  // "examined_rows", if not nullptr, is incremented for each successful Read().
+  AdaptiveRefIterator(THD *thd, TABLE *table, Index_lookup *ref,
+                      double expected_rows, ha_rows hash_lookup_threshold,
+                      ha_rows *examined_rows);
+  ~AdaptiveRefIterator() override;
+
+  bool Init() override;
+  int Read() override;
+
+  /// @returns true if the lookups are done in the hash table.
+  bool switched_to_hash_lookup() const { return m_hash_table != nullptr; }
+
+  /// @returns the number of lookups that were done in the index.
+  ha_rows index_lookups() const { return m_index_lookups; }
+
+ private:
+  class HashTable;
+  struct StoredRow;
+
+  /// Read the entire table into m_hash_table. Leaves m_hash_table at nullptr
+  /// if the table cannot be read this way.
+  /// @returns true on error.
+  bool BuildHashTable();
+
+  /// The iterator that does the lookups in the index.
+  RefIterator<false> m_index_iterator;
+
+  Index_lookup *const m_ref;
+  const ha_rows m_hash_lookup_threshold;
+  ha_rows *const m_examined_rows;
+  ha_rows m_index_lookups{0};
+
+  /// Set if BuildHashTable() gave up, so that it is not tried again.
+  bool m_hash_table_failed{false};
+
+  /// The columns stored in the hash table.
+  pack_rows::TableCollection m_tables;
+
+  /// Where the hash table keys and rows are allocated.
+  MEM_ROOT m_mem_root;
+
+  std::unique_ptr<HashTable> m_hash_table;
+
+  bool m_first_record_since_init{false};
+
+  /// The next row to return from the hash table, if any.
+  const StoredRow *m_next_row{nullptr};
+};
+
 /**
   Like RefIterator, but used in situations where we're guaranteed to have
   exactly zero or one rows for each reference (due to e.g. unique constraints).
@@ -0,0 +1,190 @@
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include "sql/iterators/row_batch.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "my_sys.h"
+#include "mysqld_error.h"
+#include "sql/iterators/row_iterator.h"
+#include "sql/table.h"
+#include "thr_lock.h"
+
+using pack_rows::TableCollection;
+
+namespace {
+
+// The row status stored in front of each record image.
+enum RowStatus : uchar { kFoundRow = 0, kNoRow = 1, kNullRow = 2 };
+
+}  // namespace
+
+bool RowBatch::IsSupported(const TableCollection &tables) {
+  // BLOB data lives outside the record buffer, and row IDs must be fetched
+  // from the handler while it is positioned on the row.
+  if (tables.has_blob_column() || tables.store_rowids()) {
+    return false;
+  }
+  for (const pack_rows::Table &table : tables.tables()) {
+    // Rows that are read with locks may have to be unlocked by the consumer
+    // (see RowIterator::UnlockRow()), which requires the handler to be
+    // positioned on the row.
+    if (table.table->reginfo.lock_type > TL_READ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool RowBatch::Init(const TableCollection *tables, size_t capacity) {
+  Reset();
+  if (capacity == 0 || !IsSupported(*tables)) {
+    m_capacity = 0;
+    return false;
+  }
+
+  // Reuse the memory from the previous execution if possible.
+  if (m_tables == tables && m_capacity == capacity) {
+    return false;
+  }
+
+  m_mem_root.ClearForReuse();
+  m_tables = tables;
+  m_capacity = capacity;
+
+  const size_t num_tables = tables->tables().size();
+  m_table_offsets = m_mem_root.ArrayAlloc<size_t>(num_tables);
+  m_image_sizes = m_mem_root.ArrayAlloc<size_t>(num_tables);
+  m_selection = m_mem_root.ArrayAlloc<uint32_t>(capacity);
+  if (m_table_offsets == nullptr || m_image_sizes == nullptr ||
+      m_selection == nullptr) {
+    m_capacity = 0;
+    my_error(ER_OUTOFMEMORY, MYF(0), capacity * sizeof(uint32_t));
+    return true;
+  }
+
+  size_t row_size = 0;
+  for (size_t i = 0; i < num_tables; ++i) {
+    m_table_offsets[i] = row_size;
+    m_image_sizes[i] = 1 + tables->tables()[i].table->s->reclength;
+    row_size += m_image_sizes[i];
+  }
+
+  m_images = m_mem_root.ArrayAlloc<uchar>(row_size * capacity);
+  if (m_images == nullptr) {
+    m_capacity = 0;
+    my_error(ER_OUTOFMEMORY, MYF(0), row_size * capacity);
+    return true;
+  }
+  return false;
+}
+
+void RowBatch::AppendFromTableBuffers() {
+  assert(!full());
+  const size_t row_idx = m_num_rows++;
+  const auto &tables = m_tables->tables();
+  for (size_t i = 0; i < tables.size(); ++i) {
+    const TABLE *table = tables[i].table;
+    uchar *image = m_images + m_table_offsets[i] * m_capacity +
+                   row_idx * m_image_sizes[i];
+    if (table->has_null_row()) {
+      image[0] = kNullRow;
+    } else if (!table->has_row()) {
+      image[0] = kNoRow;
+    } else {
+      image[0] = kFoundRow;
+    }
+    memcpy(image + 1, table->record[0], m_image_sizes[i] - 1);
+  }
+  m_selection[m_num_selected++] = row_idx;
+}
+
+void RowBatch::LoadRow(size_t row_idx) {
+  assert(row_idx < m_num_rows);
+  const auto &tables = m_tables->tables();
+  for (size_t i = 0; i < tables.size(); ++i) {
+    TABLE *table = tables[i].table;
+    const uchar *image = m_images + m_table_offsets[i] * m_capacity +
+                         row_idx * m_image_sizes[i];
+    memcpy(table->record[0], image + 1, m_image_sizes[i] - 1);
+    switch (image[0]) {
+      case kNullRow:
+        table->set_null_row();
+        break;
+      case kNoRow:
+        table->set_no_row();
+        break;
+      default:
+        table->set_found_row();
+        break;
+    }
+  }
+}
+
+void RowBatch::Clear() {
+  if (m_num_rows > 0) {
+    LoadRow(m_num_rows - 1);
+  }
+  m_num_rows = 0;
+  m_num_selected = 0;
+  m_next_selected = 0;
+}
+
+void RowBatch::Reset() {
+  m_num_rows = 0;
+  m_num_selected = 0;
+  m_next_selected = 0;
+  m_end_of_records = false;
+}
+
+int RowBatch::ReadRow(RowIterator *source) {
+  while (m_next_selected == m_num_selected) {
+    if (m_end_of_records) {
+      // Leave the record buffers as the source left them at end of records.
+      Clear();
+      return -1;
+    }
+    Clear();
+    const int err = source->ReadBatch(this);
+    if (err == 1) {
+      return 1;
+    }
+    m_end_of_records = err == -1;
+  }
+  LoadRow(m_selection[m_next_selected++]);
+  return 0;
+}
+
+int RowIterator::ReadBatch(RowBatch *batch) {
+  assert(batch->empty());
+  while (!batch->full()) {
+    const int err = Read();
+    if (err != 0) {
+      return err;
+    }
+    batch->AppendFromTableBuffers();
+  }
+  return 0;
+}
@@ -0,0 +1,185 @@
+#ifndef SQL_ITERATORS_ROW_BATCH_H_
+#define SQL_ITERATORS_ROW_BATCH_H_
+
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/// @file
+///
+/// This file contains the RowBatch class, which is used for exchanging
+/// rows between iterators a batch at a time (see RowIterator::ReadBatch()).
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+
+#include "my_alloc.h"
+#include "my_inttypes.h"
+#include "sql/pack_rows.h"
+
+class RowIterator;
+
+/**
+  A batch of rows read from a RowIterator, used by RowIterator::ReadBatch().
+
+  Items are evaluated against the tables' record buffers, so in order to let
+  the consumer evaluate its conditions and expressions unchanged, a batch keeps
+  a copy of the complete record buffer (record[0]) of every table in a
+  pack_rows::TableCollection for each row, together with the row status of the
+  table (found row, no row or NULL-complemented row). Every table gets its own
+  contiguous area in the batch, so that the images of one table are stored
+  next to each other.
+
+  In addition to the physical rows, the batch has a selection vector, which
+  holds the indexes of the rows that are still live. A filter does not move
+  any data around; it only shrinks the selection vector.
+
+  Before the source iterator is asked for more rows, the physically last row in
+  the batch (which is the last row the source put in the record buffers) is
+  restored into the record buffers. This is needed since some iterators depend
+  on the record buffers being untouched between two calls to Read(); see for
+  instance the cache in EQRefIterator.
+
+  Batches can only be used for tables that are read without locking, do not
+  have BLOB columns (the BLOB data is not owned by the record buffer) and do
+  not need row IDs; see IsSupported().
+ */
+class RowBatch {
+ public:
+  RowBatch() = default;
+
+  RowBatch(const RowBatch &) = delete;
+  RowBatch &operator=(const RowBatch &) = delete;
+
+  /// @returns true if all tables in the collection can be read in batches.
+  static bool IsSupported(const pack_rows::TableCollection &tables);
+
+  /**
+    Set up the batch for holding rows from the given tables. If the capacity is
+    zero, or the tables cannot be read in batches, the batch is disabled, and
+    the consumer should read rows one by one as usual. Any rows left over from
+    an earlier use are discarded.
+
+    @param tables the tables to store rows for. Must outlive the batch.
+    @param capacity the maximum number of rows in the batch.
+
+    @retval true if an out-of-memory error occurred. my_error() is called.
+   */
+  bool Init(const pack_rows::TableCollection *tables, size_t capacity);
+
+  /// @returns true if Init() set up the batch for use.
+  bool is_enabled() const { return m_capacity > 0; }
+
+  size_t capacity() const { return m_capacity; }
+
+  /// @returns the number of selected rows in the batch.
+  size_t size() const { return m_num_selected; }
+
+  bool empty() const { return m_num_rows == 0; }
+
+  /// @returns true if no more rows can be appended to the batch.
+  bool full() const { return m_num_rows == m_capacity; }
+
+  /**
+    Copy the current contents of the tables' record buffers into the batch as
+    a new row, which is selected. The batch must not be full.
+   */
+  void AppendFromTableBuffers();
+
+  /// Load the selected row number "idx" (0 <= idx < size()) into the tables'
+  /// record buffers.
+  void LoadSelectedRow(size_t idx) { LoadRow(m_selection[idx]); }
+
+  /// Used for filtering: let the selected row number "from" be the selected
+  /// row number "to" (to <= from).
+  void MoveSelectedRow(size_t from, size_t to) {
+    assert(to <= from && from < m_num_selected);
+    m_selection[to] = m_selection[from];
+  }
+
+  /// Keep only the "num_selected" first selected rows.
+  void ShrinkSelection(size_t num_selected) {
+    assert(num_selected <= m_num_selected);
+    m_num_selected = num_selected;
+    m_next_selected = std::min(m_next_selected, num_selected);
+  }
+
+  /**
+    Remove all rows from the batch, so that it can be filled again by the
+    source iterator. The physically last row is restored into the record
+    buffers first, so that the source sees the record buffers as it left them.
+   */
+  void Clear();
+
+  /**
+    Discard all rows without touching the record buffers. Must be called when
+    the source iterator is (re-)initialized.
+   */
+  void Reset();
+
+  /**
+    Read the next row through the batch, for consumers that process one row at
+    a time. The row is loaded into the tables' record buffers, just like
+    RowIterator::Read() would have done. When all the rows in the batch are
+    consumed, the batch is refilled by calling source->ReadBatch().
+
+    @returns the same as RowIterator::Read().
+   */
+  int ReadRow(RowIterator *source);
+
+ private:
+  void LoadRow(size_t row_idx);
+
+  /// The tables to store rows for.
+  const pack_rows::TableCollection *m_tables{nullptr};
+
+  /// Memory for the row images and the selection vector.
+  MEM_ROOT m_mem_root{PSI_NOT_INSTRUMENTED, 16384};
+
+  /// The record images. The images of table number i in m_tables start at
+  /// m_images + m_table_offsets[i] * m_capacity, and each of them is
+  /// m_image_sizes[i] bytes long, the first byte being the row status.
+  uchar *m_images{nullptr};
+  size_t *m_table_offsets{nullptr};
+  size_t *m_image_sizes{nullptr};
+
+  /// The indexes of the selected rows, in increasing order.
+  uint32_t *m_selection{nullptr};
+
+  size_t m_capacity{0};
+
+  /// The number of rows physically stored in the batch.
+  size_t m_num_rows{0};
+
+  /// The number of rows in m_selection.
+  size_t m_num_selected{0};
+
+  /// The next selected row to be returned by ReadRow().
+  size_t m_next_selected{0};
+
+  /// Whether the source iterator has reported end of records.
+  bool m_end_of_records{false};
+};
+
+#endif  // SQL_ITERATORS_ROW_BATCH_H_
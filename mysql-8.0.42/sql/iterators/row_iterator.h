@@ -29,6 +29,7 @@
 
 class Item;
 class JOIN;
+class RowBatch;
 class THD;
 struct TABLE;
 
@@ -115,6 +116,30 @@ class RowIterator {
    */
   virtual int Read() = 0;
 
+  /**
+    Read a batch of rows into the given (empty) batch, stopping when the batch
+    is full or at end of records. This allows composite iterators that consume
+    all (or most) of their input, such as HashJoinIterator (build input) and
+    AggregateIterator, to amortize the cost of going through the iterator tree
+    over many rows; see RowBatch for the details.
+
+    The default implementation calls Read() repeatedly and copies each row into
+    the batch. Iterators with a tighter native loop (e.g. TableScanIterator),
+    or that can work on a whole batch at a time (e.g. FilterIterator), override
+    it. Iterators that do not know how to deal with batches need to do nothing.
+
+    Note that if end of records is reached, the batch may still contain rows
+    that were read before that.
+
+    @retval
+      0   OK; the batch is full, or contains at least one row
+    @retval
+      -1   End of records; any rows in the batch are the last ones
+    @retval
+      1   Error
+   */
+  virtual int ReadBatch(RowBatch *batch);
+
   /**
     Mark the current row buffer as containing a NULL row or not, so that if you
     read from it and the flag is true, you'll get only NULLs no matter what is
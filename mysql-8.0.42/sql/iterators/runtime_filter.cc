@@ -0,0 +1,245 @@
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include "sql/iterators/runtime_filter.h"
+
+#include <assert.h>
+#include <algorithm>
+
+#include "my_alloc.h"
+#include "my_bitmap.h"
+#include "sql/handler.h"
+#include "sql/field.h"
+#include "sql/field_common_properties.h"
+#include "sql/item.h"
+#include "sql/table.h"
+#include "template_utils.h"
+
+RuntimeFilter::RuntimeFilter(Field *probe_field, Item *build_expr)
+    : m_probe_field(probe_field),
+      m_build_expr(build_expr),
+      m_temporal(false),
+      m_unsigned(probe_field->is_unsigned()),
+      m_check_range(probe_field->is_unsigned() == build_expr->unsigned_flag) {
+  assert(is_integer_type(probe_field->type()));
+}
+
+RuntimeFilter::RuntimeFilter(Field *probe_field)
+    : m_probe_field(probe_field),
+      m_build_expr(nullptr),
+      m_temporal(!is_integer_type(probe_field->type())),
+      m_unsigned(!m_temporal && probe_field->is_unsigned()),
+      m_check_range(true) {
+  assert(IsSupportedColumn(probe_field));
+  LetAllRowsThrough();
+}
+
+TABLE *RuntimeFilter::probe_table() const { return m_probe_field->table; }
+
+bool RuntimeFilter::IsSupportedColumn(const Field *field) {
+  switch (field->real_type()) {
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_LONGLONG:
+    case MYSQL_TYPE_NEWDATE:
+    case MYSQL_TYPE_DATETIME2:
+    case MYSQL_TYPE_TIMESTAMP2:
+      return true;
+    default:
+      return false;
+  }
+}
+
+longlong RuntimeFilter::ColumnValue(ptrdiff_t offset) const {
+  if (!m_temporal) return m_probe_field->val_int_offset(offset);
+  // TIMESTAMP is compared in UTC, like filesort does, since local time may
+  // go backwards.
+  m_probe_field->move_field_offset(offset);
+  const longlong value = m_probe_field->val_date_temporal_at_utc();
+  m_probe_field->move_field_offset(-offset);
+  return value;
+}
+
+void RuntimeFilter::Push() {
+  handler *file = probe_table()->file;
+  m_next = file->ha_get_runtime_filter();
+  file->ha_set_runtime_filter(this);
+}
+
+void RuntimeFilter::Remove() {
+  handler *file = probe_table()->file;
+  RuntimeFilter *first = file->ha_get_runtime_filter();
+  if (first == this) {
+    file->ha_set_runtime_filter(m_next);
+  } else {
+    for (RuntimeFilter *filter = first; filter != nullptr;
+         filter = filter->m_next) {
+      if (filter->m_next == this) {
+        filter->m_next = m_next;
+        break;
+      }
+    }
+  }
+  m_next = nullptr;
+}
+
+bool RuntimeFilter::IsSupportedCondition(const Item *probe_side,
+                                         const Item *build_side,
+                                         const TABLE *probe_table) {
+  const Item *real_probe_side = const_cast<Item *>(probe_side)->real_item();
+  if (real_probe_side->type() != Item::FIELD_ITEM) return false;
+  const Field *field = down_cast<const Item_field *>(real_probe_side)->field;
+  return field->table == probe_table && is_integer_type(field->type()) &&
+         is_integer_type(build_side->data_type());
+}
+
+void RuntimeFilter::Reset(MEM_ROOT *mem_root, double expected_build_rows,
+                          size_t max_bloom_filter_bytes) {
+  m_min = m_unsigned ? static_cast<longlong>(ULLONG_MAX) : LLONG_MAX;
+  m_max = m_unsigned ? 0 : LLONG_MIN;
+  m_rows_checked = 0;
+  m_rows_rejected = 0;
+  m_switched_off = false;
+
+  // If the Bloom filter cannot be allocated, we still have the range. (The
+  // row estimate is clamped to avoid overflow; with more rows than bytes, the
+  // filter gets its maximum size anyway.)
+  const double expected_rows = std::clamp(
+      expected_build_rows, 1.0, static_cast<double>(max_bloom_filter_bytes));
+  m_values = BloomFilter();
+  m_values.Init(mem_root, static_cast<size_t>(expected_rows),
+                max_bloom_filter_bytes);
+}
+
+void RuntimeFilter::AddBuildRow() {
+  const longlong value = m_build_expr->val_int();
+  if (m_build_expr->null_value) return;
+
+  if (m_unsigned) {
+    m_min = static_cast<longlong>(std::min(static_cast<ulonglong>(m_min),
+                                           static_cast<ulonglong>(value)));
+    m_max = static_cast<longlong>(std::max(static_cast<ulonglong>(m_max),
+                                           static_cast<ulonglong>(value)));
+  } else {
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+  }
+  if (m_values.is_enabled()) {
+    m_values.Insert(Hash(value));
+  }
+}
+
+bool RuntimeFilter::ColumnIsRead() const {
+  const TABLE *table = m_probe_field->table;
+  return bitmap_is_set(table->read_set, m_probe_field->field_index()) &&
+         (!table->key_read ||
+          m_probe_field->part_of_key.is_set(table->file->active_index));
+}
+
+bool RuntimeFilter::MayMatch(const uchar *record) {
+  if (m_switched_off || !ColumnIsRead()) {
+    return m_next == nullptr || m_next->MayMatch(record);
+  }
+
+  const ptrdiff_t offset = record - m_probe_field->table->record[0];
+  bool may_match;
+  if (m_probe_field->is_real_null(offset)) {
+    may_match = m_nulls_may_match;
+  } else {
+    const longlong value = ColumnValue(offset);
+    may_match = (!m_check_range || InRange(value)) &&
+                (!m_values.is_enabled() || m_values.MayContain(Hash(value)));
+  }
+
+  ++m_rows_checked;
+  if (!may_match) ++m_rows_rejected;
+  // Filters with a range set from the outside are cheap, and may not reject
+  // anything until the range is set, so they are never switched off.
+  if (m_build_expr != nullptr && m_rows_checked == kRowsBeforeEvaluation &&
+      m_rows_rejected < kRowsBeforeEvaluation / 16) {
+    // Checking the rows costs more than it saves.
+    m_switched_off = true;
+  }
+  return may_match && (m_next == nullptr || m_next->MayMatch(record));
+}
+
+TopNFilter::TopNFilter(Field *sort_field, bool descending, ha_rows limit)
+    : m_filter(sort_field), m_descending(descending), m_limit(limit) {
+  assert(limit > 0);
+}
+
+void TopNFilter::StartSort() {
+  m_values.clear();
+  m_filter.LetAllRowsThrough();
+  m_filter.Push();
+}
+
+void TopNFilter::AddRow() {
+  Value value{false, 0};
+  if (!m_filter.probe_field()->is_null()) {
+    value.first = true;
+    value.second = static_cast<ulonglong>(m_filter.ColumnValue());
+    if (!m_filter.is_unsigned()) value.second ^= 1ULL << 63;
+  }
+
+  const auto comes_before = [this](const Value &a, const Value &b) {
+    return Before(a, b);
+  };
+  if (m_values.size() < m_limit) {
+    m_values.push_back(value);
+    std::push_heap(m_values.begin(), m_values.end(), comes_before);
+    if (m_values.size() == m_limit) UpdateRange();
+  } else if (Before(value, m_values.front())) {
+    std::pop_heap(m_values.begin(), m_values.end(), comes_before);
+    m_values.back() = value;
+    std::push_heap(m_values.begin(), m_values.end(), comes_before);
+    UpdateRange();
+  }
+}
+
+void TopNFilter::UpdateRange() {
+  const Value &worst = m_values.front();
+  const longlong worst_value = static_cast<longlong>(
+      m_filter.is_unsigned() ? worst.second : worst.second ^ (1ULL << 63));
+  const longlong type_min = m_filter.is_unsigned() ? 0 : LLONG_MIN;
+  const longlong type_max =
+      m_filter.is_unsigned() ? static_cast<longlong>(ULLONG_MAX) : LLONG_MAX;
+
+  // Rows that tie with the worst value may still get in on the next sort
+  // columns, so they must pass.
+  if (m_descending) {
+    // NULL sorts last in descending order.
+    if (worst.first) {
+      m_filter.SetRange(worst_value, type_max, /*nulls_may_match=*/false);
+    }
+  } else if (worst.first) {
+    m_filter.SetRange(type_min, worst_value, /*nulls_may_match=*/true);
+  } else {
+    // Only NULLs can get in. (An empty range has min > max.)
+    m_filter.SetRange(m_filter.is_unsigned() ? 1 : 0,
+                      m_filter.is_unsigned() ? 0 : -1,
+                      /*nulls_may_match=*/true);
+  }
+}
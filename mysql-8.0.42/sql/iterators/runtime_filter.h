@@ -0,0 +1,319 @@
+#ifndef SQL_ITERATORS_RUNTIME_FILTER_H_
+#define SQL_ITERATORS_RUNTIME_FILTER_H_
+
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/// @file
+///
+/// This file contains the RuntimeFilter class, which lets a hash join discard
+/// probe rows that cannot match while the probe table is being scanned, and
+/// the TopNFilter class, which does the same for a sort with a LIMIT.
+
+#include <assert.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+#include "my_base.h"
+#include "my_inttypes.h"
+#include "sql/iterators/bloom_filter.h"
+
+class Field;
+class Item;
+struct MEM_ROOT;
+struct TABLE;
+
+/**
+  A filter on the rows of a table, built at execution time from the build
+  input of a hash join.
+
+  The filter belongs to a join condition "probe_field = build_expr", where
+  probe_field is an integer column of the (single) table on the probe side of
+  the join, and build_expr is an integer expression over the build input.
+  While the hash table is built, the filter records the smallest and largest
+  value of build_expr, as well as a Bloom filter of all the values. When the
+  entire build input is read, the hash join pushes the filter to the handler
+  of the probe table (see handler::ha_set_runtime_filter()), and rows where
+  probe_field is outside the range, or not in the Bloom filter, are thrown
+  away by the table or index scan (or by the storage engine itself) before
+  they reach the join. This only pays off for joins where most probe rows
+  have no match, like a join between a large fact table and a filtered
+  dimension table; so if the filter turns out to let almost every row
+  through, it switches itself off.
+
+  Since rows with no match are thrown away, and rows with SQL NULL in
+  probe_field are thrown away as well, runtime filters can only be used for
+  inner joins and semijoins with a join condition that does not consider NULL
+  equal to NULL.
+
+  A filter can also be made without a build expression, in which case the
+  range is set by the owner of the filter with SetRange() (see TopNFilter).
+
+  Several filters can be pushed to the same handler (say, by a hash join that
+  probes a table that is read by a sort with a LIMIT); they are chained
+  together, and a row must pass all of them.
+ */
+class RuntimeFilter {
+ public:
+  /// @param probe_field the column to filter on. Must be an integer column.
+  /// @param build_expr the expression whose values are collected from the
+  ///   build input. Must return an integer.
+  RuntimeFilter(Field *probe_field, Item *build_expr);
+
+  /// Make a filter on the range of a column, which lets all rows through
+  /// until SetRange() is called.
+  /// @param probe_field the column to filter on. See IsSupportedColumn().
+  explicit RuntimeFilter(Field *probe_field);
+
+  /**
+    Empty the filter, so that it is ready to collect the values from a new
+    pass over the build input.
+
+    @param mem_root where to allocate the Bloom filter. Must live until the
+      filter is reset again.
+    @param expected_build_rows the number of rows we expect to see from the
+      build input.
+    @param max_bloom_filter_bytes the maximum size of the Bloom filter. If the
+      Bloom filter cannot be allocated, only the range is checked.
+   */
+  void Reset(MEM_ROOT *mem_root, double expected_build_rows,
+             size_t max_bloom_filter_bytes);
+
+  /// Add the value of the build expression for the row that currently lies in
+  /// the record buffers of the build input. SQL NULL is ignored, since it never
+  /// matches anything.
+  void AddBuildRow();
+
+  /**
+    Check a row of the probe table.
+
+    @param record the row, in the format of TABLE::record[0] (it does not need
+      to lie in record[0], though).
+
+    @returns false if the row cannot have a match in the build input.
+   */
+  bool MayMatch(const uchar *record);
+
+  /**
+    Let only the rows where the column is between "min" and "max" (inclusive)
+    through, and optionally the rows where it is NULL. Only for filters made
+    without a build expression. The values are the ones returned by
+    ColumnValue().
+   */
+  void SetRange(longlong min, longlong max, bool nulls_may_match) {
+    assert(m_build_expr == nullptr);
+    m_min = min;
+    m_max = max;
+    m_nulls_may_match = nulls_may_match;
+  }
+
+  /// Set the widest possible range, including NULL. Only for filters made
+  /// without a build expression.
+  void LetAllRowsThrough() {
+    SetRange(m_unsigned ? 0 : LLONG_MIN,
+             m_unsigned ? static_cast<longlong>(ULLONG_MAX) : LLONG_MAX,
+             /*nulls_may_match=*/true);
+  }
+
+  Field *probe_field() const { return m_probe_field; }
+  TABLE *probe_table() const;
+
+  /// Push the filter to the handler of the probe table, in addition to any
+  /// filters that are already there. See handler::ha_set_runtime_filter().
+  void Push();
+
+  /// Remove the filter from the handler of the probe table, leaving any
+  /// other filters in place.
+  void Remove();
+
+  /// @returns the number of probe rows that MayMatch() has said no to.
+  ha_rows rows_rejected() const { return m_rows_rejected; }
+
+  /// @returns true if filters without a build expression can be made on the
+  /// column: integer columns, and DATE, DATETIME and TIMESTAMP columns.
+  static bool IsSupportedColumn(const Field *field);
+
+  /// @returns the value of the column in the record buffer of its table,
+  /// as a number that sorts like the column does: the integer itself for
+  /// integer columns, and the packed value (in UTC, for TIMESTAMP) for
+  /// temporal columns. The column must not be NULL.
+  longlong ColumnValue() const { return ColumnValue(0); }
+
+  /// Whether ColumnValue() is to be compared as an unsigned integer.
+  bool is_unsigned() const { return m_unsigned; }
+
+  /**
+    Check whether a runtime filter can be built for an equi-join condition.
+
+    @param probe_side one side of an equi-join condition, over the probe input.
+    @param build_side the other side of the condition.
+    @param probe_table the only table on the probe side of the join.
+
+    @returns true if the probe side is an integer column of "probe_table" and
+      the build side an integer expression, so that the two are compared as
+      integers.
+   */
+  static bool IsSupportedCondition(const Item *probe_side,
+                                   const Item *build_side,
+                                   const TABLE *probe_table);
+
+ private:
+  static uint64_t Hash(longlong value) {
+    // The finalizer from MurmurHash3; it spreads consecutive keys evenly over
+    // all 64 bits, which the Bloom filter needs.
+    uint64_t hash = static_cast<uint64_t>(value);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  /// @returns true if the current scan of the probe table reads the column
+  /// to filter on. It does not always; for instance, the index scans of an
+  /// index merge read only the columns that are part of the index.
+  bool ColumnIsRead() const;
+
+  longlong ColumnValue(ptrdiff_t offset) const;
+
+  bool InRange(longlong value) const {
+    if (m_unsigned) {
+      return static_cast<ulonglong>(value) >= static_cast<ulonglong>(m_min) &&
+             static_cast<ulonglong>(value) <= static_cast<ulonglong>(m_max);
+    }
+    return value >= m_min && value <= m_max;
+  }
+
+  Field *const m_probe_field;
+  /// nullptr for filters whose range is set with SetRange().
+  Item *const m_build_expr;
+
+  /// Whether the column is a temporal column, which is compared through its
+  /// packed value.
+  const bool m_temporal;
+
+  /// Whether the values are to be compared as unsigned integers. If the two
+  /// sides of the join condition do not agree on signedness, the range is not
+  /// checked (but the Bloom filter is), since the values are compared as
+  /// signed and unsigned integers at the same time.
+  const bool m_unsigned;
+  const bool m_check_range;
+
+  /// The smallest and largest value seen in the build input. If m_min is
+  /// larger than m_max, no values have been seen.
+  longlong m_min{0};
+  longlong m_max{-1};
+
+  /// Whether rows with SQL NULL in the column pass the filter. Only for
+  /// filters without a build expression.
+  bool m_nulls_may_match{false};
+
+  BloomFilter m_values;
+
+  /// The next filter pushed to the same handler, if any.
+  RuntimeFilter *m_next{nullptr};
+
+  /// After this many rows, MayMatch() checks how many rows the filter has
+  /// rejected, and switches the filter off if it is not worth it.
+  static constexpr ha_rows kRowsBeforeEvaluation = 4096;
+
+  ha_rows m_rows_checked{0};
+  ha_rows m_rows_rejected{0};
+  bool m_switched_off{false};
+};
+
+/**
+  A filter for the rows that go into a sort with a LIMIT (a "top-N" sort),
+  such as the ones in ORDER BY created_at DESC LIMIT 50.
+
+  While the sort reads its input, the filter keeps the N best values of the
+  first sort column seen so far. Once it has seen N rows, no row whose value
+  is worse than the worst of those N values can be among the first N rows
+  of the sort, so the filter pushes a RuntimeFilter to the handler of the
+  table the column belongs to, which lets the scans of that table (and the
+  storage engine) throw away such rows before they are joined with other
+  tables and sorted. The range is narrowed as better rows are found.
+
+  A row may only be thrown away this way if that cannot change any of the
+  other rows that reach the sort, so the table must not be on the inner side
+  of an outer join, a semijoin or an antijoin, nor read through any other
+  operation than filters and inner joins. It is up to the creator of the
+  filter to check this.
+ */
+class TopNFilter {
+ public:
+  /**
+    @param sort_field the first column to sort on. See
+      RuntimeFilter::IsSupportedColumn().
+    @param descending whether the sort on the column is descending.
+    @param limit the number of rows the sort is to return.
+   */
+  TopNFilter(Field *sort_field, bool descending, ha_rows limit);
+
+  /// Start a new sort: forget the values seen so far, and push the filter
+  /// (which lets all rows through until "limit" rows have been seen).
+  void StartSort();
+
+  /// Look at the row that is about to be added to the sort.
+  void AddRow();
+
+  /// Remove the filter from the handler once the sort has read all its
+  /// input.
+  void EndSort() { m_filter.Remove(); }
+
+  ha_rows rows_rejected() const { return m_filter.rows_rejected(); }
+
+  /// The largest LIMIT to make a filter for. The filter keeps a value for
+  /// each row within the LIMIT, and the larger the LIMIT, the fewer rows it
+  /// can throw away.
+  static constexpr ha_rows kMaxLimit = 65536;
+
+ private:
+  /// A value of the column, which sorts ascending like the column, with NULL
+  /// first: the first member is false for NULL, and the second member is the
+  /// value, converted so that it sorts as an unsigned integer.
+  using Value = std::pair<bool, ulonglong>;
+
+  /// @returns true if a row with value "a" comes before a row with value "b"
+  /// in the sort.
+  bool Before(const Value &a, const Value &b) const {
+    return m_descending ? b < a : a < b;
+  }
+
+  /// Set the range of m_filter from the worst of the values kept.
+  void UpdateRange();
+
+  RuntimeFilter m_filter;
+  const bool m_descending;
+  const ha_rows m_limit;
+
+  /// The best m_limit values seen so far, as a heap with the worst value on
+  /// top.
+  std::vector<Value> m_values;
+};
+
+#endif  // SQL_ITERATORS_RUNTIME_FILTER_H_
@@ -46,6 +46,7 @@
 #include "sql/handler.h"
 #include "sql/item.h"
 #include "sql/iterators/basic_row_iterators.h"
+#include "sql/iterators/runtime_filter.h"
 #include "sql/mysqld.h"  // stage_executing
 #include "sql/psi_memory_key.h"
 #include "sql/query_options.h"
@@ -397,16 +398,16 @@ int SortBufferIndirectIterator::Read() {
   }
 }
 
-SortingIterator::SortingIterator(THD *thd, Filesort *filesort,
-                                 unique_ptr_destroy_only<RowIterator> source,
-                                 ha_rows num_rows_estimate,
-                                 table_map tables_to_get_rowid_for,
-                                 ha_rows *examined_rows)
+SortingIterator::SortingIterator(
+    THD *thd, Filesort *filesort, unique_ptr_destroy_only<RowIterator> source,
+    ha_rows num_rows_estimate, table_map tables_to_get_rowid_for,
+    unique_ptr_destroy_only<TopNFilter> top_n_filter, ha_rows *examined_rows)
     : RowIterator(thd),
       m_filesort(filesort),
       m_source_iterator(std::move(source)),
       m_num_rows_estimate(num_rows_estimate),
       m_tables_to_get_rowid_for(tables_to_get_rowid_for),
+      m_top_n_filter(std::move(top_n_filter)),
       m_examined_rows(examined_rows) {}
 
 SortingIterator::~SortingIterator() {
@@ -528,9 +529,14 @@ int SortingIterator::DoSort() {
                             MYF(MY_WME | MY_ZEROFILL));
 
   ha_rows found_rows;
+  if (m_top_n_filter != nullptr) m_top_n_filter->StartSort();
   bool error = ::filesort(thd(), m_filesort, m_source_iterator.get(),
                           m_tables_to_get_rowid_for, m_num_rows_estimate,
-                          &m_fs_info, &m_sort_result, &found_rows);
+                          m_top_n_filter.get(), &m_fs_info, &m_sort_result,
+                          &found_rows);
+  // The filter must not be applied to the reads of the sorted rows by row ID
+  // (or to anything else that reads the table later).
+  if (m_top_n_filter != nullptr) m_top_n_filter->EndSort();
   for (TABLE *table : m_filesort->tables) {
     table->set_keyread(false);  // Restore if we used indexes
   }
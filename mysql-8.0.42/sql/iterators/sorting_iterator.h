@@ -38,6 +38,7 @@
 class Filesort;
 class QEP_TAB;
 class THD;
+class TopNFilter;
 
 /**
   An adapter that takes in another RowIterator and produces the same rows,
@@ -64,9 +65,13 @@ class SortingIterator final : public RowIterator {
   // num_rows_estimate is used only for whether we intend to use the priority
   // queue optimization or not; if we estimate fewer rows than we can fit into
   // RAM, we never use the priority queue.
+  //
+  // "top_n_filter", if not nullptr, is pushed to the scans below us while we
+  // read from "source" (see TopNFilter).
   SortingIterator(THD *thd, Filesort *filesort,
                   unique_ptr_destroy_only<RowIterator> source,
                   ha_rows num_rows_estimate, table_map tables_to_get_rowid_for,
+                  unique_ptr_destroy_only<TopNFilter> top_n_filter,
                   ha_rows *examined_rows);
   ~SortingIterator() override;
 
@@ -127,6 +132,7 @@ class SortingIterator final : public RowIterator {
 
   const ha_rows m_num_rows_estimate;
   const table_map m_tables_to_get_rowid_for;
+  unique_ptr_destroy_only<TopNFilter> m_top_n_filter;
   ha_rows *m_examined_rows;
 
   // Holds one out of all RowIterator implementations we need so that it is
@@ -29,6 +29,7 @@
 #include <chrono>
 
 #include "my_alloc.h"
+#include "sql/iterators/row_batch.h"
 #include "sql/iterators/row_iterator.h"
 #include "sql/sql_class.h"
 #include "sql/sql_lex.h"
@@ -102,6 +103,16 @@ class IteratorProfilerImpl final : public IteratorProfiler {
     }
   }
 
+  /**
+      Mark the end of an iterator->ReadBatch() call.
+      @param start_time time when ReadBatch() started.
+      @param num_rows the number of rows returned in the batch.
+  */
+  void StopReadBatch(TimeStamp start_time, uint64_t num_rows) {
+    StopRead(start_time, /*read_ok=*/false);
+    m_num_rows += num_rows;
+  }
+
  private:
   static double DurationToMs(duration dur) {
     return std::chrono::duration<double>(dur).count() * 1e3;
@@ -178,6 +189,14 @@ class TimingIterator final : public RowIterator {
     return err;
   }
 
+  int ReadBatch(RowBatch *batch) override {
+    const IteratorProfilerImpl::TimeStamp start_time =
+        IteratorProfilerImpl::Now();
+    int err = m_iterator.ReadBatch(batch);
+    m_profiler.StopReadBatch(start_time, batch->size());
+    return err;
+  }
+
   void SetNullRowFlag(bool is_null_row) override {
     m_iterator.SetNullRowFlag(is_null_row);
   }
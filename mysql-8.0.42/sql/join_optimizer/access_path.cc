@@ -33,7 +33,9 @@
 #include "sql/iterators/composite_iterators.h"
 #include "sql/iterators/delete_rows_iterator.h"
 #include "sql/iterators/hash_join_iterator.h"
+#include "sql/iterators/parallel_aggregate_iterator.h"
 #include "sql/iterators/ref_row_iterators.h"
+#include "sql/iterators/runtime_filter.h"
 #include "sql/iterators/sorting_iterator.h"
 #include "sql/iterators/timing_iterator.h"
 #include "sql/iterators/window_iterators.h"
@@ -54,10 +56,12 @@
 #include "sql/range_optimizer/range_optimizer.h"
 #include "sql/range_optimizer/reverse_index_range_scan.h"
 #include "sql/range_optimizer/rowid_ordered_retrieval.h"
+#include "sql/sort_param.h"
 #include "sql/sql_optimizer.h"
 #include "sql/sql_update.h"
 #include "sql/table.h"
 
+#include <memory>
 #include <vector>
 
 using pack_rows::TableCollection;
@@ -110,6 +114,23 @@ AccessPath *NewDeleteRowsAccessPath(THD *thd, AccessPath *child,
   return path;
 }
 
+AccessPath *NewParallelAggregateAccessPath(THD *thd, JOIN *join,
+                                           AccessPath *aggregate_path) {
+  const AccessPath *table_scan_path = nullptr;
+  if (parallel_aggregate::MakeAggregationSpec(thd, aggregate_path, join,
+                                              &table_scan_path) == nullptr) {
+    return nullptr;
+  }
+  const size_t max_threads =
+      table_scan_path->table_scan().table->file->max_parallel_scan_threads();
+  if (max_threads < 2) return nullptr;
+
+  AccessPath *path =
+      NewGatherAccessPath(thd, aggregate_path, static_cast<int>(max_threads));
+  EstimateGatherCost(path);
+  return path;
+}
+
 AccessPath *NewUpdateRowsAccessPath(THD *thd, AccessPath *child,
                                     table_map update_tables,
                                     table_map immediate_tables) {
@@ -330,6 +351,67 @@ bool FinalizeMaterializedSubqueries(THD *thd, JOIN *join, AccessPath *path) {
       });
 }
 
+/**
+  Check whether a table is read below the given access path in a way that lets
+  a TopNFilter throw away rows from it: through filters and joins only, and
+  never on the inner side of a join that is not an inner join. (Throwing away
+  a row on the outer side of any join only throws away the rows it would have
+  been joined with; on the inner side of an outer join, it could make the
+  join output a NULL-complemented row instead.)
+ */
+static bool IsReadThroughInnerJoinsOnly(const AccessPath *path,
+                                        const TABLE *table) {
+  switch (path->type) {
+    case AccessPath::FILTER:
+      return IsReadThroughInnerJoinsOnly(path->filter().child, table);
+    case AccessPath::NESTED_LOOP_JOIN: {
+      const auto &param = path->nested_loop_join();
+      return IsReadThroughInnerJoinsOnly(param.outer, table) ||
+             (param.join_type == JoinType::INNER &&
+              IsReadThroughInnerJoinsOnly(param.inner, table));
+    }
+    case AccessPath::HASH_JOIN: {
+      const auto &param = path->hash_join();
+      const RelationalExpression::Type type = param.join_predicate->expr->type;
+      return IsReadThroughInnerJoinsOnly(param.outer, table) ||
+             ((type == RelationalExpression::INNER_JOIN ||
+               type == RelationalExpression::STRAIGHT_INNER_JOIN) &&
+              IsReadThroughInnerJoinsOnly(param.inner, table));
+    }
+    default:
+      return GetBasicTable(path) == table;
+  }
+}
+
+/**
+  Make a filter that lets the scans below a sort with a LIMIT throw away rows
+  that cannot make it past the LIMIT, if possible. See TopNFilter.
+ */
+static unique_ptr_destroy_only<TopNFilter> NewTopNFilter(
+    THD *thd, MEM_ROOT *mem_root, const JOIN *join, const AccessPath *path) {
+  const auto &param = path->sort();
+  const Filesort *filesort = param.filesort;
+  // With SQL_CALC_FOUND_ROWS, all rows must reach the sort to be counted.
+  if (!thd->variables.sort_runtime_filters || filesort->limit == 0 ||
+      filesort->limit > TopNFilter::kMaxLimit ||
+      filesort->m_remove_duplicates ||
+      (join != nullptr && join->calc_found_rows)) {
+    return nullptr;
+  }
+
+  const st_sort_field &first = filesort->sortorder[0];
+  if (first.item == nullptr) return nullptr;
+  const Item *item = first.item->real_item();
+  if (item->type() != Item::FIELD_ITEM) return nullptr;
+  Field *field = down_cast<const Item_field *>(item)->field;
+  if (!RuntimeFilter::IsSupportedColumn(field) || field->is_virtual_gcol() ||
+      !IsReadThroughInnerJoinsOnly(param.child, field->table)) {
+    return nullptr;
+  }
+  return unique_ptr_destroy_only<TopNFilter>(
+      new (mem_root) TopNFilter(field, first.reverse, filesort->limit));
+}
+
 namespace {
 
 struct IteratorToBeCreated {
@@ -444,6 +526,10 @@ unique_ptr_destroy_only<RowIterator> CreateIteratorFromAccessPath(
           iterator = NewIterator<RefIterator<true>>(
               thd, mem_root, param.table, param.ref, param.use_order,
               path->num_output_rows(), examined_rows);
+        } else if (param.hash_lookup_threshold > 0) {
+          iterator = NewIterator<AdaptiveRefIterator>(
+              thd, mem_root, param.table, param.ref, path->num_output_rows(),
+              param.hash_lookup_threshold, examined_rows);
         } else {
           iterator = NewIterator<RefIterator<false>>(
               thd, mem_root, param.table, param.ref, param.use_order,
@@ -855,7 +941,8 @@ unique_ptr_destroy_only<RowIterator> CreateIteratorFromAccessPath(
         Filesort *filesort = param.filesort;
         iterator = NewIterator<SortingIterator>(
             thd, mem_root, filesort, std::move(job.children[0]),
-            num_rows_estimate, param.tables_to_get_rowid_for, examined_rows);
+            num_rows_estimate, param.tables_to_get_rowid_for,
+            NewTopNFilter(thd, mem_root, join, path), examined_rows);
         if (filesort->m_remove_duplicates) {
           filesort->tables[0]->duplicate_removal_iterator =
               down_cast<SortingIterator *>(iterator->real_iterator());
@@ -1149,6 +1236,31 @@ unique_ptr_destroy_only<RowIterator> CreateIteratorFromAccessPath(
             thd, mem_root, std::move(job.children[0]), param.name);
         break;
       }
+      case AccessPath::GATHER: {
+        const auto &param = path->gather();
+        if (job.children.is_null()) {
+          SetupJobsForChildren(mem_root, param.child, join,
+                               eligible_for_batch_mode, &job, &todo);
+          continue;
+        }
+        // Check again now that the plan is final; if the aggregation can no
+        // longer be split between threads, the serial plan is run as is.
+        const AccessPath *table_scan_path = nullptr;
+        std::unique_ptr<parallel_aggregate::AggregationSpec> spec =
+            parallel_aggregate::MakeAggregationSpec(thd, param.child, join,
+                                                    &table_scan_path);
+        if (spec == nullptr) {
+          iterator = std::move(job.children[0]);
+          break;
+        }
+        ha_rows *scan_examined_rows = table_scan_path->count_examined_rows
+                                          ? &join->examined_rows
+                                          : nullptr;
+        iterator = NewIterator<ParallelAggregateIterator>(
+            thd, mem_root, join, table_scan_path->table_scan().table,
+            std::move(spec), std::move(job.children[0]), scan_examined_rows);
+        break;
+      }
       case AccessPath::DELETE_ROWS: {
         const auto &param = path->delete_rows();
         if (job.children.is_null()) {
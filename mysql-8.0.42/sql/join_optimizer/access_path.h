@@ -257,6 +257,7 @@ struct AccessPath {
     REMOVE_DUPLICATES_ON_INDEX,
     ALTERNATIVE,
     CACHE_INVALIDATOR,
+    GATHER,
 
     // Access paths that modify tables.
     DELETE_ROWS,
@@ -827,6 +828,14 @@ struct AccessPath {
     assert(type == CACHE_INVALIDATOR);
     return u.cache_invalidator;
   }
+  auto &gather() {
+    assert(type == GATHER);
+    return u.gather;
+  }
+  const auto &gather() const {
+    assert(type == GATHER);
+    return u.gather;
+  }
   auto &delete_rows() {
     assert(type == DELETE_ROWS);
     return u.delete_rows;
@@ -873,6 +882,11 @@ struct AccessPath {
       Index_lookup *ref;
       bool use_order;
       bool reverse;
+      /// If nonzero, the number of lookups after which the rest of the
+      /// lookups are done in a hash table built from the entire table,
+      /// instead of in the index. See AdaptiveRefIterator. Only set by the
+      /// old optimizer.
+      ha_rows hash_lookup_threshold;
     } ref;
     struct {
       TABLE *table;
@@ -1202,6 +1216,13 @@ struct AccessPath {
       AccessPath *child;
       const char *name;
     } cache_invalidator;
+    struct {
+      // The serial plan, which is what is run if the work cannot be split
+      // between threads after all.
+      AccessPath *child;
+      // The number of threads we expect to run the child with.
+      int num_workers;
+    } gather;
     struct {
       AccessPath *child;
       table_map tables_to_delete_from;
@@ -1268,6 +1289,7 @@ inline AccessPath *NewRefAccessPath(THD *thd, TABLE *table, Index_lookup *ref,
   path->ref().ref = ref;
   path->ref().use_order = use_order;
   path->ref().reverse = reverse;
+  path->ref().hash_lookup_threshold = 0;
   return path;
 }
 
@@ -1692,6 +1714,25 @@ inline AccessPath *NewInvalidatorAccessPath(THD *thd, AccessPath *child,
   return path;
 }
 
+inline AccessPath *NewGatherAccessPath(THD *thd, AccessPath *child,
+                                       int num_workers) {
+  AccessPath *path = new (thd->mem_root) AccessPath;
+  path->type = AccessPath::GATHER;
+  path->gather().child = child;
+  path->gather().num_workers = num_workers;
+  return path;
+}
+
+/**
+  If the aggregation in "aggregate_path" (an AGGREGATE access path) can be
+  split between the parallel read threads of the storage engine (see
+  ParallelAggregateIterator), return a costed GATHER access path on top of it;
+  otherwise, return nullptr. The caller decides whether the GATHER path is
+  worth it.
+ */
+AccessPath *NewParallelAggregateAccessPath(THD *thd, JOIN *join,
+                                           AccessPath *aggregate_path);
+
 AccessPath *NewDeleteRowsAccessPath(THD *thd, AccessPath *child,
                                     table_map delete_tables,
                                     table_map immediate_tables);
@@ -925,3 +925,40 @@ void EstimateWindowCost(AccessPath *path) {
   path->init_once_cost = child->init_once_cost;
   path->cost = child->cost + kWindowOneRowCost * child->num_output_rows();
 }
+
+void EstimateGatherCost(AccessPath *path) {
+  const auto &param = path->gather();
+  const AccessPath *aggregate = param.child;
+
+  // The threads aggregate in hash tables, so any sort between the scan and
+  // the aggregation is not part of the parallel plan.
+  const AccessPath *input = aggregate->aggregate().child;
+  if (input->type == AccessPath::SORT) {
+    input = input->sort().child;
+  }
+
+  const double num_workers = std::max(1, param.num_workers);
+  const double input_rows = std::max(0.0, input->num_output_rows());
+  const double num_groups = std::max(0.0, aggregate->num_output_rows());
+
+  // Each thread sees every group at most once, so at most num_workers
+  // partial results per group are merged.
+  const double partial_results = std::min(input_rows, num_groups * num_workers);
+  const double merge_cost =
+      kAggregateOneRowCost * partial_results +
+      (num_groups > 1.0 ? kSortOneRowCost * num_groups * log2(num_groups)
+                        : 0.0);
+  const double scan_cost =
+      (input->cost + kHashBuildOneRowCost * input_rows) / num_workers;
+
+  path->set_num_output_rows(aggregate->num_output_rows());
+  // Nothing is returned before all threads are done.
+  path->init_cost =
+      kParallelWorkerStartupCost * num_workers + scan_cost + merge_cost;
+  path->cost = path->init_cost + kAggregateOneRowCost * num_groups;
+  path->init_once_cost = 0.0;
+  path->num_output_rows_before_filter = path->num_output_rows();
+  path->cost_before_filter = path->cost;
+  path->ordering_state = aggregate->ordering_state;
+  path->safe_for_rowid = aggregate->safe_for_rowid;
+}
@@ -56,6 +56,11 @@ constexpr double kHashReturnOneRowCost = 0.07;
 constexpr double kMaterializeOneRowCost = 0.1;
 constexpr double kWindowOneRowCost = 0.1;
 
+/// The cost of starting one thread of a parallel scan, and of merging its
+/// results with those of the other threads afterwards. This is what keeps
+/// small tables from being scanned in parallel.
+constexpr double kParallelWorkerStartupCost = 1000.0;
+
 /// A fallback cardinality estimate that is used in case the storage engine
 /// cannot provide one (like for table functions). It's a fairly arbitrary
 /// non-zero value.
@@ -140,6 +145,15 @@ void EstimateLimitOffsetCost(AccessPath *path);
 /// Estimate the costs and row count for a WINDOW AccessPath.
 void EstimateWindowCost(AccessPath *path);
 
+/**
+  Estimate the costs and row count for a GATHER AccessPath. The child (an
+  AGGREGATE path) is computed by path->gather().num_workers threads, which
+  each scan a part of the input and aggregate it in a hash table; the partial
+  results are merged and sorted on the grouping columns before the first row
+  is returned.
+ */
+void EstimateGatherCost(AccessPath *path);
+
 inline double FindOutputRowsForJoin(double left_rows, double right_rows,
                                     const JoinPredicate *edge) {
   double fanout = right_rows * edge->selectivity;
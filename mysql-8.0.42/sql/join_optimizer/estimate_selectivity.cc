@@ -26,7 +26,9 @@
 #include <sys/types.h>
 #include <algorithm>
 #include <initializer_list>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "my_bitmap.h"
 #include "my_table_map.h"
@@ -39,6 +41,7 @@
 #include "sql/join_optimizer/bit_utils.h"
 #include "sql/join_optimizer/print_utils.h"
 #include "sql/key.h"
+#include "sql/mem_root_array.h"
 #include "sql/sql_bitmap.h"
 #include "sql/sql_const.h"
 #include "sql/sql_select.h"
@@ -158,6 +161,50 @@ static double EstimateFieldSelectivity(Field *field, double *selectivity_cap,
   return std::min(selectivity, 1.0);
 }
 
+/**
+  Estimate the selectivity of joining the given fields to each other on
+  equality, from how the values in their histograms overlap (see
+  histograms::Histogram::get_equi_join_selectivity()). This takes into account
+  skew and ranges of values that are only found on one side, which
+  EstimateFieldSelectivity() does not. If there are more than two fields, we
+  choose the largest selectivity of any two fields from different tables,
+  for the same reasons as in EstimateFieldSelectivity().
+
+  Returns -1.0 if some field does not have a histogram, or if the histograms
+  cannot be combined.
+ */
+static double EstimateHistogramJoinSelectivity(
+    const std::vector<const Field *> &fields, string *trace) {
+  std::vector<const histograms::Histogram *> field_histograms;
+  for (const Field *field : fields) {
+    const histograms::Histogram *histogram =
+        field->table->s->find_histogram(field->field_index());
+    if (histogram == nullptr || empty(*histogram)) return -1.0;
+    field_histograms.push_back(histogram);
+  }
+
+  double selectivity = -1.0;
+  for (size_t i = 0; i < fields.size(); ++i) {
+    for (size_t j = i + 1; j < fields.size(); ++j) {
+      if (fields[i]->table == fields[j]->table) continue;
+      double pair_selectivity;
+      if (field_histograms[i]->get_equi_join_selectivity(*field_histograms[j],
+                                                         &pair_selectivity)) {
+        return -1.0;
+      }
+      if (trace != nullptr) {
+        *trace += StringPrintf(
+            " - estimating selectivity %f for %s.%s = %s.%s from the overlap "
+            "of their histograms\n",
+            pair_selectivity, fields[i]->table->alias, fields[i]->field_name,
+            fields[j]->table->alias, fields[j]->field_name);
+      }
+      selectivity = std::max(selectivity, pair_selectivity);
+    }
+  }
+  return selectivity;
+}
+
 /**
   For the given condition, to try estimate its filtering selectivity,
   on a 0..1 scale (where 1.0 lets all records through).
@@ -198,6 +245,13 @@ double EstimateSelectivity(THD *thd, Item *condition, string *trace) {
               selectivity,
               EstimateFieldSelectivity(field, &selectivity_cap, trace));
         }
+        const double histogram_selectivity = EstimateHistogramJoinSelectivity(
+            {down_cast<Item_field *>(left)->field,
+             down_cast<Item_field *>(right)->field},
+            trace);
+        if (histogram_selectivity >= 0.0) {
+          selectivity = histogram_selectivity;
+        }
         if (selectivity >= 0.0) {
           selectivity = std::min(selectivity, selectivity_cap);
           if (trace != nullptr) {
@@ -263,10 +317,17 @@ double EstimateSelectivity(THD *thd, Item *condition, string *trace) {
     assert(equal->const_arg() == nullptr);
 
     double selectivity = -1.0;
+    std::vector<const Field *> fields;
     for (Item_field &field : equal->get_fields()) {
       selectivity = std::max(
           selectivity,
           EstimateFieldSelectivity(field.field, &selectivity_cap, trace));
+      fields.push_back(field.field);
+    }
+    const double histogram_selectivity =
+        EstimateHistogramJoinSelectivity(fields, trace);
+    if (histogram_selectivity >= 0.0) {
+      selectivity = histogram_selectivity;
     }
     if (selectivity >= 0.0) {
       selectivity = std::min(selectivity, selectivity_cap);
@@ -307,3 +368,96 @@ double EstimateSelectivity(THD *thd, Item *condition, string *trace) {
   }
   return selectivity;
 }
+
+double EstimateJoinCorrelationFactor(
+    THD *thd, const Mem_root_array<Item_eq_base *> &conditions,
+    string *trace) {
+  // The fields on each side of the field = field conditions, by their index
+  // in "conditions".
+  std::vector<std::pair<size_t, const Field *>> fields;
+  for (size_t i = 0; i < std::min<size_t>(conditions.size(), 64); ++i) {
+    if (!is_function_of_type(conditions[i], Item_func::EQ_FUNC)) continue;
+    const Item *left = conditions[i]->arguments()[0];
+    const Item *right = conditions[i]->arguments()[1];
+    if (left->type() != Item::FIELD_ITEM || right->type() != Item::FIELD_ITEM)
+      continue;
+    const Field *left_field = down_cast<const Item_field *>(left)->field;
+    const Field *right_field = down_cast<const Item_field *>(right)->field;
+    if (left_field->table == right_field->table) continue;
+    fields.emplace_back(i, left_field);
+    fields.emplace_back(i, right_field);
+  }
+  if (fields.size() < 4) return 1.0;
+
+  // For each set of conditions that join a prefix of an index, the
+  // selectivity of joining on the entire prefix at once.
+  std::map<uint64_t, double> prefix_selectivities;
+  for (const auto &[condition_idx, table_field] : fields) {
+    const TABLE *table = table_field->table;
+    const double rows = table->file->stats.records;
+    if (rows < 1.0) continue;
+    for (uint key_idx = 0; key_idx < table->s->keys; ++key_idx) {
+      const KEY &key = table->key_info[key_idx];
+      if (!table_field->key_start.is_set(key_idx)) continue;
+      uint64_t conditions_in_prefix = 0;
+      for (uint part = 0; part < key.user_defined_key_parts; ++part) {
+        const auto found = std::find_if(
+            fields.begin(), fields.end(), [&](const auto &field) {
+              return field.second->table == table &&
+                     field.second->field_index() ==
+                         key.key_part[part].fieldnr - 1U &&
+                     !IsBitSet(field.first, conditions_in_prefix);
+            });
+        if (found == fields.end()) break;
+        conditions_in_prefix |= uint64_t{1} << found->first;
+        if (part > 0 && key.has_records_per_key(part)) {
+          double &selectivity = prefix_selectivities[conditions_in_prefix];
+          selectivity = std::max(
+              selectivity,
+              std::min(1.0, static_cast<double>(key.records_per_key(part)) /
+                                rows));
+          if (trace != nullptr) {
+            *trace += StringPrintf(
+                " - found candidate index %s with selectivity %f for the "
+                "first %u columns\n",
+                key.name, selectivity, part + 1);
+          }
+        }
+      }
+    }
+  }
+
+  // Use the prefixes that cover the most conditions first.
+  std::vector<std::pair<uint64_t, double>> prefixes(
+      prefix_selectivities.begin(), prefix_selectivities.end());
+  std::stable_sort(prefixes.begin(), prefixes.end(),
+                   [](const auto &a, const auto &b) {
+                     return PopulationCount(a.first) >
+                            PopulationCount(b.first);
+                   });
+  double factor = 1.0;
+  uint64_t conditions_used = 0;
+  for (const auto &[conditions_in_prefix, selectivity] : prefixes) {
+    if (Overlaps(conditions_in_prefix, conditions_used)) continue;
+    conditions_used |= conditions_in_prefix;
+
+    double independent_selectivity = 1.0;
+    for (size_t condition_idx : BitsSetIn(conditions_in_prefix)) {
+      independent_selectivity *= EstimateSelectivity(
+          thd, conditions[condition_idx], /*trace=*/nullptr);
+    }
+    // Columns that are joined on together are rarely less correlated than
+    // independent ones, so only ever adjust upwards.
+    if (selectivity > independent_selectivity) {
+      factor *= selectivity / independent_selectivity;
+      if (trace != nullptr) {
+        *trace += StringPrintf(
+            " - using selectivity %f instead of %f for %d correlated "
+            "conditions\n",
+            selectivity, independent_selectivity,
+            PopulationCount(conditions_in_prefix));
+      }
+    }
+  }
+  return factor;
+}
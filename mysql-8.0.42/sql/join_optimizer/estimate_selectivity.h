@@ -26,8 +26,11 @@
 
 #include <string>
 
+#include "sql/mem_root_array.h"
+
 class THD;
 class Item;
+class Item_eq_base;
 
 /**
   For the given condition, to try estimate its filtering selectivity,
@@ -35,4 +38,16 @@ class Item;
  */
 double EstimateSelectivity(THD *thd, Item *condition, std::string *trace);
 
+/**
+  Find the factor to multiply the product of the selectivities of the given
+  equijoin conditions with, to account for correlation between the columns
+  that they join on. Conditions that join on all the columns of a prefix of
+  an index, e.g. (country, city), are estimated together from the number of
+  distinct values of that prefix, instead of as if the columns were
+  independent.
+ */
+double EstimateJoinCorrelationFactor(
+    THD *thd, const Mem_root_array<Item_eq_base *> &conditions,
+    std::string *trace);
+
 #endif  // SQL_JOIN_OPTIMIZER_ESTIMATE_SELECTIVITY
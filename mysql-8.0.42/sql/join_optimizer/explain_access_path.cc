@@ -35,6 +35,7 @@
 #include "sql-common/json_dom.h"
 #include "sql/filesort.h"
 #include "sql/item_cmpfunc.h"
+#include "sql/item_subselect.h"
 #include "sql/item_sum.h"
 #include "sql/iterators/basic_row_iterators.h"
 #include "sql/iterators/bka_iterator.h"
@@ -223,7 +224,23 @@ static bool GetAccessPathsFromItem(Item *item_arg, const char *source_text,
         Item_subselect *subselect = down_cast<Item_subselect *>(item);
         Query_block *query_block = subselect->unit->first_query_block();
         char description[256];
-        if (query_block->is_dependent()) {
+        // Correlated scalar subqueries may have taken some of their results
+        // from the result cache (see Subquery_result_cache).
+        ulonglong cache_hits = 0;
+        ulonglong cache_misses = 0;
+        if (subselect->substype() == Item_subselect::SINGLEROW_SUBS) {
+          const auto *singlerow =
+              down_cast<const Item_singlerow_subselect *>(subselect);
+          cache_hits = singlerow->result_cache_hits();
+          cache_misses = singlerow->result_cache_misses();
+        }
+        if (query_block->is_dependent() && cache_hits + cache_misses > 0) {
+          snprintf(description, sizeof(description),
+                   "Select #%d (subquery in %s; dependent; result cache: "
+                   "%llu hits, %llu misses)",
+                   query_block->select_number, source_text, cache_hits,
+                   cache_misses);
+        } else if (query_block->is_dependent()) {
           snprintf(description, sizeof(description),
                    "Select #%d (subquery in %s; dependent)",
                    query_block->select_number, source_text);
@@ -257,6 +274,13 @@ static bool GetAccessPathsFromItem(Item *item_arg, const char *source_text,
         if (query_block->is_cacheable())
           error |=
               AddMemberToObject<Json_boolean>(child_obj, "cacheable", true);
+        if (cache_hits + cache_misses > 0) {
+          error |= AddMemberToObject<Json_int>(child_obj, "result_cache_hits",
+                                               cache_hits);
+          error |= AddMemberToObject<Json_int>(child_obj,
+                                               "result_cache_misses",
+                                               cache_misses);
+        }
 
         children->push_back({path, description, query_block->join, child_obj});
 
@@ -985,6 +1009,18 @@ static std::unique_ptr<Json_object> SetObjectMembers(
           RefToString(*path->ref().ref, key, /*include_nulls=*/false),
           /*ranges=*/nullptr, nullptr, path->ref().reverse,
           table->file->pushed_idx_cond, obj);
+      if (path->ref().hash_lookup_threshold > 0 && path->iterator != nullptr) {
+        const auto *iterator = down_cast<const AdaptiveRefIterator *>(
+            path->iterator->real_iterator());
+        if (iterator->switched_to_hash_lookup()) {
+          description += " (switched to hash lookup after " +
+                         std::to_string(iterator->index_lookups()) +
+                         " lookups)";
+          error |= AddMemberToObject<Json_int>(
+              obj, "index_lookups_before_hash_lookup",
+              iterator->index_lookups());
+        }
+      }
       error |= AddChildrenFromPushedCondition(table, children);
       break;
     }
@@ -1589,6 +1625,17 @@ static std::unique_ptr<Json_object> SetObjectMembers(
                                               path->cache_invalidator().name);
       children->push_back({path->cache_invalidator().child});
       break;
+    case AccessPath::GATHER: {
+      char buf[64];
+      snprintf(buf, sizeof(buf), "Gather (workers: %d)",
+               path->gather().num_workers);
+      description = buf;
+      error |= AddMemberToObject<Json_string>(obj, "access_type", "gather");
+      error |= AddMemberToObject<Json_int>(obj, "workers",
+                                           path->gather().num_workers);
+      children->push_back({path->gather().child});
+      break;
+    }
     case AccessPath::DELETE_ROWS: {
       error |=
           AddMemberToObject<Json_string>(obj, "access_type", "delete_rows");
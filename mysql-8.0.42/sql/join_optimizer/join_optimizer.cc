@@ -2021,6 +2021,11 @@ bool CostingReceiver::ProposeRefAccess(
     path.ref().table = table;
     path.ref().ref = ref;
     path.ref().reverse = reverse;
+    // The switch to hash lookups (see AdaptiveRefIterator) is not used here.
+    // The hypergraph optimizer already proposes hash joins wherever they are
+    // possible, and picks nested loops with index lookups only when their
+    // cost is lower.
+    path.ref().hash_lookup_threshold = 0;
 
     // TODO(sgunders): Some storage engines, like NDB, can benefit from
     // use_order = false if we don't actually need the ordering later.
@@ -4377,6 +4382,9 @@ string PrintAccessPath(const AccessPath &path, const JoinHypergraph &graph,
     case AccessPath::CACHE_INVALIDATOR:
       str += "CACHE_INVALIDATOR";
       break;
+    case AccessPath::GATHER:
+      str += "GATHER";
+      break;
     case AccessPath::DELETE_ROWS:
       str += "DELETE_ROWS";
       break;
@@ -5365,6 +5373,25 @@ AccessPath CreateStreamingAggregationPath(THD *thd, AccessPath *path,
   return aggregate_path;
 }
 
+/**
+  If parallel_aggregation is enabled, and the aggregation in "aggregate_path"
+  can be split between the parallel read threads of the storage engine,
+  propose a GATHER path that does so, as an alternative to the serial
+  aggregation. The GATHER path wins if the scan is large enough to pay for
+  starting the threads.
+ */
+void ProposeParallelAggregation(
+    THD *thd, JOIN *join, const AccessPath &aggregate_path,
+    const CostingReceiver &receiver,
+    Prealloced_array<AccessPath *, 4> *new_root_candidates) {
+  if (!thd->variables.parallel_aggregation) return;
+  AccessPath *gather_path = NewParallelAggregateAccessPath(
+      thd, join, new (thd->mem_root) AccessPath(aggregate_path));
+  if (gather_path == nullptr) return;
+  receiver.ProposeAccessPath(gather_path, new_root_candidates,
+                             /*obsolete_orderings=*/0, "parallel");
+}
+
 // If we are planned using in2exists, and our SELECT list has a window
 // function, the HAVING condition may include parts that refer to window
 // functions. (This cannot happen in standard SQL, but we add such conditions
@@ -6757,6 +6784,8 @@ AccessPath *FindBestQueryPlan(THD *thd, Query_block *query_block,
         aggregate_rows = aggregate_path.num_output_rows();
         receiver.ProposeAccessPath(&aggregate_path, &new_root_candidates,
                                    /*obsolete_orderings=*/0, "sort elided");
+        ProposeParallelAggregation(thd, join, aggregate_path, receiver,
+                                   &new_root_candidates);
         continue;
       }
 
@@ -6803,6 +6832,8 @@ AccessPath *FindBestQueryPlan(THD *thd, Query_block *query_block,
         aggregate_rows = aggregate_path.num_output_rows();
         receiver.ProposeAccessPath(&aggregate_path, &new_root_candidates,
                                    /*obsolete_orderings=*/0, description);
+        ProposeParallelAggregation(thd, join, aggregate_path, receiver,
+                                   &new_root_candidates);
       }
     }
     root_candidates = std::move(new_root_candidates);
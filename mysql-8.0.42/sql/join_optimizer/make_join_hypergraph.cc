@@ -3124,6 +3124,31 @@ void PromoteCycleJoinPredicates(
   }
 }
 
+/**
+  The selectivity of each join edge is the product of the selectivities of
+  its conditions, which assumes that the columns they join on are
+  independent. Adjust it for columns that are known to be correlated; see
+  EstimateJoinCorrelationFactor().
+ */
+void AdjustJoinSelectivitiesForCorrelation(THD *thd, JoinHypergraph *graph,
+                                           string *trace) {
+  for (JoinPredicate &edge : graph->edges) {
+    if (edge.expr->equijoin_conditions.size() < 2) continue;
+    string correlation_trace;
+    const double factor = EstimateJoinCorrelationFactor(
+        thd, edge.expr->equijoin_conditions,
+        trace == nullptr ? nullptr : &correlation_trace);
+    if (factor == 1.0) continue;
+    edge.selectivity = std::min(1.0, edge.selectivity * factor);
+    if (trace != nullptr) {
+      *trace += StringPrintf("Correlation in join %s:\n",
+                             GenerateExpressionLabel(edge.expr).c_str());
+      *trace += correlation_trace;
+      *trace += StringPrintf("  - total: %.3f\n", edge.selectivity);
+    }
+  }
+}
+
 }  // namespace
 
 /**
@@ -3643,6 +3668,7 @@ bool MakeJoinHypergraph(THD *thd, string *trace, JoinHypergraph *graph,
       std::unique(multiple_equalities.begin(), multiple_equalities.end()),
       multiple_equalities.end());
   CompleteFullMeshForMultipleEqualities(thd, multiple_equalities, graph, trace);
+  AdjustJoinSelectivitiesForCorrelation(thd, graph, trace);
   if (graph->graph.edges.size() != old_graph_edges) {
     // We added at least one cycle-inducing edge.
     PromoteCycleJoinPredicates(thd, root, multiple_equalities, graph, trace);
@@ -213,6 +213,10 @@ void WalkAccessPaths(AccessPathPtr path, JoinPtr join,
       WalkAccessPaths(path->cache_invalidator().child, join, cross_query_blocks,
                       std::forward<Func &&>(func), post_order_traversal);
       break;
+    case AccessPath::GATHER:
+      WalkAccessPaths(path->gather().child, join, cross_query_blocks,
+                      std::forward<Func &&>(func), post_order_traversal);
+      break;
     case AccessPath::INDEX_MERGE:
       for (AccessPath *child : *path->index_merge().children) {
         WalkAccessPaths(child, join, cross_query_blocks,
@@ -320,6 +324,7 @@ void WalkTablesUnderAccessPath(AccessPath *root_path, Func &&func,
           case AccessPath::CACHE_INVALIDATOR:
           case AccessPath::FAKE_SINGLE_ROW:
           case AccessPath::FILTER:
+          case AccessPath::GATHER:
           case AccessPath::HASH_JOIN:
           case AccessPath::LIMIT_OFFSET:
           case AccessPath::MATERIALIZE_INFORMATION_SCHEMA_TABLE:
@@ -788,7 +788,9 @@ MySQL clients support the protocol:
 #include "sql/derror.h"
 #include "sql/event_data_objects.h"  // init_scheduler_psi_keys
 #include "sql/events.h"              // Events
+#include "sql/filesort_utils.h"      // key_thread_sort_worker
 #include "sql/handler.h"
+#include "sql/histograms/histogram_maintenance.h"
 #include "sql/hostname_cache.h"  // hostname_cache_init
 #include "sql/init.h"            // unireg_init
 #include "sql/item.h"
@@ -1166,6 +1168,7 @@ const char *default_tmp_storage_engine;
 ulonglong temptable_max_ram;
 ulonglong temptable_max_mmap;
 bool temptable_use_mmap;
+bool temptable_use_columnar_storage;
 static char compiled_default_collation_name[] = MYSQL_DEFAULT_COLLATION_NAME;
 static bool binlog_format_used = false;
 
@@ -2659,6 +2662,7 @@ static void clean_up(bool print_message) {
   delegates_destroy();
   xa::Transaction_cache::dispose();
   MDL_context_backup_manager::destroy();
+  histograms::auto_update_cleanup();
   table_def_free();
   mdl_destroy();
   key_caches.delete_elements();
@@ -8216,6 +8220,7 @@ int mysqld_main(int argc, char **argv)
   start_handle_manager();
 
   create_compress_gtid_table_thread();
+  histograms::create_auto_update_thread();
 
   LogEvent()
       .type(LOG_TYPE_ERROR)
@@ -8296,6 +8301,7 @@ int mysqld_main(int argc, char **argv)
                      MYSQLD_SUCCESS_EXIT);
 
   terminate_compress_gtid_table_thread();
+  histograms::terminate_auto_update_thread();
   /*
     Save set of GTIDs of the last binlog into gtid_executed table
     on server shutdown.
@@ -11854,6 +11860,8 @@ PSI_mutex_key key_mutex_replica_worker_hash;
 PSI_mutex_key key_monitor_info_run_lock;
 PSI_mutex_key key_LOCK_delegate_connection_mutex;
 PSI_mutex_key key_LOCK_group_replication_connection_mutex;
+PSI_mutex_key key_LOCK_hash_join_parallel;
+PSI_mutex_key key_LOCK_histogram_auto_update;
 
 /* clang-format off */
 static PSI_mutex_info all_server_mutexes[]=
@@ -11948,7 +11956,9 @@ static PSI_mutex_info all_server_mutexes[]=
   { &key_LOCK_delegate_connection_mutex, "LOCK_delegate_connection_mutex", PSI_FLAG_SINGLETON, 0, PSI_DOCUMENT_ME},
   { &key_LOCK_group_replication_connection_mutex, "LOCK_group_replication_connection_mutex", PSI_FLAG_SINGLETON, 0, PSI_DOCUMENT_ME},
 { &key_LOCK_authentication_policy, "LOCK_authentication_policy", PSI_FLAG_SINGLETON, 0, "A lock to ensure execution of CREATE USER or ALTER USER sql and SET @@global.authentication_policy variable are serialized"},
-  { &key_LOCK_global_conn_mem_limit, "LOCK_global_conn_mem_limit", PSI_FLAG_SINGLETON, 0, PSI_DOCUMENT_ME}
+  { &key_LOCK_global_conn_mem_limit, "LOCK_global_conn_mem_limit", PSI_FLAG_SINGLETON, 0, PSI_DOCUMENT_ME},
+  { &key_LOCK_hash_join_parallel, "ParallelChunkJoin::m_mutex", 0, 0, PSI_DOCUMENT_ME},
+  { &key_LOCK_histogram_auto_update, "LOCK_histogram_auto_update", PSI_FLAG_SINGLETON, 0, PSI_DOCUMENT_ME}
 };
 /* clang-format on */
 
@@ -12021,6 +12031,8 @@ PSI_cond_key key_cond_slave_worker_hash;
 PSI_cond_key key_monitor_info_run_cond;
 PSI_cond_key key_COND_delegate_connection_cond_var;
 PSI_cond_key key_COND_group_replication_connection_cond_var;
+PSI_cond_key key_COND_hash_join_chunk_done;
+PSI_cond_key key_COND_histogram_auto_update;
 
 /* clang-format off */
 static PSI_cond_info all_server_conds[]=
@@ -12064,7 +12076,9 @@ static PSI_cond_info all_server_conds[]=
   { &key_cond_slave_worker_hash, "Relay_log_info::replica_worker_hash_cond", 0, 0, PSI_DOCUMENT_ME},
   { &key_monitor_info_run_cond, "Source_IO_monitor::run_cond", 0, 0, PSI_DOCUMENT_ME},
   { &key_COND_delegate_connection_cond_var, "THD::COND_delegate_connection_cond_var", 0, 0, PSI_DOCUMENT_ME},
-  { &key_COND_group_replication_connection_cond_var, "THD::COND_group_replication_connection_cond_var", 0, 0, PSI_DOCUMENT_ME}
+  { &key_COND_group_replication_connection_cond_var, "THD::COND_group_replication_connection_cond_var", 0, 0, PSI_DOCUMENT_ME},
+  { &key_COND_hash_join_chunk_done, "ParallelChunkJoin::m_chunk_done", 0, 0, PSI_DOCUMENT_ME},
+  { &key_COND_histogram_auto_update, "COND_histogram_auto_update", PSI_FLAG_SINGLETON, 0, PSI_DOCUMENT_ME}
 };
 /* clang-format on */
 
@@ -12074,6 +12088,8 @@ PSI_thread_key key_thread_one_connection;
 PSI_thread_key key_thread_compress_gtid_table;
 PSI_thread_key key_thread_parser_service;
 PSI_thread_key key_thread_handle_con_admin_sockets;
+PSI_thread_key key_thread_hash_join_worker;
+PSI_thread_key key_thread_histogram_auto_update;
 
 /* clang-format off */
 static PSI_thread_info all_server_threads[]=
@@ -12093,6 +12109,9 @@ PSI_FLAG_USER | PSI_FLAG_NO_SEQNUM, 0, PSI_DOCUMENT_ME},
   { &key_thread_compress_gtid_table, "compress_gtid_table", "gtid_zip", PSI_FLAG_SINGLETON, 0, PSI_DOCUMENT_ME},
   { &key_thread_parser_service, "parser_service", "parser_srv", PSI_FLAG_SINGLETON, 0, PSI_DOCUMENT_ME},
   { &key_thread_handle_con_admin_sockets, "admin_interface", "con_admin", PSI_FLAG_USER, 0, PSI_DOCUMENT_ME},
+  { &key_thread_hash_join_worker, "hash_join_worker", "hj_worker", 0, 0, PSI_DOCUMENT_ME},
+  { &key_thread_sort_worker, "sort_worker", "sort_worker", 0, 0, PSI_DOCUMENT_ME},
+  { &key_thread_histogram_auto_update, "histogram_auto_update", "hist_update", PSI_FLAG_SINGLETON, 0, PSI_DOCUMENT_ME},
 };
 /* clang-format on */
 
@@ -134,6 +134,7 @@ PSI_memory_key key_memory_show_replica_status_io_gtid_set;
 PSI_memory_key key_memory_sp_head_call_root;
 PSI_memory_key key_memory_sp_head_execute_root;
 PSI_memory_key key_memory_sp_head_main_root;
+PSI_memory_key key_memory_subquery_result_cache;
 PSI_memory_key key_memory_table_mapping_root;
 PSI_memory_key key_memory_table_share;
 PSI_memory_key key_memory_test_quick_select_exec;
@@ -372,6 +373,10 @@ static PSI_memory_info all_server_memory[] = {
     {&key_memory_histograms, "histograms", 0, 0, PSI_DOCUMENT_ME},
     {&key_memory_hash_join, "hash_join", PSI_FLAG_MEM_COLLECT, 0,
      PSI_DOCUMENT_ME},
+    {&key_memory_subquery_result_cache, "subquery_result_cache",
+     PSI_FLAG_MEM_COLLECT, 0,
+     "Results of correlated scalar subqueries, keyed by their outer "
+     "references."},
     {&key_memory_rm_table_foreach_root, "rm_table::foreach_root",
      PSI_FLAG_THREAD, 0,
      "Mem root for temporary objects allocated while dropping tables or the "
@@ -160,6 +160,7 @@ extern PSI_memory_key key_memory_show_replica_status_io_gtid_set;
 extern PSI_memory_key key_memory_sp_head_call_root;
 extern PSI_memory_key key_memory_sp_head_execute_root;
 extern PSI_memory_key key_memory_sp_head_main_root;
+extern PSI_memory_key key_memory_subquery_result_cache;
 extern PSI_memory_key key_memory_table_mapping_root;
 extern PSI_memory_key key_memory_table_share;
 extern PSI_memory_key key_memory_test_quick_select_exec;
@@ -39,6 +39,7 @@
 #include "mysql/components/services/bits/psi_bits.h"
 #include "mysql/service_mysql_alloc.h"
 #include "sql/join_optimizer/bit_utils.h"
+#include "sql/iterators/runtime_filter.h"
 #include "sql/key.h"
 #include "sql/psi_memory_key.h"
 #include "sql/range_optimizer/reverse_index_range_scan.h"
@@ -369,8 +370,17 @@ int IndexRangeScanIterator::Read() {
     table()->column_bitmaps_set_no_signal(&column_bitmap, &column_bitmap);
   }
 
+  RuntimeFilter *runtime_filter = file->ha_get_runtime_filter_to_check();
+
   char *dummy;
-  int result = file->ha_multi_range_read_next(&dummy);
+  int result;
+  do {
+    result = file->ha_multi_range_read_next(&dummy);
+    if (result == 0 && m_examined_rows != nullptr) {
+      ++*m_examined_rows;
+    }
+  } while (result == 0 && runtime_filter != nullptr &&
+           !runtime_filter->MayMatch(table()->record[0]));
 
   if (in_ror_merged_scan) {
     /* Restore bitmaps set on entry */
@@ -380,9 +390,6 @@ int IndexRangeScanIterator::Read() {
     }
   }
   if (result == 0) {
-    if (m_examined_rows != nullptr) {
-      ++*m_examined_rows;
-    }
     return 0;
   }
   return HandleError(result);
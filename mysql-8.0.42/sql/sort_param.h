@@ -452,15 +452,21 @@ class Sort_param {
    */
   void get_rec_and_res_len(uchar *record_start, uint *recl, uint *resl);
 
-  // NOTE: Even with FILESORT_ALG_STD_STABLE, we do not necessarily have a
-  // stable sort if spilling to disk; this is purely a performance option.
+  // NOTE: Even with FILESORT_ALG_STD_STABLE or FILESORT_ALG_RADIX, which are
+  // both stable, we do not necessarily have a stable sort if spilling to disk;
+  // this is purely a performance option.
   enum enum_sort_algorithm {
     FILESORT_ALG_NONE,
     FILESORT_ALG_STD_SORT,
-    FILESORT_ALG_STD_STABLE
+    FILESORT_ALG_STD_STABLE,
+    FILESORT_ALG_RADIX
   };
   enum_sort_algorithm m_sort_algorithm{FILESORT_ALG_NONE};
 
+  /// The number of threads that may sort the keys in memory. See the
+  /// sort_threads system variable.
+  size_t m_max_sort_threads{1};
+
   Addon_fields_status m_addon_fields_status{
       Addon_fields_status::unknown_status};
 
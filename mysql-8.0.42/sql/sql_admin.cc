@@ -89,6 +89,7 @@
 #include "sql/sql_list.h"
 #include "sql/sql_parse.h"      // check_table_access
 #include "sql/sql_partition.h"  // set_part_state
+#include "sql/sql_planner.h"    // Join_order_cache
 #include "sql/sql_table.h"      // mysql_recreate_table
 #include "sql/ssl_acceptor_context_operator.h"
 #include "sql/ssl_init_callback.h"
@@ -1738,6 +1739,9 @@ bool Sql_cmd_analyze_table::execute(THD *thd) {
                             &handler::ha_analyze, 0, m_alter_info, true);
   }
 
+  // Join orders chosen with the old statistics may no longer be the best.
+  if (!res) Join_order_cache::invalidate_all();
+
   /* ! we write after unlocking the table */
   if (!res && !thd->lex->no_write_to_binlog) {
     /*
@@ -101,6 +101,7 @@
 #include "sql/field.h"
 #include "sql/handler.h"
 #include "sql/histograms/histogram.h"
+#include "sql/histograms/histogram_maintenance.h"
 #include "sql/item.h"
 #include "sql/item_cmpfunc.h"  // Item_func_eq
 #include "sql/item_func.h"
@@ -627,6 +628,10 @@ static bool read_histograms(THD *thd, TABLE_SHARE *share,
     }
   }
 
+  if (!share->m_histograms->empty())
+    histograms::register_table_for_auto_update(share->db.str,
+                                               share->table_name.str);
+
   return false;
 }
 
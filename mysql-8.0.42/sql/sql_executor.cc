@@ -3746,6 +3746,82 @@ bool QEP_TAB::use_order() const {
   return false;
 }
 
+/**
+  Find out after how many lookups the ref access of the given table should
+  switch from the index to a hash table over the entire table (see
+  AdaptiveRefIterator). That is when the table has been looked up
+  adaptive_join_factor times as often as the optimizer expected, and more
+  often than it takes for the lookups to cost more than a table scan.
+
+  @returns the number of lookups, or 0 if the access must never switch
+ */
+static ha_rows HashLookupThreshold(QEP_TAB *qep_tab) {
+  JOIN *join = qep_tab->join();
+  THD *thd = join->thd;
+  TABLE *table = qep_tab->table();
+  const ulong factor = thd->variables.adaptive_join_factor;
+  if (factor == 0) return 0;
+
+  // The rows are copied out of the table, so they must not change while the
+  // query runs, and they must not be locked.
+  if (thd->lex->sql_command != SQLCOM_SELECT) return 0;
+  if (qep_tab->table_ref == nullptr || !qep_tab->table_ref->is_base_table() ||
+      table->s->tmp_table != NO_TMP_TABLE)
+    return 0;
+  if (table->reginfo.lock_type > TL_READ ||
+      thd->tx_isolation == ISO_SERIALIZABLE)
+    return 0;
+
+  if (qep_tab->use_order() ||
+      static_cast<uint>(qep_tab->idx()) <= join->const_tables ||
+      qep_tab->position() == nullptr)
+    return 0;
+  if (table->s->primary_key == MAX_KEY ||
+      (table->file->ha_table_flags() & HA_PRIMARY_KEY_REQUIRED_FOR_POSITION) ==
+          0)
+    return 0;
+
+  // The hash table compares key images byte by byte, which is only the same
+  // as comparing the values for the types below.
+  const Index_lookup &ref = qep_tab->ref();
+  const KEY &key = table->key_info[ref.key];
+  if (key.flags & (HA_MULTI_VALUED_KEY | HA_FULLTEXT | HA_SPATIAL)) return 0;
+  for (uint i = 0; i < ref.key_parts; ++i) {
+    const Field *field = key.key_part[i].field;
+    switch (field->real_type()) {
+      case MYSQL_TYPE_TINY:
+      case MYSQL_TYPE_SHORT:
+      case MYSQL_TYPE_INT24:
+      case MYSQL_TYPE_LONG:
+      case MYSQL_TYPE_LONGLONG:
+      case MYSQL_TYPE_YEAR:
+      case MYSQL_TYPE_NEWDATE:
+      case MYSQL_TYPE_TIME2:
+      case MYSQL_TYPE_DATETIME2:
+      case MYSQL_TYPE_TIMESTAMP2:
+      case MYSQL_TYPE_NEWDECIMAL:
+        break;
+      default:
+        return 0;
+    }
+    if (field->is_virtual_gcol()) return 0;
+    if (field->is_nullable() &&
+        (ref.null_rejecting & (key_part_map{1} << i)) == 0)
+      return 0;
+    if (ref.cond_guards != nullptr && ref.cond_guards[i] != nullptr) return 0;
+  }
+
+  const double expected_lookups =
+      std::max(join->best_positions[qep_tab->idx() - 1].prefix_rowcount, 1.0);
+  const double lookup_cost =
+      std::max(qep_tab->position()->read_cost / expected_lookups, 1e-6);
+  const double scan_cost = table->file->table_scan_cost().total_cost();
+  const double threshold =
+      std::max({factor * expected_lookups, scan_cost / lookup_cost, 1.0});
+  if (threshold >= static_cast<double>(HA_POS_ERROR)) return 0;
+  return static_cast<ha_rows>(threshold);
+}
+
 AccessPath *QEP_TAB::access_path() {
   assert(table());
   // Only some access methods support reversed access:
@@ -3759,6 +3835,9 @@ AccessPath *QEP_TAB::access_path() {
       path = NewRefAccessPath(join()->thd, table(), &ref(), use_order(),
                               m_reversed_access,
                               /*count_examined_rows=*/true);
+      if (!m_reversed_access) {
+        path->ref().hash_lookup_threshold = HashLookupThreshold(this);
+      }
       used_ref = &ref();
       break;
 
@@ -106,6 +106,7 @@ class Item_rollup_group_item;
 class Item_rollup_sum_switcher;
 class Item_sum;
 class JOIN;
+class Join_order_cache;
 class Opt_hints_global;
 class Opt_hints_qb;
 class PT_subquery;
@@ -1973,6 +1974,12 @@ class Query_block : public Query_term {
     should be changed only when THD::LOCK_query_plan mutex is taken.
   */
   JOIN *join{nullptr};
+  /**
+    Join orders chosen by earlier optimizations of this query block, if it
+    belongs to a prepared statement or a stored program. Allocated on the
+    statement's MEM_ROOT, so it lives until the statement is reprepared.
+  */
+  Join_order_cache *join_order_cache{nullptr};
   /// Set of table references contained in outer-most join nest
   mem_root_deque<Table_ref *> m_table_nest;
   /// Pointer to the set of table references in the currently active join
@@ -2023,10 +2023,31 @@ bool Optimize_table_order::choose_table_order() {
   Table_map_restorer deps_lateral(
       &join->deps_of_remaining_lateral_derived_tables);
 
+  Join_order_cache *order_cache = nullptr;
+  if (!straight_join && get_join_order_cache(&order_cache)) return true;
+  const uint8 *const cached_order =
+      order_cache == nullptr ? nullptr : order_cache->find(thd, join);
+
   if (straight_join)
     optimize_straight_join(join_tables);
-  else {
+  else if (cached_order != nullptr) {
+    // Put the tables in the order chosen by an earlier execution, and only
+    // calculate the cost of that order.
+    for (uint idx = join->const_tables; idx < join->tables; ++idx) {
+      const uint tableno = cached_order[idx - join->const_tables];
+      JOIN_TAB **const tab = std::find_if(
+          join->best_ref + idx, join->best_ref + join->tables,
+          [tableno](const JOIN_TAB *t) {
+            return t->table_ref->tableno() == tableno;
+          });
+      assert(tab != join->best_ref + join->tables);
+      std::swap(join->best_ref[idx], *tab);
+    }
+    Opt_trace_object(&thd->opt_trace).add("join_order_from_cache", true);
+    optimize_straight_join(join_tables);
+  } else {
     if (greedy_search(join_tables)) return true;
+    if (order_cache != nullptr) order_cache->insert(join);
   }
 
   deps_lateral.assert_unchanged();
@@ -2042,6 +2063,107 @@ bool Optimize_table_order::choose_table_order() {
   return false;
 }
 
+/**
+  Get the cache of join orders chosen by earlier executions of the query
+  block, creating it if needed.
+
+  Only query blocks of prepared statements and stored programs are optimized
+  more than once. Query blocks with semijoin nests are not cached, since the
+  semijoin strategies are chosen together with the join order.
+
+  @param[out] cache the cache, or nullptr if the join order is not to be
+    cached.
+
+  @returns true if out of memory
+*/
+bool Optimize_table_order::get_join_order_cache(Join_order_cache **cache) {
+  *cache = nullptr;
+  Query_block *const query_block = join->query_block;
+  if (emb_sjm_nest != nullptr || !thd->variables.optimizer_join_order_cache ||
+      thd->stmt_arena->is_regular() || !query_block->sj_nests.empty() ||
+      join->tables - join->const_tables < 2)
+    return false;
+
+  if (query_block->join_order_cache == nullptr) {
+    query_block->join_order_cache =
+        Join_order_cache::create(thd->stmt_arena->mem_root, join->tables);
+    if (query_block->join_order_cache == nullptr) return true;
+  }
+  *cache = query_block->join_order_cache;
+  return false;
+}
+
+std::atomic<ulonglong> Join_order_cache::s_version{0};
+
+Join_order_cache *Join_order_cache::create(MEM_ROOT *mem_root, uint tables) {
+  Join_order_cache *const cache = new (mem_root) Join_order_cache(tables);
+  if (cache == nullptr) return nullptr;
+  cache->m_key_buckets = mem_root->ArrayAlloc<uint8>(tables);
+  if (cache->m_key_buckets == nullptr) return nullptr;
+  for (Entry &entry : cache->m_entries) {
+    entry.row_buckets = mem_root->ArrayAlloc<uint8>(tables);
+    entry.order = mem_root->ArrayAlloc<uint8>(tables);
+    if (entry.row_buckets == nullptr || entry.order == nullptr) return nullptr;
+  }
+  return cache;
+}
+
+/// @returns the power of four of a number of rows, counting from 1 for a
+/// single row.
+static uint8 row_bucket(ha_rows rows) {
+  uint8 bucket = 0;
+  for (; rows > 0; rows >>= 2) ++bucket;
+  return bucket;
+}
+
+void Join_order_cache::make_key(const THD *thd, const JOIN *join) {
+  const System_variables &variables = thd->variables;
+  const ulonglong version = s_version.load();
+  if (m_version != version ||
+      m_optimizer_switch != variables.optimizer_switch ||
+      m_search_depth != variables.optimizer_search_depth ||
+      m_prune_level != variables.optimizer_prune_level) {
+    for (Entry &entry : m_entries) entry.used = false;
+    m_next_entry = 0;
+    m_version = version;
+    m_optimizer_switch = variables.optimizer_switch;
+    m_search_depth = variables.optimizer_search_depth;
+    m_prune_level = variables.optimizer_prune_level;
+  }
+
+  memset(m_key_buckets, 0, m_tables);
+  for (uint idx = join->const_tables; idx < join->tables; ++idx) {
+    const JOIN_TAB *const tab = join->best_ref[idx];
+    m_key_buckets[tab->table_ref->tableno()] = row_bucket(tab->found_records);
+  }
+}
+
+const uint8 *Join_order_cache::find(const THD *thd, const JOIN *join) {
+  if (join->tables != m_tables) return nullptr;
+  make_key(thd, join);
+  for (const Entry &entry : m_entries) {
+    if (entry.used && entry.const_tables == join->const_table_map &&
+        memcmp(entry.row_buckets, m_key_buckets, m_tables) == 0)
+      return entry.order;
+  }
+  return nullptr;
+}
+
+void Join_order_cache::insert(const JOIN *join) {
+  if (join->tables != m_tables) return;
+
+  Entry &entry = m_entries[m_next_entry];
+  m_next_entry = (m_next_entry + 1) % kMaxEntries;
+
+  entry.used = true;
+  entry.const_tables = join->const_table_map;
+  memcpy(entry.row_buckets, m_key_buckets, m_tables);
+  for (uint idx = join->const_tables; idx < join->tables; ++idx) {
+    entry.order[idx - join->const_tables] =
+        join->best_positions[idx].table->table_ref->tableno();
+  }
+}
+
 /**
   Heuristic procedure to automatically guess a reasonable degree of
   exhaustiveness for the greedy search procedure.
@@ -30,6 +30,7 @@
 */
 
 #include <sys/types.h>
+#include <atomic>
 
 #include "my_inttypes.h"
 #include "my_table_map.h"
@@ -38,7 +39,9 @@
 class Cost_model_server;
 class JOIN;
 class JOIN_TAB;
+class Join_order_cache;
 class Key_use;
+struct MEM_ROOT;
 class Opt_trace_object;
 class THD;
 struct TABLE;
@@ -191,6 +194,7 @@ class Optimize_table_order {
 
   table_map calculate_lateral_deps_of_final_plan(uint tab_no) const;
   bool plan_has_duplicate_tabs() const;
+  bool get_join_order_cache(Join_order_cache **cache);
   static uint determine_search_depth(uint search_depth, uint table_count);
 };
 
@@ -302,4 +306,102 @@ class Join_tab_compare_default {
   bool operator()(const JOIN_TAB *jt1, const JOIN_TAB *jt2) const;
 };
 
+/**
+  The join orders chosen for a query block by earlier optimizations of the
+  same prepared statement or stored program statement, so that later
+  executions can skip the search for the best join order
+  (Optimize_table_order::greedy_search()).
+
+  An order is only reused if the query block looks the same to the optimizer
+  as when the order was chosen: the same tables must be constant, and the
+  estimated number of rows of each of the other tables must be within the
+  same power of four. These depend on the values of the parameters, through
+  the range optimizer and const table detection, so there is in effect one
+  entry for each class of parameter values with similar selectivity. A reused
+  order gets its access methods and costs calculated anew, like a
+  STRAIGHT_JOIN; only the search is skipped.
+
+  The cache is emptied if the optimizer settings change. Statements that are
+  reprepared after DDL (see Reprepare_observer) get new query blocks, and so
+  an empty cache. ANALYZE TABLE empties all caches (see invalidate_all()),
+  since the new statistics may favor other orders.
+*/
+class Join_order_cache {
+ public:
+  /**
+    @param mem_root where to allocate the cache. Must live as long as the
+      cache.
+    @param tables the number of tables in the query block.
+
+    @returns the new cache, or nullptr if out of memory.
+  */
+  static Join_order_cache *create(MEM_ROOT *mem_root, uint tables);
+
+  /**
+    Find the join order chosen for the query block when it had the same
+    properties as now.
+
+    @param thd the session, for the optimizer settings.
+    @param join the query block, with its tables sorted out and their rows
+      estimated, but no join order yet.
+
+    @returns the table numbers (see Table_ref::tableno()) of the non-const
+      tables in join order, or nullptr if there is no such order.
+  */
+  const uint8 *find(const THD *thd, const JOIN *join);
+
+  /**
+    Save the join order that has been chosen for the query block, for the
+    properties given to the last call to find(), which found nothing. The
+    oldest entry is replaced if the cache is full.
+
+    @param join the query block, with the chosen order in
+      JOIN::best_positions.
+  */
+  void insert(const JOIN *join);
+
+  /// Empty all caches, because the statistics the orders were based on have
+  /// changed.
+  static void invalidate_all() { s_version.fetch_add(1); }
+
+  /// The number of orders kept for each query block.
+  static constexpr uint kMaxEntries = 4;
+
+ private:
+  struct Entry {
+    bool used{false};
+    table_map const_tables{0};
+    /// For each table number, the power of four of the estimated number of
+    /// rows, or 0 for const tables.
+    uint8 *row_buckets{nullptr};
+    /// The table numbers of the non-const tables, in join order.
+    uint8 *order{nullptr};
+  };
+
+  explicit Join_order_cache(uint tables)
+      : m_tables(tables), m_version(s_version.load()) {}
+
+  /// Fill m_key_buckets from the row estimates of the tables of "join", and
+  /// empty the cache if the statistics or the optimizer settings have
+  /// changed.
+  void make_key(const THD *thd, const JOIN *join);
+
+  const uint m_tables;
+  Entry m_entries[kMaxEntries];
+  /// The entry to replace next.
+  uint m_next_entry{0};
+  /// The row buckets of the key made by make_key().
+  uint8 *m_key_buckets{nullptr};
+
+  /// Optimizer settings that the orders were chosen with.
+  ulonglong m_optimizer_switch{0};
+  ulong m_search_depth{0};
+  ulong m_prune_level{0};
+
+  /// The value of s_version when the cache was last emptied.
+  ulonglong m_version;
+
+  static std::atomic<ulonglong> s_version;
+};
+
 #endif /* SQL_PLANNER_INCLUDED */
@@ -102,6 +102,8 @@
 #include "sql/derror.h"                          // read_texts
 #include "sql/discrete_interval.h"
 #include "sql/events.h"          // Events
+#include "sql/filesort_utils.h"  // max_sort_threads
+#include "sql/histograms/histogram_maintenance.h"
 #include "sql/hostname_cache.h"  // host_cache_resize
 #include "sql/log.h"
 #include "sql/mdl.h"
@@ -2339,6 +2341,100 @@ static Sys_var_ulong Sys_join_buffer_size(
     HINT_UPDATEABLE SESSION_VAR(join_buff_size), CMD_LINE(REQUIRED_ARG),
     VALID_RANGE(128, ULONG_MAX), DEFAULT(256 * 1024), BLOCK_SIZE(128));
 
+static Sys_var_ulong Sys_iterator_batch_size(
+    "iterator_batch_size",
+    "The maximum number of rows that hash join build inputs and aggregation "
+    "inputs read from their child iterators at a time. Zero means that rows "
+    "are read one at a time",
+    HINT_UPDATEABLE SESSION_VAR(iterator_batch_size), CMD_LINE(REQUIRED_ARG),
+    VALID_RANGE(0, 65536), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_hash_join_threads(
+    "hash_join_threads",
+    "The maximum number of threads that join the chunk files of an inner hash "
+    "join that has spilled to disk. A value of 1 means that the chunk files "
+    "are joined by the session thread, one at a time",
+    HINT_UPDATEABLE SESSION_VAR(hash_join_threads), CMD_LINE(REQUIRED_ARG),
+    VALID_RANGE(1, 64), DEFAULT(1), BLOCK_SIZE(1));
+
+// Must be in the same order as hash_join_buffer::HashTableType.
+static const char *hash_join_table_type_names[] = {"SEGMENTED", "FLAT",
+                                                   nullptr};
+static Sys_var_enum Sys_hash_join_table_type(
+    "hash_join_table_type",
+    "The kind of hash table used by hash joins. SEGMENTED is a general-purpose "
+    "hash map. FLAT is an open-addressing hash table with inline hash values, "
+    "which probes the hash table a batch of rows at a time (with "
+    "iterator_batch_size > 0), and is faster for hash tables larger than the "
+    "CPU caches",
+    HINT_UPDATEABLE SESSION_VAR(hash_join_table_type), CMD_LINE(REQUIRED_ARG),
+    hash_join_table_type_names, DEFAULT(0));
+
+static Sys_var_bool Sys_hash_join_runtime_filters(
+    "hash_join_runtime_filters",
+    "Let inner hash joins and hash semijoins that have read their entire build "
+    "input throw away probe rows that cannot match already when the probe "
+    "table is scanned, based on the range and a Bloom filter of the integer "
+    "join key values in the build input",
+    HINT_UPDATEABLE SESSION_VAR(hash_join_runtime_filters), CMD_LINE(OPT_ARG),
+    DEFAULT(true));
+
+static Sys_var_ulong Sys_adaptive_join_factor(
+    "adaptive_join_factor",
+    "Let an index lookup on the inner table of a nested loop join read the "
+    "entire table into an in-memory hash table, and do the remaining lookups "
+    "there, once it has been done this many times more often than the "
+    "optimizer expected, and more often than a table scan costs. 0 disables "
+    "the switch. The hypergraph optimizer never makes it",
+    HINT_UPDATEABLE SESSION_VAR(adaptive_join_factor), CMD_LINE(REQUIRED_ARG),
+    VALID_RANGE(0, 1000000), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_bool Sys_parallel_aggregation(
+    "parallel_aggregation",
+    "Let the hypergraph optimizer compute GROUP BY and aggregate functions "
+    "over a full scan of a large InnoDB table with "
+    "innodb_parallel_read_threads threads, when the filter, the grouping and "
+    "the aggregate functions (COUNT, SUM, AVG, MIN and MAX) only involve "
+    "integer columns",
+    HINT_UPDATEABLE SESSION_VAR(parallel_aggregation), CMD_LINE(OPT_ARG),
+    DEFAULT(false));
+
+static Sys_var_bool Sys_sort_runtime_filters(
+    "sort_runtime_filters",
+    "Let a sort with a LIMIT throw away rows that cannot make it past the "
+    "LIMIT already when the table of the first sort column is scanned, once "
+    "it has seen enough rows to know the range of values that can still "
+    "make it",
+    HINT_UPDATEABLE SESSION_VAR(sort_runtime_filters), CMD_LINE(OPT_ARG),
+    DEFAULT(true));
+
+static Sys_var_ulonglong Sys_subquery_result_cache_size(
+    "subquery_result_cache_size",
+    "The largest amount of memory each correlated scalar subquery may use "
+    "to remember its results for the values of its outer references, so "
+    "that it is not run again for values it has already seen. "
+    "0 turns the cache off",
+    HINT_UPDATEABLE SESSION_VAR(subquery_result_cache_size),
+    CMD_LINE(REQUIRED_ARG),
+    VALID_RANGE(0, std::numeric_limits<ulonglong>::max()),
+    DEFAULT(1024 * 1024), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_sort_threads(
+    "sort_threads",
+    "The maximum number of threads that sort the rows of a filesort that are "
+    "held in memory. Only large sorts are split between threads. A value of "
+    "1 means that the rows are sorted by the session thread",
+    HINT_UPDATEABLE SESSION_VAR(sort_threads), CMD_LINE(REQUIRED_ARG),
+    VALID_RANGE(1, 64), DEFAULT(1), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_max_sort_threads(
+    "max_sort_threads",
+    "The maximum number of threads that sort the rows of filesorts at the "
+    "same time, over all sessions, in addition to the session threads. "
+    "Sorts that would go over the limit use fewer threads",
+    GLOBAL_VAR(max_sort_threads), CMD_LINE(REQUIRED_ARG),
+    VALID_RANGE(0, 1024), DEFAULT(64), BLOCK_SIZE(1));
+
 static Sys_var_keycache Sys_key_buffer_size(
     "key_buffer_size",
     "The size of the buffer used for "
@@ -3312,6 +3408,15 @@ static Sys_var_ulong Sys_optimizer_search_depth(
     HINT_UPDATEABLE SESSION_VAR(optimizer_search_depth), CMD_LINE(REQUIRED_ARG),
     VALID_RANGE(0, MAX_TABLES + 1), DEFAULT(MAX_TABLES + 1), BLOCK_SIZE(1));
 
+static Sys_var_bool Sys_optimizer_join_order_cache(
+    "optimizer_join_order_cache",
+    "Let prepared statements and statements in stored programs reuse the "
+    "join order chosen by an earlier execution, instead of searching for "
+    "it again, as long as the tables have about the same estimated number "
+    "of rows as then",
+    HINT_UPDATEABLE SESSION_VAR(optimizer_join_order_cache), CMD_LINE(OPT_ARG),
+    DEFAULT(false));
+
 static Sys_var_ulong Sys_optimizer_max_subgraph_pairs(
     "optimizer_max_subgraph_pairs",
     "Maximum depth of subgraph pairs a query can have before the "
@@ -3363,6 +3468,21 @@ static Sys_var_ulonglong Sys_histogram_generation_max_mem_size(
     NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(check_session_admin),
     ON_UPDATE(nullptr));
 
+static Sys_var_ulong Sys_histogram_auto_update_threshold(
+    "histogram_auto_update_threshold",
+    "Rebuild the histograms of a table in the background once this "
+    "percentage of its rows has been modified since the previous rebuild. "
+    "0 disables background histogram updates",
+    GLOBAL_VAR(histogram_auto_update_threshold), CMD_LINE(REQUIRED_ARG),
+    VALID_RANGE(0, 100), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_histogram_auto_update_interval(
+    "histogram_auto_update_interval",
+    "Number of seconds between two checks for tables whose histograms "
+    "should be rebuilt in the background",
+    GLOBAL_VAR(histogram_auto_update_interval), CMD_LINE(REQUIRED_ARG),
+    VALID_RANGE(1, 86400), DEFAULT(60), BLOCK_SIZE(1));
+
 /*
   Need at least 400Kb to get through bootstrap.
   Need at least 8Mb to get through mtr check testcase, which does
@@ -5372,6 +5492,15 @@ static Sys_var_bool Sys_temptable_use_mmap(
     ON_UPDATE(update_deprecated_with_removal_message), nullptr,
     sys_var::PARSE_NORMAL);
 
+static Sys_var_bool Sys_temptable_use_columnar_storage(
+    "temptable_use_columnar_storage",
+    "Store TempTable tables without indexes column by column, with "
+    "dictionary and run-length encoding of repeated values. This saves memory "
+    "for tables that are written once and read many times, like materialized "
+    "derived tables and common table expressions.",
+    GLOBAL_VAR(temptable_use_columnar_storage), CMD_LINE(OPT_ARG),
+    DEFAULT(false));
+
 static Sys_var_plugin Sys_default_tmp_storage_engine(
     "default_tmp_storage_engine",
     "The default storage engine for new explicit temporary tables",
@@ -238,6 +238,15 @@ struct System_variables {
   uint cte_max_recursion_depth;
   ulonglong histogram_generation_max_mem_size;
   ulong join_buff_size;
+  ulong iterator_batch_size;
+  ulong hash_join_threads;
+  ulong hash_join_table_type;  // hash_join_buffer::HashTableType
+  bool hash_join_runtime_filters;
+  ulong adaptive_join_factor;
+  bool parallel_aggregation;
+  bool sort_runtime_filters;
+  ulonglong subquery_result_cache_size;
+  ulong sort_threads;
   ulong lock_wait_timeout;
   ulong max_allowed_packet;
   ulong max_error_count;
@@ -254,6 +263,7 @@ struct System_variables {
   ulong net_write_timeout;
   ulong optimizer_prune_level;
   ulong optimizer_search_depth;
+  bool optimizer_join_order_cache;
   ulong optimizer_max_subgraph_pairs;
   ulonglong parser_max_mem_size;
   ulong range_optimizer_max_mem_size;
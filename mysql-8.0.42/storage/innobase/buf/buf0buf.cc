@@ -81,6 +81,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "srv0srv.h"
 #include "srv0start.h"
 #include "sync0sync.h"
+#include "ut0lock_free_hash.h"
 #include "ut0new.h"
 
 #include "scope_guard.h"
@@ -305,7 +306,12 @@ static const ulint BUF_READ_AHEAD_PORTION = 32;
 buf_pool_t *buf_pool_ptr;
 
 /** true when resizing buffer pool is in the critical path. */
-volatile bool buf_pool_resizing;
+std::atomic<bool> buf_pool_resizing;
+
+/** Threads that are buffer-fixing a guessed root page without the page hash
+latch. buf_pool_resize() waits for them to leave before it frees chunks.
+See Buf_fetch_normal::fix_root_guess(). */
+static ut_lock_free_cnt_t buf_root_guess_readers;
 
 /** Atomic variables to track resize status code and progress */
 std::atomic_uint32_t buf_pool_resize_status_code = {0};
@@ -1363,6 +1369,9 @@ static void buf_pool_create(buf_pool_t *buf_pool, ulint buf_pool_size,
 
     buf_pool->zip_hash = ut::new_<hash_table_t>(2 * buf_pool->curr_size);
 
+    buf_pool->LRU_policy = buf_LRU_policy;
+    buf_LRU_ghosts_create(buf_pool);
+
     buf_pool->last_printout_time = std::chrono::steady_clock::now();
   }
   /* 2. Initialize flushing fields
@@ -1475,6 +1484,7 @@ static void buf_pool_free_instance(buf_pool_t *buf_pool) {
   ha_clear(buf_pool->page_hash);
   ut::delete_(buf_pool->page_hash);
   ut::delete_(buf_pool->zip_hash);
+  buf_LRU_ghosts_free(buf_pool);
 }
 
 /** Frees the buffer pool global data structures. */
@@ -2045,7 +2055,8 @@ static bool buf_pool_withdraw_blocks(buf_pool_t *buf_pool) {
   return (false);
 }
 
-/** resize page_hash and zip_hash for a buffer pool instance.
+/** resize page_hash, zip_hash and the LRU ghost entries for a buffer pool
+instance.
 @param[in]      buf_pool        buffer pool instance */
 static void buf_pool_resize_hash(buf_pool_t *buf_pool) {
   hash_table_t *new_hash_table;
@@ -2121,6 +2132,12 @@ static void buf_pool_resize_hash(buf_pool_t *buf_pool) {
 
   ut::delete_(buf_pool->zip_hash);
   buf_pool->zip_hash = new_hash_table;
+
+  /* The ghost entries are only hints, start over with a number of slots
+  that matches the new size of the instance. */
+  ut_ad(mutex_own(&buf_pool->LRU_list_mutex));
+  buf_LRU_ghosts_free(buf_pool);
+  buf_LRU_ghosts_create(buf_pool);
 }
 
 #ifdef UNIV_DEBUG
@@ -2368,6 +2385,11 @@ withdraw_retry:
   /* Indicate critical path */
   buf_pool_resizing = true;
 
+  /* Threads that buffer-fix guessed blocks without the page hash latch, and
+  did so before they could see the flag above, may still be reading the
+  chunks. */
+  buf_root_guess_readers.await_release_of_old_references();
+
   /* Acquire all buffer pool mutexes and hash table locks */
   /* TODO: while we certainly lock a lot here, it does not necessarily
   buy us enough correctness. Exploits the fact that freed pages must
@@ -3685,9 +3707,83 @@ struct Buf_fetch_normal : public Buf_fetch<Buf_fetch_normal> {
   @param[out] block             Block to fetch.
   @return DB_SUCCESS or error code. */
   dberr_t get(buf_block_t *&block) noexcept;
+
+ private:
+  /** Buffer-fix the caller's guess without acquiring the page hash latch,
+  if it still holds the page and the page is the root page of an index
+  (see btr_search_t::root_guess). This only succeeds if the block is
+  already buffer-fixed by another thread, which is the common case for the
+  root pages of hot indexes. Other pages are always looked up in the page
+  hash: walking its chains without the latch is not supported.
+  @return buffer-fixed block, or nullptr if the page must be looked up with
+  the page hash latch. */
+  buf_block_t *fix_root_guess() noexcept;
 };
 
+/** Buffer-fix a block unless its buffer-fix count is zero. A block that is
+buffer-fixed can't be evicted, relocated or freed, whereas the buffer-fix
+count of an unfixed block may be reset by buf_page_init_low() concurrently.
+@param[in,out]  bpage   block to buffer-fix
+@return true if the block was buffer-fixed. */
+static bool buf_block_fix_if_fixed(buf_page_t *bpage) noexcept {
+  auto count = bpage->buf_fix_count.load();
+
+  while (count > 0) {
+    if (bpage->buf_fix_count.compare_exchange_weak(count, count + 1)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+buf_block_t *Buf_fetch_normal::fix_root_guess() noexcept {
+  /* Chunks are only freed by buf_pool_resize() after it has set
+  buf_pool_resizing and waited for all references to go away. */
+  const auto reference = buf_root_guess_readers.reference();
+
+  if (buf_pool_resizing.load()) {
+    return nullptr;
+  }
+
+  /* The page hash chains are not walked: their links and the page ids of
+  unfixed blocks change under the page hash latch only. The guess is a
+  block descriptor as long as it points into one of the chunks of this
+  instance, and only its atomic buffer-fix count is accessed before the
+  block is fixed. */
+  auto block = m_guess;
+
+  if (block == nullptr || !buf_is_block_in_instance(m_buf_pool, block) ||
+      !buf_block_fix_if_fixed(&block->page)) {
+    return nullptr;
+  }
+
+  /* The block can't change its identity while it is buffer-fixed, so if it
+  now contains the page it must be the one in the page hash. */
+  if (block->page.id != m_page_id ||
+      buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE ||
+      block->page.was_stale() || !page_is_root(block->frame)) {
+    buf_block_unfix(block);
+    return nullptr;
+  }
+
+  ut_ad(block->page.in_page_hash);
+  ut_ad(!block->page.in_zip_hash);
+
+  m_hash_lock = buf_page_hash_lock_get(m_buf_pool, m_page_id);
+
+  return block;
+}
+
 dberr_t Buf_fetch_normal::get(buf_block_t *&block) noexcept {
+  if (srv_buf_pool_root_guess_fast_path) {
+    block = fix_root_guess();
+
+    if (block != nullptr) {
+      return DB_SUCCESS;
+    }
+  }
+
   /* Keep this path as simple as possible. */
   for (;;) {
     /* Lookup the page in the page hash. If it doesn't exist in the
@@ -4417,6 +4513,23 @@ buf_block_t *Buf_fetch<T>::single_page() {
   return (block);
 }
 
+/** Account an access to an index page in buf_stat_per_index, if
+innodb_buffer_pool_index_stats is enabled.
+@param[in]      block           page that was accessed, or nullptr */
+static inline void buf_stat_per_index_page_get(const buf_block_t *block) {
+  if (!srv_buf_pool_index_stats || block == nullptr) {
+    return;
+  }
+
+  const page_t *frame = block->frame;
+  const auto page_type = fil_page_get_type(frame);
+
+  if (page_type == FIL_PAGE_INDEX || page_type == FIL_PAGE_RTREE) {
+    buf_stat_per_index->inc_gets(
+        index_id_t(block->page.id.space(), btr_page_get_index_id(frame)));
+  }
+}
+
 buf_block_t *buf_page_get_gen(const page_id_t &page_id,
                               const page_size_t &page_size, ulint rw_latch,
                               buf_block_t *guess, Page_fetch mode,
@@ -4466,7 +4579,11 @@ buf_block_t *buf_page_get_gen(const page_id_t &page_id,
     fetch.m_mtr = mtr;
     fetch.m_dirty_with_no_latch = dirty_with_no_latch;
 
-    return (fetch.single_page());
+    auto block = fetch.single_page();
+
+    buf_stat_per_index_page_get(block);
+
+    return (block);
 
   } else {
     Buf_fetch_other fetch(page_id, page_size);
@@ -4479,7 +4596,11 @@ buf_block_t *buf_page_get_gen(const page_id_t &page_id,
     fetch.m_mtr = mtr;
     fetch.m_dirty_with_no_latch = dirty_with_no_latch;
 
-    return (fetch.single_page());
+    auto block = fetch.single_page();
+
+    buf_stat_per_index_page_get(block);
+
+    return (block);
   }
 }
 
@@ -4580,6 +4701,8 @@ bool buf_page_optimistic_get(ulint rw_latch, buf_block_t *block,
     Counter::inc(buf_pool->stat.m_n_page_gets, block->page.id.page_no());
   }
 
+  buf_stat_per_index_page_get(block);
+
   return (true);
 }
 
@@ -5247,6 +5370,10 @@ static void buf_page_monitor(
     if (is_leaf && io_type == BUF_IO_READ) {
       buf_stat_per_index->inc(index_id_t(space_id, idx_id));
     }
+
+    if (io_type == BUF_IO_READ && srv_buf_pool_index_stats) {
+      buf_stat_per_index->inc_reads(index_id_t(space_id, idx_id));
+    }
   }
 
   if (!MONITOR_IS_ON(MONITOR_MODULE_BUF_PAGE)) {
@@ -721,10 +721,13 @@ class Double_write {
   @param[in]  in_bpage          Page to write.
   @param[in]  sync              true if it's a synchronous write.
   @param[in]  e_block           block containing encrypted data frame.
+  @param[in]  batched           true if the caller calls
+                                os_aio_simulated_wake_handler_threads()
+                                once all writes of the batch are posted.
   @return DB_SUCCESS or error code */
   [[nodiscard]] static dberr_t write_to_datafile(
-      const buf_page_t *in_bpage, bool sync,
-      const file::Block *e_block) noexcept;
+      const buf_page_t *in_bpage, bool sync, const file::Block *e_block,
+      bool batched = false) noexcept;
 
   /** Force a flush of the page queue.
   @param[in] flush_type           FLUSH LIST or LRU LIST flush.
@@ -1601,7 +1604,8 @@ void Double_write::check_block(const buf_block_t *block) noexcept {
 }
 
 dberr_t Double_write::write_to_datafile(const buf_page_t *in_bpage, bool sync,
-                                        const file::Block *e_block) noexcept {
+                                        const file::Block *e_block,
+                                        bool batched) noexcept {
   ut_ad(buf_page_in_file(in_bpage));
   ut_ad(in_bpage->current_thread_has_io_responsibility());
   ut_ad(in_bpage->is_io_fix_write());
@@ -1621,7 +1625,7 @@ dberr_t Double_write::write_to_datafile(const buf_page_t *in_bpage, bool sync,
 
   uint32_t type = IORequest::WRITE;
 
-  if (sync) {
+  if (sync || batched) {
     type |= IORequest::DO_NOT_WAKE;
   }
 
@@ -2201,8 +2205,8 @@ void Double_write::write_data_pages(buf_flush_t flush_type,
     bpage->set_dblwr_batch_id(batch_id);
 
     ut_d(bpage->take_io_responsibility());
-    auto err =
-        write_to_datafile(bpage, false, std::get<1>(m_buf_pages.m_pages[i]));
+    auto err = write_to_datafile(bpage, false,
+                                 std::get<1>(m_buf_pages.m_pages[i]), true);
 
     if (err == DB_PAGE_IS_STALE || err == DB_TABLESPACE_DELETED) {
       /* For async operation, if space is deleted, fil_io already
@@ -35,10 +35,15 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include <stdarg.h>
 #include <stdio.h>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 
 #include "buf0buf.h"
 #include "buf0dump.h"
+#include "buf0rea.h"
 #include "dict0dict.h"
+#include "fsp0fsp.h"
+#include "mach0data.h"
 
 #include "my_io.h"
 #include "my_psi_config.h"
@@ -67,9 +72,8 @@ static bool buf_load_should_start = false;
 
 static bool buf_load_abort_flag = false;
 
-/* Used to temporary store dump info in order to avoid IO while holding
-buffer pool LRU list mutex during dump and also to sort the contents of the
-dump before reading the pages from disk during load.
+/* Used to sort the contents of the dump before reading the pages from disk
+during load.
 We store the space id in the high 32 bits and page no in low 32 bits. */
 typedef uint64_t buf_dump_t;
 
@@ -83,6 +87,32 @@ constexpr space_id_t BUF_DUMP_SPACE(uint64_t a) {
 constexpr page_no_t BUF_DUMP_PAGE(uint64_t a) {
   return static_cast<page_no_t>((a)&0xFFFFFFFFUL);
 }
+
+/* The dump file is written in a binary format, all numbers are stored
+big-endian:
+  BUF_DUMP_MAGIC, BUF_DUMP_VERSION, number of buffer pool instances,
+followed by one section for each buffer pool instance, in order:
+  instance number, number of pages N (0 for an empty instance),
+  N (space id, page number) pairs in LRU order, most recently used first.
+The index of a page within its section is its LRU position. Files that do
+not start with BUF_DUMP_MAGIC are in the text format of earlier versions,
+one "space,page" pair per line, and are still accepted by buf_load(). */
+
+/** Magic number at the start of a binary dump file ("IBPD") */
+constexpr uint32_t BUF_DUMP_MAGIC = 0x49425044;
+
+/** Version of the binary dump file format */
+constexpr uint32_t BUF_DUMP_VERSION = 1;
+
+/** Size of the file header: magic, version and number of instances */
+constexpr size_t BUF_DUMP_HEADER_SIZE = 12;
+
+/** Size of a section header: instance number and number of pages */
+constexpr size_t BUF_DUMP_SECTION_HEADER_SIZE = 8;
+
+/** Size of one page entry: space id and page number */
+constexpr size_t BUF_DUMP_ENTRY_SIZE = 8;
+
 /** Wakes up the buffer pool dump/load thread and instructs it to start
  a dump. This function is called by MySQL code via buffer_pool_dump_now()
  and it should return immediately because the whole MySQL is frozen during
@@ -246,7 +276,7 @@ static void buf_dump(bool obey_shutdown) {
 
   buf_dump_status(STATUS_INFO, "Dumping buffer pool(s) to %s", full_filename);
 
-  f = fopen(tmp_filename, "w");
+  f = fopen(tmp_filename, "wb");
   if (f == nullptr) {
     buf_dump_status(STATUS_ERR, "Cannot open '%s' for writing: %s",
                     tmp_filename, strerror(errno));
@@ -254,10 +284,24 @@ static void buf_dump(bool obey_shutdown) {
   }
   /* else */
 
+  byte header[BUF_DUMP_HEADER_SIZE];
+
+  mach_write_to_4(header, BUF_DUMP_MAGIC);
+  mach_write_to_4(header + 4, BUF_DUMP_VERSION);
+  mach_write_to_4(header + 8, srv_buf_pool_instances);
+
+  if (fwrite(header, sizeof(header), 1, f) != 1) {
+    fclose(f);
+    buf_dump_status(STATUS_ERR, "Cannot write to '%s': %s", tmp_filename,
+                    strerror(errno));
+    /* leave tmp_filename to exist */
+    return;
+  }
+
   /* walk through each buffer pool */
   for (i = 0; i < srv_buf_pool_instances && !SHOULD_QUIT(); i++) {
     buf_pool_t *buf_pool;
-    buf_dump_t *dump;
+    byte *dump;
 
     buf_pool = buf_pool_from_array(i);
 
@@ -267,13 +311,9 @@ static void buf_dump(bool obey_shutdown) {
 
     size_t n_pages = UT_LIST_GET_LEN(buf_pool->LRU);
 
-    /* skip empty buffer pools */
-    if (n_pages == 0) {
-      mutex_exit(&buf_pool->LRU_list_mutex);
-      continue;
-    }
-
-    if (srv_buf_pool_dump_pct != 100) {
+    /* An empty buffer pool still gets its section, so that the loader can
+    tell a complete file from a truncated one. */
+    if (n_pages != 0 && srv_buf_pool_dump_pct != 100) {
       ut_ad(srv_buf_pool_dump_pct < 100);
 
       n_pages = n_pages * srv_buf_pool_dump_pct / 100;
@@ -283,24 +323,37 @@ static void buf_dump(bool obey_shutdown) {
       }
     }
 
-    dump = static_cast<buf_dump_t *>(
-        ut::malloc_withkey(UT_NEW_THIS_FILE_PSI_KEY, n_pages * sizeof(*dump)));
+    const size_t dump_size =
+        BUF_DUMP_SECTION_HEADER_SIZE + n_pages * BUF_DUMP_ENTRY_SIZE;
+
+    dump = static_cast<byte *>(
+        ut::malloc_withkey(UT_NEW_THIS_FILE_PSI_KEY, dump_size));
 
     if (dump == nullptr) {
       mutex_exit(&buf_pool->LRU_list_mutex);
       fclose(f);
-      buf_dump_status(STATUS_ERR, "Cannot allocate %zu bytes: %s",
-                      n_pages * sizeof(*dump), strerror(errno));
+      buf_dump_status(STATUS_ERR, "Cannot allocate %zu bytes: %s", dump_size,
+                      strerror(errno));
       /* leave tmp_filename to exist */
       return;
     }
+
+    mach_write_to_4(dump, i);
+    mach_write_to_4(dump + 4, n_pages);
+
     {
       size_t j{0};
+      byte *ptr = dump + BUF_DUMP_SECTION_HEADER_SIZE;
+
       for (auto bpage : buf_pool->LRU) {
         if (n_pages <= j) break;
         ut_a(buf_page_in_file(bpage));
 
-        dump[j++] = BUF_DUMP_CREATE(bpage->id.space(), bpage->id.page_no());
+        mach_write_to_4(ptr, bpage->id.space());
+        mach_write_to_4(ptr + 4, bpage->id.page_no());
+
+        ptr += BUF_DUMP_ENTRY_SIZE;
+        ++j;
       }
 
       ut_a(j == n_pages);
@@ -308,29 +361,32 @@ static void buf_dump(bool obey_shutdown) {
 
     mutex_exit(&buf_pool->LRU_list_mutex);
 
-    for (size_t j = 0; j < n_pages && !SHOULD_QUIT(); j++) {
-      ret = fprintf(f, SPACE_ID_PF "," PAGE_NO_PF "\n", BUF_DUMP_SPACE(dump[j]),
-                    BUF_DUMP_PAGE(dump[j]));
-      if (ret < 0) {
-        ut::free(dump);
-        fclose(f);
-        buf_dump_status(STATUS_ERR, "Cannot write to '%s': %s", tmp_filename,
-                        strerror(errno));
-        /* leave tmp_filename to exist */
-        return;
-      }
+    buf_dump_status(STATUS_VERBOSE,
+                    "Dumping buffer pool " ULINTPF "/" ULINTPF ", %zu pages",
+                    i + 1, static_cast<ulint>(srv_buf_pool_instances), n_pages);
 
-      if (j % 128 == 0) {
-        buf_dump_status(
-            STATUS_VERBOSE,
-            "Dumping buffer pool " ULINTPF "/" ULINTPF ", page %zu/%zu", i + 1,
-            static_cast<ulint>(srv_buf_pool_instances), j + 1, n_pages);
-      }
+    /* Write the whole section at once, so that a dump interrupted by
+    shutdown never ends with a truncated section. */
+    if (fwrite(dump, dump_size, 1, f) != 1) {
+      ut::free(dump);
+      fclose(f);
+      buf_dump_status(STATUS_ERR, "Cannot write to '%s': %s", tmp_filename,
+                      strerror(errno));
+      /* leave tmp_filename to exist */
+      return;
     }
 
     ut::free(dump);
   }
 
+  if (i < srv_buf_pool_instances) {
+    fclose(f);
+    buf_dump_status(STATUS_INFO,
+                    "Dumping of buffer pool(s) aborted on request");
+    /* leave tmp_filename to exist */
+    return;
+  }
+
   ret = fclose(f);
   if (ret != 0) {
     buf_dump_status(STATUS_ERR, "Cannot close '%s': %s", tmp_filename,
@@ -427,22 +483,344 @@ static inline void buf_load_throttle_if_needed(
   *last_activity_count = srv_get_activity_count();
 }
 
+/** A page listed in the dump file. */
+struct Buf_load_page {
+  /** Space id and page number, see BUF_DUMP_CREATE() */
+  buf_dump_t m_id;
+
+  /** Position of the page in the LRU list when it was dumped, 0 is the
+  most recently used page */
+  uint32_t m_lru_pos;
+};
+
+using Buf_load_pages = ut::vector<Buf_load_page>;
+
+/** Read a dump file written in the text format of earlier versions. The
+pages are listed in LRU order, so the line number is used as LRU position.
+@param[in]      f               dump file
+@param[in]      full_filename   name of the dump file, for messages
+@param[out]     pages           pages listed in the file
+@return true on success */
+static bool buf_load_read_text(FILE *f, const char *full_filename,
+                               Buf_load_pages &pages) {
+  ulint space_id;
+  ulint page_no;
+
+  while (fscanf(f, ULINTPF "," ULINTPF, &space_id, &page_no) == 2 &&
+         !SHUTTING_DOWN()) {
+    if (space_id > UINT32_MASK || page_no > UINT32_MASK) {
+      buf_load_status(STATUS_ERR,
+                      "Error parsing '%s': bogus"
+                      " space,page " ULINTPF "," ULINTPF " at line %zu,"
+                      " unable to load buffer pool",
+                      full_filename, space_id, page_no, pages.size());
+      return false;
+    }
+
+    const auto lru_pos = static_cast<uint32_t>(
+        std::min(pages.size(), static_cast<size_t>(UINT32_MASK)));
+
+    pages.push_back({BUF_DUMP_CREATE(space_id, page_no), lru_pos});
+  }
+
+  if (!SHUTTING_DOWN() && !feof(f)) {
+    /* fscanf() returned != 2 */
+    buf_load_status(STATUS_ERR, "Error %s '%s', unable to load buffer pool",
+                    ferror(f) ? "reading" : "parsing", full_filename);
+    return false;
+  }
+
+  return true;
+}
+
+/** Read a binary dump file, the magic number has already been read. The
+file must hold exactly one section for each buffer pool instance listed in
+its header. When the number of buffer pool instances has not changed since
+the dump, only the hottest pages that fit in the current size of each
+instance are kept.
+@param[in]      f               dump file
+@param[in]      full_filename   name of the dump file, for messages
+@param[out]     pages           pages listed in the file
+@return true on success */
+static bool buf_load_read_binary(FILE *f, const char *full_filename,
+                                 Buf_load_pages &pages) {
+  byte header[BUF_DUMP_HEADER_SIZE - 4];
+
+  if (fread(header, sizeof(header), 1, f) != 1) {
+    buf_load_status(STATUS_ERR,
+                    "Error reading '%s', unable to load buffer pool",
+                    full_filename);
+    return false;
+  }
+
+  const uint32_t version = mach_read_from_4(header);
+  const uint32_t n_instances = mach_read_from_4(header + 4);
+
+  if (version != BUF_DUMP_VERSION) {
+    buf_load_status(STATUS_ERR,
+                    "Unsupported format version %u of '%s',"
+                    " unable to load buffer pool",
+                    version, full_filename);
+    return false;
+  }
+
+  if (n_instances == 0 || n_instances > MAX_BUFFER_POOLS) {
+    buf_load_status(STATUS_ERR,
+                    "Error parsing '%s': bogus number of buffer pool"
+                    " instances %u, unable to load buffer pool",
+                    full_filename, n_instances);
+    return false;
+  }
+
+  /* Pages that fit in one instance, if the dumped instances are still
+  the instances of the buffer pool. */
+  size_t instance_capacity = std::numeric_limits<size_t>::max();
+
+  if (n_instances == srv_buf_pool_instances) {
+    instance_capacity = buf_pool_get_n_pages() / srv_buf_pool_instances;
+  }
+
+  byte entries[128 * BUF_DUMP_ENTRY_SIZE];
+
+  for (uint32_t i = 0; i < n_instances && !SHUTTING_DOWN(); ++i) {
+    byte section[BUF_DUMP_SECTION_HEADER_SIZE];
+
+    /* A file that ends before the last section, even in the middle of a
+    section header, was truncated. */
+    if (fread(section, sizeof(section), 1, f) != 1) {
+      buf_load_status(STATUS_ERR,
+                      "Error %s '%s': %u of %u buffer pool sections found,"
+                      " unable to load buffer pool",
+                      ferror(f) ? "reading" : "parsing", full_filename, i,
+                      n_instances);
+      return false;
+    }
+
+    const uint32_t instance = mach_read_from_4(section);
+    const uint32_t n_pages = mach_read_from_4(section + 4);
+
+    if (instance != i) {
+      buf_load_status(STATUS_ERR,
+                      "Error parsing '%s': bogus buffer pool instance %u,"
+                      " unable to load buffer pool",
+                      full_filename, instance);
+      return false;
+    }
+
+    for (uint32_t pos = 0; pos < n_pages;) {
+      const uint32_t n = std::min(n_pages - pos, uint32_t{128});
+
+      if (fread(entries, BUF_DUMP_ENTRY_SIZE, n, f) != n) {
+        buf_load_status(STATUS_ERR,
+                        "Error reading '%s', unable to load buffer pool",
+                        full_filename);
+        return false;
+      }
+
+      for (uint32_t j = 0; j < n; ++j, ++pos) {
+        if (pos >= instance_capacity) {
+          continue;
+        }
+
+        const byte *ptr = entries + j * BUF_DUMP_ENTRY_SIZE;
+
+        pages.push_back({BUF_DUMP_CREATE(mach_read_from_4(ptr),
+                                         mach_read_from_4(ptr + 4)),
+                         pos});
+      }
+    }
+  }
+
+  if (!SHUTTING_DOWN() && fgetc(f) != EOF) {
+    buf_load_status(STATUS_ERR,
+                    "Error parsing '%s': data after the last buffer pool"
+                    " section, unable to load buffer pool",
+                    full_filename);
+    return false;
+  }
+
+  return true;
+}
+
+/** Number of pages after which a run of adjacent pages is split, so that
+the reads issued for one run do not grow without bound. This is one extent
+with the default page size. */
+static constexpr size_t BUF_LOAD_MAX_RUN = BUF_READ_PAGES_MAX;
+
+/** Maximum number of pages of one tablespace handed to a load thread at a
+time. Large tablespaces are split so that they can be loaded in parallel. */
+static constexpr size_t BUF_LOAD_CHUNK_PAGES = 1024;
+
+/** Maximum number of pending reads in a buffer pool instance before the
+load threads wait for reads to complete. */
+static constexpr ulint BUF_LOAD_MAX_PEND_READS = 256;
+
+/** Pages of one tablespace that are read in by one load thread. */
+struct Buf_load_chunk {
+  /** First page of the chunk in Buf_load::m_pages */
+  size_t m_begin;
+
+  /** End of the chunk in Buf_load::m_pages */
+  size_t m_end;
+
+  /** Lowest LRU position of the pages in the chunk */
+  uint32_t m_lru_pos;
+};
+
+/** State of a buffer pool load, shared by the load threads. */
+struct Buf_load {
+  /** Pages to read, sorted by (space, page) */
+  Buf_load_pages m_pages;
+
+  /** Chunks of m_pages, hottest first */
+  ut::vector<Buf_load_chunk> m_chunks;
+
+  /** Next chunk to be read in */
+  std::atomic<size_t> m_next_chunk{0};
+
+  /** Number of pages processed */
+  std::atomic<size_t> m_n_loaded{0};
+
+  /** Number of load threads that have finished */
+  std::atomic<size_t> m_n_done{0};
+
+  /** Number of pages requested, used for throttling */
+  std::atomic<ulint> m_n_io{0};
+
+  /** Protects m_last_check_time and m_last_activity_count */
+  std::mutex m_throttle_mutex;
+
+  /** See buf_load_throttle_if_needed() */
+  std::chrono::steady_clock::time_point m_last_check_time;
+
+  /** See buf_load_throttle_if_needed() */
+  ulint m_last_activity_count{0};
+
+  /** @return true if the load threads should stop */
+  bool should_stop() const { return buf_load_abort_flag || SHUTTING_DOWN(); }
+};
+
+/** Wait until the number of pending reads in the buffer pool instance of a
+page is low enough to issue another read.
+@param[in]      page_id         page to be read */
+static void buf_load_wait_for_pending_reads(const page_id_t &page_id) {
+  const buf_pool_t *buf_pool = buf_pool_get(page_id);
+
+  while (buf_pool->n_pend_reads >= BUF_LOAD_MAX_PEND_READS &&
+         !SHUTTING_DOWN()) {
+    /* Our own reads may still be queued without having been submitted. */
+    os_aio_simulated_wake_handler_threads();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+/** Read in the pages of a chunk. A run of adjacent pages is read with one
+I/O request if the tablespace allows it, see buf_read_pages_background().
+Other pages are issued as asynchronous reads, which are handed to the I/O
+handler threads in batches of adjacent pages.
+@param[in,out]  load            state of the load
+@param[in]      chunk           pages to read in */
+static void buf_load_chunk(Buf_load *load, const Buf_load_chunk &chunk) {
+  const space_id_t space_id = BUF_DUMP_SPACE(load->m_pages[chunk.m_begin].m_id);
+
+  fil_space_t *space = fil_space_acquire_silent(space_id);
+
+  if (space == nullptr) {
+    load->m_n_loaded.fetch_add(chunk.m_end - chunk.m_begin);
+    return;
+  }
+
+  const page_size_t page_size(space->flags);
+
+  /* Pages that are decrypted or decompressed when they are read in would
+  be read twice, and the system and temporary tablespaces may consist of
+  several files. Read those one page at a time. The dump may also list
+  pages beyond the end of the tablespace, if it has been truncated since;
+  only the pages that exist are read together. */
+  const bool read_runs = !fsp_is_system_or_temp_tablespace(space_id) &&
+                         !space->is_compressed() && !space->is_encrypted();
+
+  const page_no_t space_size = read_runs ? fil_space_get_size(space_id) : 0;
+
+  size_t n_queued = 0;
+
+  for (size_t i = chunk.m_begin; i < chunk.m_end && !load->should_stop();) {
+    const page_id_t page_id(space_id, BUF_DUMP_PAGE(load->m_pages[i].m_id));
+
+    size_t run = 1;
+
+    while (read_runs && i + run < chunk.m_end && run < BUF_LOAD_MAX_RUN &&
+           page_id.page_no() + run < space_size &&
+           BUF_DUMP_PAGE(load->m_pages[i + run].m_id) ==
+               page_id.page_no() + run) {
+      ++run;
+    }
+
+    buf_load_wait_for_pending_reads(page_id);
+
+    if (run > 1) {
+      buf_read_pages_background(page_id, page_size, run);
+    } else {
+      buf_read_page_background(page_id, page_size, false);
+
+      if (++n_queued == BUF_LOAD_MAX_RUN || i + 1 == chunk.m_end ||
+          BUF_DUMP_PAGE(load->m_pages[i + 1].m_id) != page_id.page_no() + 1) {
+        os_aio_simulated_wake_handler_threads();
+        n_queued = 0;
+      }
+    }
+
+    i += run;
+
+    load->m_n_loaded.fetch_add(run);
+
+    const auto n_io = load->m_n_io.fetch_add(run);
+
+    if ((n_io + run) / srv_io_capacity != n_io / srv_io_capacity) {
+      /* Sleeping with the mutex held also holds back the other load
+      threads when they reach their next check. Pass the number of the
+      I/O operation that completed the last srv_io_capacity of them. */
+      std::lock_guard<std::mutex> guard(load->m_throttle_mutex);
+
+      buf_load_throttle_if_needed(
+          &load->m_last_check_time, &load->m_last_activity_count,
+          (n_io + run) / srv_io_capacity * srv_io_capacity - 1);
+    }
+  }
+
+  os_aio_simulated_wake_handler_threads();
+
+  fil_space_release(space);
+}
+
+/** Body of a buffer pool load thread. Chunks are taken in order, so the
+hottest pages are read in first.
+@param[in,out]  load            state of the load */
+static void buf_load_thread(Buf_load *load) {
+  while (!load->should_stop()) {
+    const auto i = load->m_next_chunk.fetch_add(1);
+
+    if (i >= load->m_chunks.size()) {
+      break;
+    }
+
+    buf_load_chunk(load, load->m_chunks[i]);
+  }
+
+  load->m_n_done.fetch_add(1);
+}
+
 /** Perform a buffer pool load from the file specified by
  innodb_buffer_pool_filename. If any errors occur then the value of
  innodb_buffer_pool_load_status will be set accordingly, see buf_load_status().
  The dump filename can be specified by (relative to srv_data_home):
- SET GLOBAL innodb_buffer_pool_filename='filename'; */
+ SET GLOBAL innodb_buffer_pool_filename='filename';
+ The pages are read in by innodb_buffer_pool_load_threads threads. */
 static void buf_load() {
   char full_filename[OS_FILE_MAX_PATH];
   char now[32];
   FILE *f;
-  buf_dump_t *dump;
-  ulint dump_n;
-  ulint total_buffer_pools_pages;
-  ulint i;
-  ulint space_id;
-  ulint page_no;
-  int fscanf_ret;
 
   /* Ignore any leftovers from before */
   buf_load_abort_flag = false;
@@ -451,7 +829,7 @@ static void buf_load() {
 
   buf_load_status(STATUS_INFO, "Loading buffer pool(s) from %s", full_filename);
 
-  f = fopen(full_filename, "r");
+  f = fopen(full_filename, "rb");
   if (f == nullptr) {
     buf_load_status(STATUS_ERR, "Cannot open '%s' for reading: %s",
                     full_filename, strerror(errno));
@@ -459,103 +837,42 @@ static void buf_load() {
   }
   /* else */
 
-  /* First scan the file to estimate how many entries are in it.
-  This file is tiny (approx 500KB per 1GB buffer pool), reading it
-  two times is fine. */
-  dump_n = 0;
-  while (fscanf(f, ULINTPF "," ULINTPF, &space_id, &page_no) == 2 &&
-         !SHUTTING_DOWN()) {
-    dump_n++;
-  }
-
-  if (!SHUTTING_DOWN() && !feof(f)) {
-    /* fscanf() returned != 2 */
-    const char *what;
-    if (ferror(f)) {
-      what = "reading";
-    } else {
-      what = "parsing";
-    }
-    fclose(f);
-    buf_load_status(STATUS_ERR,
-                    "Error %s '%s',"
-                    " unable to load buffer pool (stage 1)",
-                    what, full_filename);
-    return;
-  }
-
-  /* If dump is larger than the buffer pool(s), then we ignore the
-  extra trailing. This could happen if a dump is made, then buffer
-  pool is shrunk and then load is attempted. */
-  total_buffer_pools_pages = buf_pool_get_n_pages() * srv_buf_pool_instances;
-  if (dump_n > total_buffer_pools_pages) {
-    dump_n = total_buffer_pools_pages;
-  }
+  Buf_load load;
+  bool success;
+  byte magic[4];
 
-  if (dump_n != 0) {
-    dump = static_cast<buf_dump_t *>(
-        ut::malloc_withkey(UT_NEW_THIS_FILE_PSI_KEY, dump_n * sizeof(*dump)));
+  if (fread(magic, sizeof(magic), 1, f) == 1 &&
+      mach_read_from_4(magic) == BUF_DUMP_MAGIC) {
+    success = buf_load_read_binary(f, full_filename, load.m_pages);
   } else {
-    fclose(f);
-    ut_sprintf_timestamp(now);
-    buf_load_status(STATUS_INFO,
-                    "Buffer pool(s) load completed at %s"
-                    " (%s was empty)",
-                    now, full_filename);
-    return;
+    rewind(f);
+    success = buf_load_read_text(f, full_filename, load.m_pages);
   }
 
-  if (dump == nullptr) {
-    fclose(f);
-    buf_load_status(STATUS_ERR, "Cannot allocate " ULINTPF " bytes: %s",
-                    (ulint)(dump_n * sizeof(*dump)), strerror(errno));
+  fclose(f);
+
+  if (!success) {
     return;
   }
 
-  rewind(f);
-
-  for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
-    fscanf_ret = fscanf(f, ULINTPF "," ULINTPF, &space_id, &page_no);
+  auto &pages = load.m_pages;
 
-    if (fscanf_ret != 2) {
-      if (feof(f)) {
-        break;
-      }
-      /* else */
-
-      ut::free(dump);
-      fclose(f);
-      buf_load_status(STATUS_ERR,
-                      "Error parsing '%s', unable"
-                      " to load buffer pool (stage 2)",
-                      full_filename);
-      return;
-    }
+  /* If dump is larger than the buffer pool(s), then we keep only the
+  pages that were the most recently used. This could happen if a dump is
+  made, then buffer pool is shrunk and then load is attempted. */
+  const size_t total_buffer_pools_pages = buf_pool_get_n_pages();
 
-    if (space_id > UINT32_MASK || page_no > UINT32_MASK) {
-      ut::free(dump);
-      fclose(f);
-      buf_load_status(STATUS_ERR,
-                      "Error parsing '%s': bogus"
-                      " space,page " ULINTPF "," ULINTPF " at line " ULINTPF
-                      ","
-                      " unable to load buffer pool",
-                      full_filename, space_id, page_no, i);
-      return;
-    }
+  if (pages.size() > total_buffer_pools_pages) {
+    std::nth_element(pages.begin(), pages.begin() + total_buffer_pools_pages,
+                     pages.end(),
+                     [](const Buf_load_page &lhs, const Buf_load_page &rhs) {
+                       return lhs.m_lru_pos < rhs.m_lru_pos;
+                     });
 
-    dump[i] = BUF_DUMP_CREATE(space_id, page_no);
+    pages.resize(total_buffer_pools_pages);
   }
 
-  /* Set dump_n to the actual number of initialized elements,
-  i could be smaller than dump_n here if the file got truncated after
-  we read it the first time. */
-  dump_n = i;
-
-  fclose(f);
-
-  if (dump_n == 0) {
-    ut::free(dump);
+  if (pages.empty() || SHUTTING_DOWN()) {
     ut_sprintf_timestamp(now);
     buf_load_status(STATUS_INFO,
                     "Buffer pool(s) load completed at %s"
@@ -564,19 +881,34 @@ static void buf_load() {
     return;
   }
 
-  if (!SHUTTING_DOWN()) {
-    std::sort(dump, dump + dump_n);
+  /* Sort by (space, page) so that adjacent pages are read in together. */
+  std::sort(pages.begin(), pages.end(),
+            [](const Buf_load_page &lhs, const Buf_load_page &rhs) {
+              return lhs.m_id < rhs.m_id;
+            });
+
+  for (size_t i = 0; i < pages.size(); ++i) {
+    auto &chunks = load.m_chunks;
+
+    if (chunks.empty() ||
+        BUF_DUMP_SPACE(pages[i].m_id) !=
+            BUF_DUMP_SPACE(pages[chunks.back().m_begin].m_id) ||
+        chunks.back().m_end - chunks.back().m_begin == BUF_LOAD_CHUNK_PAGES) {
+      chunks.push_back({i, i, pages[i].m_lru_pos});
+    }
+
+    auto &chunk = chunks.back();
+
+    chunk.m_end = i + 1;
+    chunk.m_lru_pos = std::min(chunk.m_lru_pos, pages[i].m_lru_pos);
   }
 
-  std::chrono::steady_clock::time_point last_check_time;
-  ulint last_activity_cnt = 0;
+  std::stable_sort(load.m_chunks.begin(), load.m_chunks.end(),
+                   [](const Buf_load_chunk &lhs, const Buf_load_chunk &rhs) {
+                     return lhs.m_lru_pos < rhs.m_lru_pos;
+                   });
 
-  /* Avoid calling the expensive fil_space_acquire_silent() for each
-  page within the same tablespace. dump[] is sorted by (space, page),
-  so all pages from a given tablespace are consecutive. */
-  space_id_t cur_space_id = BUF_DUMP_SPACE(dump[0]);
-  fil_space_t *space = fil_space_acquire_silent(cur_space_id);
-  page_size_t page_size(space ? space->flags : 0);
+  const size_t dump_n = pages.size();
 
 #ifdef HAVE_PSI_STAGE_INTERFACE
   PSI_stage_progress *pfs_stage_progress =
@@ -586,72 +918,49 @@ static void buf_load() {
   mysql_stage_set_work_estimated(pfs_stage_progress, dump_n);
   mysql_stage_set_work_completed(pfs_stage_progress, 0);
 
-  for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
-    /* space_id for this iteration of the loop */
-    const space_id_t this_space_id = BUF_DUMP_SPACE(dump[i]);
+  const size_t n_threads =
+      std::min(size_t{srv_buf_pool_load_threads}, load.m_chunks.size());
 
-    if (this_space_id != cur_space_id) {
-      if (space != nullptr) {
-        fil_space_release(space);
-      }
+  std::vector<IB_thread> threads;
 
-      cur_space_id = this_space_id;
-      space = fil_space_acquire_silent(cur_space_id);
+  threads.reserve(n_threads);
 
-      if (space != nullptr) {
-        const page_size_t cur_page_size(space->flags);
-        page_size.copy_from(cur_page_size);
-      }
-    }
+  for (size_t i = 0; i < n_threads; ++i) {
+    auto thread =
+        os_thread_create(buf_load_thread_key, i, buf_load_thread, &load);
 
-    if (space == nullptr) {
-      continue;
-    }
-
-    buf_read_page_background(page_id_t(this_space_id, BUF_DUMP_PAGE(dump[i])),
-                             page_size, true);
-
-    if (i % 64 == 63) {
-      os_aio_simulated_wake_handler_threads();
-    }
+    thread.start();
 
-    /* Update the progress every 32 MiB, which is every Nth page,
-    where N = 32*1024^2 / page_size. */
-    static const ulint update_status_every_n_mb = 32;
-    static const ulint update_status_every_n_pages =
-        update_status_every_n_mb * 1024 * 1024 / page_size.physical();
+    threads.push_back(std::move(thread));
+  }
 
-    if (i % update_status_every_n_pages == 0) {
-      buf_load_status(STATUS_VERBOSE, "Loaded " ULINTPF "/" ULINTPF " pages",
-                      i + 1, dump_n);
-      mysql_stage_set_work_completed(pfs_stage_progress, i);
-    }
+  while (load.m_n_done.load() < n_threads) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
-    if (buf_load_abort_flag) {
-      if (space != nullptr) {
-        fil_space_release(space);
-      }
-      buf_load_abort_flag = false;
-      ut::free(dump);
-      buf_load_status(STATUS_INFO, "Buffer pool(s) load aborted on request");
-      /* Premature end, set estimated = completed = i and
-      end the current stage event. */
-      mysql_stage_set_work_estimated(pfs_stage_progress, i);
-      mysql_stage_set_work_completed(pfs_stage_progress, i);
-#ifdef HAVE_PSI_STAGE_INTERFACE
-      mysql_end_stage();
-#endif /* HAVE_PSI_STAGE_INTERFACE */
-      return;
-    }
+    const size_t n_loaded = load.m_n_loaded.load();
 
-    buf_load_throttle_if_needed(&last_check_time, &last_activity_cnt, i);
+    buf_load_status(STATUS_VERBOSE, "Loaded %zu/%zu pages", n_loaded, dump_n);
+    mysql_stage_set_work_completed(pfs_stage_progress, n_loaded);
   }
 
-  if (space != nullptr) {
-    fil_space_release(space);
+  for (auto &thread : threads) {
+    thread.join();
   }
 
-  ut::free(dump);
+  const size_t n_loaded = load.m_n_loaded.load();
+
+  if (buf_load_abort_flag) {
+    buf_load_abort_flag = false;
+    buf_load_status(STATUS_INFO, "Buffer pool(s) load aborted on request");
+    /* Premature end, set estimated = completed = n_loaded and
+    end the current stage event. */
+    mysql_stage_set_work_estimated(pfs_stage_progress, n_loaded);
+    mysql_stage_set_work_completed(pfs_stage_progress, n_loaded);
+#ifdef HAVE_PSI_STAGE_INTERFACE
+    mysql_end_stage();
+#endif /* HAVE_PSI_STAGE_INTERFACE */
+    return;
+  }
 
   ut_sprintf_timestamp(now);
 
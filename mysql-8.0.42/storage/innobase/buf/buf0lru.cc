@@ -136,6 +136,59 @@ std::chrono::milliseconds get_buf_LRU_old_threshold() {
 
 /** @} */
 
+/** Page replacement policy of the buffer pool, see buf_LRU_policy_t. Copied
+to buf_pool->LRU_policy of every instance. */
+ulong buf_LRU_policy = BUF_LRU_POLICY_MIDPOINT;
+
+void buf_LRU_ghosts_create(buf_pool_t *buf_pool) {
+  /* Remember about as many evicted pages as half of the instance can
+  hold, as suggested for the 2Q policy. */
+  buf_pool->LRU_ghosts_size = ut_2_power_up(
+      std::max(buf_pool->curr_size / 2, ulint{BUF_LRU_OLD_MIN_LEN}));
+
+  buf_pool->LRU_ghosts = static_cast<uint64_t *>(
+      ut::zalloc_withkey(UT_NEW_THIS_FILE_PSI_KEY,
+                         buf_pool->LRU_ghosts_size * sizeof(uint64_t)));
+}
+
+void buf_LRU_ghosts_free(buf_pool_t *buf_pool) {
+  ut::free(buf_pool->LRU_ghosts);
+  buf_pool->LRU_ghosts = nullptr;
+  buf_pool->LRU_ghosts_size = 0;
+}
+
+/** Remembers that a page was evicted from the buffer pool instance.
+@param[in,out]  buf_pool        buffer pool instance
+@param[in]      page_id         id of the evicted page */
+static void buf_LRU_ghost_add(buf_pool_t *buf_pool, const page_id_t &page_id) {
+  ut_ad(mutex_own(&buf_pool->LRU_list_mutex));
+
+  if (buf_pool->LRU_policy != BUF_LRU_POLICY_2Q ||
+      buf_pool->LRU_ghosts == nullptr) {
+    return;
+  }
+
+  buf_LRU_ghost_set(buf_pool->LRU_ghosts, buf_pool->LRU_ghosts_size,
+                    buf_pool->freed_page_clock, page_id);
+}
+
+/** Looks up and removes the ghost entry of a page that is being read in.
+@param[in,out]  buf_pool        buffer pool instance
+@param[in]      page_id         id of the page
+@return true if the page was evicted recently */
+static bool buf_LRU_ghost_remove(buf_pool_t *buf_pool,
+                                 const page_id_t &page_id) {
+  ut_ad(mutex_own(&buf_pool->LRU_list_mutex));
+
+  if (buf_pool->LRU_policy != BUF_LRU_POLICY_2Q ||
+      buf_pool->LRU_ghosts == nullptr) {
+    return false;
+  }
+
+  return buf_LRU_ghost_take(buf_pool->LRU_ghosts, buf_pool->LRU_ghosts_size,
+                            buf_pool->freed_page_clock, page_id);
+}
+
 /** Takes a block out of the LRU list and page hash table.
 If the block is compressed-only (BUF_BLOCK_ZIP_PAGE),
 the object will be freed.
@@ -1725,6 +1778,13 @@ void buf_LRU_add_block(buf_page_t *bpage, /*!< in: control block */
                                   added to the start, regardless of this
                                   parameter */
 {
+  /* A page that is read in again shortly after it was evicted belongs to
+  the working set: do not make it compete with scanned pages for a place
+  in the "old" sublist once more. */
+  if (old && buf_LRU_ghost_remove(buf_pool_from_bpage(bpage), bpage->id)) {
+    old = false;
+  }
+
   buf_LRU_add_block_low(bpage, old);
 }
 
@@ -1838,6 +1898,11 @@ bool buf_LRU_free_page(buf_page_t *bpage, bool zip) {
   ut_ad(rw_lock_own(hash_lock, RW_LOCK_X));
   ut_ad(buf_page_can_relocate(bpage));
 
+  if (b == nullptr) {
+    /* The page leaves the buffer pool entirely. */
+    buf_LRU_ghost_add(buf_pool, bpage->id);
+  }
+
   if (!buf_LRU_block_remove_hashed(bpage, zip, false)) {
     mutex_exit(&buf_pool->LRU_list_mutex);
 
@@ -2406,6 +2471,24 @@ uint buf_LRU_old_ratio_update(
   return (new_ratio);
 }
 
+void buf_LRU_policy_update(ulong policy) {
+  for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+    buf_pool_t *buf_pool = buf_pool_from_array(i);
+
+    mutex_enter(&buf_pool->LRU_list_mutex);
+
+    if (buf_pool->LRU_policy != policy && buf_pool->LRU_ghosts != nullptr) {
+      /* Forget the evictions done under the previous policy. */
+      memset(buf_pool->LRU_ghosts, 0,
+             buf_pool->LRU_ghosts_size * sizeof(uint64_t));
+    }
+
+    buf_pool->LRU_policy = policy;
+
+    mutex_exit(&buf_pool->LRU_list_mutex);
+  }
+}
+
 /** Update the historical stats that we are collecting for LRU eviction
  policy at the end of each interval. */
 void buf_LRU_stat_update(void) {
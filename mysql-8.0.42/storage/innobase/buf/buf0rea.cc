@@ -326,6 +326,116 @@ bool buf_read_page_background(const page_id_t &page_id,
   return (count > 0);
 }
 
+ulint buf_read_pages_background(const page_id_t &page_id,
+                                const page_size_t &page_size,
+                                page_no_t n_pages) {
+  ut_ad(n_pages > 0);
+  ut_ad(n_pages <= BUF_READ_PAGES_MAX);
+  ut_ad(!fsp_is_system_or_temp_tablespace(page_id.space()));
+
+  const ulint physical_size = page_size.physical();
+  const ulint len = n_pages * physical_size;
+
+  auto buf = static_cast<byte *>(ut::aligned_alloc_withkey(
+      UT_NEW_THIS_FILE_PSI_KEY, len, UNIV_PAGE_SIZE));
+
+  if (buf == nullptr) {
+    ulint count = 0;
+
+    for (page_no_t i = 0; i < n_pages; ++i) {
+      const page_id_t cur_page_id(page_id.space(), page_id.page_no() + i);
+
+      count += buf_read_page_background(cur_page_id, page_size, true);
+    }
+
+    return count;
+  }
+
+  buf_page_t *bpages[BUF_READ_PAGES_MAX];
+  ulint n_init = 0;
+
+  for (page_no_t i = 0; i < n_pages; ++i) {
+    const page_id_t cur_page_id(page_id.space(), page_id.page_no() + i);
+
+    bpages[i] = buf_page_init_for_read(BUF_READ_ANY_PAGE, cur_page_id,
+                                       page_size, false);
+
+    if (bpages[i] != nullptr) {
+      ++n_init;
+    }
+  }
+
+  dberr_t err = DB_SUCCESS;
+
+  if (n_init > 0) {
+    DBUG_PRINT("ib_buf", ("read pages %u:%u..%u size=%u sync",
+                          (unsigned)page_id.space(),
+                          (unsigned)page_id.page_no(),
+                          (unsigned)(page_id.page_no() + n_pages - 1),
+                          (unsigned)physical_size));
+
+    /* Read the raw pages, and decrypt or decompress them one at a time
+    below, since that is done for the first page of a request only. */
+    IORequest request(IORequest::READ | IORequest::NO_COMPRESSION |
+                      IORequest::IGNORE_MISSING);
+
+    thd_wait_begin(nullptr, THD_WAIT_DISKIO);
+
+    err = fil_io(request, true, page_id, page_size, 0, len, buf, nullptr);
+
+    thd_wait_end(nullptr);
+  }
+
+  ulint count = 0;
+
+  for (page_no_t i = 0; i < n_pages; ++i) {
+    buf_page_t *bpage = bpages[i];
+
+    if (bpage == nullptr) {
+      continue;
+    }
+
+    if (err != DB_SUCCESS) {
+      buf_read_page_handle_error(bpage);
+      continue;
+    }
+
+    const byte *src = buf + i * physical_size;
+    void *dst;
+
+    if (page_size.is_compressed()) {
+      dst = bpage->zip.data;
+    } else {
+      ut_a(buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE);
+
+      dst = reinterpret_cast<buf_block_t *>(bpage)->frame;
+    }
+
+    if (Encryption::is_encrypted_page(src) ||
+        fil_page_get_type(src) == FIL_PAGE_COMPRESSED) {
+      IORequest request(IORequest::READ | IORequest::IGNORE_MISSING);
+
+      if (fil_io(request, true, bpage->id, page_size, 0, physical_size, dst,
+                 bpage) != DB_SUCCESS) {
+        buf_read_page_handle_error(bpage);
+        continue;
+      }
+    } else {
+      memcpy(dst, src, physical_size);
+    }
+
+    if (buf_page_io_complete(bpage, false)) {
+      ++count;
+    }
+  }
+
+  ut::aligned_free(buf);
+
+  srv_stats.buf_pool_reads.add(count);
+
+  return count;
+}
+
 ulint buf_read_ahead_linear(const page_id_t &page_id,
                             const page_size_t &page_size, bool inside_ibuf) {
   buf_pool_t *buf_pool = buf_pool_get(page_id);
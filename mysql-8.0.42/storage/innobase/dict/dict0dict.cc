@@ -82,6 +82,7 @@ extern uint ibuf_debug;
 #include "btr0cur.h"
 #include "btr0sea.h"
 #include "buf0buf.h"
+#include "buf0stats.h"
 #include "data0type.h"
 #include "dict0boot.h"
 #include "dict0crea.h"
@@ -2677,6 +2678,11 @@ static void dict_index_remove_from_cache_low(
     mutex_exit(&page_zip_stat_per_index_mutex);
   }
 
+  /* Likewise for its page access and page read counters. */
+  if (!lru_evict && !index->table->discard_after_ddl) {
+    buf_stat_per_index->drop(index_id_t(index->space, index->id));
+  }
+
   /* Remove the index from the list of indexes of the table */
   UT_LIST_REMOVE(table->indexes, index);
 
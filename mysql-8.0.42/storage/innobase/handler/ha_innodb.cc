@@ -179,6 +179,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "os0thread-create.h"
 #include "os0thread.h"
 #include "sql/item.h"
+#include "sql/iterators/runtime_filter.h"
 #include "sql_base.h"
 #include "srv0tmp.h"
 #include "trx0rec.h"
@@ -472,6 +473,18 @@ static TYPELIB innodb_stats_method_typelib = {
     array_elements(innodb_stats_method_names) - 1,
     "innodb_stats_method_typelib", innodb_stats_method_names, nullptr};
 
+/** Possible values of innodb_buffer_pool_replacement_policy, in the order of
+buf_LRU_policy_t */
+static const char *innodb_buffer_pool_replacement_policy_names[] = {
+    "midpoint", "2q", NullS};
+
+/** Used to define an enumerate type of the system variable
+innodb_buffer_pool_replacement_policy. */
+static TYPELIB innodb_buffer_pool_replacement_policy_typelib = {
+    array_elements(innodb_buffer_pool_replacement_policy_names) - 1,
+    "innodb_buffer_pool_replacement_policy_typelib",
+    innodb_buffer_pool_replacement_policy_names, nullptr};
+
 #endif /* UNIV_HOTBACKUP */
 
 /** Possible values of the parameter innodb_checksum_algorithm */
@@ -828,6 +841,7 @@ static PSI_thread_info all_innodb_threads[] = {
                    PSI_DOCUMENT_ME),
     PSI_THREAD_KEY(buf_dump_thread, "ib_buf_dump", PSI_FLAG_SINGLETON, 0,
                    PSI_DOCUMENT_ME),
+    PSI_THREAD_KEY(buf_load_thread, "ib_buf_load", 0, 0, PSI_DOCUMENT_ME),
     PSI_THREAD_KEY(clone_ddl_thread, "ib_clone_ddl", PSI_FLAG_SINGLETON, 0,
                    PSI_DOCUMENT_ME),
     PSI_THREAD_KEY(clone_gtid_thread, "ib_clone_gtid", PSI_FLAG_SINGLETON, 0,
@@ -855,6 +869,7 @@ static PSI_thread_info all_innodb_threads[] = {
                    PSI_FLAG_SINGLETON, 0, PSI_DOCUMENT_ME),
     PSI_THREAD_KEY(recv_writer_thread, "ib_recv_write", PSI_FLAG_SINGLETON, 0,
                    PSI_DOCUMENT_ME),
+    PSI_THREAD_KEY(recv_apply_thread, "ib_recv_apply", 0, 0, PSI_DOCUMENT_ME),
     PSI_THREAD_KEY(srv_error_monitor_thread, "ib_srv_err_mon",
                    PSI_FLAG_SINGLETON, 0, PSI_DOCUMENT_ME),
     PSI_THREAD_KEY(srv_lock_timeout_thread, "ib_srv_lock_to",
@@ -4994,9 +5009,21 @@ static int innodb_init_params() {
     dblwr::g_mode = dblwr::Mode::OFF;
   }
 
-#ifdef LINUX_NATIVE_AIO
+#ifndef LINUX_IO_URING
+  /* io_uring is only supported when the support is compiled in. */
+  srv_use_io_uring = false;
+#endif /* !LINUX_IO_URING */
+
+#if defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+#ifndef LINUX_NATIVE_AIO
+  /* Without libaio, io_uring is the only native AIO interface. */
+  if (!srv_use_io_uring) {
+    srv_use_native_aio = false;
+  }
+#endif /* !LINUX_NATIVE_AIO */
   if (srv_use_native_aio) {
-    ib::info(ER_IB_MSG_541) << "Using Linux native AIO";
+    ib::info(ER_IB_MSG_541) << (srv_use_io_uring ? "Using Linux io_uring"
+                                                 : "Using Linux native AIO");
   }
 #elif !defined _WIN32
   /* Currently native AIO is supported only on Windows and Linux
@@ -17294,6 +17321,7 @@ int ha_innobase::info_low(uint flag, bool is_analyze) {
 
     stats.records = (ha_rows)n_rows;
     stats.deleted = 0;
+    stats.rows_modified = ib_table->stat_n_rows_modified;
 
     calculate_index_size_stats(ib_table, n_rows, stat_clustered_index_size,
                                stat_sum_of_other_index_sizes, &stats);
@@ -18436,6 +18464,12 @@ int ha_innobase::end_stmt() {
     row_mysql_prebuilt_free_blob_heap(m_prebuilt);
   }
 
+  /* A fetch cache that has grown during a long scan is not kept
+  for every open table handle. */
+  if (m_prebuilt->fetch_cache_capacity > MYSQL_FETCH_CACHE_SIZE) {
+    row_mysql_prebuilt_free_fetch_cache(m_prebuilt);
+  }
+
   m_prebuilt->end_stmt();
 
   reset_template();
@@ -20709,6 +20743,17 @@ static void innodb_old_blocks_pct_update(
       buf_LRU_old_ratio_update(*static_cast<const uint *>(save), true));
 }
 
+/** Update the system variable innodb_buffer_pool_replacement_policy using the
+"saved" value. This function is registered as a callback with MySQL.
+@param[in]      save            immediate result from check function */
+static void innodb_buffer_pool_replacement_policy_update(THD *, SYS_VAR *,
+                                                         void *,
+                                                         const void *save) {
+  buf_LRU_policy = *static_cast<const ulong *>(save);
+
+  buf_LRU_policy_update(buf_LRU_policy);
+}
+
 /** Update the system variable innodb_old_blocks_pct using the "saved"
  value. This function is registered as a callback with MySQL. */
 static void innodb_change_buffer_max_size_update(
@@ -22396,6 +22441,11 @@ static MYSQL_SYSVAR_ULONG(
     "Dump only the hottest N% of each buffer pool, defaults to 25", nullptr,
     nullptr, 25, 1, 100, 0);
 
+static MYSQL_SYSVAR_ULONG(
+    buffer_pool_load_threads, srv_buf_pool_load_threads, PLUGIN_VAR_RQCMDARG,
+    "Number of threads that read pages in during a buffer pool load",
+    nullptr, nullptr, 4, 1, 64, 0);
+
 static MYSQL_SYSVAR_ULONG(
     idle_flush_pct, srv_idle_flush_pct, PLUGIN_VAR_RQCMDARG,
     "Up to what percentage of dirty pages to be flushed when server is found"
@@ -22542,6 +22592,13 @@ static MYSQL_SYSVAR_ULONG(write_io_threads, srv_n_write_io_threads,
                           "Number of background write I/O threads in InnoDB.",
                           nullptr, nullptr, 4, 1, 64, 0);
 
+static MYSQL_SYSVAR_ULONG(
+    recovery_apply_threads, srv_n_recovery_apply_threads,
+    PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+    "Number of threads that apply redo log records to pages during crash"
+    " recovery.",
+    nullptr, nullptr, 1, 1, 64, 0);
+
 static MYSQL_SYSVAR_ULONG(force_recovery, srv_force_recovery,
                           PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
                           "Helps to save your data in case the disk image of "
@@ -22765,6 +22822,28 @@ static MYSQL_SYSVAR_UINT(
     " The timeout is disabled if 0.",
     nullptr, nullptr, 1000, 0, UINT32_MAX, 0);
 
+static MYSQL_SYSVAR_ENUM(
+    buffer_pool_replacement_policy, buf_LRU_policy, PLUGIN_VAR_RQCMDARG,
+    "Page replacement policy of the buffer pool. midpoint inserts pages read"
+    " in at the head of the 'old' blocks. 2q also remembers recently evicted"
+    " pages and inserts them at the 'new' end when they are read in again.",
+    nullptr, innodb_buffer_pool_replacement_policy_update,
+    BUF_LRU_POLICY_MIDPOINT, &innodb_buffer_pool_replacement_policy_typelib);
+
+static MYSQL_SYSVAR_BOOL(
+    buffer_pool_index_stats, srv_buf_pool_index_stats, PLUGIN_VAR_OPCMDARG,
+    "Count page accesses and page reads for each index, as shown in"
+    " INFORMATION_SCHEMA.INNODB_CACHED_INDEXES.",
+    nullptr, nullptr, false);
+
+static MYSQL_SYSVAR_BOOL(
+    buffer_pool_root_guess_fast_path, srv_buf_pool_root_guess_fast_path,
+    PLUGIN_VAR_OPCMDARG,
+    "Let index searches find the root page of the index without acquiring"
+    " the buffer pool page hash latch, when the block that held the root"
+    " page the last time is still in use by other threads.",
+    nullptr, nullptr, false);
+
 static MYSQL_SYSVAR_LONG(
     open_files, innobase_open_files, PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
     "How many files at the maximum InnoDB keeps open at the same time.",
@@ -22904,6 +22983,12 @@ static MYSQL_SYSVAR_BOOL(use_native_aio, srv_use_native_aio,
                          "Use native AIO if supported on this platform.",
                          nullptr, nullptr, true);
 
+static MYSQL_SYSVAR_BOOL(use_io_uring, srv_use_io_uring,
+                         PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+                         "Use io_uring instead of libaio for native AIO if"
+                         " supported on this platform.",
+                         nullptr, nullptr, false);
+
 #ifdef HAVE_LIBNUMA
 static MYSQL_SYSVAR_BOOL(
     numa_interleave, srv_numa_interleave,
@@ -23194,6 +23279,7 @@ static SYS_VAR *innobase_system_variables[] = {
     MYSQL_SYSVAR(buffer_pool_dump_at_shutdown),
     MYSQL_SYSVAR(buffer_pool_in_core_file),
     MYSQL_SYSVAR(buffer_pool_dump_pct),
+    MYSQL_SYSVAR(buffer_pool_load_threads),
 #ifdef UNIV_DEBUG
     MYSQL_SYSVAR(buffer_pool_evict),
 #endif /* UNIV_DEBUG */
@@ -23225,6 +23311,7 @@ static SYS_VAR *innobase_system_variables[] = {
     MYSQL_SYSVAR(fast_shutdown),
     MYSQL_SYSVAR(read_io_threads),
     MYSQL_SYSVAR(write_io_threads),
+    MYSQL_SYSVAR(recovery_apply_threads),
     MYSQL_SYSVAR(file_per_table),
     MYSQL_SYSVAR(flush_log_at_timeout),
     MYSQL_SYSVAR(flush_log_at_trx_commit),
@@ -23290,6 +23377,9 @@ static SYS_VAR *innobase_system_variables[] = {
     MYSQL_SYSVAR(max_purge_lag_delay),
     MYSQL_SYSVAR(old_blocks_pct),
     MYSQL_SYSVAR(old_blocks_time),
+    MYSQL_SYSVAR(buffer_pool_replacement_policy),
+    MYSQL_SYSVAR(buffer_pool_index_stats),
+    MYSQL_SYSVAR(buffer_pool_root_guess_fast_path),
     MYSQL_SYSVAR(open_files),
     MYSQL_SYSVAR(optimize_fulltext_only),
     MYSQL_SYSVAR(rollback_on_timeout),
@@ -23324,6 +23414,7 @@ static SYS_VAR *innobase_system_variables[] = {
     MYSQL_SYSVAR(autoinc_lock_mode),
     MYSQL_SYSVAR(version),
     MYSQL_SYSVAR(use_native_aio),
+    MYSQL_SYSVAR(use_io_uring),
 #ifdef HAVE_LIBNUMA
     MYSQL_SYSVAR(numa_interleave),
 #endif /* HAVE_LIBNUMA */
@@ -23504,6 +23595,15 @@ innobase_index_cond(ha_innobase *h) /*!< in/out: pointer to ha_innobase */
   return h->pushed_idx_cond->val_int() ? ICP_MATCH : ICP_NO_MATCH;
 }
 
+/** Check a row against the runtime filter pushed to the handler.
+@param[in,out]  h       pointer to ha_innobase
+@param[in]      record  the row, in MySQL format
+@return false if the row cannot be of interest to the server */
+bool innobase_runtime_filter(ha_innobase *h, const byte *record) {
+  assert(h->ha_get_runtime_filter() != nullptr);
+  return h->ha_get_runtime_filter()->MayMatch(record);
+}
+
 /** Get the computed value by supplying the base column values.
 @param[in,out]  table   the table whose virtual column template to be built */
 void innobase_init_vc_templ(dict_table_t *table) {
@@ -23841,6 +23941,18 @@ bool ha_innobase::is_record_buffer_wanted(ha_rows *const max_rows) const {
   return true;
 }
 
+bool ha_innobase::runtime_filter_push(RuntimeFilter *filter) {
+  /* The filter is checked in row_search_mvcc() right after a row is
+  converted to MySQL format, for consistent reads only; a locking read
+  would have to release the lock on each row that is thrown away. With
+  index condition pushdown, the row is converted elsewhere, so let the
+  server check the filter instead. */
+  m_prebuilt->runtime_filter = filter != nullptr &&
+                               m_prebuilt->select_lock_type == LOCK_NONE &&
+                               pushed_idx_cond == nullptr;
+  return m_prebuilt->runtime_filter;
+}
+
 /** Return max limits for a single set of multi-valued keys
 @param[out]     num_keys        number of keys to store
 @param[out]     keys_length     total length of keys, bytes
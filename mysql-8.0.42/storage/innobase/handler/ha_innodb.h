@@ -465,6 +465,9 @@ class ha_innobase : public handler {
   @param[in]      scan_ctx      A scan context created by parallel_scan_init. */
   void parallel_scan_end(void *scan_ctx) override;
 
+  /** @return the value of innodb_parallel_read_threads for the session. */
+  size_t max_parallel_scan_threads() const override;
+
   bool check_if_incompatible_data(HA_CREATE_INFO *info,
                                   uint table_changes) override;
 
@@ -531,6 +534,13 @@ class ha_innobase : public handler {
   @retval false  if the handler does not want a buffer */
   bool is_record_buffer_wanted(ha_rows *const max_rows) const override;
 
+  /** Decide whether row_search_mvcc() is to check the rows it finds
+  against a runtime filter.
+  @param[in]    filter  the new filter, or nullptr if it was removed
+  @retval true  if InnoDB checks the filter
+  @retval false if the server has to check the filter */
+  bool runtime_filter_push(RuntimeFilter *filter) override;
+
   /** TRUNCATE an InnoDB table.
   @param[in]            name            table name
   @param[in]            form            table definition
@@ -1548,6 +1548,10 @@ void ha_innobase::parallel_scan_end(void *parallel_scan_ctx) {
   ut::delete_(parallel_reader);
 }
 
+size_t ha_innobase::max_parallel_scan_threads() const {
+  return thd_parallel_read_threads(ha_thd());
+}
+
 bool ha_innobase::inplace_alter_table(TABLE *altered_table,
                                       Alter_inplace_info *ha_alter_info,
                                       const dd::Table *old_dd_tab
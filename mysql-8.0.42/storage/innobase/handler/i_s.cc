@@ -109,7 +109,7 @@ constexpr auto I_S_PAGE_TYPE_BITS = 6;
 
 /** I_S.innodb_* views version postfix. Every time the define of any InnoDB I_S
 table is changed, this value has to be increased accordingly */
-constexpr uint8_t i_s_innodb_plugin_version_postfix = 2;
+constexpr uint8_t i_s_innodb_plugin_version_postfix = 3;
 
 /** I_S.innodb_* views version. It would be X.Y and X should be the server major
 version while Y is the InnoDB I_S views version, starting from 1 */
@@ -7078,6 +7078,20 @@ static ST_FIELD_INFO innodb_cached_indexes_fields_info[] = {
      STRUCT_FLD(field_flags, MY_I_S_UNSIGNED), STRUCT_FLD(old_name, ""),
      STRUCT_FLD(open_method, 0)},
 
+#define CACHED_INDEXES_N_PAGE_GETS 3
+    {STRUCT_FLD(field_name, "N_PAGE_GETS"),
+     STRUCT_FLD(field_length, MY_INT64_NUM_DECIMAL_DIGITS),
+     STRUCT_FLD(field_type, MYSQL_TYPE_LONGLONG), STRUCT_FLD(value, 0),
+     STRUCT_FLD(field_flags, MY_I_S_UNSIGNED), STRUCT_FLD(old_name, ""),
+     STRUCT_FLD(open_method, 0)},
+
+#define CACHED_INDEXES_N_PAGE_READS 4
+    {STRUCT_FLD(field_name, "N_PAGE_READS"),
+     STRUCT_FLD(field_length, MY_INT64_NUM_DECIMAL_DIGITS),
+     STRUCT_FLD(field_type, MYSQL_TYPE_LONGLONG), STRUCT_FLD(value, 0),
+     STRUCT_FLD(field_flags, MY_I_S_UNSIGNED), STRUCT_FLD(old_name, ""),
+     STRUCT_FLD(open_method, 0)},
+
     END_OF_ST_FIELD_INFO};
 
 /** Populate INFORMATION_SCHEMA.INNODB_CACHED_INDEXES.
@@ -7093,8 +7107,9 @@ static int i_s_fill_innodb_cached_indexes_row(THD *thd, space_id_t space_id,
 
   const index_id_t idx_id(space_id, index_id);
   const uint64_t n = buf_stat_per_index->get(idx_id);
+  const uint64_t n_gets = buf_stat_per_index->get_gets(idx_id);
 
-  if (n == 0) {
+  if (n == 0 && n_gets == 0) {
     return 0;
   }
 
@@ -7106,6 +7121,11 @@ static int i_s_fill_innodb_cached_indexes_row(THD *thd, space_id_t space_id,
 
   OK(fields[CACHED_INDEXES_N_CACHED_PAGES]->store(n, true));
 
+  OK(fields[CACHED_INDEXES_N_PAGE_GETS]->store(n_gets, true));
+
+  OK(fields[CACHED_INDEXES_N_PAGE_READS]->store(
+      buf_stat_per_index->get_reads(idx_id), true));
+
   OK(schema_table_store_record(thd, table_to_fill));
 
   return 0;
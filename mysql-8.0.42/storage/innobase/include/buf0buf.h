@@ -2415,6 +2415,20 @@ struct buf_pool_t {
   shrinks or grows! */
   ulint LRU_old_len;
 
+  /** Page replacement policy of this instance, see buf_LRU_policy_t.
+  Protected by LRU_list_mutex. */
+  ulong LRU_policy;
+
+  /** Ghost entries of pages recently evicted from this instance, used by
+  BUF_LRU_POLICY_2Q. Each slot holds a tag of the page id in the high 32 bits
+  and the low 32 bits of freed_page_clock at the eviction. An entry is valid
+  while fewer than LRU_ghosts_size pages have been evicted since. Protected
+  by LRU_list_mutex. */
+  uint64_t *LRU_ghosts;
+
+  /** Number of slots in LRU_ghosts, a power of two */
+  ulint LRU_ghosts_size;
+
   /** Base node of the unzip_LRU list. The list is protected by the
   LRU_list_mutex. */
   UT_LIST_BASE_NODE_T(buf_block_t, unzip_LRU) unzip_LRU;
@@ -40,6 +40,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "univ.i"
 #ifndef UNIV_HOTBACKUP
 #include "ut0byte.h"
+#include "ut0rnd.h"
 
 // Forward declaration
 struct trx_t;
@@ -171,6 +172,63 @@ uint buf_LRU_old_ratio_update(
     bool adjust); /*!< in: true=adjust the LRU list;
                    false=just assign buf_pool->LRU_old_ratio
                    during the initialization of InnoDB */
+
+/** Updates buf_pool->LRU_policy of all the buffer pool instances.
+@param[in]      policy          new policy, see buf_LRU_policy_t */
+void buf_LRU_policy_update(ulong policy);
+
+/** Allocates the ghost entries of a buffer pool instance, see
+buf_pool_t::LRU_ghosts.
+@param[in,out]  buf_pool        buffer pool instance */
+void buf_LRU_ghosts_create(buf_pool_t *buf_pool);
+
+/** Frees the ghost entries of a buffer pool instance.
+@param[in,out]  buf_pool        buffer pool instance */
+void buf_LRU_ghosts_free(buf_pool_t *buf_pool);
+
+/** Records the eviction of a page in a table of ghost entries, see
+buf_pool_t::LRU_ghosts. A newer eviction replaces an older one hashing to
+the same slot.
+@param[in,out]  ghosts          ghost entries
+@param[in]      n_ghosts        number of slots in ghosts, a power of two
+@param[in]      clock           number of pages evicted so far
+@param[in]      page_id         id of the evicted page */
+inline void buf_LRU_ghost_set(uint64_t *ghosts, size_t n_ghosts,
+                              uint64_t clock, const page_id_t &page_id) {
+  const uint64_t hash =
+      ut::hash_uint64(ut_ull_create(page_id.space(), page_id.page_no()));
+
+  ghosts[hash & (n_ghosts - 1)] =
+      (hash & 0xFFFFFFFF00000000ULL) | static_cast<uint32_t>(clock);
+}
+
+/** Looks up and removes the ghost entry of a page in a table of ghost
+entries, see buf_pool_t::LRU_ghosts.
+@param[in,out]  ghosts          ghost entries
+@param[in]      n_ghosts        number of slots in ghosts, a power of two
+@param[in]      clock           number of pages evicted so far
+@param[in]      page_id         id of the page
+@return true if the page was evicted less than n_ghosts evictions ago */
+inline bool buf_LRU_ghost_take(uint64_t *ghosts, size_t n_ghosts,
+                               uint64_t clock, const page_id_t &page_id) {
+  const uint64_t hash =
+      ut::hash_uint64(ut_ull_create(page_id.space(), page_id.page_no()));
+  const auto slot = hash & (n_ghosts - 1);
+  const uint64_t ghost = ghosts[slot];
+
+  if (ghost == 0 ||
+      (ghost & 0xFFFFFFFF00000000ULL) != (hash & 0xFFFFFFFF00000000ULL)) {
+    return false;
+  }
+
+  ghosts[slot] = 0;
+
+  /* Number of pages evicted since this page was evicted */
+  const uint32_t distance =
+      static_cast<uint32_t>(clock) - static_cast<uint32_t>(ghost);
+
+  return distance < n_ghosts;
+}
 /** Update the historical stats that we are collecting for LRU eviction
  policy at the end of each interval. */
 void buf_LRU_stat_update(void);
@@ -236,6 +294,22 @@ least this many milliseconds ago.  Not protected by any mutex or latch. */
 std::chrono::milliseconds get_buf_LRU_old_threshold();
 /** @} */
 
+/** Page replacement policies of the LRU list, the values of
+innodb_buffer_pool_replacement_policy. */
+enum buf_LRU_policy_t : ulong {
+  /** Pages read in are inserted at the midpoint of the LRU list, at the head
+  of the "old" sublist, and made young when they are accessed again after
+  innodb_old_blocks_time. */
+  BUF_LRU_POLICY_MIDPOINT = 0,
+
+  /** As BUF_LRU_POLICY_MIDPOINT, but the ids of recently evicted pages are
+  remembered as ghost entries, and a page that is read in again while it
+  still has a ghost entry is inserted at the head of the LRU list. Pages
+  touched once by a scan thus stay in the "old" sublist, while pages that
+  are re-referenced soon after their eviction are kept young (2Q). */
+  BUF_LRU_POLICY_2Q = 1
+};
+
 /** @brief Statistics for selecting the LRU list for eviction.
 
 These statistics are not 'of' LRU but 'for' LRU.  We keep count of I/O
@@ -79,6 +79,22 @@ released by the i/o-handler thread.
 bool buf_read_page_background(const page_id_t &page_id,
                               const page_size_t &page_size, bool sync);
 
+/** Maximum number of pages that buf_read_pages_background() reads at once */
+constexpr page_no_t BUF_READ_PAGES_MAX = 64;
+
+/** High-level function which reads adjacent pages of a tablespace from a
+file to the buffer pool with one synchronous read, for the pages that are
+not already there. The pages must exist in a single data file: this is not
+used for the system and temporary tablespaces. Pages that must be decrypted
+or decompressed are read again one at a time. Used by the buffer pool load.
+@param[in]      page_id         first page id
+@param[in]      page_size       page size
+@param[in]      n_pages         number of pages, at most BUF_READ_PAGES_MAX
+@return number of pages that have been read in */
+ulint buf_read_pages_background(const page_id_t &page_id,
+                                const page_size_t &page_size,
+                                page_no_t n_pages);
+
 /** Applies a random read-ahead in buf_pool if there are at least a threshold
 value of accessed pages from the random read-ahead area. Does not read any
 page, not even the one at the position (space, offset), if the read-ahead
@@ -45,17 +45,27 @@ this program; if not, write to the Free Software Foundation, Inc.,
 /** Per index buffer pool statistics - contains how many pages for each index
 are cached in the buffer pool(s). This is a key,value store where the key is
 the index id and the value is the number of pages in the buffer pool that
-belong to this index. */
+belong to this index. When innodb_buffer_pool_index_stats is enabled, the
+number of page accesses and of pages read from disk are also counted for
+each index, which gives the hit ratio of the buffer pool per index. */
 class buf_stat_per_index_t {
  public:
   /** Constructor. */
   buf_stat_per_index_t() {
     m_store = ut::new_withkey<ut_lock_free_hash_t>(
         ut::make_psi_memory_key(mem_key_buf_stat_per_index_t), 1024, true);
+    m_gets = ut::new_withkey<ut_lock_free_hash_t>(
+        ut::make_psi_memory_key(mem_key_buf_stat_per_index_t), 1024, false);
+    m_reads = ut::new_withkey<ut_lock_free_hash_t>(
+        ut::make_psi_memory_key(mem_key_buf_stat_per_index_t), 1024, false);
   }
 
   /** Destructor. */
-  ~buf_stat_per_index_t() { ut::delete_(m_store); }
+  ~buf_stat_per_index_t() {
+    ut::delete_(m_reads);
+    ut::delete_(m_gets);
+    ut::delete_(m_store);
+  }
 
   /** Increment the number of pages for a given index with 1.
   @param[in]    id      id of the index whose count to increment */
@@ -80,23 +90,71 @@ class buf_stat_per_index_t {
   /** Get the number of pages in the buffer pool for a given index.
   @param[in]    id      id of the index whose pages to peek
   @return number of pages */
-  uint64_t get(const index_id_t &id) {
+  uint64_t get(const index_id_t &id) { return get(m_store, id); }
+
+  /** Count an access to a page of a given index.
+  @param[in]    id      id of the index whose page was accessed */
+  void inc_gets(const index_id_t &id) {
+    if (should_skip(id)) {
+      return;
+    }
+
+    m_gets->inc(id.conv_to_int());
+  }
+
+  /** Count a read of a page of a given index into the buffer pool.
+  @param[in]    id      id of the index whose page was read */
+  void inc_reads(const index_id_t &id) {
+    if (should_skip(id)) {
+      return;
+    }
+
+    m_reads->inc(id.conv_to_int());
+  }
+
+  /** Forget the page accesses and page reads counted for a given index,
+  when the index is dropped.
+  @param[in]    id      id of the index */
+  void drop(const index_id_t &id) {
+    if (should_skip(id)) {
+      return;
+    }
+
+    m_gets->del(id.conv_to_int());
+    m_reads->del(id.conv_to_int());
+  }
+
+  /** Get the number of page accesses counted for a given index.
+  @param[in]    id      id of the index
+  @return number of page accesses */
+  uint64_t get_gets(const index_id_t &id) { return get(m_gets, id); }
+
+  /** Get the number of page reads counted for a given index.
+  @param[in]    id      id of the index
+  @return number of pages read */
+  uint64_t get_reads(const index_id_t &id) { return get(m_reads, id); }
+
+ private:
+  /** Get the counter of a given index from a store.
+  @param[in]    store   store to look in
+  @param[in]    id      id of the index
+  @return value of the counter */
+  uint64_t get(ut_lock_free_hash_t *store, const index_id_t &id) {
     if (should_skip(id)) {
       return (0);
     }
 
-    const int64_t ret = m_store->get(id.conv_to_int());
+    const int64_t ret = store->get(id.conv_to_int());
 
     if (ret == ut_lock_free_hash_t::NOT_FOUND) {
       /* If the index is not found in this structure,
-      then 0 of its pages are in the buffer pool. */
+      then its counter is 0. */
       return (0);
     }
 
     return (static_cast<uint64_t>(ret >= 0 ? ret : 0));
   }
 
- private:
   /** Assess if we should skip a page from accounting.
   @param[in]    id      index_id of the page
   @return true if it should not be accounted */
@@ -109,6 +167,12 @@ class buf_stat_per_index_t {
 
   /** (key, value) storage. */
   ut_lock_free_hash_t *m_store;
+
+  /** Number of page accesses per index */
+  ut_lock_free_hash_t *m_gets;
+
+  /** Number of pages read into the buffer pool per index */
+  ut_lock_free_hash_t *m_reads;
 };
 
 /** Container for how many pages from each index are contained in the buffer
@@ -2283,6 +2283,14 @@ regardless of the value of the global srv_stats_persistent_auto_recalc
   any latch, because this is only used for heuristics. */
   uint64_t stat_modified_counter;
 
+  /** How many rows have been inserted, updated, or deleted since the
+  table object was loaded into the dictionary cache. Unlike
+  stat_modified_counter this is never reset, so the server layer can
+  compare it against a value it remembered earlier to decide whether
+  column histograms have become stale. Not protected by any latch; it
+  is only used for heuristics. */
+  uint64_t stat_n_rows_modified;
+
 /** Background stats thread is not working on this table. */
 #define BG_STAT_NONE 0
 
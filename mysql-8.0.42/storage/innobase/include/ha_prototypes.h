@@ -414,6 +414,12 @@ void ib_warn_row_too_big(const dict_table_t *table);
 [[nodiscard]] ICP_RESULT innobase_index_cond(
     ha_innobase *h); /*!< in/out: pointer to ha_innobase */
 
+/** Check a row against the runtime filter pushed to the handler.
+@param[in,out]  h       pointer to ha_innobase
+@param[in]      record  the row, in MySQL format
+@return false if the row cannot be of interest to the server */
+[[nodiscard]] bool innobase_runtime_filter(ha_innobase *h, const byte *record);
+
 /** Gets information on the durability property requested by thread.
  Used when writing either a prepare or commit record to the log
  buffer.
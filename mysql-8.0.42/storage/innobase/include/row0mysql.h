@@ -97,6 +97,12 @@ struct row_prebuilt_t;
 void row_mysql_prebuilt_free_blob_heap(
     row_prebuilt_t *prebuilt); /*!< in: prebuilt struct of a
                                ha_innobase:: table handle */
+
+/** Frees the fetch cache in prebuilt. Any rows in it that are yet to be
+returned are thrown away.
+@param[in,out]  prebuilt        prebuilt struct of a ha_innobase:: table
+                                handle */
+void row_mysql_prebuilt_free_fetch_cache(row_prebuilt_t *prebuilt);
 /** Stores a >= 5.0.3 format true VARCHAR length to dest, in the MySQL row
  format.
  @return pointer to the data, we skip the 1 or 2 bytes at the start
@@ -502,9 +508,31 @@ struct mysql_row_templ_t {
                                 column */
 };
 
+/* Number of rows the fetch cache holds when a scan starts */
 constexpr uint32_t MYSQL_FETCH_CACHE_SIZE = 8;
 /* After fetching this many rows, we start caching them in fetch_cache */
 constexpr uint32_t MYSQL_FETCH_CACHE_THRESHOLD = 4;
+/* Every time a scan fills the fetch cache, the cache is doubled for the next
+batch, until it holds this many rows or MYSQL_FETCH_CACHE_MAX_BYTES, whichever
+is less. Long scans then restore their cursor once per batch of hundreds of
+rows instead of once every MYSQL_FETCH_CACHE_SIZE rows. */
+constexpr uint32_t MYSQL_FETCH_CACHE_MAX_SIZE = 512;
+/* The largest fetch cache we allocate, in bytes; the same limit as the
+server uses for the record buffers it provides */
+constexpr uint32_t MYSQL_FETCH_CACHE_MAX_BYTES = 128 * 1024;
+
+/** Compute the size of the next batch of a scan that filled its fetch cache.
+@param[in]      limit           number of rows in the batch that was filled
+@param[in]      mysql_row_len   length of a row in the fetch cache
+@return number of rows to fetch in the next batch */
+constexpr ulint row_fetch_cache_next_limit(ulint limit, ulint mysql_row_len) {
+  /* Reserve space for the magic numbers, see row_prebuilt_t::fetch_cache. */
+  const ulint max_rows = std::max<ulint>(
+      MYSQL_FETCH_CACHE_SIZE,
+      std::min<ulint>(MYSQL_FETCH_CACHE_MAX_SIZE,
+                      MYSQL_FETCH_CACHE_MAX_BYTES / (mysql_row_len + 8)));
+  return std::min(2 * limit, max_rows);
+}
 
 constexpr uint32_t ROW_PREBUILT_ALLOCATED = 78540783;
 constexpr uint32_t ROW_PREBUILT_FREED = 26423527;
@@ -717,16 +745,20 @@ struct row_prebuilt_t {
   /** ROW_SEL_NEXT or ROW_SEL_PREV */
   ulint fetch_direction;
 
-  byte *fetch_cache[MYSQL_FETCH_CACHE_SIZE];
+  byte *fetch_cache;
   /*!< a cache for fetched rows if we
   fetch many rows from the same cursor:
   it saves CPU time to fetch them in a
   batch; we reserve mysql_row_len
-  bytes for each such row; these
-  pointers point 4 bytes past the
-  allocated mem buf start, because
-  there is a 4 byte magic number at the
-  start and at the end */
+  bytes for each such row, with a 4 byte
+  magic number at the start and at the
+  end of each row; see fetch_cache_row() */
+  ulint fetch_cache_capacity; /*!< number of rows there is room
+                              for in fetch_cache */
+  ulint fetch_cache_limit;   /*!< number of rows to fetch into
+                             fetch_cache in the next batch; starts
+                             at MYSQL_FETCH_CACHE_SIZE for each
+                             scan and grows as the scan goes on */
   ulint fetch_cache_first;   /*!< position of the first not yet
                            fetched row in fetch_cache */
   ulint n_fetch_cached;      /*!< number of not yet fetched rows
@@ -787,6 +819,10 @@ struct row_prebuilt_t {
                          is used, false otherwise. */
   ulint idx_cond_n_cols; /*!< Number of fields in idx_cond_cols.
                          0 if and only if idx_cond == false. */
+  bool runtime_filter;   /*!< True if the rows found by
+                         row_search_mvcc() are checked against the
+                         runtime filter of m_mysql_handler, see
+                         innobase_runtime_filter() */
   /*----------------------*/
   unsigned innodb_api : 1;     /*!< whether this is a InnoDB API
                                query */
@@ -858,6 +894,19 @@ struct row_prebuilt_t {
   @retval false  if records cannot be prefetched */
   bool can_prefetch_records() const;
 
+  /** @return the buffer for row number i in the fetch cache */
+  byte *fetch_cache_row(ulint i) const {
+    ut_ad(i < fetch_cache_capacity);
+    return fetch_cache + i * (mysql_row_len + 8) + 4;
+  }
+
+  /** The current batch filled the fetch cache; fetch twice as many rows in
+  the next batch, if the cache may grow that large. */
+  void grow_fetch_cache_limit() {
+    fetch_cache_limit =
+        row_fetch_cache_next_limit(fetch_cache_limit, mysql_row_len);
+  }
+
   /** Determines if the query is REPLACE or ON DUPLICATE KEY UPDATE in which
   case duplicate values should be allowed (and further processed) instead of
   causing an error.
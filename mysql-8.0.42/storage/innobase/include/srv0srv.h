@@ -389,11 +389,19 @@ extern unsigned long long srv_online_max_size;
 /** Number of threads to use for parallel reads. */
 extern ulong srv_parallel_read_threads;
 
+/** Number of threads that apply redo log records during crash recovery. */
+extern ulong srv_n_recovery_apply_threads;
+
 /* If this flag is true, then we will use the native aio of the
 OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 extern bool srv_use_native_aio;
+
+/* If this flag and srv_use_native_aio are true, then on Linux we will use
+io_uring instead of libaio (provided we compiled Innobase with it in, and
+the kernel supports it). */
+extern bool srv_use_io_uring;
 extern bool srv_numa_interleave;
 
 /* The innodb_directories variable value. This a list of directories
@@ -610,6 +618,8 @@ extern ulint srv_buf_pool_base_size;
 extern long long srv_buf_pool_curr_size;
 /** Dump this % of each buffer pool during BP dump */
 extern ulong srv_buf_pool_dump_pct;
+/** Number of threads that read pages in during BP load */
+extern ulong srv_buf_pool_load_threads;
 /** Lock table size in bytes */
 extern ulint srv_lock_table_size;
 
@@ -670,6 +680,16 @@ extern ulong srv_log_flush_notifier_timeout;
 
 extern uint buf_LRU_old_threshold;
 
+/** Page replacement policy of the buffer pool, see buf_LRU_policy_t */
+extern ulong buf_LRU_policy;
+
+/** Count page accesses and reads per index, see buf_stat_per_index_t */
+extern bool srv_buf_pool_index_stats;
+
+/** Let index searches buffer-fix the guessed root page, if it is already
+buffer-fixed by other threads, without acquiring the page hash latch */
+extern bool srv_buf_pool_root_guess_fast_path;
+
 extern ulong srv_n_page_cleaners;
 
 extern double srv_max_dirty_pages_pct;
@@ -790,6 +810,7 @@ extern srv_stats_t srv_stats;
 extern mysql_pfs_key_t log_archiver_thread_key;
 extern mysql_pfs_key_t page_archiver_thread_key;
 extern mysql_pfs_key_t buf_dump_thread_key;
+extern mysql_pfs_key_t buf_load_thread_key;
 extern mysql_pfs_key_t buf_resize_thread_key;
 extern mysql_pfs_key_t clone_ddl_thread_key;
 extern mysql_pfs_key_t clone_gtid_thread_key;
@@ -810,6 +831,7 @@ extern mysql_pfs_key_t log_flush_notifier_thread_key;
 extern mysql_pfs_key_t page_flush_coordinator_thread_key;
 extern mysql_pfs_key_t page_flush_thread_key;
 extern mysql_pfs_key_t recv_writer_thread_key;
+extern mysql_pfs_key_t recv_apply_thread_key;
 extern mysql_pfs_key_t srv_error_monitor_thread_key;
 extern mysql_pfs_key_t srv_lock_timeout_thread_key;
 extern mysql_pfs_key_t srv_master_thread_key;
@@ -26,6 +26,7 @@
 INCLUDE(CheckFunctionExists)
 INCLUDE(CheckCSourceCompiles)
 INCLUDE(CheckCSourceRuns)
+INCLUDE(CheckSymbolExists)
 
 ADD_DEFINITIONS(-DHAVE_LZ4=1)
 
@@ -45,6 +46,18 @@ IF(UNIX AND NOT IGNORE_AIO_CHECK)
       LINK_LIBRARIES(aio)
     ENDIF()
 
+    # io_uring is used through raw system calls, so only the kernel
+    # headers are needed. Completion polling relies on IORING_ENTER_EXT_ARG
+    # (Linux 5.11).
+    CHECK_SYMBOL_EXISTS(IORING_FEAT_EXT_ARG "linux/io_uring.h"
+      HAVE_IORING_FEAT_EXT_ARG)
+    CHECK_SYMBOL_EXISTS(__NR_io_uring_setup "sys/syscall.h"
+      HAVE_IO_URING_SYSCALLS)
+
+    IF(HAVE_IORING_FEAT_EXT_ARG AND HAVE_IO_URING_SYSCALLS)
+      ADD_DEFINITIONS(-DLINUX_IO_URING=1)
+    ENDIF()
+
   ELSEIF(SOLARIS)
     ADD_DEFINITIONS("-DUNIV_SOLARIS")
   ENDIF()
@@ -37,6 +37,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include <my_aes.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <array>
 #include <iomanip>
 #include <map>
@@ -203,6 +204,7 @@ static lsn_t recv_max_page_lsn;
 #ifndef UNIV_HOTBACKUP
 #ifdef UNIV_PFS_THREAD
 mysql_pfs_key_t recv_writer_thread_key;
+mysql_pfs_key_t recv_apply_thread_key;
 #endif /* UNIV_PFS_THREAD */
 
 static bool recv_writer_is_active() {
@@ -1118,6 +1120,91 @@ static void recv_apply_log_rec(recv_addr_t *recv_addr) {
   }
 }
 
+/** Pages with redo log records to apply in one batch. */
+using Recv_pages = ut::vector<recv_addr_t *>;
+
+/** Progress of a batch of redo log application, shared by the threads that
+apply it. All the fields are protected by recv_sys->mutex. */
+struct Recv_apply_progress {
+  /** Interval between progress reports in percent */
+  static const size_t PCT = 10;
+
+  /** Constructor
+  @param[in]    batch_size      number of pages in the batch */
+  explicit Recv_apply_progress(size_t batch_size)
+      : m_batch_size(batch_size),
+        m_unit(batch_size / PCT),
+        m_start_time(std::chrono::steady_clock::now()) {
+    if (m_unit <= PCT) {
+      m_pct = 100;
+      m_unit = batch_size;
+    }
+  }
+
+  /** Account for one more page and report the progress if due. */
+  void page_applied() {
+    ut_ad(mutex_own(&recv_sys->mutex));
+
+    ++m_applied;
+
+    if (m_unit == 0 || (m_applied % m_unit) == 0) {
+      ib::info(ER_IB_MSG_708) << m_pct << "%";
+
+      m_pct += PCT;
+
+      m_start_time = std::chrono::steady_clock::now();
+
+    } else if (std::chrono::steady_clock::now() - m_start_time >=
+               PRINT_INTERVAL) {
+      m_start_time = std::chrono::steady_clock::now();
+
+      ib::info(ER_IB_MSG_709)
+          << std::setprecision(2)
+          << ((double)m_applied * 100) / (double)m_batch_size << "%";
+    }
+  }
+
+  /** Number of pages in the batch */
+  const size_t m_batch_size;
+
+  /** Report the percentage every m_unit pages */
+  size_t m_unit;
+
+  /** Next percentage to report */
+  size_t m_pct{PCT};
+
+  /** Number of pages processed so far */
+  size_t m_applied{0};
+
+  /** Time of the last progress report */
+  std::chrono::steady_clock::time_point m_start_time;
+};
+
+/** Apply the redo log records of a range of pages. Each apply thread works
+on its own contiguous range of page ids, so that the read-ahead issued by
+recv_read_in_area() for an area is normally done by one thread. The
+recv_sys->mutex is acquired for each page, and released by
+recv_apply_log_rec() while the page is read in or its records are applied,
+so that the threads only serialize on the bookkeeping.
+@param[in]      begin           first page of the range
+@param[in]      end             end of the range
+@param[in]      thread_id       apply thread number, unused
+@param[in,out]  progress        progress of the batch */
+static void recv_apply_log_recs_range(const Recv_pages::const_iterator &begin,
+                                      const Recv_pages::const_iterator &end,
+                                      size_t thread_id,
+                                      Recv_apply_progress *progress) {
+  for (auto it = begin; it != end; ++it) {
+    mutex_enter(&recv_sys->mutex);
+
+    recv_apply_log_rec(*it);
+
+    progress->page_applied();
+
+    mutex_exit(&recv_sys->mutex);
+  }
+}
+
 dberr_t recv_apply_hashed_log_recs(log_t &log, bool allow_ibuf) {
   for (;;) {
     mutex_enter(&recv_sys->mutex);
@@ -1142,18 +1229,9 @@ dberr_t recv_apply_hashed_log_recs(log_t &log, bool allow_ibuf) {
 
   ib::info(ER_IB_MSG_707, ulonglong{batch_size});
 
-  static const size_t PCT = 10;
-
-  size_t pct = PCT;
-  size_t applied = 0;
-  auto unit = batch_size / PCT;
-
-  if (unit <= PCT) {
-    pct = 100;
-    unit = batch_size;
-  }
+  Recv_pages pages;
 
-  auto start_time = std::chrono::steady_clock::now();
+  pages.reserve(batch_size);
 
   for (const auto &space : *recv_sys->spaces) {
     bool dropped;
@@ -1180,34 +1258,42 @@ dberr_t recv_apply_hashed_log_recs(log_t &log, bool allow_ibuf) {
       }
     }
 
-    for (auto pages : space.second.m_pages) {
-      ut_ad(pages.second->space == space.first);
+    for (auto page : space.second.m_pages) {
+      ut_ad(page.second->space == space.first);
 
       if (dropped) {
-        pages.second->state = RECV_DISCARDED;
+        page.second->state = RECV_DISCARDED;
       }
 
-      recv_apply_log_rec(pages.second);
-
-      ++applied;
+      pages.push_back(page.second);
+    }
+  }
 
-      if (unit == 0 || (applied % unit) == 0) {
-        ib::info(ER_IB_MSG_708) << pct << "%";
+  /* Order the pages by page id, so that each apply thread gets a
+  contiguous range of pages and reads them in with its own read-ahead. */
+  std::sort(pages.begin(), pages.end(),
+            [](const recv_addr_t *lhs, const recv_addr_t *rhs) {
+              return lhs->space < rhs->space ||
+                     (lhs->space == rhs->space && lhs->page_no < rhs->page_no);
+            });
+
+  /* Number of additional threads, a range shorter than the read-ahead area
+  is not worth a thread of its own. */
+  size_t n_threads = 0;
+
+  if (srv_n_recovery_apply_threads > 1) {
+    n_threads = std::min(size_t{srv_n_recovery_apply_threads},
+                         pages.size() / RECV_READ_AHEAD_AREA);
+  }
 
-        pct += PCT;
+  Recv_apply_progress progress(batch_size);
 
-        start_time = std::chrono::steady_clock::now();
+  mutex_exit(&recv_sys->mutex);
 
-      } else if (std::chrono::steady_clock::now() - start_time >=
-                 PRINT_INTERVAL) {
-        start_time = std::chrono::steady_clock::now();
+  par_for(recv_apply_thread_key, pages, n_threads, recv_apply_log_recs_range,
+          &progress);
 
-        ib::info(ER_IB_MSG_709)
-            << std::setprecision(2)
-            << ((double)applied * 100) / (double)batch_size << "%";
-      }
-    }
-  }
+  mutex_enter(&recv_sys->mutex);
 
   /* Wait until all the pages have been processed */
 
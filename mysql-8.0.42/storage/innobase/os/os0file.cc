@@ -79,6 +79,16 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
 #endif /* UNIV_HOTBACKUP */
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+#ifndef UNIV_HOTBACKUP
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#else /* UNIV_HOTBACKUP */
+#undef LINUX_IO_URING
+#endif /* UNIV_HOTBACKUP */
+#endif /* LINUX_IO_URING */
+
 #ifdef HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE
 #include <fcntl.h>
 #include <linux/falloc.h>
@@ -288,6 +298,16 @@ The io_handler_thread() thread then collects the completed IO request from the
 segment of 8 * OS_AIO_N_PENDING_IOS_PER_THREAD slots of the array it is
 responsible for with io_getevents() and calls completion routine on it.
 
+If innodb_use_io_uring is also set, and the kernel supports it, each segment
+gets an io_uring instead of an io_context. The calling thread writes a
+submission queue entry for the slot and, unless the request was made with
+IORequest::DO_NOT_WAKE, passes it to the kernel with io_uring_enter(). Requests
+made with DO_NOT_WAKE (read-ahead, background reads and doublewrite flush
+batches) are passed to the kernel together by the
+os_aio_simulated_wake_handler_threads() call that ends the batch. The
+io_handler_thread() of the segment reaps the completion queue, and calls the
+same completion routine as for libaio.
+
 **********************************************************************/
 
 #ifdef UNIV_PFS_IO
@@ -366,9 +386,11 @@ struct Slot {
   /** length of the block to read or write */
   DWORD len{0};
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+#ifdef LINUX_NATIVE_AIO
   /** Linux control block for aio */
   struct iocb control;
+#endif /* LINUX_NATIVE_AIO */
 
   /** AIO return code */
   int ret{0};
@@ -378,13 +400,13 @@ struct Slot {
 
   /** length of the block to read or write */
   ulint len{0};
-#else  /* !_WIN32 && !LINUX_NATIVE_AIO */
+#else  /* !_WIN32 && !LINUX_NATIVE_AIO && !LINUX_IO_URING */
   /** length of the block to read or write */
   ulint len{0};
 
   /** bytes written/read. */
   ulint n_bytes{0};
-#endif /* !_WIN32 && !LINUX_NATIVE_AIO */
+#endif /* !_WIN32 && !LINUX_NATIVE_AIO && !LINUX_IO_URING */
 
   /** Buffer block for compressed pages or encrypted pages */
   file::Block *buf_block{nullptr};
@@ -426,6 +448,272 @@ inline std::ostream &operator<<(std::ostream &out, const Slot &obj) noexcept {
   return (obj.print(out));
 }
 
+#ifdef LINUX_IO_URING
+/** One io_uring instance, used through the raw system calls so that no
+library beyond the kernel headers is needed. The rings are mapped with a
+single mmap(), and completions are waited for with a timeout passed through
+IORING_ENTER_EXT_ARG, so Linux 5.11 or newer is required. */
+class Io_uring {
+ public:
+  Io_uring() = default;
+
+  ~Io_uring() { destroy(); }
+
+  Io_uring(const Io_uring &) = delete;
+  Io_uring &operator=(const Io_uring &) = delete;
+
+  /** Create the ring.
+  @param[in]    entries         minimum number of submission queue entries
+  @return 0 on success or a negated errno value */
+  [[nodiscard]] int create(uint32_t entries);
+
+  /** Unmap the rings and close the ring file descriptor. */
+  void destroy();
+
+  /** Add a read or write to the submission queue. The caller must
+  serialize calls for the same ring.
+  @param[in]    is_read         true for a read, false for a write
+  @param[in]    fd              file descriptor
+  @param[in]    buf             buffer to read into or write from
+  @param[in]    len             number of bytes
+  @param[in]    offset          file offset in bytes
+  @param[in]    user_data       returned unchanged with the completion
+  @return false if the submission queue is full */
+  [[nodiscard]] bool queue(bool is_read, int fd, void *buf, uint32_t len,
+                           uint64_t offset, void *user_data);
+
+  /** Pass all queued entries to the kernel.
+  @return number of entries consumed by the kernel or a negated errno value */
+  int submit() { return (enter(0, nullptr)); }
+
+  /** Pass all queued entries to the kernel and wait until at least one
+  completion is available.
+  @param[in]    timeout_ns      how long to wait, in nanoseconds
+  @return number of entries consumed by the kernel or a negated errno value;
+          -ETIME if the wait timed out */
+  int submit_and_wait(uint64_t timeout_ns);
+
+  /** Call a function for each available completion and release the
+  completion queue entries. Must only be called by the thread that owns the
+  completion queue.
+  @param[in]    f               called with each io_uring_cqe
+  @return number of completions processed */
+  template <typename F>
+  ulint reap(F &&f) {
+    const auto head = *m_cq_head;
+    const auto tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+
+    for (auto i = head; i != tail; ++i) {
+      f(m_cqes[i & m_cq_mask]);
+    }
+
+    __atomic_store_n(m_cq_head, tail, __ATOMIC_RELEASE);
+
+    return (tail - head);
+  }
+
+ private:
+  /** Call io_uring_enter() for all entries that were queued but not yet
+  consumed by the kernel.
+  @param[in]    min_complete    number of completions to wait for
+  @param[in]    timeout         wait timeout, used if min_complete > 0
+  @return number of entries consumed or a negated errno value */
+  int enter(uint32_t min_complete, const __kernel_timespec *timeout);
+
+  /** Ring file descriptor */
+  int m_fd{-1};
+
+  /** Shared submission and completion queue rings */
+  void *m_rings{nullptr};
+
+  /** Size of m_rings mapping */
+  size_t m_rings_size{0};
+
+  /** Submission queue entries */
+  io_uring_sqe *m_sqes{nullptr};
+
+  /** Number of submission queue entries */
+  uint32_t m_sq_entries{0};
+
+  /** Submission queue head, advanced by the kernel */
+  uint32_t *m_sq_head{nullptr};
+
+  /** Submission queue tail, advanced by us */
+  uint32_t *m_sq_tail{nullptr};
+
+  /** Submission queue index mask */
+  uint32_t m_sq_mask{0};
+
+  /** Completion queue head, advanced by us */
+  uint32_t *m_cq_head{nullptr};
+
+  /** Completion queue tail, advanced by the kernel */
+  uint32_t *m_cq_tail{nullptr};
+
+  /** Completion queue index mask */
+  uint32_t m_cq_mask{0};
+
+  /** Completion queue entries */
+  io_uring_cqe *m_cqes{nullptr};
+};
+
+int Io_uring::create(uint32_t entries) {
+  ut_a(m_fd == -1);
+
+  io_uring_params params;
+  memset(&params, 0x0, sizeof(params));
+
+  const auto fd = static_cast<int>(
+      syscall(__NR_io_uring_setup, entries, &params));
+
+  if (fd < 0) {
+    return (-errno);
+  }
+
+  m_fd = fd;
+
+  if (!(params.features & IORING_FEAT_SINGLE_MMAP) ||
+      !(params.features & IORING_FEAT_EXT_ARG)) {
+    destroy();
+    return (-ENOSYS);
+  }
+
+  const auto sq_size =
+      params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  const auto cq_size =
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+  m_rings_size = std::max<size_t>(sq_size, cq_size);
+
+  auto rings = mmap(nullptr, m_rings_size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+
+  if (rings == MAP_FAILED) {
+    const auto err = errno;
+    destroy();
+    return (-err);
+  }
+
+  m_rings = rings;
+
+  const auto sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+
+  auto sqes = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+
+  if (sqes == MAP_FAILED) {
+    const auto err = errno;
+    destroy();
+    return (-err);
+  }
+
+  m_sqes = static_cast<io_uring_sqe *>(sqes);
+  m_sq_entries = params.sq_entries;
+
+  auto base = static_cast<byte *>(m_rings);
+
+  m_sq_head = reinterpret_cast<uint32_t *>(base + params.sq_off.head);
+  m_sq_tail = reinterpret_cast<uint32_t *>(base + params.sq_off.tail);
+  m_sq_mask = *reinterpret_cast<uint32_t *>(base + params.sq_off.ring_mask);
+
+  m_cq_head = reinterpret_cast<uint32_t *>(base + params.cq_off.head);
+  m_cq_tail = reinterpret_cast<uint32_t *>(base + params.cq_off.tail);
+  m_cq_mask = *reinterpret_cast<uint32_t *>(base + params.cq_off.ring_mask);
+  m_cqes = reinterpret_cast<io_uring_cqe *>(base + params.cq_off.cqes);
+
+  /* Submission queue entry i always sits in slot i of the index array. */
+  auto sq_array = reinterpret_cast<uint32_t *>(base + params.sq_off.array);
+
+  for (uint32_t i = 0; i < m_sq_entries; ++i) {
+    sq_array[i] = i;
+  }
+
+  return (0);
+}
+
+void Io_uring::destroy() {
+  if (m_sqes != nullptr) {
+    munmap(m_sqes, m_sq_entries * sizeof(io_uring_sqe));
+    m_sqes = nullptr;
+  }
+
+  if (m_rings != nullptr) {
+    munmap(m_rings, m_rings_size);
+    m_rings = nullptr;
+  }
+
+  if (m_fd != -1) {
+    close(m_fd);
+    m_fd = -1;
+  }
+}
+
+bool Io_uring::queue(bool is_read, int fd, void *buf, uint32_t len,
+                     uint64_t offset, void *user_data) {
+  const auto tail = *m_sq_tail;
+
+  if (tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE) >= m_sq_entries) {
+    return (false);
+  }
+
+  auto sqe = &m_sqes[tail & m_sq_mask];
+
+  memset(sqe, 0x0, sizeof(*sqe));
+
+  sqe->opcode = is_read ? IORING_OP_READ : IORING_OP_WRITE;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uintptr_t>(buf);
+  sqe->len = len;
+  sqe->off = offset;
+  sqe->user_data = reinterpret_cast<uintptr_t>(user_data);
+
+  /* Publish the entry only after it has been completely written. */
+  __atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+  return (true);
+}
+
+int Io_uring::submit_and_wait(uint64_t timeout_ns) {
+  __kernel_timespec timeout;
+
+  timeout.tv_sec = static_cast<int64_t>(timeout_ns / 1000000000UL);
+  timeout.tv_nsec = static_cast<long long>(timeout_ns % 1000000000UL);
+
+  return (enter(1, &timeout));
+}
+
+int Io_uring::enter(uint32_t min_complete, const __kernel_timespec *timeout) {
+  /* Entries the kernel has not consumed yet. Another thread may pass them
+  to the kernel concurrently, in which case the kernel only consumes what
+  is left. */
+  const uint32_t to_submit = __atomic_load_n(m_sq_tail, __ATOMIC_ACQUIRE) -
+                             __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+
+  if (to_submit == 0 && min_complete == 0) {
+    return (0);
+  }
+
+  unsigned flags = 0;
+  io_uring_getevents_arg arg;
+  void *argp = nullptr;
+  size_t argsz = 0;
+
+  if (min_complete > 0) {
+    memset(&arg, 0x0, sizeof(arg));
+    arg.ts = reinterpret_cast<uintptr_t>(timeout);
+
+    flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+    argp = &arg;
+    argsz = sizeof(arg);
+  }
+
+  const auto ret = syscall(__NR_io_uring_enter, m_fd, to_submit, min_complete,
+                           flags, argp, argsz);
+
+  return (ret < 0 ? -errno : static_cast<int>(ret));
+}
+#endif /* LINUX_IO_URING */
+
 /** The asynchronous i/o array structure */
 class AIO {
  public:
@@ -517,12 +805,41 @@ class AIO {
   @param[in,out]        file    file where to print */
   void to_file(FILE *file) const;
 
-#ifdef LINUX_NATIVE_AIO
+#if defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
   /** Dispatch an AIO request to the kernel.
   @param[in,out]        slot    an already reserved slot
+  @param[in]    submit  false to only queue the request when io_uring is
+                        used; it is then passed to the kernel by the next
+                        submit_all() or completion poll of the segment
+  @return true on success. */
+  [[nodiscard]] bool linux_dispatch(Slot *slot, bool submit);
+#endif /* LINUX_NATIVE_AIO || LINUX_IO_URING */
+
+#ifdef LINUX_IO_URING
+  /** Queue an AIO request on the io_uring of the slot's segment.
+  @param[in,out]        slot    an already reserved slot
   @return true on success. */
-  [[nodiscard]] bool linux_dispatch(Slot *slot);
+  [[nodiscard]] bool uring_queue(Slot *slot);
 
+  /** Accessor for the io_uring of a segment
+  @param[in]    segment Segment for which to get the ring
+  @return the io_uring for the segment */
+  [[nodiscard]] Io_uring *uring(ulint segment) {
+    ut_ad(segment < get_n_segments());
+
+    return (&m_urings[segment]);
+  }
+
+  /** Pass the requests queued on the io_uring of every segment of every
+  array to the kernel. */
+  static void uring_submit_all();
+
+  /** Checks if io_uring can be used for InnoDB files.
+  @return true if supported, false otherwise. */
+  [[nodiscard]] static bool is_io_uring_supported();
+#endif /* LINUX_IO_URING */
+
+#ifdef LINUX_NATIVE_AIO
   /** Accessor for an AIO event
   @param[in]    index   Index into the array
   @return the event at the index */
@@ -711,6 +1028,12 @@ class AIO {
   [[nodiscard]] dberr_t init_linux_native_aio();
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+  /** Initialise one io_uring per segment
+  @return DB_SUCCESS or error code */
+  [[nodiscard]] dberr_t init_io_uring();
+#endif /* LINUX_IO_URING */
+
  private:
   typedef std::vector<Slot> Slots;
 
@@ -766,6 +1089,13 @@ class AIO {
   IOEvents m_events;
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+  /** One io_uring per segment when srv_use_io_uring is set, else nullptr.
+  The submission queue of a ring is filled under m_mutex; its completion
+  queue is only read by the I/O handler thread of the segment. */
+  Io_uring *m_urings{nullptr};
+#endif /* LINUX_IO_URING */
+
   /** The aio arrays for non-ibuf i/o and ibuf i/o. These are NULL when the
   module has not yet been initialized. */
 
@@ -784,9 +1114,12 @@ AIO *AIO::s_reads;
 AIO *AIO::s_writes;
 AIO *AIO::s_ibuf;
 
-#if defined(LINUX_NATIVE_AIO)
-/** timeout for each io_getevents() call = 500ms. */
+#if defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+/** timeout for each io_getevents() or io_uring_enter() call = 500ms. */
 static constexpr uint64_t OS_AIO_REAP_TIMEOUT = 500000000UL;
+#endif /* LINUX_NATIVE_AIO || LINUX_IO_URING */
+
+#if defined(LINUX_NATIVE_AIO)
 
 /** time to sleep if io_setup() returns EAGAIN. */
 static constexpr std::chrono::milliseconds OS_AIO_IO_SETUP_RETRY_SLEEP{500};
@@ -1584,10 +1917,12 @@ void AIO::release(Slot *slot) {
 
   ResetEvent(slot->handle);
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 
   if (srv_use_native_aio) {
+#ifdef LINUX_NATIVE_AIO
     memset(&slot->control, 0x0, sizeof(slot->control));
+#endif /* LINUX_NATIVE_AIO */
     slot->ret = 0;
     slot->n_bytes = 0;
   } else {
@@ -1597,7 +1932,7 @@ void AIO::release(Slot *slot) {
     ut_ad(slot->ret == 0);
   }
 
-#endif /* !_WIN32 && LINUX_NATIVE_AIO */
+#endif /* !_WIN32 && (LINUX_NATIVE_AIO || LINUX_IO_URING) */
 }
 
 /** Frees a slot in the AIO array. Assumes caller doesn't own the mutex.
@@ -2093,9 +2428,9 @@ static dberr_t os_file_punch_hole_posix(os_file_t fh, os_offset_t off,
   return (DB_IO_NO_PUNCH_HOLE);
 }
 
-#if defined(LINUX_NATIVE_AIO)
+#if defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 
-/** Linux native AIO handler */
+/** Linux native AIO handler, for both libaio and io_uring */
 class LinuxAIOHandler {
  public:
   /**
@@ -2161,6 +2496,19 @@ class LinuxAIOHandler {
   each wakeup and that is why we use timed wait in io_getevents(). */
   void collect();
 
+#ifdef LINUX_IO_URING
+  /** The io_uring counterpart of collect(). Waits in io_uring_enter(),
+  which also passes any requests queued with IORequest::DO_NOT_WAKE to
+  the kernel, and then drains the completion queue of the segment. */
+  void collect_uring();
+#endif /* LINUX_IO_URING */
+
+  /** Mark a slot of this segment as completed.
+  @param[in,out]        slot            The completed slot
+  @param[in]    res             Number of bytes transferred, or a negated
+                                  errno value on failure */
+  void complete(Slot *slot, int64_t res);
+
  private:
   /** Slot array */
   AIO *m_array;
@@ -2200,6 +2548,24 @@ dberr_t LinuxAIOHandler::resubmit(Slot *slot) {
   slot->n_bytes = 0;
   slot->io_already_done = false;
 
+#ifdef LINUX_IO_URING
+  if (srv_use_io_uring) {
+    /* Resubmit an I/O request */
+    if (!m_array->uring_queue(slot)) {
+      return (DB_IO_PARTIAL_FAILED);
+    }
+
+    const int ret = m_array->uring(m_segment)->submit();
+
+    if (ret < 0) {
+      errno = -ret;
+    }
+
+    return (ret < 0 ? DB_IO_PARTIAL_FAILED : DB_SUCCESS);
+  }
+#endif /* LINUX_IO_URING */
+
+#ifdef LINUX_NATIVE_AIO
   /* make sure that slot->offset fits in off_t */
   ut_ad(sizeof(off_t) >= sizeof(os_offset_t));
   struct iocb *iocb = &slot->control;
@@ -2221,6 +2587,9 @@ dberr_t LinuxAIOHandler::resubmit(Slot *slot) {
   }
 
   return (ret < 0 ? DB_IO_PARTIAL_FAILED : DB_SUCCESS);
+#else  /* LINUX_NATIVE_AIO */
+  ut_error;
+#endif /* LINUX_NATIVE_AIO */
 }
 
 /** Check if the AIO succeeded
@@ -2306,6 +2675,14 @@ void LinuxAIOHandler::collect() {
   ut_ad(m_n_slots > 0);
   ut_ad(m_segment < m_array->get_n_segments());
 
+#ifdef LINUX_IO_URING
+  if (srv_use_io_uring) {
+    collect_uring();
+    return;
+  }
+#endif /* LINUX_IO_URING */
+
+#ifdef LINUX_NATIVE_AIO
   /* Which io_context we are going to use. */
   io_context *io_ctx = m_array->io_ctx(m_segment);
 
@@ -2349,43 +2726,14 @@ void LinuxAIOHandler::collect() {
       /* We have not overstepped to next segment. */
       ut_a(slot->pos < end_pos);
 
-      /** If write of the page is compressed (compression is enabled, it is not
-      the first page, it is not a redolog, not a doublewrite buffer) and punch
-      holes are enabled, call AIOHandler::io_complete to check if hole punching
-      is needed.
-      Keep in sync with os_aio_windows_handler(). */
-      if (slot->offset > 0 && !slot->skip_punch_hole &&
-          slot->type.is_compression_enabled() && !slot->type.is_log() &&
-          slot->type.is_write() && slot->type.is_compressed() &&
-          slot->type.punch_hole() && !slot->type.is_dblwr()) {
-        slot->err = AIOHandler::io_complete(slot);
-      } else {
-        slot->err = DB_SUCCESS;
-      }
-
-      /* Mark this request as completed. The error handling
-      will be done in the calling function. */
-      m_array->acquire();
-
       /* events[i].res2 should always be ZERO */
       ut_ad(events[i].res2 == 0);
-      slot->io_already_done = true;
 
       /* Even though events[i].res is an unsigned number in libaio, it is
       used to return a negative value (negated errno value) to indicate
       error and a positive value to indicate number of bytes read or
       written. */
-
-      if (events[i].res > slot->len) {
-        /* failure */
-        slot->n_bytes = 0;
-        slot->ret = events[i].res;
-      } else {
-        /* success */
-        slot->n_bytes = events[i].res;
-        slot->ret = 0;
-      }
-      m_array->release();
+      complete(slot, static_cast<int64_t>(events[i].res));
     }
 
     if (srv_shutdown_state.load() == SRV_SHUTDOWN_EXIT_THREADS ||
@@ -2420,6 +2768,111 @@ void LinuxAIOHandler::collect() {
 
     break;
   }
+#else  /* LINUX_NATIVE_AIO */
+  ut_error;
+#endif /* LINUX_NATIVE_AIO */
+}
+
+#ifdef LINUX_IO_URING
+void LinuxAIOHandler::collect_uring() {
+  Io_uring *ring = m_array->uring(m_segment);
+
+  /* Starting point of the m_segment we will be working on. */
+  const ulint start_pos = m_segment * m_n_slots;
+
+  /* End point. */
+  const ulint end_pos = start_pos + m_n_slots;
+
+  for (;;) {
+    const int ret = ring->submit_and_wait(OS_AIO_REAP_TIMEOUT);
+
+    const auto n_completed = ring->reap([&](const io_uring_cqe &cqe) {
+      auto slot = reinterpret_cast<Slot *>(cqe.user_data);
+
+      /* Some sanity checks. */
+      ut_a(slot != nullptr);
+      ut_a(slot->is_reserved);
+      ut_a(slot->pos >= start_pos);
+      ut_a(slot->pos < end_pos);
+
+      int64_t res = cqe.res;
+
+      /* Pretend that only the first half of the request was done, so that
+      the rest is resubmitted. Keep the offset aligned for O_DIRECT. */
+      DBUG_EXECUTE_IF("ib_io_uring_short_io", {
+        if (res >= 2 * static_cast<int64_t>(UNIV_PAGE_SIZE_MIN)) {
+          res = static_cast<int64_t>(
+              ut_uint64_align_down(res / 2, UNIV_PAGE_SIZE_MIN));
+        }
+      });
+
+      complete(slot, res);
+    });
+
+    if (srv_shutdown_state.load() == SRV_SHUTDOWN_EXIT_THREADS ||
+        !buf_flush_page_cleaner_is_active() || n_completed > 0) {
+      break;
+    }
+
+    switch (ret) {
+      case -ETIME:
+        /* No request completed within the timeout. */
+
+      case -EAGAIN:
+      case -EBUSY:
+        /* Not enough resources to submit, or the completion queue must be
+        drained first! Try again. */
+
+      case -EINTR:
+        /* Interrupted! */
+
+        continue;
+    }
+
+    if (ret >= 0) {
+      /* Woken up without completions, check again. */
+      continue;
+    }
+
+    /* All other errors should cause a trap for now. */
+    ib::fatal(UT_LOCATION_HERE, ER_IB_MSG_755)
+        << "Unexpected ret_code[" << ret << "] from io_uring_enter()!";
+  }
+}
+#endif /* LINUX_IO_URING */
+
+void LinuxAIOHandler::complete(Slot *slot, int64_t res) {
+  /** If write of the page is compressed (compression is enabled, it is not
+  the first page, it is not a redolog, not a doublewrite buffer) and punch
+  holes are enabled, call AIOHandler::io_complete to check if hole punching
+  is needed.
+  Keep in sync with os_aio_windows_handler(). */
+  if (slot->offset > 0 && !slot->skip_punch_hole &&
+      slot->type.is_compression_enabled() && !slot->type.is_log() &&
+      slot->type.is_write() && slot->type.is_compressed() &&
+      slot->type.punch_hole() && !slot->type.is_dblwr()) {
+    slot->err = AIOHandler::io_complete(slot);
+  } else {
+    slot->err = DB_SUCCESS;
+  }
+
+  /* Mark this request as completed. The error handling
+  will be done in the calling function. */
+  m_array->acquire();
+
+  slot->io_already_done = true;
+
+  if (res < 0 || static_cast<uint64_t>(res) > slot->len) {
+    /* failure */
+    slot->n_bytes = 0;
+    slot->ret = static_cast<int>(res);
+  } else {
+    /* success */
+    slot->n_bytes = static_cast<ssize_t>(res);
+    slot->ret = 0;
+  }
+
+  m_array->release();
 }
 
 /** Process a Linux AIO request
@@ -2539,11 +2992,47 @@ static dberr_t os_aio_linux_handler(ulint global_segment, fil_node_t **m1,
 
 /** Dispatch an AIO request to the kernel.
 @param[in,out]  slot            an already reserved slot
+@param[in]      submit          false to only queue the request when io_uring
+                                is used; it is then passed to the kernel by
+                                the next submit_all() or completion poll of
+                                the segment
 @return true on success. */
-bool AIO::linux_dispatch(Slot *slot) {
+bool AIO::linux_dispatch(Slot *slot, bool submit) {
   ut_a(slot->is_reserved);
   ut_ad(slot->type.validate());
 
+#ifdef LINUX_IO_URING
+  if (srv_use_io_uring) {
+    acquire();
+    const bool queued = uring_queue(slot);
+    release();
+
+    if (!queued) {
+      errno = EAGAIN;
+      return (false);
+    }
+
+    if (!submit) {
+      return (true);
+    }
+
+    /* Submit outside the array mutex. This also submits whatever other
+    threads queued on the same ring in the meantime. */
+    const ulint segment = (slot->pos * m_n_segments) / m_slots.size();
+    const int ret = m_urings[segment].submit();
+
+    /* -EAGAIN and -EBUSY leave the request queued, and the I/O handler
+    thread of the segment submits it on its next poll. */
+    if (ret < 0 && ret != -EAGAIN && ret != -EBUSY) {
+      errno = -ret;
+      return (false);
+    }
+
+    return (true);
+  }
+#endif /* LINUX_IO_URING */
+
+#ifdef LINUX_NATIVE_AIO
   /* Find out what we are going to work with.
   The iocb struct is directly in the slot.
   The io_context is one per segment. */
@@ -2563,7 +3052,105 @@ bool AIO::linux_dispatch(Slot *slot) {
   }
 
   return (ret == 1);
+#else  /* LINUX_NATIVE_AIO */
+  ut_error;
+#endif /* LINUX_NATIVE_AIO */
+}
+
+#ifdef LINUX_IO_URING
+/** Queue an AIO request on the io_uring of the slot's segment.
+@param[in,out]  slot            an already reserved slot
+@return true on success. */
+bool AIO::uring_queue(Slot *slot) {
+  ut_ad(is_mutex_owned());
+  ut_a(slot->is_reserved);
+
+  const ulint segment = (slot->pos * m_n_segments) / m_slots.size();
+
+  /* A ring has as many submission queue entries as its segment has
+  slots, so it can only be full if the kernel refused earlier entries. */
+  return (m_urings[segment].queue(
+      slot->type.is_read(), slot->file.m_file, slot->ptr,
+      static_cast<uint32_t>(slot->len), slot->offset, slot));
+}
+
+/** Pass the requests queued on the io_uring of every segment of every
+array to the kernel. */
+void AIO::uring_submit_all() {
+  for (auto array : {s_ibuf, s_reads, s_writes}) {
+    if (array == nullptr || array->m_urings == nullptr) {
+      continue;
+    }
+
+    for (ulint i = 0; i < array->m_n_segments; ++i) {
+      /* Errors leave the requests queued for the I/O handler thread. */
+      (void)array->m_urings[i].submit();
+    }
+  }
+}
+
+/** Checks if io_uring can be used for InnoDB files. Unlike libaio,
+io_uring falls back to worker threads for files that cannot be accessed
+asynchronously, so this only checks that a ring can be created and that a
+single I/O completes.
+@return true if supported, false otherwise. */
+bool AIO::is_io_uring_supported() {
+  Io_uring ring;
+
+  const int ret = ring.create(1);
+
+  if (ret < 0) {
+    ib::warn(ER_IB_MSG_761) << "io_uring_setup() returned error[" << -ret
+                            << "]. Linux 5.11 or newer is required for"
+                               " innodb_use_io_uring.";
+    return (false);
+  }
+
+  int fd;
+  const char *name;
+
+  if (!srv_read_only_mode) {
+    fd = innobase_mysql_tmpfile(nullptr);
+    name = "tmpdir";
+  } else {
+    name = srv_sys_space.first_datafile()->filepath();
+    fd = ::open(name, O_RDONLY);
+  }
+
+  if (fd < 0) {
+    ib::warn(ER_IB_MSG_763) << "Unable to open " << name
+                            << " to check io_uring support.";
+    return (false);
+  }
+
+  byte *buf =
+      static_cast<byte *>(ut::aligned_zalloc(UNIV_PAGE_SIZE, UNIV_PAGE_SIZE));
+
+  const uint32_t len = srv_read_only_mode ? 512 : UNIV_PAGE_SIZE;
+
+  int64_t res = -EIO;
+
+  if (ring.queue(srv_read_only_mode, fd, buf, len, 0, buf) &&
+      ring.submit_and_wait(OS_AIO_REAP_TIMEOUT * 10) >= 0) {
+    ring.reap([&](const io_uring_cqe &cqe) { res = cqe.res; });
+  }
+
+  ut::aligned_free(buf);
+  close(fd);
+
+  if (res != len) {
+    ib::error(ER_IB_MSG_766) << "Linux io_uring check on " << name
+                             << " returned error[" << -res << "]";
+    return (false);
+  }
+
+  return (true);
 }
+#endif /* LINUX_IO_URING */
+
+#endif /* LINUX_NATIVE_AIO || LINUX_IO_URING */
+
+#ifdef LINUX_NATIVE_AIO
 
 /** Creates an io_context for native linux AIO.
 @param[in]      max_events      number of events
@@ -5908,15 +6495,15 @@ dberr_t os_aio_handler(ulint segment, fil_node_t **m1, void **m2,
 
     err = os_aio_windows_handler(segment, m1, m2, request);
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 
     err = os_aio_linux_handler(segment, m1, m2, request);
-#else /* !_WIN32 && !LINUX_NATIVE_AIO */
+#else /* !_WIN32 && !LINUX_NATIVE_AIO && !LINUX_IO_URING */
     ut_error;
 
     err = DB_ERROR; /* Eliminate compiler warning */
 
-#endif /* !_WIN32 && !LINUX_NATIVE_AIO */
+#endif /* !_WIN32 && !LINUX_NATIVE_AIO && !LINUX_IO_URING */
 
   } else {
     srv_set_io_thread_op_info(segment, "simulated aio handle");
@@ -5981,15 +6568,17 @@ dberr_t AIO::init_slots() {
 
     (*m_handles)[i] = over->hEvent;
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 
     slot.ret = 0;
 
     slot.n_bytes = 0;
 
+#ifdef LINUX_NATIVE_AIO
     memset(&slot.control, 0x0, sizeof(slot.control));
+#endif /* LINUX_NATIVE_AIO */
 
-#endif /* !_WIN32 && LINUX_NATIVE_AIO */
+#endif /* !_WIN32 && (LINUX_NATIVE_AIO || LINUX_IO_URING) */
   }
 
   return (DB_SUCCESS);
@@ -6029,6 +6618,30 @@ dberr_t AIO::init_linux_native_aio() {
 }
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+/** Initialise one io_uring per segment */
+dberr_t AIO::init_io_uring() {
+  ut_a(m_urings == nullptr);
+
+  m_urings = ut::new_arr_withkey<Io_uring>(UT_NEW_THIS_FILE_PSI_KEY,
+                                           ut::Count{m_n_segments});
+
+  for (ulint i = 0; i < m_n_segments; ++i) {
+    const int ret =
+        m_urings[i].create(static_cast<uint32_t>(slots_per_segment()));
+
+    if (ret < 0) {
+      ib::error(ER_IB_MSG_761)
+          << "io_uring_setup() returned error[" << -ret << "]";
+
+      return (DB_IO_ERROR);
+    }
+  }
+
+  return (DB_SUCCESS);
+}
+#endif /* LINUX_IO_URING */
+
 /** Initialise the array */
 dberr_t AIO::init() {
   ut_a(!m_slots.empty());
@@ -6041,6 +6654,18 @@ dberr_t AIO::init() {
 #endif /* _WIN32 */
 
   if (srv_use_native_aio) {
+#ifdef LINUX_IO_URING
+    if (srv_use_io_uring) {
+      dberr_t err = init_io_uring();
+
+      if (err != DB_SUCCESS) {
+        return (err);
+      }
+
+      return (init_slots());
+    }
+#endif /* LINUX_IO_URING */
+
 #ifdef LINUX_NATIVE_AIO
     dberr_t err = init_linux_native_aio();
 
@@ -6105,13 +6730,33 @@ AIO::~AIO() {
   }
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+  if (m_urings != nullptr) {
+    ut::delete_arr(m_urings);
+  }
+#endif /* LINUX_IO_URING */
+
   m_slots.clear();
 }
 
 bool AIO::start(ulint n_per_seg, ulint n_readers, ulint n_writers) {
+#ifdef LINUX_IO_URING
+  if (srv_use_native_aio && srv_use_io_uring && !is_io_uring_supported()) {
+    ib::warn(ER_IB_MSG_829) << "Linux io_uring disabled.";
+
+    srv_use_io_uring = false;
+
+#ifndef LINUX_NATIVE_AIO
+    /* There is no other native AIO interface to fall back to. */
+    srv_use_native_aio = false;
+#endif /* !LINUX_NATIVE_AIO */
+  }
+#endif /* LINUX_IO_URING */
+
 #if defined(LINUX_NATIVE_AIO)
   /* Check if native aio is supported on this system and tmpfs */
-  if (srv_use_native_aio && !is_linux_native_aio_supported()) {
+  if (srv_use_native_aio && !srv_use_io_uring &&
+      !is_linux_native_aio_supported()) {
     ib::warn(ER_IB_MSG_829) << "Linux Native AIO disabled.";
 
     srv_use_native_aio = false;
@@ -6419,18 +7064,18 @@ void os_aio_wake_all_threads_at_shutdown() {
 
   AIO::wake_at_shutdown();
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 
   /* When using native AIO interface the io helper threads
-  wait on io_getevents with a timeout value of 500ms. At
-  each wake up these threads check the server status.
-  No need to do anything to wake them up. */
+  wait on io_getevents or io_uring_enter with a timeout value
+  of 500ms. At each wake up these threads check the server
+  status. No need to do anything to wake them up. */
 
   if (srv_use_native_aio) {
     return;
   }
 
-#endif /* !_WIN32 && LINUX_NATIVE_AIO */
+#endif /* !_WIN32 && (LINUX_NATIVE_AIO || LINUX_IO_URING) */
 
   /* Fall through to simulated AIO handler wakeup if we are
   not using native AIO. */
@@ -6670,7 +7315,7 @@ Slot *AIO::reserve_slot(IORequest &type, fil_node_t *m1, void *m2,
 
     ResetEvent(slot->handle);
   }
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 
   /* If we are not using native AIO skip this part. */
   if (srv_use_native_aio) {
@@ -6683,21 +7328,27 @@ Slot *AIO::reserve_slot(IORequest &type, fil_node_t *m1, void *m2,
     ut_a(sizeof(aio_offset) >= sizeof(offset) ||
          ((os_offset_t)aio_offset) == offset);
 
-    auto iocb = &slot->control;
+#ifdef LINUX_NATIVE_AIO
+    /* With io_uring the submission queue entry is written from the slot
+    when the request is dispatched. */
+    if (!srv_use_io_uring) {
+      auto iocb = &slot->control;
 
-    if (type.is_read()) {
-      io_prep_pread(iocb, file.m_file, slot->ptr, slot->len, aio_offset);
-    } else {
-      ut_ad(type.is_write());
-      io_prep_pwrite(iocb, file.m_file, slot->ptr, slot->len, aio_offset);
-    }
+      if (type.is_read()) {
+        io_prep_pread(iocb, file.m_file, slot->ptr, slot->len, aio_offset);
+      } else {
+        ut_ad(type.is_write());
+        io_prep_pwrite(iocb, file.m_file, slot->ptr, slot->len, aio_offset);
+      }
 
-    iocb->data = slot;
+      iocb->data = slot;
+    }
+#endif /* LINUX_NATIVE_AIO */
 
     slot->n_bytes = 0;
     slot->ret = 0;
   }
-#endif /* !_WIN32 && LINUX_NATIVE_AIO */
+#endif /* !_WIN32 && (LINUX_NATIVE_AIO || LINUX_IO_URING) */
 
   release();
 
@@ -6750,6 +7401,14 @@ void AIO::wake_simulated_handler_thread(ulint global_segment, ulint segment) {
 /** Wakes up simulated aio i/o-handler threads if they have something to do. */
 void os_aio_simulated_wake_handler_threads() {
   if (srv_use_native_aio) {
+#ifdef LINUX_IO_URING
+    /* Requests made with IORequest::DO_NOT_WAKE are only queued on the
+    io_uring submission queues: pass the whole batch to the kernel. */
+    if (srv_use_io_uring) {
+      AIO::uring_submit_all();
+    }
+#endif /* LINUX_IO_URING */
+
     /* We do not use simulated aio: do nothing */
 
     return;
@@ -6984,11 +7643,11 @@ try_again:
 #ifdef _WIN32
       ret = ReadFile(file.m_file, slot->ptr, slot->len, &slot->n_bytes,
                      &slot->control);
-#elif defined(LINUX_NATIVE_AIO)
-      if (!array->linux_dispatch(slot)) {
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+      if (!array->linux_dispatch(slot, type.is_wake())) {
         goto err_exit;
       }
-#endif /* !_WIN32 && LINUX_NATIVE_AIO */
+#endif /* !_WIN32 && (LINUX_NATIVE_AIO || LINUX_IO_URING) */
     } else if (type.is_wake()) {
       AIO::wake_simulated_handler_thread(
           AIO::get_segment_no_from_slot(array, slot));
@@ -7000,11 +7659,11 @@ try_again:
 #ifdef _WIN32
       ret = WriteFile(file.m_file, slot->ptr, slot->len, &slot->n_bytes,
                       &slot->control);
-#elif defined(LINUX_NATIVE_AIO)
-      if (!array->linux_dispatch(slot)) {
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+      if (!array->linux_dispatch(slot, type.is_wake())) {
         goto err_exit;
       }
-#endif /* !_WIN32 && LINUX_NATIVE_AIO */
+#endif /* !_WIN32 && (LINUX_NATIVE_AIO || LINUX_IO_URING) */
 
     } else if (type.is_wake()) {
       AIO::wake_simulated_handler_thread(
@@ -7026,9 +7685,9 @@ try_again:
   /* AIO request was queued successfully! */
   return (DB_SUCCESS);
 
-#if defined LINUX_NATIVE_AIO || defined _WIN32
+#if defined LINUX_NATIVE_AIO || defined LINUX_IO_URING || defined _WIN32
 err_exit:
-#endif /* LINUX_NATIVE_AIO || _WIN32 */
+#endif /* LINUX_NATIVE_AIO || LINUX_IO_URING || _WIN32 */
 
   array->release_with_mutex(slot);
   if (os_file_handle_error(name, type.is_read() ? "aio read" : "aio write")) {
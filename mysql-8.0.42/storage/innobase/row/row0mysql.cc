@@ -154,6 +154,30 @@ void row_mysql_prebuilt_free_blob_heap(row_prebuilt_t *prebuilt) {
   prebuilt->blob_heap = nullptr;
 }
 
+void row_mysql_prebuilt_free_fetch_cache(row_prebuilt_t *prebuilt) {
+  byte *ptr = prebuilt->fetch_cache;
+
+  for (ulint i = 0; i < prebuilt->fetch_cache_capacity; i++) {
+    ulint magic1 = mach_read_from_4(ptr);
+    ut_a(magic1 == ROW_PREBUILT_FETCH_MAGIC_N);
+    ptr += 4;
+
+    byte *row = ptr;
+    ut_a(row == prebuilt->fetch_cache_row(i));
+    ptr += prebuilt->mysql_row_len;
+
+    ulint magic2 = mach_read_from_4(ptr);
+    ut_a(magic2 == ROW_PREBUILT_FETCH_MAGIC_N);
+    ptr += 4;
+  }
+
+  ut::free(prebuilt->fetch_cache);
+  prebuilt->fetch_cache = nullptr;
+  prebuilt->fetch_cache_capacity = 0;
+  prebuilt->n_fetch_cached = 0;
+  prebuilt->fetch_cache_first = 0;
+}
+
 /** Stores a >= 5.0.3 format true VARCHAR length to dest, in the MySQL row
  format.
  @return pointer to the data, we skip the 1 or 2 bytes at the start
@@ -911,6 +935,7 @@ row_prebuilt_t *row_create_prebuilt(
   prebuilt->fts_doc_id = 0;
 
   prebuilt->mysql_row_len = mysql_row_len;
+  prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
 
   prebuilt->ins_sel_stmt = false;
   prebuilt->session = nullptr;
@@ -968,25 +993,8 @@ void row_prebuilt_free(row_prebuilt_t *prebuilt, bool dict_locked) {
     mem_heap_free(prebuilt->old_vers_heap);
   }
 
-  if (prebuilt->fetch_cache[0] != nullptr) {
-    byte *base = prebuilt->fetch_cache[0] - 4;
-    byte *ptr = base;
-
-    for (ulint i = 0; i < MYSQL_FETCH_CACHE_SIZE; i++) {
-      ulint magic1 = mach_read_from_4(ptr);
-      ut_a(magic1 == ROW_PREBUILT_FETCH_MAGIC_N);
-      ptr += 4;
-
-      byte *row = ptr;
-      ut_a(row == prebuilt->fetch_cache[i]);
-      ptr += prebuilt->mysql_row_len;
-
-      ulint magic2 = mach_read_from_4(ptr);
-      ut_a(magic2 == ROW_PREBUILT_FETCH_MAGIC_N);
-      ptr += 4;
-    }
-
-    ut::free(base);
+  if (prebuilt->fetch_cache != nullptr) {
+    row_mysql_prebuilt_free_fetch_cache(prebuilt);
   }
 
   if (prebuilt->rtr_info) {
@@ -1105,6 +1113,8 @@ static inline void row_update_statistics_if_needed(
   uint64_t counter;
   uint64_t n_rows;
 
+  table->stat_n_rows_modified++;
+
   if (!table->stat_initialized) {
     DBUG_EXECUTE_IF("test_upd_stats_if_needed_not_inited",
                     fprintf(stderr,
@@ -3576,7 +3576,7 @@ static inline void row_sel_dequeue_cached_row_for_mysql(
   const auto record_buffer = row_sel_get_record_buffer(prebuilt);
   cached_rec = record_buffer
                    ? record_buffer->record(prebuilt->fetch_cache_first)
-                   : prebuilt->fetch_cache[prebuilt->fetch_cache_first];
+                   : prebuilt->fetch_cache_row(prebuilt->fetch_cache_first);
 
   if (UNIV_UNLIKELY(prebuilt->keep_other_fields_on_keyread)) {
     row_sel_copy_cached_fields_for_mysql(buf, cached_rec, prebuilt);
@@ -3627,7 +3627,9 @@ static inline void row_sel_dequeue_cached_row_for_mysql(
   }
 }
 
-/** Initialise the prefetch cache. */
+/** Initialise the prefetch cache, so that it has room for
+prebuilt->fetch_cache_limit rows. Any smaller cache that was allocated for
+an earlier batch is freed; it must be empty. */
 static inline void row_sel_prefetch_cache_init(
     row_prebuilt_t *prebuilt) /*!< in/out: prebuilt struct */
 {
@@ -3638,12 +3640,20 @@ static inline void row_sel_prefetch_cache_init(
   /* We use our own prefetch cache only if the server didn't
   provide one. */
   ut_ad(row_sel_get_record_buffer(prebuilt) == nullptr);
+  ut_ad(prebuilt->n_fetch_cached == 0);
+
+  if (prebuilt->fetch_cache != nullptr) {
+    row_mysql_prebuilt_free_fetch_cache(prebuilt);
+  }
 
   /* Reserve space for the magic number. */
-  sz = UT_ARR_SIZE(prebuilt->fetch_cache) * (prebuilt->mysql_row_len + 8);
+  sz = prebuilt->fetch_cache_limit * (prebuilt->mysql_row_len + 8);
   ptr = static_cast<byte *>(ut::malloc_withkey(UT_NEW_THIS_FILE_PSI_KEY, sz));
 
-  for (i = 0; i < UT_ARR_SIZE(prebuilt->fetch_cache); i++) {
+  prebuilt->fetch_cache = ptr;
+  prebuilt->fetch_cache_capacity = prebuilt->fetch_cache_limit;
+
+  for (i = 0; i < prebuilt->fetch_cache_capacity; i++) {
     /* A user has reported memory corruption in these
     buffers in Linux. Put magic numbers there to help
     to track a possible bug. */
@@ -3651,7 +3661,7 @@ static inline void row_sel_prefetch_cache_init(
     mach_write_to_4(ptr, ROW_PREBUILT_FETCH_MAGIC_N);
     ptr += 4;
 
-    prebuilt->fetch_cache[i] = ptr;
+    ut_ad(ptr == prebuilt->fetch_cache_row(i));
     ptr += prebuilt->mysql_row_len;
 
     mach_write_to_4(ptr, ROW_PREBUILT_FETCH_MAGIC_N);
@@ -3668,14 +3678,17 @@ static inline byte *row_sel_fetch_last_buf(
 
   ut_ad(!prebuilt->templ_contains_blob);
   if (record_buffer == nullptr) {
-    ut_ad(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+    ut_ad(prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit);
   } else {
     ut_ad(prebuilt->mysql_prefix_len <= record_buffer->record_size());
     ut_ad(record_buffer->records() == prebuilt->n_fetch_cached);
   }
 
-  if (record_buffer == nullptr && prebuilt->fetch_cache[0] == nullptr) {
-    /* Allocate memory for the fetch cache */
+  if (record_buffer == nullptr &&
+      prebuilt->fetch_cache_capacity < prebuilt->fetch_cache_limit) {
+    /* Allocate memory for the fetch cache, or make room for a
+    larger batch than the previous one. This happens only at the
+    start of a batch, when the cache is empty. */
     ut_ad(prebuilt->n_fetch_cached == 0);
 
     row_sel_prefetch_cache_init(prebuilt);
@@ -3683,8 +3696,9 @@ static inline byte *row_sel_fetch_last_buf(
 
   /* Use the server-provided buffer if there is one. Otherwise,
   use our own prefetch buffer. */
-  byte *buf = record_buffer ? record_buffer->add_record()
-                            : prebuilt->fetch_cache[prebuilt->n_fetch_cached];
+  byte *buf = record_buffer
+                  ? record_buffer->add_record()
+                  : prebuilt->fetch_cache_row(prebuilt->n_fetch_cached);
 
   ut_ad(prebuilt->fetch_cache_first == 0);
   UNIV_MEM_INVALID(buf, record_buffer ? record_buffer->record_size()
@@ -4531,6 +4545,7 @@ dberr_t row_search_mvcc(byte *buf, page_cur_mode_t mode,
     prebuilt->n_rows_fetched = 0;
     prebuilt->n_fetch_cached = 0;
     prebuilt->fetch_cache_first = 0;
+    prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
     prebuilt->m_end_range = false;
     if (record_buffer != nullptr) {
       record_buffer->reset();
@@ -4559,6 +4574,7 @@ dberr_t row_search_mvcc(byte *buf, page_cur_mode_t mode,
       prebuilt->n_rows_fetched = 0;
       prebuilt->n_fetch_cached = 0;
       prebuilt->fetch_cache_first = 0;
+      prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
       prebuilt->m_end_range = false;
 
       /* A record buffer is not used for scroll cursors.
@@ -5607,8 +5623,9 @@ rec_loop:
     not cache rows because there the cursor is a scrollable
     cursor. */
 
-    const auto max_rows_to_cache =
-        record_buffer ? record_buffer->max_records() : MYSQL_FETCH_CACHE_SIZE;
+    const auto max_rows_to_cache = record_buffer
+                                       ? record_buffer->max_records()
+                                       : prebuilt->fetch_cache_limit;
     ut_a(prebuilt->n_fetch_cached < max_rows_to_cache);
 
     /* We only convert from InnoDB row format to MySQL row
@@ -5690,6 +5707,17 @@ rec_loop:
         }
       }
 
+      if (prebuilt->runtime_filter &&
+          !innobase_runtime_filter(prebuilt->m_mysql_handler, next_buf)) {
+        /* The server has no use for this record. Let the
+        next record take its place in the buffer. */
+        if (next_buf != buf && record_buffer != nullptr) {
+          record_buffer->remove_last();
+        }
+        next_buf = prev_buf;
+        goto next_rec;
+      }
+
       if (next_buf != buf) {
         row_sel_enqueue_cache_row_for_mysql(next_buf, prebuilt);
       }
@@ -5701,6 +5729,13 @@ rec_loop:
       goto next_rec;
     }
 
+    if (record_buffer == nullptr) {
+      /* The scan has gone on for a full batch, so it is likely
+      to go on for longer. Fetch more rows per cursor restore in
+      the next batch. */
+      prebuilt->grow_fetch_cache_limit();
+    }
+
   } else {
     /* We cannot use a record buffer for this scan, so assert that
     we don't have one. If we have a record buffer here,
@@ -5738,6 +5773,11 @@ rec_loop:
         happens at a lower level, not here. */
         goto next_rec;
       }
+
+      if (prebuilt->runtime_filter &&
+          !innobase_runtime_filter(prebuilt->m_mysql_handler, buf)) {
+        goto next_rec;
+      }
     }
 
     if (prebuilt->clust_index_was_generated) {
@@ -212,11 +212,18 @@ bool high_level_read_only;
 /** Number of threads to use for parallel reads. */
 ulong srv_parallel_read_threads;
 
+/** Number of threads that apply redo log records during crash recovery. */
+ulong srv_n_recovery_apply_threads;
+
 /** If this flag is true, then we will use the native aio of the
 OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads. */
 bool srv_use_native_aio = false;
 
+/** If this flag and srv_use_native_aio are true, then on Linux we will use
+io_uring instead of libaio. */
+bool srv_use_io_uring = false;
+
 bool srv_numa_interleave = false;
 
 #ifdef UNIV_DEBUG
@@ -458,6 +465,13 @@ ulint srv_buf_pool_base_size = 0;
 long long srv_buf_pool_curr_size = 0;
 /** Dump this % of each buffer pool during BP dump */
 ulong srv_buf_pool_dump_pct;
+/** Number of threads that read pages in during BP load */
+ulong srv_buf_pool_load_threads;
+/** Count page accesses and reads per index, see buf_stat_per_index_t */
+bool srv_buf_pool_index_stats = false;
+/** Let index searches buffer-fix the guessed root page, if it is already
+buffer-fixed by other threads, without acquiring the page hash latch */
+bool srv_buf_pool_root_guess_fast_path = false;
 /** Lock table size in bytes */
 ulint srv_lock_table_size = ULINT_MAX;
 
@@ -113,6 +113,11 @@ class Column {
       /** [in] Length of the row buffer. */
       size_t mysql_row_length) const;
 
+  /** Get the length of the user data of the cells, if all cells of this
+   * column are the same size.
+   * @return user data length, or 0 if the cells can have different sizes */
+  uint32_t fixed_size() const;
+
  private:
   /** Check if the cells in this column can be NULL.
    * @return true if cells are allowed to be NULL. */
@@ -256,6 +261,10 @@ inline void Column::write_is_null(bool is_null, unsigned char *mysql_row,
 
 inline bool Column::is_fixed_size() const { return m_length_bytes_size == 0; }
 
+inline uint32_t Column::fixed_size() const {
+  return is_fixed_size() ? m_length : 0;
+}
+
 inline uint32_t Column::read_user_data_length(
     const unsigned char *mysql_row) const {
   if (m_length_bytes_size == 0) {
@@ -0,0 +1,269 @@
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License, version 2.0, as published by the
+Free Software Foundation.
+
+This program is designed to work with certain software (including
+but not limited to OpenSSL) that is licensed under separate terms,
+as designated in a particular file or component or in included license
+documentation.  The authors of MySQL hereby grant you an additional
+permission to link the program and your derivative works with the
+separately licensed software that they have either included with
+the program or referenced in the documentation.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License, version 2.0,
+for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/** @file storage/temptable/include/temptable/column_store.h
+TempTable Column_store declaration. */
+
+#ifndef TEMPTABLE_COLUMN_STORE_H
+#define TEMPTABLE_COLUMN_STORE_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "storage/temptable/include/temptable/allocator.h"
+
+namespace temptable {
+
+/** The values of one column of a table that is stored column by column (see
+ * `temptable_use_columnar_storage`). Values are appended, and addressed by
+ * their row number, which is the number of values appended before them.
+ *
+ * As long as the column has few distinct values, each distinct value is
+ * stored once, and the rows hold 16-bit codes into that dictionary. The codes
+ * are kept in segments of `ROWS_PER_SEGMENT` rows, and a full segment is
+ * sealed into the smallest of three encodings: one byte per row, two bytes
+ * per row, or runs of equal codes. If the dictionary fills up, or turns out
+ * not to pay off, the rest of the column is stored plain.
+ *
+ * Values never move once they are stored, and are not freed before clear(),
+ * so the pointers returned by get() (which the handler hands out as BLOB
+ * pointers) stay valid while the table is written to. All memory comes from
+ * the allocator of the table, so it counts against the size limits of the
+ * table. */
+class Column_store {
+ public:
+  /** Constructor. */
+  Column_store(
+      /** [in] Length of the values if they all have the same length, or 0. */
+      uint32_t fixed_length,
+      /** [in] Allocator to use for all the memory of the column. */
+      Allocator<uint8_t> *allocator);
+
+  Column_store(const Column_store &) = delete;
+  Column_store &operator=(const Column_store &) = delete;
+
+  Column_store(Column_store &&other) noexcept;
+  Column_store &operator=(Column_store &&) = delete;
+
+  ~Column_store();
+
+  /** Append a value. If an exception is thrown, no value is appended.
+   * @return the row number of the value */
+  size_t append(
+      /** [in] The value. Must be `fixed_length` bytes for fixed-length
+       * columns. */
+      const unsigned char *data,
+      /** [in] Length of the value. */
+      uint32_t length);
+
+  /** Take away the last value appended. Its memory is not reused. */
+  void remove_last();
+
+  /** Get a value. */
+  void get(
+      /** [in] Row number of the value. */
+      size_t row,
+      /** [out] The value, which stays valid until clear() is called. */
+      const unsigned char **data,
+      /** [out] Length of the value. */
+      uint32_t *length) const;
+
+  /** @return the number of values in the column */
+  size_t size() const;
+
+  /** Remove all values, and free their memory. */
+  void clear();
+
+  /** Number of rows in each segment of dictionary codes. */
+  static constexpr size_t ROWS_PER_SEGMENT = 4096;
+
+  /** The largest number of distinct values kept in the dictionary. */
+  static constexpr size_t MAX_DICTIONARY_SIZE = 1 << 16;
+
+ private:
+  /** How the codes of a sealed segment are stored. */
+  enum class Encoding : uint8_t {
+    /** One byte per row. */
+    CODES_8,
+    /** Two bytes per row. */
+    CODES_16,
+    /** An array of `Run`. */
+    RUNS,
+  };
+
+  /** Rows of a segment that have the same code. */
+  struct Run {
+    /** One past the last row of the run, counting from the segment start. */
+    uint16_t m_end;
+
+    uint16_t m_code;
+  };
+
+  struct Segment {
+    uint8_t *m_data;
+
+    size_t m_data_size;
+
+    uint32_t m_number_of_runs;
+
+    Encoding m_encoding;
+  };
+
+  using Dictionary = std::unordered_map<
+      std::string_view, uint16_t, std::hash<std::string_view>,
+      std::equal_to<std::string_view>,
+      Allocator<std::pair<const std::string_view, uint16_t>>>;
+
+  /** Allocate memory that is not freed before clear().
+   * @return the memory */
+  uint8_t *allocate(size_t size);
+
+  /** Copy a value to memory that is not freed before clear(). Variable-length
+   * values are prefixed with their length.
+   * @return the copy */
+  const uint8_t *store_value(const unsigned char *data, uint32_t length);
+
+  /** Read a value copied by store_value(). */
+  void read_value(const uint8_t *value, const unsigned char **data,
+                  uint32_t *length) const;
+
+  /** Append a value in dictionary-encoded form. */
+  void append_to_dictionary(const unsigned char *data, uint32_t length);
+
+  /** Append a value in plain form. */
+  void append_plain(const unsigned char *data, uint32_t length);
+
+  /** Check if the rows stored so far take up less memory with the
+   * dictionary than they would if they were stored plain.
+   * @return true if the dictionary should be kept for the next rows */
+  bool dictionary_pays_off() const;
+
+  /** Encode the open segment of codes and start a new one. */
+  void seal_open_segment();
+
+  /** Stop adding to the dictionary, and store the rest of the column plain. */
+  void switch_to_plain();
+
+  uint16_t code(size_t row) const;
+
+  const uint32_t m_fixed_length;
+
+  Allocator<uint8_t> *m_allocator;
+
+  /** Memory holding the values, as (pointer, size) pairs. */
+  std::vector<std::pair<uint8_t *, size_t>,
+              Allocator<std::pair<uint8_t *, size_t>>>
+      m_chunks;
+
+  /** Unused bytes at the end of the last element of `m_chunks`. */
+  size_t m_chunk_free;
+
+  size_t m_number_of_rows;
+
+  /** Rows from this one on are stored plain. */
+  size_t m_first_plain_row;
+
+  /** Total length of the values of the rows that are not stored plain. */
+  size_t m_value_bytes;
+
+  /** Total length of the values in the dictionary. */
+  size_t m_dictionary_value_bytes;
+
+  /** The distinct values, indexed by their code. */
+  std::vector<const uint8_t *, Allocator<const uint8_t *>> m_dictionary_values;
+
+  /** Lookup of the codes of the distinct values, while the dictionary grows. */
+  Dictionary m_dictionary;
+
+  std::vector<Segment, Allocator<Segment>> m_segments;
+
+  /** The codes of the rows after the last sealed segment. Once it reaches
+   * `ROWS_PER_SEGMENT` elements, it keeps its capacity. */
+  std::vector<uint16_t, Allocator<uint16_t>> m_open_codes;
+
+  /** Values of the plain rows. For fixed-length columns, the values are kept
+   * back to back, `PLAIN_VALUES_PER_ARRAY` in each array. For variable-length
+   * columns, each array element points to one value. */
+  std::vector<const uint8_t *, Allocator<const uint8_t *>> m_plain;
+
+  /** Number of fixed-length values in each element of `m_plain`. */
+  static constexpr size_t PLAIN_VALUES_PER_ARRAY = 1024;
+
+  /** Size of the first element of `m_chunks`. Each next one is twice as
+   * large, up to `CHUNK_SIZE`, unless a larger one is needed. */
+  static constexpr size_t MIN_CHUNK_SIZE = 1024;
+
+  /** Largest size of the elements of `m_chunks`, unless a larger one is
+   * needed. */
+  static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+  /** Number of doublings from `MIN_CHUNK_SIZE` to `CHUNK_SIZE`. */
+  static constexpr size_t MAX_CHUNK_SIZE_SHIFT = 6;
+  static_assert(MIN_CHUNK_SIZE << MAX_CHUNK_SIZE_SHIFT == CHUNK_SIZE);
+};
+
+/* Implementation of inlined methods. */
+
+inline size_t Column_store::size() const { return m_number_of_rows; }
+
+inline void Column_store::read_value(const uint8_t *value,
+                                     const unsigned char **data,
+                                     uint32_t *length) const {
+  if (m_fixed_length > 0) {
+    *data = value;
+    *length = m_fixed_length;
+  } else {
+    memcpy(length, value, sizeof(*length));
+    *data = value + sizeof(*length);
+  }
+}
+
+inline void Column_store::get(size_t row, const unsigned char **data,
+                              uint32_t *length) const {
+  assert(row < m_number_of_rows);
+
+  if (row < m_first_plain_row) {
+    read_value(m_dictionary_values[code(row)], data, length);
+    return;
+  }
+
+  const size_t plain_row = row - m_first_plain_row;
+  if (m_fixed_length > 0) {
+    *data = m_plain[plain_row / PLAIN_VALUES_PER_ARRAY] +
+            plain_row % PLAIN_VALUES_PER_ARRAY * m_fixed_length;
+    *length = m_fixed_length;
+  } else {
+    read_value(m_plain[plain_row], data, length);
+  }
+}
+
+} /* namespace temptable */
+
+#endif /* TEMPTABLE_COLUMN_STORE_H */
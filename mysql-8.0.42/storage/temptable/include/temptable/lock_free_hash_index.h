@@ -0,0 +1,309 @@
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License, version 2.0, as published by the
+Free Software Foundation.
+
+This program is designed to work with certain software (including
+but not limited to OpenSSL) that is licensed under separate terms,
+as designated in a particular file or component or in included license
+documentation.  The authors of MySQL hereby grant you an additional
+permission to link the program and your derivative works with the
+separately licensed software that they have either included with
+the program or referenced in the documentation.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License, version 2.0,
+for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/** @file storage/temptable/include/temptable/lock_free_hash_index.h
+Lock-free hash index which can be populated by several threads at once. */
+
+#ifndef TEMPTABLE_LOCK_FREE_HASH_INDEX_H
+#define TEMPTABLE_LOCK_FREE_HASH_INDEX_H
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+
+#include "storage/temptable/include/temptable/allocator.h"
+#include "storage/temptable/include/temptable/lock_free_type.h"
+#include "storage/temptable/include/temptable/result.h"
+
+namespace temptable {
+
+/** Unique hash index which several threads can insert into, and look up in,
+ * at the same time, without taking any locks. This is the building block for
+ * deduplicating the rows of a materialization (e.g. DISTINCT or GROUP BY)
+ * that is filled by several worker threads: each worker inserts a pointer to
+ * its row, and learns atomically whether it was the first one with that key.
+ *
+ * The index is an open-addressing hash table with linear probing and a fixed
+ * number of slots, chosen at construction time. Each slot consists of two
+ * lock-free atomics (see Lock_free_type): the hash of the key and a pointer
+ * to the entry which holds the key. An insert claims an empty slot by a
+ * compare-and-swap of the hash, and then publishes the entry pointer.
+ * Entries with equal keys have equal hashes and follow the same probe
+ * sequence, and slots are never emptied while the index is in use, so two
+ * threads can never both insert the same key. A thread that finds a slot
+ * with the hash it is looking for, but no entry yet, waits for the thread
+ * that claimed the slot to publish it, which that thread does right away.
+ *
+ * Entries cannot be removed one by one, and the index does not grow: when
+ * it holds `max_entries` entries, insert() returns Result::RECORD_FILE_FULL
+ * (threads inserting at the same time may each add one more entry first),
+ * like a TempTable table that has hit its size limit, so that the caller
+ * can fall back to an on-disk table. The slot array is allocated once, by
+ * the constructor, so the (single-threaded) TempTable allocator is never used
+ * concurrently.
+ *
+ * @tparam T Type of the entries. The index only stores pointers to them.
+ * @tparam Allocator_type Allocator to get the slot array from. */
+template <typename T, typename Allocator_type = Allocator<uint8_t>>
+class Lock_free_hash_index {
+ public:
+  /** Constructor. Throws Result::OUT_OF_MEM or Result::RECORD_FILE_FULL (see
+   * Allocator::allocate()) if the slots cannot be allocated. */
+  Lock_free_hash_index(
+      /** [in] Number of entries the index must be able to hold. */
+      size_t max_entries,
+      /** [in] Allocator for the slot array. */
+      const Allocator_type &allocator);
+
+  Lock_free_hash_index(const Lock_free_hash_index &) = delete;
+  Lock_free_hash_index &operator=(const Lock_free_hash_index &) = delete;
+  Lock_free_hash_index(Lock_free_hash_index &&) = delete;
+  Lock_free_hash_index &operator=(Lock_free_hash_index &&) = delete;
+
+  /** Destructor. Does not touch the entries. */
+  ~Lock_free_hash_index();
+
+  /** Insert an entry, unless an entry with an equal key is already there. May
+   * be called by several threads at the same time, also concurrently with
+   * lookup().
+   * @retval Result::OK the entry was inserted
+   * @retval Result::FOUND_DUPP_KEY an entry with an equal key was already in
+   * the index, and `existing` was set to it
+   * @retval Result::RECORD_FILE_FULL the index holds `max_entries` entries,
+   * none with a key equal to that of `entry` */
+  template <typename Equal>
+  Result insert(
+      /** [in] Hash of the key of the entry. */
+      uint64_t hash,
+      /** [in] The entry to insert. Must not be nullptr, and must stay valid
+       * as long as the index is used. */
+      T *entry,
+      /** [in] Function which returns true if the keys of two entries, given
+       * as `const T &`, are equal. */
+      Equal equal,
+      /** [out] The entry with an equal key, if there was one. */
+      T **existing);
+
+  /** Find the entry with a given key. May be called by several threads at the
+   * same time, also concurrently with insert().
+   * @return the entry, or nullptr if there is none */
+  template <typename Matches>
+  T *lookup(
+      /** [in] Hash of the key to search for. */
+      uint64_t hash,
+      /** [in] Function which returns true if the key of an entry, given as
+       * `const T &`, is the one searched for. */
+      Matches matches) const;
+
+  /** @return the number of entries in the index */
+  size_t size() const;
+
+  /** Remove all entries. Must not be called concurrently with anything
+   * else. */
+  void clear();
+
+ private:
+  /** A slot of the hash table. A hash of 0 means that the slot is empty. */
+  struct Slot {
+    Lock_free_type<unsigned long long> m_hash;
+    Lock_free_type<T *> m_entry;
+  };
+
+  using Slot_allocator =
+      typename std::allocator_traits<Allocator_type>::template rebind_alloc<
+          Slot>;
+
+  /** Map the hash of a key to the value stored in a slot, which is never
+   * 0. */
+  static unsigned long long slot_hash(uint64_t hash);
+
+  /** Wait until the thread that claimed a slot has published its entry.
+   * @return the entry of the slot */
+  static T *wait_for_entry(const Slot &slot);
+
+  Slot_allocator m_allocator;
+
+  /** Number of slots, a power of 2. */
+  size_t m_number_of_slots;
+
+  size_t m_max_entries;
+
+  Slot *m_slots;
+
+  std::atomic<size_t> m_size;
+};
+
+/* Implementation of inlined methods. */
+
+template <typename T, typename Allocator_type>
+inline Lock_free_hash_index<T, Allocator_type>::Lock_free_hash_index(
+    size_t max_entries, const Allocator_type &allocator)
+    : m_allocator(allocator),
+      m_number_of_slots(2),
+      m_max_entries(max_entries),
+      m_slots(nullptr),
+      m_size(0) {
+  /* Keep the load factor at 3/4 at most, or probe sequences get long. */
+  while (m_number_of_slots / 4 * 3 < max_entries) {
+    m_number_of_slots *= 2;
+  }
+
+  m_slots = m_allocator.allocate(m_number_of_slots);
+  for (size_t i = 0; i < m_number_of_slots; ++i) {
+    Slot *slot = new (&m_slots[i]) Slot();
+    slot->m_hash.m_value.store(0, std::memory_order_relaxed);
+    slot->m_entry.m_value.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+template <typename T, typename Allocator_type>
+inline Lock_free_hash_index<T, Allocator_type>::~Lock_free_hash_index() {
+  for (size_t i = 0; i < m_number_of_slots; ++i) {
+    m_slots[i].~Slot();
+  }
+  m_allocator.deallocate(m_slots, m_number_of_slots);
+}
+
+template <typename T, typename Allocator_type>
+inline unsigned long long Lock_free_hash_index<T, Allocator_type>::slot_hash(
+    uint64_t hash) {
+  return hash == 0 ? 1 : hash;
+}
+
+template <typename T, typename Allocator_type>
+inline T *Lock_free_hash_index<T, Allocator_type>::wait_for_entry(
+    const Slot &slot) {
+  T *entry = slot.m_entry.m_value.load(std::memory_order_acquire);
+  while (entry == nullptr) {
+    std::this_thread::yield();
+    entry = slot.m_entry.m_value.load(std::memory_order_acquire);
+  }
+  return entry;
+}
+
+template <typename T, typename Allocator_type>
+template <typename Equal>
+inline Result Lock_free_hash_index<T, Allocator_type>::insert(uint64_t hash,
+                                                              T *entry,
+                                                              Equal equal,
+                                                              T **existing) {
+  assert(entry != nullptr);
+
+  const unsigned long long wanted = slot_hash(hash);
+  const size_t mask = m_number_of_slots - 1;
+
+  for (size_t i = hash & mask, probes = 0; probes < m_number_of_slots;
+       i = (i + 1) & mask, ++probes) {
+    Slot &slot = m_slots[i];
+    unsigned long long claimed =
+        slot.m_hash.m_value.load(std::memory_order_acquire);
+
+    if (claimed == 0) {
+      if (m_size.load(std::memory_order_acquire) < m_max_entries) {
+        if (slot.m_hash.m_value.compare_exchange_strong(
+                claimed, wanted, std::memory_order_acq_rel)) {
+          /* Only winners are counted, so several threads can get past the
+           * check above at once and overshoot `m_max_entries` by at most one
+           * entry per concurrent insert. */
+          m_size.fetch_add(1, std::memory_order_acq_rel);
+          slot.m_entry.m_value.store(entry, std::memory_order_release);
+          return Result::OK;
+        }
+        /* Another thread claimed the slot first, `claimed` now holds its
+         * hash. */
+      } else {
+        /* The index is full, unless another thread claimed this slot since it
+         * was read, possibly with an equal key. The count never goes down, so
+         * if the slot is still empty, the key is not in the index. */
+        claimed = slot.m_hash.m_value.load(std::memory_order_acquire);
+        if (claimed == 0) {
+          return Result::RECORD_FILE_FULL;
+        }
+      }
+    }
+
+    if (claimed == wanted) {
+      T *slot_entry = wait_for_entry(slot);
+      if (equal(static_cast<const T &>(*slot_entry),
+                static_cast<const T &>(*entry))) {
+        *existing = slot_entry;
+        return Result::FOUND_DUPP_KEY;
+      }
+    }
+  }
+
+  /* The overshoot has taken every slot. */
+  return Result::RECORD_FILE_FULL;
+}
+
+template <typename T, typename Allocator_type>
+template <typename Matches>
+inline T *Lock_free_hash_index<T, Allocator_type>::lookup(
+    uint64_t hash, Matches matches) const {
+  const unsigned long long wanted = slot_hash(hash);
+  const size_t mask = m_number_of_slots - 1;
+
+  /* An empty slot ends the search. There is nearly always one, but
+   * concurrent inserts may overshoot `m_max_entries`, so bound the search. */
+  for (size_t i = hash & mask, probes = 0; probes < m_number_of_slots;
+       i = (i + 1) & mask, ++probes) {
+    const Slot &slot = m_slots[i];
+    const unsigned long long claimed =
+        slot.m_hash.m_value.load(std::memory_order_acquire);
+
+    if (claimed == 0) {
+      return nullptr;
+    }
+
+    if (claimed == wanted) {
+      T *slot_entry = wait_for_entry(slot);
+      if (matches(static_cast<const T &>(*slot_entry))) {
+        return slot_entry;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+template <typename T, typename Allocator_type>
+inline size_t Lock_free_hash_index<T, Allocator_type>::size() const {
+  return m_size.load(std::memory_order_acquire);
+}
+
+template <typename T, typename Allocator_type>
+inline void Lock_free_hash_index<T, Allocator_type>::clear() {
+  for (size_t i = 0; i < m_number_of_slots; ++i) {
+    m_slots[i].m_hash.m_value.store(0, std::memory_order_relaxed);
+    m_slots[i].m_entry.m_value.store(nullptr, std::memory_order_relaxed);
+  }
+  m_size.store(0, std::memory_order_release);
+}
+
+} /* namespace temptable */
+
+#endif /* TEMPTABLE_LOCK_FREE_HASH_INDEX_H */
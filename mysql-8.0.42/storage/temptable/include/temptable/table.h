@@ -36,6 +36,7 @@ TempTable Table declarations. */
 #include "sql/table.h"
 #include "storage/temptable/include/temptable/allocator.h"
 #include "storage/temptable/include/temptable/column.h"
+#include "storage/temptable/include/temptable/column_store.h"
 #include "storage/temptable/include/temptable/cursor.h"
 #include "storage/temptable/include/temptable/index.h"
 #include "storage/temptable/include/temptable/result.h"
@@ -47,7 +48,8 @@ namespace temptable {
 class Table {
  public:
   Table(TABLE *mysql_table, Block *shared_block,
-        bool all_columns_are_fixed_size, size_t tmp_table_size_limit);
+        bool all_columns_are_fixed_size, size_t tmp_table_size_limit,
+        bool columnar);
 
   /* The `m_rows` member is too expensive to copy around. */
   Table(const Table &) = delete;
@@ -113,6 +115,10 @@ class Table {
 
   Result enable_indexes();
 
+  /** Check if the table is stored column by column.
+   * @return true if the rows are kept in `m_column_stores` */
+  bool is_columnar() const;
+
  private:
   /** Index entry for storing index pointer as well
    * as allocated memory size. */
@@ -147,6 +153,14 @@ class Table {
 
   Result indexes_remove(Storage::Element *row);
 
+  /** Append a row to `m_column_stores`. If an exception is thrown, nothing
+   * is appended.
+   * @return the row number of the row in the column stores */
+  uint64_t columns_append(const unsigned char *mysql_row);
+
+  /** Copy a row from `m_column_stores` to MySQL row format. */
+  void columns_read(uint64_t row_number, unsigned char *mysql_row) const;
+
   TableResourceMonitor m_resource_monitor;
 
   /** Allocator for all members that need dynamic memory allocation. */
@@ -167,6 +181,18 @@ class Table {
 
   Columns m_columns;
 
+  /** If the table is stored column by column, the values of each column (in
+   * the order of `m_columns`), followed by the NULL bits at the start of the
+   * MySQL row, if there are any. The elements of `m_rows` then hold the row
+   * numbers of the rows in these stores. Updated rows are appended anew, and
+   * the space of updated and removed rows is only reclaimed by truncate(),
+   * so this is meant for tables that are written once and read many times,
+   * like materialized derived tables. */
+  std::vector<Column_store, Allocator<Column_store>> m_column_stores;
+
+  /** Number of bytes with NULL bits at the start of the MySQL row. */
+  uint32_t m_null_bytes;
+
   TABLE_SHARE *m_mysql_table_share;
 };
 
@@ -205,7 +231,11 @@ inline void Table::row(const Storage::Iterator &pos,
 
   const Storage::Element *storage_element = *pos;
 
-  if (m_all_columns_are_fixed_size) {
+  if (is_columnar()) {
+    assert(m_rows.element_size() == sizeof(uint64_t));
+
+    columns_read(*static_cast<const uint64_t *>(storage_element), mysql_row);
+  } else if (m_all_columns_are_fixed_size) {
     assert(m_rows.element_size() == m_mysql_row_length);
 
     memcpy(mysql_row, storage_element, m_mysql_row_length);
@@ -218,7 +248,11 @@ inline void Table::row(const Storage::Iterator &pos,
 }
 
 inline void Table::truncate() {
-  if (!m_all_columns_are_fixed_size) {
+  if (is_columnar()) {
+    for (auto &column_store : m_column_stores) {
+      column_store.clear();
+    }
+  } else if (!m_all_columns_are_fixed_size) {
     for (auto element : m_rows) {
       Row *row = static_cast<Row *>(element);
       row->~Row();
@@ -248,6 +282,8 @@ inline Result Table::enable_indexes() {
   return Result::WRONG_COMMAND;
 }
 
+inline bool Table::is_columnar() const { return !m_column_stores.empty(); }
+
 inline bool Table::indexed() const {
   return m_indexes_are_enabled && !m_index_entries.empty();
 }
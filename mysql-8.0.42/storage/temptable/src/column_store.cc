@@ -0,0 +1,349 @@
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License, version 2.0, as published by the
+Free Software Foundation.
+
+This program is designed to work with certain software (including
+but not limited to OpenSSL) that is licensed under separate terms,
+as designated in a particular file or component or in included license
+documentation.  The authors of MySQL hereby grant you an additional
+permission to link the program and your derivative works with the
+separately licensed software that they have either included with
+the program or referenced in the documentation.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License, version 2.0,
+for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/** @file storage/temptable/src/column_store.cc
+TempTable Column_store implementation. */
+
+#include "storage/temptable/include/temptable/column_store.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+namespace temptable {
+
+Column_store::Column_store(uint32_t fixed_length,
+                           Allocator<uint8_t> *allocator)
+    : m_fixed_length(fixed_length),
+      m_allocator(allocator),
+      /* See Table::Table() for why the vectors are constructed with a
+       * count. */
+      m_chunks(0, *allocator),
+      m_chunk_free(0),
+      m_number_of_rows(0),
+      m_first_plain_row(std::numeric_limits<size_t>::max()),
+      m_value_bytes(0),
+      m_dictionary_value_bytes(0),
+      m_dictionary_values(0, *allocator),
+      m_dictionary(0, std::hash<std::string_view>(),
+                   std::equal_to<std::string_view>(), *allocator),
+      m_segments(0, *allocator),
+      m_open_codes(0, *allocator),
+      m_plain(0, *allocator) {}
+
+Column_store::Column_store(Column_store &&other) noexcept
+    : m_fixed_length(other.m_fixed_length),
+      m_allocator(other.m_allocator),
+      m_chunks(std::move(other.m_chunks)),
+      m_chunk_free(other.m_chunk_free),
+      m_number_of_rows(other.m_number_of_rows),
+      m_first_plain_row(other.m_first_plain_row),
+      m_value_bytes(other.m_value_bytes),
+      m_dictionary_value_bytes(other.m_dictionary_value_bytes),
+      m_dictionary_values(std::move(other.m_dictionary_values)),
+      m_dictionary(std::move(other.m_dictionary)),
+      m_segments(std::move(other.m_segments)),
+      m_open_codes(std::move(other.m_open_codes)),
+      m_plain(std::move(other.m_plain)) {
+  other.clear();
+}
+
+Column_store::~Column_store() { clear(); }
+
+size_t Column_store::append(const unsigned char *data, uint32_t length) {
+  assert(m_fixed_length == 0 || length == m_fixed_length);
+
+  if (m_number_of_rows < m_first_plain_row) {
+    append_to_dictionary(data, length);
+  } else {
+    append_plain(data, length);
+  }
+
+  return m_number_of_rows++;
+}
+
+void Column_store::remove_last() {
+  assert(m_number_of_rows > 0);
+
+  --m_number_of_rows;
+
+  if (m_number_of_rows < m_first_plain_row) {
+    /* append() never leaves the segment of codes empty. */
+    assert(!m_open_codes.empty());
+    const unsigned char *data;
+    uint32_t length;
+    read_value(m_dictionary_values[m_open_codes.back()], &data, &length);
+    m_value_bytes -= length;
+    m_open_codes.pop_back();
+  } else if (m_fixed_length == 0) {
+    m_plain.pop_back();
+  }
+  /* Fixed-length plain values need no work, the array they are in is
+   * reused by the next append(). */
+}
+
+void Column_store::clear() {
+  for (const Segment &segment : m_segments) {
+    m_allocator->deallocate(segment.m_data, segment.m_data_size);
+  }
+  for (const auto &chunk : m_chunks) {
+    m_allocator->deallocate(chunk.first, chunk.second);
+  }
+
+  m_segments.clear();
+  m_chunks.clear();
+  m_chunk_free = 0;
+  m_number_of_rows = 0;
+  m_first_plain_row = std::numeric_limits<size_t>::max();
+  m_value_bytes = 0;
+  m_dictionary_value_bytes = 0;
+  m_dictionary_values.clear();
+  m_dictionary.clear();
+  m_open_codes.clear();
+  m_plain.clear();
+}
+
+uint8_t *Column_store::allocate(size_t size) {
+  if (size > m_chunk_free) {
+    /* Start small, so that small tables stay small. Cap the shift before
+     * doing it, it would overflow once there are many chunks. */
+    const size_t chunk_size = std::max(
+        size, m_chunks.size() >= MAX_CHUNK_SIZE_SHIFT
+                  ? CHUNK_SIZE
+                  : MIN_CHUNK_SIZE << m_chunks.size());
+    m_chunks.reserve(m_chunks.size() + 1);
+    m_chunks.emplace_back(m_allocator->allocate(chunk_size), chunk_size);
+    m_chunk_free = chunk_size;
+  }
+
+  const auto &chunk = m_chunks.back();
+  uint8_t *ret = chunk.first + chunk.second - m_chunk_free;
+  m_chunk_free -= size;
+  return ret;
+}
+
+const uint8_t *Column_store::store_value(const unsigned char *data,
+                                         uint32_t length) {
+  const size_t prefix = m_fixed_length > 0 ? 0 : sizeof(length);
+  uint8_t *value = allocate(prefix + length);
+
+  if (prefix > 0) {
+    memcpy(value, &length, sizeof(length));
+  }
+  if (length > 0) {
+    memcpy(value + prefix, data, length);
+  }
+
+  return value;
+}
+
+void Column_store::append_to_dictionary(const unsigned char *data,
+                                        uint32_t length) {
+  if (m_open_codes.size() == ROWS_PER_SEGMENT) {
+    seal_open_segment();
+
+    if (!dictionary_pays_off()) {
+      switch_to_plain();
+      append_plain(data, length);
+      return;
+    }
+  }
+
+  const std::string_view key(reinterpret_cast<const char *>(data), length);
+  auto it = m_dictionary.find(key);
+
+  if (it == m_dictionary.end()) {
+    if (m_dictionary_values.size() == MAX_DICTIONARY_SIZE) {
+      switch_to_plain();
+      append_plain(data, length);
+      return;
+    }
+
+    const uint8_t *value = store_value(data, length);
+    const unsigned char *stored_data;
+    uint32_t stored_length;
+    read_value(value, &stored_data, &stored_length);
+
+    /* If anything below throws, the value is in `m_dictionary_values`, but
+     * no row ever refers to it. */
+    m_dictionary_values.push_back(value);
+    it = m_dictionary
+             .emplace(std::string_view(
+                          reinterpret_cast<const char *>(stored_data), length),
+                      static_cast<uint16_t>(m_dictionary_values.size() - 1))
+             .first;
+    m_dictionary_value_bytes += length;
+  }
+
+  m_open_codes.push_back(it->second);
+  m_value_bytes += length;
+}
+
+bool Column_store::dictionary_pays_off() const {
+  /* The sizes are estimates, the memory overhead of a hash table node varies
+   * between implementations. */
+  const size_t overhead_per_value = 6 * sizeof(void *);
+  const size_t overhead_per_plain_row =
+      m_fixed_length > 0 ? 0 : sizeof(uint32_t) + sizeof(void *);
+
+  const size_t dictionary_bytes =
+      m_dictionary_value_bytes +
+      m_dictionary_values.size() * overhead_per_value +
+      m_number_of_rows * sizeof(uint16_t);
+  const size_t plain_bytes =
+      m_value_bytes + m_number_of_rows * overhead_per_plain_row;
+
+  return dictionary_bytes < plain_bytes;
+}
+
+void Column_store::append_plain(const unsigned char *data, uint32_t length) {
+  const size_t plain_row = m_number_of_rows - m_first_plain_row;
+
+  if (m_fixed_length == 0) {
+    m_plain.reserve(m_plain.size() + 1);
+    m_plain.push_back(store_value(data, length));
+    return;
+  }
+
+  if (plain_row / PLAIN_VALUES_PER_ARRAY == m_plain.size()) {
+    m_plain.reserve(m_plain.size() + 1);
+    m_plain.push_back(allocate(PLAIN_VALUES_PER_ARRAY * m_fixed_length));
+  }
+
+  memcpy(const_cast<uint8_t *>(m_plain[plain_row / PLAIN_VALUES_PER_ARRAY]) +
+             plain_row % PLAIN_VALUES_PER_ARRAY * m_fixed_length,
+         data, m_fixed_length);
+}
+
+void Column_store::seal_open_segment() {
+  assert(!m_open_codes.empty());
+  assert(m_open_codes.size() <= ROWS_PER_SEGMENT);
+
+  const size_t number_of_rows = m_open_codes.size();
+  uint16_t max_code = 0;
+  size_t number_of_runs = 0;
+
+  for (size_t i = 0; i < number_of_rows; ++i) {
+    max_code = std::max(max_code, m_open_codes[i]);
+    if (i == 0 || m_open_codes[i] != m_open_codes[i - 1]) {
+      ++number_of_runs;
+    }
+  }
+
+  Segment segment;
+  const size_t code_size = max_code <= 0xFF ? 1 : 2;
+
+  if (number_of_runs * sizeof(Run) < number_of_rows * code_size) {
+    segment.m_encoding = Encoding::RUNS;
+    segment.m_data_size = number_of_runs * sizeof(Run);
+  } else {
+    segment.m_encoding = code_size == 1 ? Encoding::CODES_8 : Encoding::CODES_16;
+    segment.m_data_size = number_of_rows * code_size;
+  }
+  segment.m_number_of_runs = static_cast<uint32_t>(number_of_runs);
+
+  m_segments.reserve(m_segments.size() + 1);
+  segment.m_data = m_allocator->allocate(segment.m_data_size);
+  /* Nothing below throws. */
+
+  switch (segment.m_encoding) {
+    case Encoding::CODES_8:
+      for (size_t i = 0; i < number_of_rows; ++i) {
+        segment.m_data[i] = static_cast<uint8_t>(m_open_codes[i]);
+      }
+      break;
+    case Encoding::CODES_16:
+      memcpy(segment.m_data, m_open_codes.data(), segment.m_data_size);
+      break;
+    case Encoding::RUNS: {
+      Run *run = reinterpret_cast<Run *>(segment.m_data);
+      for (size_t i = 0; i < number_of_rows; ++i) {
+        if (i > 0 && m_open_codes[i] != m_open_codes[i - 1]) {
+          ++run;
+        }
+        run->m_end = static_cast<uint16_t>(i + 1);
+        run->m_code = m_open_codes[i];
+      }
+      break;
+    }
+  }
+
+  m_segments.push_back(segment);
+  m_open_codes.clear();
+}
+
+void Column_store::switch_to_plain() {
+  if (!m_open_codes.empty()) {
+    seal_open_segment();
+  }
+
+  m_first_plain_row = m_number_of_rows;
+
+  /* The dictionary is still needed to decode the rows stored so far, but
+   * the lookup is not. */
+  Dictionary empty(0, std::hash<std::string_view>(),
+                   std::equal_to<std::string_view>(),
+                   m_dictionary.get_allocator());
+  m_dictionary.swap(empty);
+  decltype(m_open_codes) no_codes(0, m_open_codes.get_allocator());
+  m_open_codes.swap(no_codes);
+}
+
+uint16_t Column_store::code(size_t row) const {
+  const size_t segment_number = row / ROWS_PER_SEGMENT;
+  const size_t row_in_segment = row % ROWS_PER_SEGMENT;
+
+  if (segment_number == m_segments.size()) {
+    return m_open_codes[row_in_segment];
+  }
+
+  const Segment &segment = m_segments[segment_number];
+
+  switch (segment.m_encoding) {
+    case Encoding::CODES_8:
+      return segment.m_data[row_in_segment];
+    case Encoding::CODES_16: {
+      uint16_t code;
+      memcpy(&code, segment.m_data + row_in_segment * sizeof(code),
+             sizeof(code));
+      return code;
+    }
+    case Encoding::RUNS: {
+      const Run *first = reinterpret_cast<const Run *>(segment.m_data);
+      const Run *last = first + segment.m_number_of_runs;
+      const Run *run =
+          std::upper_bound(first, last, row_in_segment,
+                           [](size_t r, const Run &run_to_check) {
+                             return r < run_to_check.m_end;
+                           });
+      assert(run != last);
+      return run->m_code;
+    }
+  }
+
+  assert(false);
+  return 0;
+}
+
+} /* namespace temptable */
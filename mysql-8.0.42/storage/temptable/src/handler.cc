@@ -146,7 +146,8 @@ int Handler::create(const char *table_name, TABLE *mysql_table,
     const auto insert_result = kv_store.emplace(
         std::piecewise_construct, std::forward_as_tuple(table_name),
         std::forward_as_tuple(mysql_table, m_shared_block,
-                              all_columns_are_fixed_size, per_table_limit));
+                              all_columns_are_fixed_size, per_table_limit,
+                              temptable_use_columnar_storage));
 
     ret = insert_result.second ? Result::OK : Result::TABLE_EXIST;
 
@@ -49,7 +49,8 @@ TempTable Table implementation. */
 namespace temptable {
 
 Table::Table(TABLE *mysql_table, Block *shared_block,
-             bool all_columns_are_fixed_size, size_t tmp_table_size_limit)
+             bool all_columns_are_fixed_size, size_t tmp_table_size_limit,
+             bool columnar)
     : m_resource_monitor(tmp_table_size_limit),
       m_allocator(shared_block, m_resource_monitor),
       m_rows(&m_allocator),
@@ -68,6 +69,8 @@ Table::Table(TABLE *mysql_table, Block *shared_block,
       m_index_entries(0, m_allocator),
       m_insert_undo(m_allocator),
       m_columns(m_allocator),
+      m_column_stores(m_allocator),
+      m_null_bytes(mysql_table->s->null_bytes),
       m_mysql_table_share(mysql_table->s) {
   const size_t number_of_indexes = mysql_table->s->keys;
   const size_t number_of_columns = mysql_table->s->fields;
@@ -98,7 +101,21 @@ Table::Table(TABLE *mysql_table, Block *shared_block,
     m_columns.emplace_back(mysql_row, *mysql_table, *mysql_table->field[i]);
   }
 
-  if (m_all_columns_are_fixed_size) {
+  /* Indexes point to rows in MySQL format, so only tables without indexes
+   * can be stored column by column. */
+  if (columnar && number_of_indexes == 0 && number_of_columns > 0) {
+    m_column_stores.reserve(number_of_columns + 1);
+    for (const auto &column : m_columns) {
+      m_column_stores.emplace_back(column.fixed_size(), &m_allocator);
+    }
+    if (m_null_bytes > 0) {
+      m_column_stores.emplace_back(m_null_bytes, &m_allocator);
+    }
+  }
+
+  if (is_columnar()) {
+    m_rows.element_size(sizeof(uint64_t));
+  } else if (m_all_columns_are_fixed_size) {
     m_rows.element_size(m_mysql_row_length);
     assert(m_rows.number_of_elements_per_page() > 0);
   } else {
@@ -113,7 +130,7 @@ Table::Table(TABLE *mysql_table, Block *shared_block,
 Table::~Table() {
   indexes_destroy();
 
-  if (!m_all_columns_are_fixed_size) {
+  if (!is_columnar() && !m_all_columns_are_fixed_size) {
     for (auto element : m_rows) {
       Row *row = static_cast<Row *>(element);
       row->~Row();
@@ -132,7 +149,20 @@ Result Table::insert(const unsigned char *mysql_row) {
 
   Result ret;
 
-  if (m_all_columns_are_fixed_size) {
+  if (is_columnar()) {
+    assert(m_rows.element_size() == sizeof(uint64_t));
+
+    try {
+      *static_cast<uint64_t *>(row) = columns_append(mysql_row);
+    } catch (Result ex) {
+      m_rows.deallocate_back();
+      return ex;
+    }
+
+    /* Tables with indexes are never stored column by column. */
+    assert(!indexed());
+    return Result::OK;
+  } else if (m_all_columns_are_fixed_size) {
     assert(m_rows.element_size() == m_mysql_table_share->rec_buff_length);
     assert(m_rows.element_size() == m_mysql_row_length);
 
@@ -172,7 +202,9 @@ Result Table::update(const unsigned char *mysql_row_old,
                      const unsigned char *mysql_row_new,
                      Storage::Element *target_row) {
 #ifndef NDEBUG
-  if (m_all_columns_are_fixed_size) {
+  if (is_columnar()) {
+    assert(m_rows.element_size() == sizeof(uint64_t));
+  } else if (m_all_columns_are_fixed_size) {
     assert(m_rows.element_size() == m_mysql_row_length);
   } else {
     assert(m_rows.element_size() == sizeof(Row));
@@ -196,6 +228,17 @@ Result Table::update(const unsigned char *mysql_row_old,
     }
   }
 
+  /* Rows stored column by column are appended anew, which leaves the old
+   * contents in place. */
+  if (is_columnar()) {
+    try {
+      *static_cast<uint64_t *>(target_row) = columns_append(mysql_row_new);
+    } catch (Result ex) {
+      return ex;
+    }
+    return Result::OK;
+  }
+
   /* For rows that does not have fixed size the contents are swapped
    * between this row and the target_row. That guaranteed the buffer
    * memory will be released at the end of function (if needed).
@@ -230,7 +273,7 @@ Result Table::remove(const unsigned char *mysql_row_must_be,
 #ifndef NDEBUG
   /* Check that `mysql_row_must_be` equals the row pointed to by
    * `victim_position`. */
-  if (m_all_columns_are_fixed_size) {
+  if (is_columnar() || m_all_columns_are_fixed_size) {
     /* nop */
   } else {
     /* *victim_position is a pointer to an `temptable::Row` object. */
@@ -247,7 +290,7 @@ Result Table::remove(const unsigned char *mysql_row_must_be,
     }
   }
 
-  if (!m_all_columns_are_fixed_size) {
+  if (!is_columnar() && !m_all_columns_are_fixed_size) {
     Row *row = reinterpret_cast<Row *>(*victim_position);
     row->~Row();
   }
@@ -397,4 +440,53 @@ Result Table::indexes_remove(Storage::Element *row) {
   return result;
 }
 
+uint64_t Table::columns_append(const unsigned char *mysql_row) {
+  const size_t row_number = m_column_stores.front().size();
+  size_t i = 0;
+
+  try {
+    for (; i < m_columns.size(); ++i) {
+      /* The length of NULL cells is 0, except for fixed size cells. Those
+       * are stored as they are, like in the other row formats. */
+      const Column &column = m_columns[i];
+      m_column_stores[i].append(column.get_user_data_ptr(mysql_row),
+                                column.read_user_data_length(mysql_row));
+    }
+    if (m_null_bytes > 0) {
+      m_column_stores[i].append(mysql_row, m_null_bytes);
+    }
+  } catch (...) {
+    /* Keep the row numbers of all the columns in step. */
+    while (i > 0) {
+      m_column_stores[--i].remove_last();
+    }
+    throw;
+  }
+
+  return row_number;
+}
+
+void Table::columns_read(uint64_t row_number, unsigned char *mysql_row) const {
+  const unsigned char *data;
+  uint32_t data_length;
+
+  if (m_null_bytes > 0) {
+    m_column_stores.back().get(row_number, &data, &data_length);
+    memcpy(mysql_row, data, m_null_bytes);
+  }
+
+  for (size_t i = 0; i < m_columns.size(); ++i) {
+    const Column &column = m_columns[i];
+
+    m_column_stores[i].get(row_number, &data, &data_length);
+
+    /* As for Row::copy_to_mysql_row(), BLOBs point to our own copy, which
+     * stays in place while the table is written to. */
+    const bool is_null = column.read_is_null(mysql_row);
+    column.write_user_data_length(data_length, mysql_row, m_mysql_row_length);
+    column.write_user_data(is_null, data, data_length, mysql_row,
+                           m_mysql_row_length);
+  }
+}
+
 } /* namespace temptable */
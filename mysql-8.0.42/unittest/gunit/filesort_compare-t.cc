@@ -24,6 +24,7 @@
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <memory>
+#include <random>
 #include <vector>
 
 #include "my_byteorder.h"
@@ -116,6 +117,89 @@ class FileSortBMHelper {
   std::unique_ptr<uchar *[]> sort_keys;
 };
 
+/*
+  Sort keys with radix_sort_keys(), and check that the result is the same as
+  with std::stable_sort, including the order of equal keys.
+ */
+static void VerifyRadixSort(std::vector<uchar> *data, size_t key_len) {
+  const size_t num_keys = data->size() / key_len;
+  std::vector<uchar *> keys;
+  for (size_t ix = 0; ix < num_keys; ++ix) {
+    keys.push_back(data->data() + ix * key_len);
+  }
+  std::vector<uchar *> expected = keys;
+  std::stable_sort(expected.begin(), expected.end(),
+                   [key_len](const uchar *s1, const uchar *s2) {
+                     return memcmp(s1, s2, key_len) < 0;
+                   });
+  radix_sort_keys(keys.data(), keys.data() + keys.size(), key_len);
+  EXPECT_EQ(expected, keys);
+}
+
+TEST(RadixSortTest, RandomKeys) {
+  std::mt19937 generator(42);
+  for (size_t key_len : {1, 4, 9, 16, 33}) {
+    for (size_t num_keys : {0, 1, 2, 63, 64, 65, 1000, 10000}) {
+      std::vector<uchar> data(num_keys * key_len);
+      for (uchar &byte : data) byte = generator() % 256;
+      SCOPED_TRACE(key_len);
+      SCOPED_TRACE(num_keys);
+      VerifyRadixSort(&data, key_len);
+    }
+  }
+}
+
+TEST(RadixSortTest, DuplicateKeys) {
+  // Few distinct values and long runs of equal bytes, like the null
+  // indicators and high bytes of small integers in real sort keys.
+  std::mt19937 generator(42);
+  const size_t key_len = 12;
+  for (unsigned num_values : {1, 2, 3, 100}) {
+    std::vector<uchar> data(10000 * key_len);
+    for (size_t ix = 0; ix < data.size(); ix += key_len) {
+      int_to_bytes(&data[ix + 4], generator() % num_values);
+      int_to_bytes(&data[ix + 8], generator() % num_values - 50);
+    }
+    SCOPED_TRACE(num_values);
+    VerifyRadixSort(&data, key_len);
+  }
+}
+
+TEST(RadixSortTest, Parallel) {
+  // Enough keys to be split between several threads, with many ties, so that
+  // the merge of the partitions must be stable.
+  std::mt19937 generator(42);
+  const size_t key_len = 8;
+  std::vector<uchar> data(200000 * key_len);
+  for (size_t ix = 0; ix < data.size(); ix += key_len) {
+    int_to_bytes(&data[ix], generator() % 1000);
+  }
+  std::vector<uchar *> keys;
+  for (size_t ix = 0; ix < data.size(); ix += key_len) {
+    keys.push_back(&data[ix]);
+  }
+  std::vector<uchar *> expected = keys;
+  std::stable_sort(expected.begin(), expected.end(),
+                   [](const uchar *s1, const uchar *s2) {
+                     return memcmp(s1, s2, key_len) < 0;
+                   });
+  // With max_sort_threads below max_threads - 1, the keys are split between
+  // fewer threads.
+  const ulong saved_max_sort_threads = max_sort_threads;
+  for (ulong server_max : {0, 1, 64}) {
+    max_sort_threads = server_max;
+    for (size_t max_threads : {1, 2, 3, 8}) {
+      std::vector<uchar *> sorted = keys;
+      radix_sort_keys_in_parallel(sorted.data(), sorted.data() + sorted.size(),
+                                  key_len, max_threads);
+      SCOPED_TRACE(max_threads);
+      SCOPED_TRACE(server_max);
+      EXPECT_EQ(expected, sorted);
+    }
+  }
+  max_sort_threads = saved_max_sort_threads;
+}
+
 /*
   Some different mem_compare functions.
   The second one seems to win on all platforms, except sparc,
@@ -306,6 +390,19 @@ static inline void RunSortBenchmark(size_t num_iterations, bool stable_sort) {
   }
 }
 
+static void BM_RadixSort(size_t num_iterations) {
+  StopBenchmarkTiming();
+  FileSortBMHelper helper;
+  for (size_t ix = 0; ix < num_iterations; ++ix) {
+    std::vector<uchar *> keys = helper.GetKeys();
+    StartBenchmarkTiming();
+    radix_sort_keys(keys.data(), keys.data() + keys.size(),
+                    helper.record_size);
+    StopBenchmarkTiming();
+  }
+}
+BENCHMARK(BM_RadixSort)
+
 /*
   Several sorting tests below, each one runs num_iterations.
   For each iteration we take a copy of the key pointers, and sort the copy.
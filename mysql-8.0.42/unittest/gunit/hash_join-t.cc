@@ -788,6 +788,99 @@ TEST(HashJoinTest, AntiJoinIntSpillToDisk) {
                                    2000, 2001));
 }
 
+TEST(HashJoinTest, AntiJoinIntSpillToDiskFlatHashTable) {
+  my_testing::Server_initializer initializer;
+  initializer.SetUp();
+
+  // Use the flat hash table, and probe it four rows at a time.
+  initializer.thd()->variables.hash_join_table_type =
+      static_cast<ulong>(hash_join_buffer::HashTableType::FLAT);
+  initializer.thd()->variables.iterator_batch_size = 4;
+
+  vector<optional<int>> probe_data = {
+      1, 2, 3, 4, 1998, 1999, 2000, 2001, -1, -2, nullopt, nullopt, 2, 3, 4};
+
+  vector<optional<int>> build_data;
+  build_data.emplace_back(nullopt);
+  for (int i = 0; i < 1000; ++i) {
+    build_data.emplace_back(i * 2);
+  }
+
+  HashJoinTestHelper test_helper{initializer, build_data, probe_data,
+                                 /*is_nullable=*/true};
+
+  // Same as AntiJoinIntSpillToDisk.
+  HashJoinIterator hash_join_iterator{initializer.thd(),
+                                      std::move(test_helper.left_iterator),
+                                      test_helper.left_tables(),
+                                      static_cast<double>(build_data.size()),
+                                      std::move(test_helper.right_iterator),
+                                      test_helper.right_tables(),
+                                      /*store_rowids=*/false,
+                                      /*tables_to_get_rowid_for=*/0,
+                                      /*max_memory_available=*/128,
+                                      {*test_helper.join_condition},
+                                      /*allow_spill_to_disk=*/true,
+                                      JoinType::ANTI,
+                                      test_helper.extra_conditions,
+                                      /*probe_input_batch_mode=*/false,
+                                      /*hash_table_generation=*/nullptr};
+
+  ASSERT_FALSE(hash_join_iterator.Init());
+
+  EXPECT_GT(hash_join_iterator.ChunkCount(), 0)
+      << "The hash table didn't spill to disk.";
+
+  EXPECT_THAT(CollectIntResults(&hash_join_iterator,
+                                test_helper.right_qep_tab->table()->field[0]),
+              UnorderedElementsAre(nullopt, nullopt, -1, -2, 1, 3, 3, 1999,
+                                   2000, 2001));
+}
+
+TEST(HashJoinTest, InnerJoinIntFlatHashTableOneToManyMatch) {
+  my_testing::Server_initializer initializer;
+  initializer.SetUp();
+
+  initializer.thd()->variables.hash_join_table_type =
+      static_cast<ulong>(hash_join_buffer::HashTableType::FLAT);
+  initializer.thd()->variables.iterator_batch_size = 100;
+
+  // Enough distinct keys to make the hash table grow a few times, and every
+  // key twice, so that each probe row gets a chain of two matches.
+  vector<optional<int>> build_dataset;
+  vector<optional<int>> probe_dataset;
+  vector<optional<int>> expected_result;
+  for (int i = 0; i < 1000; ++i) {
+    build_dataset.emplace_back(i);
+    build_dataset.emplace_back(i);
+    if (i % 7 == 0) {
+      probe_dataset.emplace_back(i);
+      expected_result.emplace_back(i);
+      expected_result.emplace_back(i);
+    }
+  }
+  probe_dataset.emplace_back(-1);
+
+  HashJoinTestHelper test_helper(initializer, build_dataset, probe_dataset);
+
+  HashJoinIterator hash_join_iterator(
+      initializer.thd(), std::move(test_helper.left_iterator),
+      test_helper.left_tables(), /*estimated_build_rows=*/2000,
+      std::move(test_helper.right_iterator), test_helper.right_tables(),
+      /*store_rowids=*/false,
+      /*tables_to_get_rowid_for=*/0, 10 * 1024 * 1024 /* 10 MB */,
+      {*test_helper.join_condition}, true, JoinType::INNER,
+      test_helper.extra_conditions,
+      /*probe_input_batch_mode=*/false, nullptr);
+
+  ASSERT_FALSE(hash_join_iterator.Init());
+  EXPECT_EQ(0, hash_join_iterator.ChunkCount());
+
+  EXPECT_THAT(CollectIntResults(&hash_join_iterator,
+                                test_helper.left_qep_tab->table()->field[0]),
+              testing::UnorderedElementsAreArray(expected_result));
+}
+
 TEST(HashJoinTest, LeftHashJoinInt) {
   my_testing::Server_initializer initializer;
   initializer.SetUp();
@@ -898,6 +991,258 @@ TEST(HashJoinTest, HashJoinChunkFiles) {
   EXPECT_EQ(2, hash_join_iterator.ChunkCount());
 }
 
+TEST(HashJoinTest, InnerJoinIntRepartitionOversizedChunk) {
+  my_testing::Server_initializer initializer;
+  initializer.SetUp();
+
+  // Half of the probe rows have no match, so they should be dropped by the
+  // Bloom filters instead of being written to the chunk files.
+  vector<optional<int>> build_dataset;
+  vector<optional<int>> probe_dataset;
+  vector<optional<int>> expected_result;
+  for (int i = 0; i < 2000; ++i) {
+    build_dataset.emplace_back(i);
+    expected_result.emplace_back(i);
+  }
+  for (int i = 0; i < 4000; ++i) {
+    probe_dataset.emplace_back(i);
+  }
+
+  HashJoinTestHelper test_helper(initializer, build_dataset, probe_dataset);
+
+  // The row estimate is way too low, so only a single chunk pair is created
+  // when spilling to disk. The chunk pair will not fit in memory, and must be
+  // repartitioned.
+  HashJoinIterator hash_join_iterator(
+      initializer.thd(), std::move(test_helper.left_iterator),
+      test_helper.left_tables(), /*estimated_build_rows=*/10,
+      std::move(test_helper.right_iterator), test_helper.right_tables(),
+      /*store_rowids=*/false,
+      /*tables_to_get_rowid_for=*/0, 1024 /* 1 KB */,
+      {*test_helper.join_condition}, true, JoinType::INNER,
+      test_helper.extra_conditions,
+      /*probe_input_batch_mode=*/false, nullptr);
+
+  ASSERT_FALSE(hash_join_iterator.Init());
+  EXPECT_EQ(1, hash_join_iterator.ChunkCount());
+
+  EXPECT_THAT(CollectIntResults(&hash_join_iterator,
+                                test_helper.left_qep_tab->table()->field[0]),
+              testing::UnorderedElementsAreArray(expected_result));
+  EXPECT_GT(hash_join_iterator.ChunkCount(), 1)
+      << "The chunk pair wasn't repartitioned.";
+}
+
+TEST(HashJoinTest, LeftJoinIntRepartitionOversizedChunk) {
+  my_testing::Server_initializer initializer;
+  initializer.SetUp();
+
+  vector<optional<int>> build_dataset;
+  vector<optional<int>> probe_dataset;
+  for (int i = 0; i < 2000; ++i) {
+    build_dataset.emplace_back(i * 2);
+  }
+  for (int i = 0; i < 4000; ++i) {
+    probe_dataset.emplace_back(i);
+  }
+
+  HashJoinTestHelper test_helper(initializer, probe_dataset, build_dataset);
+
+  // Every probe row must be returned exactly once, either with its match or
+  // NULL-complemented, regardless of whether it was dropped by a Bloom filter,
+  // or went through a repartitioned chunk pair.
+  HashJoinIterator hash_join_iterator(
+      initializer.thd(), std::move(test_helper.right_iterator),
+      test_helper.right_tables(), /*estimated_build_rows=*/10,
+      std::move(test_helper.left_iterator), test_helper.left_tables(),
+      /*store_rowids=*/false, /*tables_to_get_rowid_for=*/0,
+      1024 /* 1 KB */, {*test_helper.join_condition}, true, JoinType::OUTER,
+      test_helper.extra_conditions,
+      /*probe_input_batch_mode=*/false, nullptr);
+
+  ASSERT_FALSE(hash_join_iterator.Init());
+
+  EXPECT_THAT(CollectIntResults(&hash_join_iterator,
+                                test_helper.left_qep_tab->table()->field[0]),
+              testing::UnorderedElementsAreArray(probe_dataset));
+  EXPECT_GT(hash_join_iterator.ChunkCount(), 1)
+      << "The chunk pair wasn't repartitioned.";
+}
+
+TEST(HashJoinTest, RuntimeFilter) {
+  my_testing::Server_initializer initializer;
+  initializer.SetUp();
+
+  HashJoinTestHelper test_helper(initializer, vector<optional<int>>{},
+                                 vector<optional<int>>{},
+                                 /*is_nullable=*/true);
+  TABLE *build_table = test_helper.left_qep_tab->table();
+  TABLE *probe_table = test_helper.right_qep_tab->table();
+  Item *build_expr = test_helper.join_condition->left_extractor();
+  Item *probe_expr = test_helper.join_condition->right_extractor();
+  ASSERT_TRUE(RuntimeFilter::IsSupportedCondition(probe_expr, build_expr,
+                                                  probe_table));
+  EXPECT_FALSE(RuntimeFilter::IsSupportedCondition(build_expr, probe_expr,
+                                                   probe_table));
+
+  MEM_ROOT mem_root(PSI_NOT_INSTRUMENTED, 1024);
+  RuntimeFilter filter(probe_table->field[0], build_expr);
+  filter.Reset(&mem_root, /*expected_build_rows=*/3,
+               /*max_bloom_filter_bytes=*/1024);
+  for (optional<int> value : {optional<int>(2), optional<int>(6),
+                              optional<int>(4), optional<int>()}) {
+    if (value.has_value()) {
+      build_table->field[0]->set_notnull();
+      build_table->field[0]->store(*value, /*unsigned_val=*/false);
+    } else {
+      build_table->field[0]->set_null();
+    }
+    filter.AddBuildRow();
+  }
+
+  auto may_match = [&](optional<int> value) {
+    if (value.has_value()) {
+      probe_table->field[0]->set_notnull();
+      probe_table->field[0]->store(*value, /*unsigned_val=*/false);
+    } else {
+      probe_table->field[0]->set_null();
+    }
+    return filter.MayMatch(probe_table->record[0]);
+  };
+
+  // There are no false negatives.
+  EXPECT_TRUE(may_match(2));
+  EXPECT_TRUE(may_match(4));
+  EXPECT_TRUE(may_match(6));
+
+  // Outside the range, or NULL.
+  EXPECT_FALSE(may_match(1));
+  EXPECT_FALSE(may_match(7));
+  EXPECT_FALSE(may_match(-100));
+  EXPECT_FALSE(may_match(nullopt));
+  EXPECT_EQ(4, filter.rows_rejected());
+}
+
+TEST(HashJoinTest, RuntimeFilterIsPushedToProbeTable) {
+  my_testing::Server_initializer initializer;
+  initializer.SetUp();
+
+  for (JoinType join_type : {JoinType::INNER, JoinType::OUTER}) {
+    HashJoinTestHelper test_helper(initializer, {2, 4, 6}, {1, 2, 3, 4});
+    handler *probe_handler = test_helper.right_qep_tab->table()->file;
+
+    HashJoinIterator hash_join_iterator(
+        initializer.thd(), std::move(test_helper.left_iterator),
+        test_helper.left_tables(), /*estimated_build_rows=*/3,
+        std::move(test_helper.right_iterator), test_helper.right_tables(),
+        /*store_rowids=*/false, /*tables_to_get_rowid_for=*/0,
+        10 * 1024 * 1024 /* 10 MB */, {*test_helper.join_condition}, true,
+        join_type, test_helper.extra_conditions,
+        /*probe_input_batch_mode=*/false, nullptr);
+
+    ASSERT_FALSE(hash_join_iterator.Init());
+    // Outer joins must see every probe row.
+    if (join_type == JoinType::INNER) {
+      EXPECT_NE(nullptr, probe_handler->ha_get_runtime_filter());
+    } else {
+      EXPECT_EQ(nullptr, probe_handler->ha_get_runtime_filter());
+    }
+
+    while (hash_join_iterator.Read() == 0) {
+    }
+    EXPECT_EQ(nullptr, probe_handler->ha_get_runtime_filter());
+  }
+}
+
+TEST(HashJoinTest, InnerJoinIntBuildInputInBatches) {
+  my_testing::Server_initializer initializer;
+  initializer.SetUp();
+
+  // Read the build input three rows at a time. 1000 is not a multiple of
+  // three, so the last batch is only partially filled.
+  initializer.thd()->variables.iterator_batch_size = 3;
+
+  vector<optional<int>> build_dataset;
+  vector<optional<int>> probe_dataset;
+  vector<optional<int>> expected_result;
+  for (int i = 0; i < 1000; ++i) {
+    build_dataset.emplace_back(i);
+    if (i % 3 == 0) {
+      probe_dataset.emplace_back(i);
+      expected_result.emplace_back(i);
+    }
+  }
+
+  HashJoinTestHelper test_helper(initializer, build_dataset, probe_dataset);
+
+  // Make the hash table spill to disk, so that the rows that are left in the
+  // batch when the hash table goes full are written to the chunk files.
+  HashJoinIterator hash_join_iterator(
+      initializer.thd(), std::move(test_helper.left_iterator),
+      test_helper.left_tables(), /*estimated_build_rows=*/1000,
+      std::move(test_helper.right_iterator), test_helper.right_tables(),
+      /*store_rowids=*/false,
+      /*tables_to_get_rowid_for=*/0, 1024 /* 1 KB */,
+      {*test_helper.join_condition}, true, JoinType::INNER,
+      test_helper.extra_conditions,
+      /*probe_input_batch_mode=*/false, nullptr);
+
+  ASSERT_FALSE(hash_join_iterator.Init());
+  EXPECT_GT(hash_join_iterator.ChunkCount(), 0)
+      << "The hash table didn't spill to disk.";
+
+  EXPECT_THAT(CollectIntResults(&hash_join_iterator,
+                                test_helper.left_qep_tab->table()->field[0]),
+              testing::UnorderedElementsAreArray(expected_result));
+}
+
+TEST(HashJoinTest, InnerJoinIntSpillToDiskInParallel) {
+  my_testing::Server_initializer initializer;
+  initializer.SetUp();
+
+  // Let four threads join the chunk files.
+  initializer.thd()->variables.hash_join_threads = 4;
+
+  // Every fifth key appears twice in the build input, so that some probe rows
+  // have more than one match in the same chunk file.
+  vector<optional<int>> build_dataset;
+  vector<optional<int>> probe_dataset;
+  vector<optional<int>> expected_result;
+  for (int i = 0; i < 1000; ++i) {
+    build_dataset.emplace_back(i);
+    if (i % 5 == 0) build_dataset.emplace_back(i);
+    if (i % 3 == 0) {
+      probe_dataset.emplace_back(i);
+      expected_result.emplace_back(i);
+      if (i % 5 == 0) expected_result.emplace_back(i);
+    }
+  }
+
+  HashJoinTestHelper test_helper(initializer, build_dataset, probe_dataset);
+
+  HashJoinIterator hash_join_iterator(
+      initializer.thd(), std::move(test_helper.left_iterator),
+      test_helper.left_tables(), /*estimated_build_rows=*/1000,
+      std::move(test_helper.right_iterator), test_helper.right_tables(),
+      /*store_rowids=*/false,
+      /*tables_to_get_rowid_for=*/0, 1024 /* 1 KB */,
+      {*test_helper.join_condition}, true, JoinType::INNER,
+      test_helper.extra_conditions,
+      /*probe_input_batch_mode=*/false, nullptr);
+
+  // Execute the join twice, to verify that the worker threads from the first
+  // execution are cleaned up properly.
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_FALSE(hash_join_iterator.Init());
+    EXPECT_GT(hash_join_iterator.ChunkCount(), 0)
+        << "The hash table didn't spill to disk.";
+
+    EXPECT_THAT(CollectIntResults(&hash_join_iterator,
+                                  test_helper.left_qep_tab->table()->field[0]),
+                testing::UnorderedElementsAreArray(expected_result));
+  }
+}
+
 TEST(HashJoinTest, InnerJoinIntNullable) {
   my_testing::Server_initializer initializer;
   initializer.SetUp();
@@ -34,6 +34,7 @@
 #include "sql/field.h"                   // my_charset_numeric
 #include "sql/histograms/equi_height.h"  // Equi_height
 #include "sql/histograms/histogram.h"    // Histogram, Histogram_comparator
+#include "sql/histograms/singleton.h"    // Singleton
 #include "sql/histograms/value_map.h"    // Value_map<T>
 #include "sql/my_decimal.h"              // my_decimal
 #include "sql_string.h"                  // String
@@ -435,4 +436,96 @@ TEST_F(HistogramSelectivityTest, EquiHeightSelectivity) {
   }
 }
 
+// Fill a value map with each of the keys in [first_key, last_key] once.
+void fill_value_map(Value_map<longlong> *value_map, longlong first_key,
+                    longlong last_key) {
+  for (longlong key = first_key; key <= last_key; ++key) {
+    EXPECT_FALSE(value_map->add_values(key, 1));
+  }
+}
+
+TEST_F(HistogramSelectivityTest, EquiJoinSelectivityPartialOverlap) {
+  Value_map<longlong> left_values(&my_charset_numeric, Value_map_type::INT);
+  Value_map<longlong> right_values(&my_charset_numeric, Value_map_type::INT);
+  fill_value_map(&left_values, 1, 100);
+  fill_value_map(&right_values, 51, 150);
+
+  Equi_height<longlong> *left = Equi_height<longlong>::create(
+      &m_mem_root, "db1", "tbl1", "col1", Value_map_type::INT);
+  Equi_height<longlong> *right = Equi_height<longlong>::create(
+      &m_mem_root, "db1", "tbl2", "col1", Value_map_type::INT);
+  EXPECT_FALSE(left->build_histogram(left_values, 10));
+  EXPECT_FALSE(right->build_histogram(right_values, 8));
+
+  // 50 of the 100 * 100 pairs match.
+  double selectivity;
+  EXPECT_FALSE(left->get_equi_join_selectivity(*right, &selectivity));
+  EXPECT_NEAR(0.005, selectivity, 0.0005);
+  EXPECT_FALSE(right->get_equi_join_selectivity(*left, &selectivity));
+  EXPECT_NEAR(0.005, selectivity, 0.0005);
+}
+
+TEST_F(HistogramSelectivityTest, EquiJoinSelectivityNoOverlap) {
+  Value_map<longlong> left_values(&my_charset_numeric, Value_map_type::INT);
+  Value_map<longlong> right_values(&my_charset_numeric, Value_map_type::INT);
+  fill_value_map(&left_values, 1, 100);
+  fill_value_map(&right_values, 201, 300);
+
+  Equi_height<longlong> *left = Equi_height<longlong>::create(
+      &m_mem_root, "db1", "tbl1", "col1", Value_map_type::INT);
+  Equi_height<longlong> *right = Equi_height<longlong>::create(
+      &m_mem_root, "db1", "tbl2", "col1", Value_map_type::INT);
+  EXPECT_FALSE(left->build_histogram(left_values, 10));
+  EXPECT_FALSE(right->build_histogram(right_values, 10));
+
+  // Never below a hundredth of 1/100, which assumes all the values match.
+  double selectivity;
+  EXPECT_FALSE(left->get_equi_join_selectivity(*right, &selectivity));
+  EXPECT_NEAR(0.0001, selectivity, 1e-12);
+}
+
+TEST_F(HistogramSelectivityTest, EquiJoinSelectivitySkew) {
+  Value_map<longlong> left_values(&my_charset_numeric, Value_map_type::INT);
+  Value_map<longlong> right_values(&my_charset_numeric, Value_map_type::INT);
+  EXPECT_FALSE(left_values.add_values(1, 90));
+  EXPECT_FALSE(left_values.add_values(2, 10));
+  EXPECT_FALSE(right_values.add_values(1, 10));
+  EXPECT_FALSE(right_values.add_values(2, 80));
+  right_values.add_null_values(10);
+
+  Singleton<longlong> *left = Singleton<longlong>::create(
+      &m_mem_root, "db1", "tbl1", "col1", Value_map_type::INT);
+  Equi_height<longlong> *right = Equi_height<longlong>::create(
+      &m_mem_root, "db1", "tbl2", "col1", Value_map_type::INT);
+  EXPECT_FALSE(left->build_histogram(left_values, 10));
+  EXPECT_FALSE(right->build_histogram(right_values, 2));
+
+  // 0.9 * 0.1 + 0.1 * 0.8, where the number of distinct values alone gives
+  // 0.9 / 2.
+  double selectivity;
+  EXPECT_FALSE(left->get_equi_join_selectivity(*right, &selectivity));
+  EXPECT_NEAR(0.17, selectivity, 0.000001);
+  EXPECT_FALSE(right->get_equi_join_selectivity(*left, &selectivity));
+  EXPECT_NEAR(0.17, selectivity, 0.000001);
+}
+
+TEST_F(HistogramSelectivityTest, EquiJoinSelectivityDifferentTypes) {
+  Value_map<longlong> int_values(&my_charset_numeric, Value_map_type::INT);
+  Value_map<double> double_values(&my_charset_numeric,
+                                  Value_map_type::DOUBLE);
+  EXPECT_FALSE(int_values.add_values(1, 1));
+  EXPECT_FALSE(double_values.add_values(1.0, 1));
+
+  Singleton<longlong> *int_histogram = Singleton<longlong>::create(
+      &m_mem_root, "db1", "tbl1", "col1", Value_map_type::INT);
+  Singleton<double> *double_histogram = Singleton<double>::create(
+      &m_mem_root, "db1", "tbl2", "col1", Value_map_type::DOUBLE);
+  EXPECT_FALSE(int_histogram->build_histogram(int_values, 10));
+  EXPECT_FALSE(double_histogram->build_histogram(double_values, 10));
+
+  double selectivity;
+  EXPECT_TRUE(int_histogram->get_equi_join_selectivity(*double_histogram,
+                                                       &selectivity));
+}
+
 }  // namespace histogram_selectivity_test
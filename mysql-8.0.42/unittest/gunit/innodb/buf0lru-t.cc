@@ -0,0 +1,120 @@
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+
+#include "storage/innobase/include/buf0lru.h"
+#include "storage/innobase/include/univ.i"
+
+namespace innodb_buf0lru_unittest {
+
+/* Number of ghost entries used by the tests. */
+constexpr size_t N_GHOSTS = 64;
+
+using Ghosts = std::array<uint64_t, N_GHOSTS>;
+
+/* A page evicted recently is found once. */
+TEST(buf0lru, ghost_hit) {
+  Ghosts ghosts{};
+  const page_id_t page_id(5, 17);
+
+  buf_LRU_ghost_set(ghosts.data(), N_GHOSTS, 100, page_id);
+
+  EXPECT_FALSE(buf_LRU_ghost_take(ghosts.data(), N_GHOSTS, 101,
+                                  page_id_t(5, 18)));
+  EXPECT_FALSE(buf_LRU_ghost_take(ghosts.data(), N_GHOSTS, 101,
+                                  page_id_t(6, 17)));
+  EXPECT_TRUE(buf_LRU_ghost_take(ghosts.data(), N_GHOSTS, 101, page_id));
+  EXPECT_FALSE(buf_LRU_ghost_take(ghosts.data(), N_GHOSTS, 102, page_id));
+}
+
+/* A ghost entry expires once as many pages as there are slots have been
+evicted since. */
+TEST(buf0lru, ghost_expiry) {
+  Ghosts ghosts{};
+  const page_id_t page_id(5, 17);
+
+  buf_LRU_ghost_set(ghosts.data(), N_GHOSTS, 100, page_id);
+  EXPECT_TRUE(
+      buf_LRU_ghost_take(ghosts.data(), N_GHOSTS, 100 + N_GHOSTS - 1, page_id));
+
+  buf_LRU_ghost_set(ghosts.data(), N_GHOSTS, 100, page_id);
+  EXPECT_FALSE(
+      buf_LRU_ghost_take(ghosts.data(), N_GHOSTS, 100 + N_GHOSTS, page_id));
+
+  /* An expired entry is removed all the same. */
+  EXPECT_FALSE(buf_LRU_ghost_take(ghosts.data(), N_GHOSTS, 101, page_id));
+}
+
+/* Only the low 32 bits of the eviction count are kept, the distance is
+still right when they wrap around. */
+TEST(buf0lru, ghost_clock_wrap) {
+  Ghosts ghosts{};
+  const page_id_t page_id(1, 2);
+
+  buf_LRU_ghost_set(ghosts.data(), N_GHOSTS, 0xFFFFFFF0ULL, page_id);
+  EXPECT_TRUE(
+      buf_LRU_ghost_take(ghosts.data(), N_GHOSTS, 0x100000010ULL, page_id));
+}
+
+/* Every page evicted within the window is found, as long as none of them
+share a slot. */
+TEST(buf0lru, ghost_many_pages) {
+  Ghosts ghosts{};
+  std::array<bool, N_GHOSTS> used{};
+  uint64_t clock = 0;
+  size_t n_set = 0;
+
+  for (page_no_t page_no = 0; n_set < N_GHOSTS / 4; ++page_no) {
+    const page_id_t page_id(3, page_no);
+    Ghosts probe{};
+
+    /* Find the slot of the page by setting it in an empty table. */
+    buf_LRU_ghost_set(probe.data(), N_GHOSTS, 1, page_id);
+    size_t slot = 0;
+    while (probe[slot] == 0) ++slot;
+
+    if (used[slot]) continue;
+    used[slot] = true;
+
+    buf_LRU_ghost_set(ghosts.data(), N_GHOSTS, ++clock, page_id);
+    ++n_set;
+  }
+
+  size_t n_found = 0;
+  for (page_no_t page_no = 0; n_found < n_set; ++page_no) {
+    ASSERT_LT(page_no, 100000U);
+    if (buf_LRU_ghost_take(ghosts.data(), N_GHOSTS, clock,
+                           page_id_t(3, page_no))) {
+      ++n_found;
+    }
+  }
+
+  for (const auto ghost : ghosts) EXPECT_EQ(ghost, 0U);
+}
+
+}  // namespace innodb_buf0lru_unittest
@@ -0,0 +1,77 @@
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+#include <gtest/gtest.h>
+
+#include "storage/innobase/include/row0mysql.h"
+
+namespace innodb_row0mysql_unittest {
+
+/* Number of rows the fetch cache holds after a scan filled it n times, for
+rows of the given length. */
+static ulint fetch_cache_limit_after(ulint mysql_row_len, size_t n) {
+  ulint limit = MYSQL_FETCH_CACHE_SIZE;
+
+  for (size_t i = 0; i < n; ++i) {
+    limit = row_fetch_cache_next_limit(limit, mysql_row_len);
+  }
+
+  return limit;
+}
+
+/* The fetch cache doubles with every batch a scan fills, up to
+MYSQL_FETCH_CACHE_MAX_SIZE rows. */
+TEST(row0mysql, fetch_cache_grows_to_max_rows) {
+  EXPECT_EQ(MYSQL_FETCH_CACHE_SIZE, fetch_cache_limit_after(100, 0));
+  EXPECT_EQ(2 * MYSQL_FETCH_CACHE_SIZE, fetch_cache_limit_after(100, 1));
+  EXPECT_EQ(4 * MYSQL_FETCH_CACHE_SIZE, fetch_cache_limit_after(100, 2));
+
+  /* 100 byte rows: 512 rows take about 55KB, so the row limit applies. */
+  EXPECT_EQ(MYSQL_FETCH_CACHE_MAX_SIZE, fetch_cache_limit_after(100, 6));
+  EXPECT_EQ(MYSQL_FETCH_CACHE_MAX_SIZE, fetch_cache_limit_after(100, 100));
+}
+
+/* Long rows are limited by MYSQL_FETCH_CACHE_MAX_BYTES instead. */
+TEST(row0mysql, fetch_cache_grows_to_max_bytes) {
+  const ulint row_len = 4000;
+  const ulint max_rows = MYSQL_FETCH_CACHE_MAX_BYTES / (row_len + 8);
+
+  EXPECT_EQ(2 * MYSQL_FETCH_CACHE_SIZE, fetch_cache_limit_after(row_len, 1));
+  EXPECT_EQ(max_rows, fetch_cache_limit_after(row_len, 100));
+  EXPECT_LE(fetch_cache_limit_after(row_len, 100) * (row_len + 8),
+            MYSQL_FETCH_CACHE_MAX_BYTES);
+}
+
+/* The cache never shrinks below its initial size, even if that exceeds
+MYSQL_FETCH_CACHE_MAX_BYTES. */
+TEST(row0mysql, fetch_cache_keeps_initial_size_for_huge_rows) {
+  static_assert(row_fetch_cache_next_limit(MYSQL_FETCH_CACHE_SIZE, 60000) ==
+                MYSQL_FETCH_CACHE_SIZE);
+
+  EXPECT_EQ(MYSQL_FETCH_CACHE_SIZE, fetch_cache_limit_after(60000, 1));
+  EXPECT_EQ(MYSQL_FETCH_CACHE_SIZE, fetch_cache_limit_after(60000, 100));
+}
+
+}  // namespace innodb_row0mysql_unittest
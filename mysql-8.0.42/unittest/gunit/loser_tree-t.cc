@@ -0,0 +1,145 @@
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include <gtest/gtest.h>
+#include <stddef.h>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "loser_tree.h"
+
+namespace loser_tree_unittest {
+
+using Sequence = std::vector<int>;
+
+// An element of a sequence: the value, and the number of the sequence.
+using Element = std::pair<int, size_t>;
+
+// Orders elements on their value only, with the smallest value on top.
+struct Greater_value {
+  bool operator()(const Element &a, const Element &b) const {
+    return a.first > b.first;
+  }
+};
+
+// Merge the sorted sequences with a loser tree.
+std::vector<Element> Merge(const std::vector<Sequence> &sequences) {
+  Loser_tree<Element, Greater_value> tree;
+  std::vector<Element> firsts;
+  std::vector<size_t> positions(sequences.size(), 0);
+  for (size_t i = 0; i < sequences.size(); ++i) {
+    firsts.emplace_back(sequences[i].empty() ? 0 : sequences[i][0], i);
+  }
+  EXPECT_FALSE(tree.init(firsts.begin(), firsts.end()));
+  // Take out the empty sequences right away. They must come first, and all
+  // values must be positive, so that they are on top.
+  for (size_t i = 0; i < sequences.size() && sequences[i].empty(); ++i) {
+    EXPECT_EQ(i, tree.top_index());
+    tree.pop();
+  }
+
+  std::vector<Element> result;
+  while (!tree.empty()) {
+    Element &top = tree.top();
+    EXPECT_EQ(top.second, tree.top_index());
+    result.push_back(top);
+    const size_t i = tree.top_index();
+    if (++positions[i] == sequences[i].size()) {
+      tree.pop();
+    } else {
+      top.first = sequences[i][positions[i]];
+      tree.update_top();
+    }
+  }
+  return result;
+}
+
+// What Merge() should return: all the elements, sorted on value, and equal
+// values in the order of their sequences.
+std::vector<Element> ExpectedMerge(const std::vector<Sequence> &sequences) {
+  std::vector<Element> expected;
+  for (size_t i = 0; i < sequences.size(); ++i) {
+    for (int value : sequences[i]) expected.emplace_back(value, i);
+  }
+  std::stable_sort(
+      expected.begin(), expected.end(),
+      [](const Element &a, const Element &b) { return a.first < b.first; });
+  return expected;
+}
+
+TEST(LoserTreeTest, Empty) {
+  Loser_tree<int> tree;
+  std::vector<int> none;
+  EXPECT_FALSE(tree.init(none.begin(), none.end()));
+  EXPECT_TRUE(tree.empty());
+  EXPECT_EQ(0U, tree.size());
+}
+
+TEST(LoserTreeTest, SingleSequence) {
+  const std::vector<Sequence> sequences = {{1, 2, 2, 5}};
+  EXPECT_EQ(ExpectedMerge(sequences), Merge(sequences));
+}
+
+TEST(LoserTreeTest, MaxOnTop) {
+  // Without a custom ordering, the greatest element is on top, just like
+  // with Priority_queue.
+  Loser_tree<int> tree;
+  const std::vector<int> values = {3, 9, 1, 4};
+  EXPECT_FALSE(tree.init(values.begin(), values.end()));
+  EXPECT_EQ(4U, tree.size());
+  EXPECT_EQ(9, tree.top());
+  EXPECT_EQ(1U, tree.top_index());
+  tree.pop();
+  EXPECT_FALSE(tree.contains(1));
+  EXPECT_EQ(4, tree.top());
+  tree.top() = 0;
+  tree.update_top();
+  EXPECT_EQ(3, tree.top());
+  EXPECT_EQ(0U, tree.top_index());
+}
+
+TEST(LoserTreeTest, EmptySequences) {
+  const std::vector<Sequence> sequences = {{}, {}, {1, 3}, {2}};
+  EXPECT_EQ(ExpectedMerge(sequences), Merge(sequences));
+}
+
+TEST(LoserTreeTest, StableMerge) {
+  // Every number of sequences from 1 to 20, to cover trees of all shapes,
+  // with few distinct values, so that there are many ties.
+  std::mt19937 generator(42);
+  for (size_t num_sequences = 1; num_sequences <= 20; ++num_sequences) {
+    std::vector<Sequence> sequences(num_sequences);
+    for (Sequence &sequence : sequences) {
+      sequence.resize(1 + generator() % 50);
+      for (int &value : sequence) value = 1 + generator() % 10;
+      std::sort(sequence.begin(), sequence.end());
+    }
+    SCOPED_TRACE(num_sequences);
+    EXPECT_EQ(ExpectedMerge(sequences), Merge(sequences));
+  }
+}
+
+}  // namespace loser_tree_unittest
@@ -23,14 +23,17 @@
 
 #include <gtest/gtest.h>
 #include <sys/types.h>
+#include <optional>
 
 #include "my_inttypes.h"
 #include "sql/filesort.h"
+#include "sql/iterators/runtime_filter.h"
 #include "sql/sort_param.h"
 #include "sql/sql_lex.h"
 #include "sql/sql_sort.h"
 #include "sql/sys_vars.h"
 #include "unittest/gunit/fake_table.h"
+#include "unittest/gunit/mock_field_long.h"
 #include "unittest/gunit/test_utils.h"
 
 namespace make_sortkey_unittest {
@@ -188,4 +191,74 @@ TEST_F(MakeSortKeyTest, AddonFields) {
       << "make_sortkey() should report back that there was not enough room.";
 }
 
+TEST(TopNFilterTest, PushesRangeOfRemainingRows) {
+  my_testing::Server_initializer initializer;
+  initializer.SetUp();
+
+  Mock_field_long field_long("column1", /*is_nullable=*/true,
+                             /*is_unsigned=*/false);
+  Fake_TABLE fake_table(&field_long);
+  bitmap_set_all(fake_table.write_set);
+  bitmap_set_all(fake_table.read_set);
+  TABLE *table = &fake_table;
+  Field *field = &field_long;
+  ASSERT_TRUE(RuntimeFilter::IsSupportedColumn(field));
+  auto set_value = [field](std::optional<int> value) {
+    if (value.has_value()) {
+      field->set_notnull();
+      field->store(*value, /*unsigned_val=*/false);
+    } else {
+      field->set_null();
+    }
+  };
+  auto may_match = [&](std::optional<int> value) {
+    set_value(value);
+    return table->file->ha_get_runtime_filter()->MayMatch(table->record[0]);
+  };
+  auto add_row = [&](TopNFilter *top_n, std::optional<int> value) {
+    set_value(value);
+    top_n->AddRow();
+  };
+
+  // ORDER BY f DESC LIMIT 2. Nothing is thrown away until two rows are seen,
+  // and NULL sorts last.
+  TopNFilter top_n(field, /*descending=*/true, /*limit=*/2);
+  top_n.StartSort();
+  ASSERT_NE(nullptr, table->file->ha_get_runtime_filter());
+  add_row(&top_n, 5);
+  EXPECT_TRUE(may_match(-3));
+  add_row(&top_n, std::nullopt);
+  EXPECT_TRUE(may_match(-3));
+  add_row(&top_n, 3);
+  EXPECT_TRUE(may_match(3));  // Ties may win on the next sort column.
+  EXPECT_TRUE(may_match(100));
+  EXPECT_FALSE(may_match(2));
+  EXPECT_FALSE(may_match(std::nullopt));
+  add_row(&top_n, 7);
+  EXPECT_FALSE(may_match(4));
+  EXPECT_TRUE(may_match(5));
+  top_n.EndSort();
+  EXPECT_EQ(nullptr, table->file->ha_get_runtime_filter());
+
+  // ORDER BY f LIMIT 1, with another filter pushed on top. NULL sorts first,
+  // and rows must pass both filters.
+  TopNFilter ascending(field, /*descending=*/false, /*limit=*/1);
+  ascending.StartSort();
+  RuntimeFilter other(field);
+  other.SetRange(-100, 20, /*nulls_may_match=*/true);
+  other.Push();
+  add_row(&ascending, 10);
+  EXPECT_TRUE(may_match(8));
+  EXPECT_TRUE(may_match(std::nullopt));
+  EXPECT_FALSE(may_match(12));
+  EXPECT_FALSE(may_match(-200));
+
+  // Removing the filter of the sort leaves the other one in place.
+  ascending.EndSort();
+  EXPECT_EQ(&other, table->file->ha_get_runtime_filter());
+  EXPECT_TRUE(may_match(12));
+  other.Remove();
+  EXPECT_EQ(nullptr, table->file->ha_get_runtime_filter());
+}
+
 }  // namespace make_sortkey_unittest
@@ -0,0 +1,441 @@
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include <limits.h>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "my_byteorder.h"
+#include "my_inttypes.h"
+#include "sql/field.h"
+#include "sql/iterators/parallel_aggregate_iterator.h"
+#include "sql/join_optimizer/access_path.h"
+#include "sql/join_optimizer/cost_model.h"
+#include "sql/my_decimal.h"
+#include "sql/table.h"
+#include "unittest/gunit/fake_table.h"
+#include "unittest/gunit/test_utils.h"
+
+namespace parallel_aggregate_unittest {
+
+using parallel_aggregate::AggregateSpec;
+using parallel_aggregate::AggregateState;
+using parallel_aggregate::AggregationSpec;
+using parallel_aggregate::ColumnPredicate;
+using parallel_aggregate::CompareIntegers;
+using parallel_aggregate::DistinctValues;
+using parallel_aggregate::GroupColumn;
+using parallel_aggregate::GroupTable;
+using parallel_aggregate::IntegerColumn;
+using std::optional;
+using std::vector;
+
+class ParallelAggregateTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    m_initializer.SetUp();
+    m_table = new (m_initializer.thd()->mem_root)
+        Fake_TABLE(/*column_count=*/2, /*cols_nullable=*/true);
+    m_row_length = (m_table->null_flags + m_table->s->null_bytes) -
+                   m_table->record[0];
+  }
+  void TearDown() override { m_initializer.TearDown(); }
+
+  /// Make a row in the format of record[0], like the ones the parallel scan
+  /// delivers.
+  vector<uchar> MakeRow(optional<int> a, optional<int> b) {
+    for (int i = 0; i < 2; ++i) {
+      Field *field = m_table->field[i];
+      const optional<int> value = i == 0 ? a : b;
+      if (value.has_value()) {
+        field->set_notnull();
+        field->store(*value, /*unsigned_val=*/false);
+      } else {
+        field->set_null();
+      }
+    }
+    return vector<uchar>(m_table->record[0],
+                         m_table->record[0] + m_row_length);
+  }
+
+  /// GROUP BY a, with COUNT(*), COUNT(b), SUM(b), MIN(b), MAX(b) and a filter
+  /// on b.
+  AggregationSpec MakeSpec(ColumnPredicate::Op op, longlong value,
+                           bool descending) {
+    const IntegerColumn a = IntegerColumn::FromField(m_table->field[0]);
+    const IntegerColumn b = IntegerColumn::FromField(m_table->field[1]);
+    AggregationSpec spec;
+    ColumnPredicate predicate;
+    predicate.column = b;
+    predicate.op = op;
+    predicate.value = value;
+    spec.predicates.push_back(predicate);
+    spec.group_columns.push_back(GroupColumn{a, descending});
+    spec.aggregates.push_back({AggregateSpec::Kind::COUNT_ROWS, b});
+    spec.aggregates.push_back({AggregateSpec::Kind::COUNT, b});
+    spec.aggregates.push_back({AggregateSpec::Kind::SUM, b});
+    spec.aggregates.push_back({AggregateSpec::Kind::MIN, b});
+    spec.aggregates.push_back({AggregateSpec::Kind::MAX, b});
+    spec.output_columns = {a, b};
+    spec.row_length = m_row_length;
+    return spec;
+  }
+
+  my_testing::Server_initializer m_initializer;
+  Fake_TABLE *m_table{nullptr};
+  size_t m_row_length{0};
+};
+
+static longlong SumAsInt(const AggregateState &state) {
+  my_decimal sum;
+  state.GetSum(&sum);
+  longlong result;
+  my_decimal2int(E_DEC_FATAL_ERROR, &sum, /*unsigned_flag=*/false, &result);
+  return result;
+}
+
+TEST_F(ParallelAggregateTest, MergeGroupsFromSeveralThreads) {
+  const AggregationSpec spec =
+      MakeSpec(ColumnPredicate::Op::GE, 0, /*descending=*/false);
+  GroupTable first_thread(&spec, /*max_memory=*/1024 * 1024);
+  GroupTable second_thread(&spec, /*max_memory=*/1024 * 1024);
+
+  for (const vector<uchar> &row :
+       {MakeRow(1, 10), MakeRow(2, 5), MakeRow({}, 3), MakeRow(1, {}),
+        MakeRow(2, -1)}) {
+    ASSERT_FALSE(first_thread.AddRow(row.data()));
+  }
+  for (const vector<uchar> &row :
+       {MakeRow(1, 20), MakeRow(2, 7), MakeRow({}, 4)}) {
+    ASSERT_FALSE(second_thread.AddRow(row.data()));
+  }
+  // (1, NULL) does not satisfy b >= 0 either.
+  EXPECT_EQ(3U, first_thread.num_groups());
+  EXPECT_EQ(3U, second_thread.num_groups());
+
+  GroupTable merged(&spec, /*max_memory=*/1024 * 1024);
+  ASSERT_FALSE(merged.Merge(&first_thread));
+  ASSERT_FALSE(merged.Merge(&second_thread));
+  merged.SortGroups();
+  EXPECT_EQ(8U, merged.rows_read());
+  ASSERT_EQ(3U, merged.num_groups());
+
+  // NULL sorts first.
+  const IntegerColumn a = spec.group_columns[0].column;
+  EXPECT_TRUE(a.IsNull(merged.group(0).row));
+  EXPECT_EQ(1, a.Value(merged.group(1).row));
+  EXPECT_EQ(2, a.Value(merged.group(2).row));
+
+  struct Expected {
+    ulonglong count;
+    longlong sum, min, max;
+  };
+  const Expected expected[] = {{2, 7, 3, 4}, {2, 30, 10, 20}, {2, 12, 5, 7}};
+  for (size_t i = 0; i < 3; ++i) {
+    SCOPED_TRACE(i);
+    const AggregateState *states = merged.group(i).states;
+    EXPECT_EQ(expected[i].count, states[0].count);
+    EXPECT_EQ(expected[i].count, states[1].count);
+    EXPECT_EQ(expected[i].sum, SumAsInt(states[2]));
+    EXPECT_EQ(expected[i].min, states[3].extreme);
+    EXPECT_EQ(expected[i].max, states[4].extreme);
+  }
+}
+
+TEST_F(ParallelAggregateTest, DescendingOrderAndNullCounts) {
+  const AggregationSpec spec =
+      MakeSpec(ColumnPredicate::Op::NE, 100, /*descending=*/true);
+  GroupTable groups(&spec, /*max_memory=*/1024 * 1024);
+  for (const vector<uchar> &row :
+       {MakeRow(3, 1), MakeRow({}, 2), MakeRow(5, 100), MakeRow(5, 6)}) {
+    ASSERT_FALSE(groups.AddRow(row.data()));
+  }
+  groups.SortGroups();
+  ASSERT_EQ(3U, groups.num_groups());
+
+  // NULL sorts last in descending order.
+  const IntegerColumn a = spec.group_columns[0].column;
+  EXPECT_EQ(5, a.Value(groups.group(0).row));
+  EXPECT_EQ(3, a.Value(groups.group(1).row));
+  EXPECT_TRUE(a.IsNull(groups.group(2).row));
+
+  // The first row that satisfied the filter is kept for each group.
+  const IntegerColumn b = spec.output_columns[1];
+  EXPECT_EQ(6, b.Value(groups.group(0).row));
+  EXPECT_EQ(1U, groups.group(0).states[0].count);
+}
+
+TEST_F(ParallelAggregateTest, SpillToDisk) {
+  const AggregationSpec spec =
+      MakeSpec(ColumnPredicate::Op::GE, 0, /*descending=*/true);
+  GroupTable first_thread(&spec, /*max_memory=*/1);
+  GroupTable second_thread(&spec, /*max_memory=*/1);
+
+  ASSERT_FALSE(first_thread.AddRow(MakeRow(1, 1).data()));
+  // Rows in existing groups need no more memory.
+  ASSERT_FALSE(first_thread.AddRow(MakeRow(1, 2).data()));
+  EXPECT_EQ(0U, first_thread.num_spilled_runs());
+  // Every new group spills the one in memory.
+  for (const vector<uchar> &row :
+       {MakeRow(2, 5), MakeRow(1, 3), MakeRow({}, 4), MakeRow(2, 6)}) {
+    ASSERT_FALSE(first_thread.AddRow(row.data()));
+  }
+  EXPECT_EQ(4U, first_thread.num_spilled_runs());
+  EXPECT_EQ(1U, first_thread.num_groups());
+  for (const vector<uchar> &row : {MakeRow(3, 7), MakeRow(1, 8)}) {
+    ASSERT_FALSE(second_thread.AddRow(row.data()));
+  }
+
+  GroupTable merged(&spec, /*max_memory=*/1024 * 1024);
+  ASSERT_FALSE(merged.Merge(&first_thread));
+  ASSERT_FALSE(merged.Merge(&second_thread));
+  EXPECT_EQ(5U, merged.num_spilled_runs());
+  EXPECT_EQ(8U, merged.rows_read());
+  ASSERT_FALSE(merged.StartReading());
+
+  // The groups come out in descending order, with the partial states from
+  // all runs combined.
+  const IntegerColumn a = spec.group_columns[0].column;
+  struct Expected {
+    optional<int> a;
+    ulonglong count;
+    longlong sum, min, max;
+  };
+  const Expected expected[] = {{3, 1, 7, 7, 7},
+                               {2, 2, 11, 5, 6},
+                               {1, 4, 14, 1, 8},
+                               {{}, 1, 4, 4, 4}};
+  for (const Expected &group : expected) {
+    SCOPED_TRACE(group.a.value_or(-1));
+    const GroupTable::Group *read_group;
+    ASSERT_EQ(0, merged.ReadGroup(&read_group));
+    if (group.a.has_value()) {
+      EXPECT_EQ(*group.a, a.Value(read_group->row));
+    } else {
+      EXPECT_TRUE(a.IsNull(read_group->row));
+    }
+    const AggregateState *states = read_group->states;
+    EXPECT_EQ(group.count, states[0].count);
+    EXPECT_EQ(group.count, states[1].count);
+    EXPECT_EQ(group.sum, SumAsInt(states[2]));
+    EXPECT_EQ(group.min, states[3].extreme);
+    EXPECT_EQ(group.max, states[4].extreme);
+  }
+  const GroupTable::Group *read_group;
+  EXPECT_EQ(-1, merged.ReadGroup(&read_group));
+}
+
+TEST_F(ParallelAggregateTest, CountDistinctFromSeveralThreads) {
+  // GROUP BY a, with COUNT(DISTINCT b).
+  const IntegerColumn a = IntegerColumn::FromField(m_table->field[0]);
+  const IntegerColumn b = IntegerColumn::FromField(m_table->field[1]);
+  AggregationSpec spec;
+  spec.group_columns.push_back(GroupColumn{a, /*descending=*/false});
+  spec.aggregates.push_back({AggregateSpec::Kind::COUNT_DISTINCT, b});
+  spec.output_columns = {a, b};
+  spec.row_length = m_row_length;
+
+  // Every thread sees every row: 100 distinct values of b, and NULL, in each
+  // of the groups a = 0, 1 and 2.
+  vector<vector<uchar>> rows;
+  for (int i = 0; i < 300; ++i) rows.push_back(MakeRow(i % 3, i % 100));
+  for (int i = 0; i < 3; ++i) rows.push_back(MakeRow(i, {}));
+
+  DistinctValues distinct_values(&spec, /*max_memory=*/1024 * 1024);
+  constexpr int kNumThreads = 4;
+  vector<std::unique_ptr<GroupTable>> thread_groups;
+  for (int i = 0; i < kNumThreads; ++i) {
+    thread_groups.push_back(std::make_unique<GroupTable>(
+        &spec, /*max_memory=*/1024 * 1024, &distinct_values));
+  }
+  std::atomic<int> failures{0};
+  vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&rows, &failures, groups = thread_groups[i].get()] {
+      for (const vector<uchar> &row : rows) {
+        if (groups->AddRow(row.data())) ++failures;
+      }
+    });
+  }
+  for (std::thread &thread : threads) thread.join();
+  ASSERT_EQ(0, failures);
+
+  GroupTable merged(&spec, /*max_memory=*/1024 * 1024);
+  for (std::unique_ptr<GroupTable> &groups : thread_groups) {
+    ASSERT_FALSE(merged.Merge(groups.get()));
+  }
+  merged.SortGroups();
+  ASSERT_EQ(3U, merged.num_groups());
+  for (size_t i = 0; i < 3; ++i) {
+    SCOPED_TRACE(i);
+    EXPECT_EQ(static_cast<longlong>(i), a.Value(merged.group(i).row));
+    // Each value was counted once, by one of the threads.
+    EXPECT_EQ(100U, merged.group(i).states[0].count);
+  }
+}
+
+TEST_F(ParallelAggregateTest, CountDistinctRunsOutOfRoom) {
+  const IntegerColumn b = IntegerColumn::FromField(m_table->field[1]);
+  AggregationSpec spec;
+  spec.aggregates.push_back({AggregateSpec::Kind::COUNT_DISTINCT, b});
+  spec.output_columns = {b};
+  spec.row_length = m_row_length;
+
+  // Room for a single value.
+  DistinctValues distinct_values(&spec, /*max_memory=*/1);
+  GroupTable groups(&spec, /*max_memory=*/1024 * 1024, &distinct_values);
+  EXPECT_FALSE(groups.AddRow(MakeRow(1, 1).data()));
+  EXPECT_FALSE(groups.AddRow(MakeRow(2, 1).data()));
+  EXPECT_FALSE(groups.AddRow(MakeRow(3, {}).data()));
+  EXPECT_EQ(GroupTable::Failure::NONE, groups.failure());
+  EXPECT_TRUE(groups.AddRow(MakeRow(4, 2).data()));
+  // The caller falls back to the serial iterators; this is not an error.
+  EXPECT_EQ(GroupTable::Failure::NO_ROOM, groups.failure());
+  EXPECT_FALSE(groups.ReportFailure());
+}
+
+TEST(ParallelAggregateStateTest, SerializeState) {
+  IntegerColumn column;
+  column.length = 8;
+  const AggregateSpec spec{AggregateSpec::Kind::SUM, column};
+
+  // Make the sum spill over into the decimal part.
+  uchar row[8];
+  int8store(row, static_cast<ulonglong>(LLONG_MAX));
+  AggregateState state;
+  state.Add(spec, row);
+  state.Add(spec, row);
+  int8store(row, static_cast<ulonglong>(-5));
+  state.Add(spec, row);
+
+  vector<uchar> buffer(AggregateState::SerializedSize());
+  state.Serialize(buffer.data());
+  AggregateState copy;
+  copy.Deserialize(buffer.data());
+  EXPECT_EQ(3U, copy.count);
+
+  my_decimal expected;
+  my_decimal sum;
+  state.GetSum(&expected);
+  copy.GetSum(&sum);
+  EXPECT_EQ(0, my_decimal_cmp(&expected, &sum));
+}
+
+TEST(ParallelAggregateStateTest, CompareSignedAndUnsigned) {
+  EXPECT_EQ(-1, CompareIntegers(-1, false, 0, true));
+  EXPECT_EQ(1, CompareIntegers(0, true, -1, false));
+  // The bit pattern of -1 is ULLONG_MAX when unsigned.
+  EXPECT_EQ(1, CompareIntegers(-1, true, LLONG_MAX, false));
+  EXPECT_EQ(-1, CompareIntegers(LLONG_MAX, false, -1, true));
+  EXPECT_EQ(1, CompareIntegers(-1, true, 1, true));
+  EXPECT_EQ(0, CompareIntegers(7, true, 7, false));
+  EXPECT_EQ(-1, CompareIntegers(-7, false, 7, false));
+}
+
+TEST(ParallelAggregateStateTest, SumDoesNotOverflow) {
+  IntegerColumn column;
+  column.length = 8;
+  const AggregateSpec spec{AggregateSpec::Kind::SUM, column};
+
+  uchar row[8];
+  int8store(row, static_cast<ulonglong>(LLONG_MAX));
+  AggregateState state;
+  state.Add(spec, row);
+  state.Add(spec, row);
+  AggregateState other;
+  other.Add(spec, row);
+  state.Merge(spec, other);
+  EXPECT_EQ(3U, state.count);
+
+  my_decimal expected;
+  my_decimal value;
+  my_decimal tmp;
+  int2my_decimal(E_DEC_FATAL_ERROR, LLONG_MAX, false, &value);
+  my_decimal_add(E_DEC_FATAL_ERROR, &tmp, &value, &value);
+  my_decimal_add(E_DEC_FATAL_ERROR, &expected, &tmp, &value);
+  my_decimal sum;
+  state.GetSum(&sum);
+  EXPECT_EQ(0, my_decimal_cmp(&expected, &sum));
+
+  // An unsigned BIGINT above LLONG_MAX.
+  IntegerColumn unsigned_column = column;
+  unsigned_column.is_unsigned = true;
+  const AggregateSpec unsigned_spec{AggregateSpec::Kind::SUM, unsigned_column};
+  int8store(row, ULLONG_MAX);
+  AggregateState unsigned_state;
+  unsigned_state.Add(unsigned_spec, row);
+  unsigned_state.GetSum(&sum);
+  int2my_decimal(E_DEC_FATAL_ERROR, static_cast<longlong>(ULLONG_MAX), true,
+                 &expected);
+  EXPECT_EQ(0, my_decimal_cmp(&expected, &sum));
+}
+
+/// The cost of a GATHER over an aggregation of "num_rows" rows into
+/// "num_groups" groups, relative to the cost of the serial aggregation.
+static double RelativeGatherCost(double num_rows, double num_groups,
+                                 int num_workers) {
+  AccessPath scan;
+  scan.type = AccessPath::TABLE_SCAN;
+  scan.set_num_output_rows(num_rows);
+  scan.init_cost = 0.0;
+  scan.cost = num_rows;
+
+  AccessPath aggregate;
+  aggregate.type = AccessPath::AGGREGATE;
+  aggregate.aggregate().child = &scan;
+  aggregate.aggregate().rollup = false;
+  aggregate.set_num_output_rows(num_groups);
+  aggregate.init_cost = 0.0;
+  aggregate.cost = scan.cost + kAggregateOneRowCost * num_rows;
+
+  AccessPath gather;
+  gather.type = AccessPath::GATHER;
+  gather.gather().child = &aggregate;
+  gather.gather().num_workers = num_workers;
+  EstimateGatherCost(&gather);
+
+  EXPECT_EQ(num_groups, gather.num_output_rows());
+  // No rows are returned until the scan is done.
+  EXPECT_LE(gather.init_cost, gather.cost);
+  EXPECT_LT(gather.cost - gather.init_cost, gather.init_cost);
+  return gather.cost / aggregate.cost;
+}
+
+TEST(ParallelAggregateCostTest, GatherPaysOffForLargeScans) {
+  EXPECT_GT(RelativeGatherCost(100.0, 10.0, /*num_workers=*/4), 1.0);
+  EXPECT_LT(RelativeGatherCost(1e7, 10.0, /*num_workers=*/4), 0.5);
+  // More workers help, as long as the scan dominates.
+  EXPECT_LT(RelativeGatherCost(1e7, 10.0, /*num_workers=*/8),
+            RelativeGatherCost(1e7, 10.0, /*num_workers=*/4));
+  // When (almost) every row is a group of its own, the merge and the sort of
+  // the groups eat up most of the gain.
+  EXPECT_GT(RelativeGatherCost(1e7, 1e7, /*num_workers=*/4),
+            RelativeGatherCost(1e7, 10.0, /*num_workers=*/4));
+}
+
+}  // namespace parallel_aggregate_unittest
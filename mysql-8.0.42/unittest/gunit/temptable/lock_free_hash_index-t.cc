@@ -0,0 +1,175 @@
+/* Copyright (c) 2025, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is designed to work with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have either included with
+   the program or referenced in the documentation.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "allocator_helper.h"
+#include "storage/temptable/include/temptable/allocator.h"
+#include "storage/temptable/include/temptable/block.h"
+#include "storage/temptable/include/temptable/lock_free_hash_index.h"
+#include "storage/temptable/include/temptable/result.h"
+
+namespace temptable_test {
+
+namespace {
+
+struct Entry {
+  uint64_t m_key;
+  size_t m_thread;
+};
+
+/* Pairs of keys have the same hash, so that equal hashes do not always mean
+ * equal keys. */
+uint64_t hash_key(uint64_t key) { return (key / 2) * 0x9E3779B97F4A7C15ULL; }
+
+bool equal_keys(const Entry &a, const Entry &b) { return a.m_key == b.m_key; }
+
+}  // namespace
+
+class Lock_free_hash_index_test : public testing::Test {
+ protected:
+  void SetUp() override {
+    Allocator_helper::set_allocator_max_ram_default();
+    temptable::Allocator<uint8_t>::init();
+  }
+
+  void TearDown() override { m_shared_block.destroy(); }
+
+  temptable::TableResourceMonitor m_table_resource_monitor{16 * 1024 * 1024};
+  temptable::Block m_shared_block;
+  temptable::Allocator<uint8_t> m_allocator{&m_shared_block,
+                                            m_table_resource_monitor};
+};
+
+TEST_F(Lock_free_hash_index_test, InsertLookup) {
+  temptable::Lock_free_hash_index<Entry> index(100, m_allocator);
+  std::vector<Entry> entries;
+  for (uint64_t key = 0; key < 100; ++key) {
+    entries.push_back({key, 0});
+  }
+
+  for (Entry &entry : entries) {
+    Entry *existing = nullptr;
+    EXPECT_EQ(index.insert(hash_key(entry.m_key), &entry, equal_keys,
+                           &existing),
+              temptable::Result::OK);
+  }
+  EXPECT_EQ(index.size(), 100);
+
+  /* Duplicates are not inserted, and the existing entry is returned. */
+  Entry duplicate{42, 1};
+  Entry *existing = nullptr;
+  EXPECT_EQ(index.insert(hash_key(42), &duplicate, equal_keys, &existing),
+            temptable::Result::FOUND_DUPP_KEY);
+  EXPECT_EQ(existing, &entries[42]);
+
+  /* The index is full. */
+  Entry extra{1000, 0};
+  EXPECT_EQ(index.insert(hash_key(1000), &extra, equal_keys, &existing),
+            temptable::Result::RECORD_FILE_FULL);
+  EXPECT_EQ(index.size(), 100);
+
+  for (uint64_t key = 0; key < 100; ++key) {
+    const Entry *found = index.lookup(
+        hash_key(key), [key](const Entry &e) { return e.m_key == key; });
+    ASSERT_NE(found, nullptr);
+    EXPECT_EQ(found->m_key, key);
+  }
+  EXPECT_EQ(index.lookup(hash_key(1000),
+                         [](const Entry &e) { return e.m_key == 1000; }),
+            nullptr);
+
+  index.clear();
+  EXPECT_EQ(index.size(), 0);
+  EXPECT_EQ(
+      index.lookup(hash_key(42), [](const Entry &e) { return e.m_key == 42; }),
+      nullptr);
+}
+
+TEST_F(Lock_free_hash_index_test, ConcurrentInserts) {
+  const size_t number_of_threads = 8;
+  const uint64_t number_of_keys = 16384;
+
+  temptable::Lock_free_hash_index<Entry> index(number_of_keys, m_allocator);
+
+  /* Every thread inserts every key, in a different order (the multipliers are
+   * odd, so they are coprime with the number of keys). Exactly one entry must
+   * win for each key. */
+  std::vector<std::vector<Entry>> entries(number_of_threads);
+  std::vector<size_t> inserted(number_of_threads, 0);
+  std::atomic<bool> error{false};
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < number_of_threads; ++t) {
+    entries[t].reserve(number_of_keys);
+    for (uint64_t i = 0; i < number_of_keys; ++i) {
+      entries[t].push_back({(i * (2 * t + 1)) % number_of_keys, t});
+    }
+    threads.emplace_back([&, t]() {
+      for (Entry &entry : entries[t]) {
+        Entry *existing = nullptr;
+        switch (index.insert(hash_key(entry.m_key), &entry, equal_keys,
+                             &existing)) {
+          case temptable::Result::OK:
+            ++inserted[t];
+            break;
+          case temptable::Result::FOUND_DUPP_KEY:
+            if (existing->m_key != entry.m_key) error = true;
+            break;
+          default:
+            error = true;
+        }
+        const uint64_t key = entry.m_key;
+        if (index.lookup(hash_key(key), [key](const Entry &e) {
+              return e.m_key == key;
+            }) == nullptr) {
+          error = true;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_FALSE(error);
+  size_t total_inserted = 0;
+  for (size_t n : inserted) {
+    total_inserted += n;
+  }
+  EXPECT_EQ(total_inserted, number_of_keys);
+  EXPECT_EQ(index.size(), number_of_keys);
+
+  for (uint64_t key = 0; key < number_of_keys; ++key) {
+    const Entry *found = index.lookup(
+        hash_key(key), [key](const Entry &e) { return e.m_key == key; });
+    ASSERT_NE(found, nullptr);
+    EXPECT_EQ(found->m_key, key);
+  }
+}
+
+}  // namespace temptable_test
@@ -28,6 +28,7 @@
 #include <vector>
 
 #include "mysql/plugin.h"
+#include "scope_guard.h"
 #include "sql/mysqld.h"
 #include "storage/temptable/include/temptable/handler.h"
 #include "unittest/gunit/temptable/table_helper.h"
@@ -275,6 +276,102 @@ TEST_F(Handler_test, SimpleTableOpsVarSize) {
   EXPECT_EQ(handler.delete_table(table_name, nullptr), 0);
 }
 
+TEST_F(Handler_test, ColumnarTableOps) {
+  const char *table_name = "t1";
+  const int number_of_rows = 10000;
+
+  /* Restore the setting even if an ASSERT_*() returns early. */
+  const bool saved_use_columnar_storage = temptable_use_columnar_storage;
+  temptable_use_columnar_storage = true;
+  auto restore_use_columnar_storage = create_scope_guard([=] {
+    temptable_use_columnar_storage = saved_use_columnar_storage;
+  });
+
+  Table_helper table_helper(table_name, thd());
+  table_helper.add_field_long("col0", false);
+  table_helper.add_field_long("col1", true);
+  table_helper.add_field_varstring("col2", 20, true);
+  table_helper.finalize();
+
+  temptable::Handler handler(hton(), table_helper.table_share());
+  table_helper.set_handler(&handler);
+
+  EXPECT_EQ(handler.create(table_name, table_helper.table(), nullptr, nullptr),
+            0);
+  EXPECT_EQ(handler.open(table_name, 0, 0, nullptr), 0);
+
+  /* col0 has a distinct value in each row, col1 has long runs of the same
+   * value, and col2 has few distinct values. */
+  for (int i = 0; i < number_of_rows; ++i) {
+    table_helper.field<Field_long>(0)->store(i, false);
+    table_helper.field<Field_long>(1)->store(i / 1000, false);
+    table_helper.field<Field_long>(1)->set_notnull();
+    if (i % 7 == 0) {
+      table_helper.field<Field_varstring>(2)->set_null();
+    } else {
+      table_helper.field<Field_varstring>(2)->store(i % 5, false);
+      table_helper.field<Field_varstring>(2)->set_notnull();
+    }
+    EXPECT_EQ(handler.write_row(table_helper.record_0()), 0);
+  }
+
+  /* Read all rows, and remember the position of one of them. */
+  std::vector<uchar> position(handler.ref_length);
+  EXPECT_EQ(handler.rnd_init(true), 0);
+  for (int i = 0; i < number_of_rows; ++i) {
+    ASSERT_EQ(handler.rnd_next(table_helper.record_0()), 0);
+    EXPECT_EQ(table_helper.field<Field_long>(0)->val_int(), i);
+    EXPECT_EQ(table_helper.field<Field_long>(1)->val_int(), i / 1000);
+    if (i % 7 == 0) {
+      EXPECT_TRUE(table_helper.field<Field_varstring>(2)->is_null());
+    } else {
+      EXPECT_FALSE(table_helper.field<Field_varstring>(2)->is_null());
+      EXPECT_EQ(table_helper.field<Field_varstring>(2)->val_int(), i % 5);
+    }
+    if (i == 5000) {
+      handler.position(table_helper.record_0());
+      memcpy(position.data(), handler.ref, handler.ref_length);
+    }
+  }
+  EXPECT_EQ(handler.rnd_next(table_helper.record_0()), HA_ERR_END_OF_FILE);
+  EXPECT_EQ(handler.rnd_end(), 0);
+
+  /* Update the first row. */
+  EXPECT_EQ(handler.rnd_init(false), 0);
+  EXPECT_EQ(handler.rnd_next(table_helper.record_1()), 0);
+  table_helper.field<Field_long>(0)->store(-1, false);
+  table_helper.field<Field_long>(1)->set_null();
+  table_helper.field<Field_varstring>(2)->store(42, false);
+  table_helper.field<Field_varstring>(2)->set_notnull();
+  EXPECT_EQ(
+      handler.update_row(table_helper.record_1(), table_helper.record_0()), 0);
+  EXPECT_EQ(handler.rnd_end(), 0);
+
+  /* Delete the second row. */
+  EXPECT_EQ(handler.rnd_init(false), 0);
+  EXPECT_EQ(handler.rnd_next(table_helper.record_1()), 0);
+  EXPECT_EQ(handler.rnd_next(table_helper.record_1()), 0);
+  EXPECT_EQ(handler.delete_row(table_helper.record_1()), 0);
+  EXPECT_EQ(handler.rnd_end(), 0);
+
+  EXPECT_EQ(handler.rnd_init(false), 0);
+  EXPECT_EQ(handler.rnd_next(table_helper.record_0()), 0);
+  EXPECT_EQ(table_helper.field<Field_long>(0)->val_int(), -1);
+  EXPECT_TRUE(table_helper.field<Field_long>(1)->is_null());
+  EXPECT_EQ(table_helper.field<Field_varstring>(2)->val_int(), 42);
+  EXPECT_EQ(handler.rnd_next(table_helper.record_0()), 0);
+  EXPECT_EQ(table_helper.field<Field_long>(0)->val_int(), 2);
+
+  EXPECT_EQ(handler.rnd_pos(table_helper.record_0(), position.data()), 0);
+  EXPECT_EQ(table_helper.field<Field_long>(0)->val_int(), 5000);
+  EXPECT_EQ(table_helper.field<Field_long>(1)->val_int(), 5);
+  EXPECT_EQ(table_helper.field<Field_varstring>(2)->val_int(), 0);
+  EXPECT_EQ(handler.rnd_end(), 0);
+
+  EXPECT_EQ(handler.close(), 0);
+  EXPECT_EQ(handler.delete_table(table_name, nullptr), 0);
+}
+
 TEST_F(Handler_test, SingleIndex) {
   ::testing::FLAGS_gtest_death_test_style = "threadsafe";
 